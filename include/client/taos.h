@@ -170,6 +170,7 @@ DLL_EXPORT int       taos_stmt_get_param(TAOS_STMT *stmt, int idx, int *type, in
 DLL_EXPORT int       taos_stmt_bind_param(TAOS_STMT *stmt, TAOS_MULTI_BIND *bind);
 DLL_EXPORT int       taos_stmt_bind_param_batch(TAOS_STMT *stmt, TAOS_MULTI_BIND *bind);
 DLL_EXPORT int       taos_stmt_bind_single_param_batch(TAOS_STMT *stmt, TAOS_MULTI_BIND *bind, int colIdx);
+// with the stmtBindZeroCopy option the buffers of every batch are referenced until `taos_stmt_execute` returns
 DLL_EXPORT int       taos_stmt_add_batch(TAOS_STMT *stmt);
 DLL_EXPORT int       taos_stmt_execute(TAOS_STMT *stmt);
 DLL_EXPORT TAOS_RES *taos_stmt_use_result(TAOS_STMT *stmt);
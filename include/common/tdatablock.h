@@ -235,7 +235,11 @@ int32_t      blockDataAppendColInfo(SSDataBlock* pBlock, SColumnInfoData* pColIn
 SColumnInfoData  createColumnInfoData(int16_t type, int32_t bytes, int16_t colId);
 SColumnInfoData* bdGetColumnInfoData(const SSDataBlock* pBlock, int32_t index);
 
+// flag segment bits of an encoded block
+#define BLOCK_FLAG_NCHAR_UTF8 (1 << 30)  // nchar columns are encoded in utf-8 instead of ucs4
+
 int32_t blockEncode(const SSDataBlock* pBlock, char* data, int32_t numOfCols);
+int32_t blockEncodeNcharToUtf8(char* data, int32_t* pDataLen);
 const char* blockDecode(SSDataBlock* pBlock, const char* pData);
 
 void blockDebugShowDataBlock(SSDataBlock* pBlock, const char* flag);
@@ -44,6 +44,9 @@ typedef struct SColData SColData;
 #define HAS_NULL  ((uint8_t)0x2)
 #define HAS_VALUE ((uint8_t)0x4)
 
+// SColData.cflag
+#define COL_DATA_REF_BUF ((int8_t)0x1)  // pData references a caller owned buffer, not freed or reallocated
+
 // bitmap ================================
 const static uint8_t BIT1_MAP[8] = {0b11111110, 0b11111101, 0b11111011, 0b11110111,
                                     0b11101111, 0b11011111, 0b10111111, 0b01111111};
@@ -146,7 +149,8 @@ extern void (*tColDataCalcSMA[])(SColData *pColData, int64_t *sum, int64_t *max,
 
 // for stmt bind
 int32_t tColDataAddValueByBind(SColData *pColData, TAOS_MULTI_BIND *pBind);
-void    tColDataSortMerge(SArray *colDataArr);
+int32_t tColDataRefValueByBind(SColData *pColData, TAOS_MULTI_BIND *pBind);
+int32_t tColDataSortMerge(SArray *colDataArr);
 
 // for raw block
 int32_t tColDataAddValueByDataBlock(SColData *pColData, int8_t type, int32_t bytes, int32_t nRows, char *lengthOrbitmap,
@@ -202,6 +206,7 @@ struct SColData {
   int16_t  cid;
   int8_t   type;
   int8_t   smaOn;
+  int8_t   cflag;
   int32_t  numOfNone;   // # of none
   int32_t  numOfNull;   // # of null
   int32_t  numOfValue;  // # of vale
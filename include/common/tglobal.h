@@ -73,9 +73,15 @@ extern int32_t tsHeartbeatTimeout;
 
 // vnode
 extern int64_t tsVndCommitMaxIntervalMs;
+extern bool    tsRetentionRecompress;
+extern int32_t tsRetentionMaxWriteRate;
+extern bool    tsBlockBloomFilter;
+extern bool    tsAdaptiveCmpr;
+extern bool    tsDictCmpr;
 
 // mnode
 extern int64_t tsMndSdbWriteDelta;
+extern int32_t tsMndSdbMaxDeltaFiles;
 extern int64_t tsMndLogRetention;
 
 // monitor
@@ -99,6 +105,7 @@ extern char    *tsSvrCrashReportUri;
 // query buffer management
 extern int32_t tsQueryBufferSize;  // maximum allowed usage buffer size in MB for each data node during query processing
 extern int64_t tsQueryBufferSizeBytes;    // maximum allowed usage buffer size in byte for each data node
+extern int32_t tsQueryBufWriteThreads;    // threads writing the spilled pages of the query buffers to disk
 extern int32_t tsCacheLazyLoadThreshold;  // cost threshold for last/last_row loading cache as much as possible
 
 // query client
@@ -110,11 +117,13 @@ extern bool    tsQueryPlannerTrace;
 extern int32_t tsQueryNodeChunkSize;
 extern bool    tsQueryUseNodeAllocator;
 extern bool    tsKeepColumnName;
+extern bool    tsStmtBindZeroCopy;
 extern bool    tsEnableQueryHb;
 extern int32_t tsRedirectPeriod;
 extern int32_t tsRedirectFactor;
 extern int32_t tsRedirectMaxPeriod;
 extern int32_t tsMaxRetryWaitTime;
+extern int32_t tsMetaCacheMaxSize;
 extern bool    tsUseAdapter;
 
 // client
@@ -167,6 +176,7 @@ extern int32_t tsRpcRetryLimit;
 extern int32_t tsRpcRetryInterval;
 
 extern bool tsDisableStream;
+extern bool tsSnapPhysical;
 
 // #define NEEDTO_COMPRESSS_MSG(size) (tsCompressMsgSize != -1 && (size) > tsCompressMsgSize)
 
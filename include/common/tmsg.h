@@ -1528,6 +1528,11 @@ typedef struct SExplainExecInfo {
   uint64_t numOfRows;
   uint32_t verboseLen;
   void*    verboseInfo;
+  uint64_t numOfBlocks;
+  uint64_t inputRows;
+  uint64_t inputBlocks;
+  double   selfCost;        // elapsed time spent in this operator, excluding the downstream operators
+  uint64_t maxOutputBytes;  // max size of an output block plus the buffer reported by the operator
 } SExplainExecInfo;
 
 typedef struct {
@@ -1553,6 +1558,10 @@ typedef struct STableScanAnalyzeInfo {
   uint32_t filterOutBlocks;
   double   elapsedTime;
   double   filterTime;
+  uint64_t loadBytes;          // on-disk size of the loaded file blocks
+  uint32_t smaFilterBlocks;    // blocks dropped by the filter according to the block SMA only
+  uint32_t cacheHits;          // stt blocks served from the reader's loaded block buffers
+  uint32_t bloomFilterBlocks;  // blocks dropped by the block bloom filters of the equality conditions
 } STableScanAnalyzeInfo;
 
 int32_t tSerializeSExplainRsp(void* buf, int32_t bufLen, SExplainRsp* pRsp);
@@ -1745,6 +1754,7 @@ typedef struct {
   uint64_t queryId;
   uint64_t taskId;
   int32_t  execId;
+  int8_t   ncharUtf8;  // return nchar columns in utf-8, only for the result fetched by client
 } SResFetchReq;
 
 int32_t tSerializeSResFetchReq(void* buf, int32_t bufLen, SResFetchReq* pReq);
@@ -109,8 +109,17 @@ typedef struct SCatalogCfg {
   uint32_t maxUserCacheNum;
   uint32_t dbRentSec;
   uint32_t stbRentSec;
+  uint64_t maxCacheSize;  // bytes, 0 for no limit
 } SCatalogCfg;
 
+typedef struct SCatalogCacheStat {
+  uint64_t cacheSize;
+  uint64_t numOfTbl;
+  uint64_t numOfMetaHit;
+  uint64_t numOfMetaMiss;
+  uint64_t numOfMetaEvict;
+} SCatalogCacheStat;
+
 typedef struct SSTableVersion {
   char     dbFName[TSDB_DB_FNAME_LEN];
   char     stbName[TSDB_TABLE_NAME_LEN];
@@ -328,6 +337,8 @@ int32_t ctgdLaunchAsyncCall(SCatalog* pCtg, SRequestConnInfo* pConn, uint64_t re
 
 int32_t catalogClearCache(void);
 
+void catalogGetCacheStat(SCatalogCacheStat* pStat);
+
 SMetaData* catalogCloneMetaData(SMetaData* pData);
 
 void catalogFreeMetaData(SMetaData* pData);
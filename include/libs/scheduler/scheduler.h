@@ -78,6 +78,7 @@ typedef struct SSchedulerReq {
   void*              chkKillParam;
   SExecResult*       pExecRes;
   void**             pFetchRes;
+  bool               ncharUtf8;
 } SSchedulerReq;
 
 int32_t schedulerInit(void);
@@ -36,7 +36,12 @@ typedef struct STdbState {
   TTB*         pSessionStateDb;
   TTB*         pParNameDb;
   TTB*         pParTagDb;
+  TTB*         pCheckpointDb;
   TXN*         txn;
+  int64_t      checkpointId;   // id of the last committed checkpoint
+  int64_t      checkpointVer;  // source wal version covered by the last committed checkpoint
+  int64_t      processedVer;   // source wal version applied to the uncommitted state
+  int64_t      replayVer;      // end of the wal tail being replayed on restart, -1 if not replaying
 } STdbState;
 
 // incremental state storage
@@ -52,6 +57,12 @@ int32_t       streamStateCommit(SStreamState* pState);
 int32_t       streamStateAbort(SStreamState* pState);
 void          streamStateDestroy(SStreamState* pState);
 
+void    streamStateSetProcessedVer(SStreamState* pState, int64_t ver);
+int64_t streamStateGetCheckpointVer(SStreamState* pState);
+void    streamStateBeginReplay(SStreamState* pState, int64_t ver);
+int64_t streamStateGetReplayVer(SStreamState* pState);
+int32_t streamStateEndReplay(SStreamState* pState);
+
 typedef struct {
   TBC*    pCur;
   int64_t number;
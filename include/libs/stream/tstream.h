@@ -263,6 +263,17 @@ typedef struct {
   SUseDbRsp dbInfo;
 } STaskDispatcherShuffle;
 
+typedef struct {
+  int32_t taskId;
+  int32_t nodeId;
+  int32_t inFlight;  // dispatch reqs sent and waiting for rsp
+  int32_t credit;    // max dispatch reqs in flight, shrinks when the downstream input is blocked
+  int8_t  hold;      // the downstream input failed, send nothing until the retry timer fires
+  int64_t reqId;     // id of the last dispatch req queued
+  int64_t stage;     // sent with each req, the downstream restarts the reqId sequence when it changes
+  SArray* pending;   // SArray<SStreamDispatchEntry>, kept until the downstream accepts them
+} SStreamDispatchDest;
+
 typedef void FTbSink(SStreamTask* pTask, void* vnode, int64_t ver, void* data);
 
 typedef struct {
@@ -354,11 +365,18 @@ typedef struct SStreamTask {
   SStreamState* pState;
 
   // do not serialize
-  int32_t recoverTryingDownstream;
-  int32_t recoverWaitingUpstream;
-  int64_t checkReqId;
-  SArray* checkReqIds;  // shuffle
-  int32_t refCnt;
+  int32_t   recoverTryingDownstream;
+  int32_t   recoverWaitingUpstream;
+  int64_t   checkReqId;
+  SArray*   checkReqIds;  // shuffle
+  int32_t   refCnt;
+  SRWLatch  dispatchLock;
+  SArray*   dispatchDest;  // SArray<SStreamDispatchDest>, one per downstream task
+  SHashObj* pVgCache;      // groupId + table name -> index of the vgroup, shuffle
+  int8_t    dispatchRetry;
+  void*     dispatchTimer;
+  SRWLatch  upstreamSeqLock;
+  SHashObj* pUpstreamSeq;  // upstream task id -> SStreamUpstreamSeq, the last dispatch req taken from each
 
   int64_t checkpointingId;
   int32_t checkpointAlignCnt;
@@ -430,8 +448,17 @@ typedef struct {
   int32_t blockNum;
   SArray* dataLen;  // SArray<int32_t>
   SArray* data;     // SArray<SRetrieveTableRsp*>
+  int64_t reqId;    // echoed in the rsp, unique per upstream and downstream task
+  int64_t stage;    // starts a new reqId sequence when it changes
 } SStreamDispatchReq;
 
+typedef struct {
+  int8_t             sent;      // waiting for rsp
+  int8_t             sending;   // being encoded and sent outside the dispatch lock, the req must stay
+  int8_t             accepted;  // accepted while sending, dropped once the send returns
+  SStreamDispatchReq req;
+} SStreamDispatchEntry;
+
 typedef struct {
   int64_t streamId;
   int32_t upstreamNodeId;
@@ -439,6 +466,7 @@ typedef struct {
   int32_t downstreamNodeId;
   int32_t downstreamTaskId;
   int8_t  inputStatus;
+  int64_t reqId;
 } SStreamDispatchRsp;
 
 typedef struct {
@@ -584,7 +612,7 @@ int32_t streamSetupTrigger(SStreamTask* pTask);
 
 int32_t streamProcessRunReq(SStreamTask* pTask);
 int32_t streamProcessDispatchReq(SStreamTask* pTask, SStreamDispatchReq* pReq, SRpcMsg* pMsg, bool exec);
-int32_t streamProcessDispatchRsp(SStreamTask* pTask, SStreamDispatchRsp* pRsp, int32_t code);
+int32_t streamProcessDispatchRsp(SStreamTask* pTask, SStreamDispatchRsp* pRsp, int32_t rspLen, int32_t code);
 
 int32_t streamProcessRetrieveReq(SStreamTask* pTask, SStreamRetrieveReq* pReq, SRpcMsg* pMsg);
 int32_t streamProcessRetrieveRsp(SStreamTask* pTask, SStreamRetrieveRsp* pRsp);
@@ -606,6 +634,8 @@ int32_t streamRestoreParam(SStreamTask* pTask);
 int32_t streamSetStatusNormal(SStreamTask* pTask);
 // source level
 int32_t streamSourceRecoverPrepareStep1(SStreamTask* pTask, int64_t ver);
+int32_t streamSourceReplayPrepare(SStreamTask* pTask);
+int32_t streamSourceReplayFinish(SStreamTask* pTask);
 int32_t streamBuildSourceRecover1Req(SStreamTask* pTask, SStreamRecoverStep1Req* pReq);
 int32_t streamSourceRecoverScanStep1(SStreamTask* pTask);
 int32_t streamBuildSourceRecover2Req(SStreamTask* pTask, SStreamRecoverStep2Req* pReq);
@@ -649,7 +679,7 @@ void         streamMetaRemoveTask(SStreamMeta* pMeta, int32_t taskId);
 int32_t streamMetaBegin(SStreamMeta* pMeta);
 int32_t streamMetaCommit(SStreamMeta* pMeta);
 int32_t streamMetaRollBack(SStreamMeta* pMeta);
-int32_t streamLoadTasks(SStreamMeta* pMeta, int64_t ver);
+int32_t streamLoadTasks(SStreamMeta* pMeta, int64_t ver, int64_t replayVer);
 
 // checkpoint
 int32_t streamProcessCheckpointSourceReq(SStreamMeta* pMeta, SStreamTask* pTask, SStreamCheckpointSourceReq* pReq);
@@ -39,6 +39,10 @@ extern "C" {
 #define SNAPSHOT_MAX_CLOCK_SKEW_MS   1000 * 10
 #define SNAPSHOT_WAIT_MS             1000 * 30
 
+// capabilities a snapshot receiver announces in its reply to the prepare message
+#define SYNC_SNAPSHOT_CAP_FILE 0x1  // accepts data files shipped as they are
+#define SYNC_SNAPSHOT_CAPS     (SYNC_SNAPSHOT_CAP_FILE)
+
 #define SYNC_MAX_RETRY_BACKOFF         5
 #define SYNC_LOG_REPL_RETRY_WAIT_MS    100
 #define SYNC_APPEND_ENTRIES_TIMEOUT_MS 10000
@@ -126,6 +130,7 @@ typedef struct SReConfigCbMeta {
 typedef struct SSnapshotParam {
   SyncIndex start;
   SyncIndex end;
+  int16_t   peerCaps;  // SYNC_SNAPSHOT_CAP_*, 0 for receivers that announce nothing
 } SSnapshotParam;
 
 typedef struct SSnapshot {
@@ -42,6 +42,7 @@ extern char            tsAVXEnable;
 extern char            tsAVX2Enable;
 extern char            tsFMAEnable;
 extern char            tsTagFilterCache;
+extern char            tsTagFilterBitmap;
 
 extern char configDir[];
 extern char tsDataDir[];
@@ -25,6 +25,7 @@ extern "C" {
 typedef struct SLRUCache SLRUCache;
 
 typedef void (*_taos_lru_deleter_t)(const void *key, size_t keyLen, void *value);
+typedef void (*_taos_lru_functor_t)(const void *key, size_t keyLen, void *value, void *ud);
 
 typedef struct LRUHandle LRUHandle;
 
@@ -47,6 +48,8 @@ void       taosLRUCacheErase(SLRUCache *cache, const void *key, size_t keyLen);
 
 void taosLRUCacheEraseUnrefEntries(SLRUCache *cache);
 
+void taosLRUCacheApply(SLRUCache *cache, _taos_lru_functor_t functor, void *ud);
+
 bool taosLRUCacheRef(SLRUCache *cache, LRUHandle *handle);
 bool taosLRUCacheRelease(SLRUCache *cache, LRUHandle *handle, bool eraseIfLastRef);
 
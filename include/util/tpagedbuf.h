@@ -39,6 +39,7 @@ typedef struct SDiskbasedBufStatis {
   int32_t getPages;
   int32_t releasePages;
   int32_t flushPages;
+  int32_t budgetSpillPages;  // pages spilled since the global memory budget is used up
 } SDiskbasedBufStatis;
 
 /**
@@ -177,6 +178,31 @@ SDiskbasedBufStatis getDBufStatis(const SDiskbasedBuf* pBuf);
  */
 void dBufPrintStatis(const SDiskbasedBuf* pBuf);
 
+/**
+ * Set the upper limit of the memory occupied by the in-memory pages of all paged buffers in this process
+ * @param limit  in bytes, negative value for no limit
+ */
+void dBufSetMemLimit(int64_t limit);
+
+/**
+ * Set the number of threads writing the evicted pages of all paged buffers in this process to disk, it only takes
+ * effect before the first paged buffer is created
+ * @param num  0 for writing the pages synchronously by the query threads
+ */
+void dBufSetWriterThreads(int32_t num);
+
+/**
+ * Stop and join the writer threads, no paged buffer may be in use. The buffers created afterwards write their pages
+ * synchronously
+ */
+void dBufStopWriters();
+
+/**
+ * Return the memory occupied by the in-memory pages of all paged buffers in this process
+ * @return
+ */
+int64_t dBufGetMemUsed();
+
 /**
  * Set all of page buffer are not need
  * @param pBuf
@@ -262,6 +262,7 @@ typedef struct SSyncQueryParam {
 
 void* doAsyncFetchRows(SRequestObj* pRequest, bool setupOneRowPtr, bool convertUcs4);
 void* doFetchRows(SRequestObj* pRequest, bool setupOneRowPtr, bool convertUcs4);
+bool  fetchNcharInUtf8(bool convertUcs4);
 
 void    doSetOneRowPtr(SReqResultInfo* pResultInfo);
 void    setResPrecision(SReqResultInfo* pResInfo, int32_t precision);
@@ -281,6 +282,17 @@ void taosAsyncQueryImplWithReqid(uint64_t connId, const char* sql, __taos_async_
 
 int32_t getVersion1BlockMetaSize(const char* p, int32_t numOfCols);
 
+// the prefetch of a consumer vgroup, changed under tmq->lock
+typedef struct {
+  int32_t cnt;     // poll rsps in the queue whose next poll has been sent already
+  int8_t  failed;  // the poll sent for the last of them failed
+} SMqPrefetchState;
+
+// a prefetch poll failed, returns true if no rsp that sent it is queued and the vgroup is idle now
+bool tmqPrefetchPollFailed(SMqPrefetchState* pState);
+// a prefetched rsp is consumed, returns true if the poll it sent failed and the vgroup is idle now
+bool tmqPrefetchedRspConsumed(SMqPrefetchState* pState);
+
 static FORCE_INLINE SReqResultInfo* tmqGetCurResInfo(TAOS_RES* res) {
   SMqRspObj* msg = (SMqRspObj*)res;
   return (SReqResultInfo*)&msg->resInfo;
@@ -560,7 +560,8 @@ void taos_init_imp(void) {
 
   rpcInit();
 
-  SCatalogCfg cfg = {.maxDBCacheNum = 100, .maxTblCacheNum = 100};
+  SCatalogCfg cfg = {
+      .maxDBCacheNum = 100, .maxTblCacheNum = 100, .maxCacheSize = (uint64_t)tsMetaCacheMaxSize * 1024 * 1024};
   catalogInit(&cfg);
 
   schedulerInit();
@@ -1537,6 +1537,7 @@ void* doFetchRows(SRequestObj* pRequest, bool setupOneRowPtr, bool convertUcs4)
     SSchedulerReq   req = {
           .syncReq = true,
           .pFetchRes = (void**)&pResInfo->pData,
+          .ncharUtf8 = fetchNcharInUtf8(convertUcs4),
     };
     pRequest->code = schedulerFetchRows(pRequest->body.queryJob, &req);
     if (pRequest->code != TSDB_CODE_SUCCESS) {
@@ -1571,6 +1572,11 @@ void* doFetchRows(SRequestObj* pRequest, bool setupOneRowPtr, bool convertUcs4)
   return pResultInfo->row;
 }
 
+// let the server encode nchar columns in utf-8 when that is exactly what the conversion would produce locally
+bool fetchNcharInUtf8(bool convertUcs4) {
+  return convertUcs4 && (strcasecmp(tsCharset, "UTF-8") == 0 || strcasecmp(tsCharset, "UTF8") == 0);
+}
+
 static void syncFetchFn(void* param, TAOS_RES* res, int32_t numOfRows) {
   SSyncQueryParam* pParam = param;
   tsem_post(&pParam->sem);
@@ -1952,7 +1958,7 @@ int32_t setResultDataPtr(SReqResultInfo* pResultInfo, TAOS_FIELD* pFields, int32
     pStart += colLength[i];
   }
 
-  if (convertUcs4) {
+  if (convertUcs4 && !(hasColumnSeg & BLOCK_FLAG_NCHAR_UTF8)) {
     code = doConvertUCS4(pResultInfo, numOfRows, numOfCols, colLength);
   }
 
@@ -24,6 +24,7 @@
 #include "tdatablock.h"
 #include "tglobal.h"
 #include "tmsg.h"
+#include "tpagedbuf.h"
 #include "tref.h"
 #include "trpc.h"
 #include "version.h"
@@ -78,6 +79,7 @@ void taos_cleanup(void) {
   tscDebug("rpc cleanup");
 
   cleanupTaskQueue();
+  dBufStopWriters();
 
   taosConvDestroy();
 
@@ -1086,6 +1088,7 @@ void taos_fetch_rows_a(TAOS_RES *res, __taos_async_fn_t fp, void *param) {
       .syncReq = false,
       .fetchFp = fetchCallback,
       .cbParam = pRequest,
+      .ncharUtf8 = fetchNcharInUtf8(pResultInfo->convertUcs4),
   };
 
   schedulerFetchRows(pRequest->body.queryJob, &req);
@@ -26,6 +26,8 @@
 
 #define EMPTY_BLOCK_POLL_IDLE_DURATION  100
 #define DEFAULT_AUTO_COMMIT_INTERVAL    5000
+#define DEFAULT_PREFETCH_NUM            1
+#define MAX_PREFETCH_NUM                16
 
 struct SMqMgmt {
   int8_t  inited;
@@ -63,6 +65,7 @@ struct tmq_conf_t {
   bool           hbBgEnable;
   uint16_t       port;
   int32_t        autoCommitInterval;
+  int32_t        prefetchNum;
   char*          ip;
   char*          user;
   char*          pass;
@@ -79,6 +82,8 @@ struct tmq_t {
   int8_t         autoCommit;
   int32_t        autoCommitInterval;
   int32_t        resetOffsetCfg;
+  int32_t        prefetchNum;  // poll rsp received ahead of the application per vgroup
+  int64_t        pollTimeout;  // timeout of the last poll, used by the prefetch poll
   uint64_t       consumerId;
   bool           hbBgEnable;
   tmq_commit_cb* commitCb;
@@ -135,6 +140,7 @@ typedef struct {
   int32_t      vgId;
   int32_t      vgStatus;
   int32_t      vgSkipCnt;
+  SMqPrefetchState prefetch;
   int64_t      emptyBlockReceiveTs; // once empty block is received, idle for ignoreCnt then start to poll data
   SEpSet       epSet;
 } SMqClientVg;
@@ -153,6 +159,7 @@ typedef struct {
   SMqClientTopic* topicHandle;
   uint64_t        reqId;
   SEpSet*         pEpset;
+  int8_t          prefetched;  // the next poll of this vgroup is sent when this rsp is received
   union {
     SMqDataRsp dataRsp;
     SMqMetaRsp metaRsp;
@@ -227,6 +234,7 @@ tmq_conf_t* tmq_conf_new() {
   conf->autoCommitInterval = DEFAULT_AUTO_COMMIT_INTERVAL;
   conf->resetOffset = TMQ_OFFSET__RESET_EARLIEAST;
   conf->hbBgEnable = true;
+  conf->prefetchNum = DEFAULT_PREFETCH_NUM;
 
   return conf;
 }
@@ -318,6 +326,15 @@ tmq_conf_res_t tmq_conf_set(tmq_conf_t* conf, const char* key, const char* value
     return TMQ_CONF_OK;
   }
 
+  if (strcasecmp(key, "msg.prefetch.num") == 0) {
+    int64_t num = taosStr2int64(value);
+    if (num < 0 || num > MAX_PREFETCH_NUM) {
+      return TMQ_CONF_INVALID;
+    }
+    conf->prefetchNum = (int32_t)num;
+    return TMQ_CONF_OK;
+  }
+
   if (strcasecmp(key, "enable.heartbeat.background") == 0) {
     if (strcasecmp(value, "true") == 0) {
       conf->hbBgEnable = true;
@@ -1068,6 +1085,7 @@ tmq_t* tmq_consumer_new(tmq_conf_t* conf, char* errstr, int32_t errstrLen) {
   pTmq->commitCb = conf->commitCb;
   pTmq->commitCbUserParam = conf->commitCbUserParam;
   pTmq->resetOffsetCfg = conf->resetOffset;
+  pTmq->prefetchNum = conf->prefetchNum;
 
   pTmq->hbBgEnable = conf->hbBgEnable;
 
@@ -1243,6 +1261,43 @@ void tmq_conf_set_auto_commit_cb(tmq_conf_t* conf, tmq_commit_cb* cb, void* para
   conf->commitCbUserParam = param;
 }
 
+static int32_t doTmqPollImpl(tmq_t* pTmq, SMqClientTopic* pTopic, SMqClientVg* pVg, int64_t timeout,
+                             const STqOffsetVal* pOffset);
+
+bool tmqPrefetchPollFailed(SMqPrefetchState* pState) {
+  if (atomic_load_32(&pState->cnt) > 0) {
+    pState->failed = 1;
+    return false;
+  }
+  return true;
+}
+
+bool tmqPrefetchedRspConsumed(SMqPrefetchState* pState) {
+  if (atomic_sub_fetch_32(&pState->cnt, 1) == 0 && pState->failed) {
+    pState->failed = 0;
+    return true;
+  }
+  return false;
+}
+
+// send the next poll of the vgroup, tmq->lock is held by the caller
+static int32_t tmqPrefetch(tmq_t* tmq, SMqClientTopic* pTopic, SMqClientVg* pVg, int32_t epoch,
+                           const STqOffsetVal* pOffset) {
+  // the vgroups of an earlier epoch have been released
+  if (atomic_load_32(&tmq->epoch) != epoch) {
+    return -1;
+  }
+
+  tscDebug("consumer:0x%" PRIx64 " prefetch from vgId:%d, prefetched:%d", tmq->consumerId, pVg->vgId,
+           atomic_load_32(&pVg->prefetch.cnt));
+  if (doTmqPollImpl(tmq, pTopic, pVg, atomic_load_64(&tmq->pollTimeout), pOffset) != TSDB_CODE_SUCCESS) {
+    tscWarn("consumer:0x%" PRIx64 " failed to prefetch from vgId:%d", tmq->consumerId, pVg->vgId);
+    return -1;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t tmqPollCb(void* param, SDataBuf* pMsg, int32_t code) {
   SMqPollCbParam* pParam = (SMqPollCbParam*)param;
 
@@ -1287,7 +1342,9 @@ int32_t tmqPollCb(void* param, SDataBuf* pMsg, int32_t code) {
       }
 
       pRspWrapper->tmqRspType = TMQ_MSG_TYPE__END_RSP;
+      taosThreadMutexLock(&tmq->lock);
       taosWriteQitem(tmq->mqueue, pRspWrapper);
+      taosThreadMutexUnlock(&tmq->lock);
     }
 
     goto CREATE_MSG_FAIL;
@@ -1359,7 +1416,22 @@ int32_t tmqPollCb(void* param, SDataBuf* pMsg, int32_t code) {
   }
 
   taosMemoryFree(pMsg->pData);
+
+  // keep the vgroup busy with the next poll while the application consumes this one. The rsp is marked prefetched only
+  // once the poll is sent, and the poll rsps are queued under tmq->lock, so the rsp of the next poll is behind this one.
+  taosThreadMutexLock(&tmq->lock);
+  if (rspType == TMQ_MSG_TYPE__POLL_RSP && pRspWrapper->dataRsp.blockNum > 0 && msgEpoch == tmqEpoch &&
+      tmq->prefetchNum > 0) {
+    if (atomic_add_fetch_32(&pVg->prefetch.cnt, 1) <= tmq->prefetchNum &&
+        tmqPrefetch(tmq, pTopic, pVg, epoch, &pRspWrapper->dataRsp.rspOffset) == TSDB_CODE_SUCCESS) {
+      pRspWrapper->prefetched = 1;
+    } else {
+      atomic_sub_fetch_32(&pVg->prefetch.cnt, 1);
+    }
+  }
+
   taosWriteQitem(tmq->mqueue, pRspWrapper);
+  taosThreadMutexUnlock(&tmq->lock);
 
   tscDebug("consumer:0x%" PRIx64 " put poll res into mqueue, type:%d, vgId:%d, total in queue:%d, reqId:0x%" PRIx64,
            tmq->consumerId, rspType, vgId, tmq->mqueue->numOfItems, requestId);
@@ -1371,7 +1443,13 @@ int32_t tmqPollCb(void* param, SDataBuf* pMsg, int32_t code) {
 
 CREATE_MSG_FAIL:
   if (epoch == tmq->epoch) {
-    atomic_store_32(&pVg->vgStatus, TMQ_VG_STATUS__IDLE);
+    // a prefetch poll failed while the rsp that sent it is still queued, the poll from its offset is sent once it is
+    // consumed. Polling from the current offset now would deliver the queued data again.
+    taosThreadMutexLock(&tmq->lock);
+    if (tmqPrefetchPollFailed(&pVg->prefetch)) {
+      atomic_store_32(&pVg->vgStatus, TMQ_VG_STATUS__IDLE);
+    }
+    taosThreadMutexUnlock(&tmq->lock);
   }
 
   tsem_post(&tmq->rspSem);
@@ -1496,11 +1574,12 @@ static bool tmqUpdateEp(tmq_t* tmq, int32_t epoch, const SMqAskEpRsp* pRsp) {
   }
 
   tmq->clientTopics = newTopics;
+  // the vgroups of the last epoch are released, prefetch checks the epoch under the lock
+  atomic_store_32(&tmq->epoch, epoch);
   taosThreadMutexUnlock(&tmq->lock);
 
   int8_t flag = (topicNumGet == 0)? TMQ_CONSUMER_STATUS__NO_TOPIC:TMQ_CONSUMER_STATUS__READY;
   atomic_store_8(&tmq->status, flag);
-  atomic_store_32(&tmq->epoch, epoch);
 
   tscDebug("consumer:0x%" PRIx64 " update topic info completed", tmq->consumerId);
   return set;
@@ -1588,7 +1667,8 @@ END:
   return code;
 }
 
-void tmqBuildConsumeReqImpl(SMqPollReq* pReq, tmq_t* tmq, int64_t timeout, SMqClientTopic* pTopic, SMqClientVg* pVg) {
+void tmqBuildConsumeReqImpl(SMqPollReq* pReq, tmq_t* tmq, int64_t timeout, SMqClientTopic* pTopic, SMqClientVg* pVg,
+                            const STqOffsetVal* pOffset) {
   int32_t groupLen = strlen(tmq->groupId);
   memcpy(pReq->subKey, tmq->groupId, groupLen);
   pReq->subKey[groupLen] = TMQ_SEPARATOR;
@@ -1599,7 +1679,7 @@ void tmqBuildConsumeReqImpl(SMqPollReq* pReq, tmq_t* tmq, int64_t timeout, SMqCl
   pReq->timeout = timeout;
   pReq->epoch = tmq->epoch;
   /*pReq->currentOffset = reqOffset;*/
-  pReq->reqOffset = pVg->currentOffset;
+  pReq->reqOffset = *pOffset;
   pReq->head.vgId = pVg->vgId;
   pReq->useSnapshot = tmq->useSnapshot;
   pReq->reqId = generateRequestId();
@@ -1670,29 +1750,31 @@ static int32_t handleErrorBeforePoll(SMqClientVg* pVg, tmq_t* pTmq) {
   return -1;
 }
 
-static int32_t doTmqPollImpl(tmq_t* pTmq, SMqClientTopic* pTopic, SMqClientVg* pVg, int64_t timeout) {
+// the vgroup status is left to the caller if the poll is not sent
+static int32_t doTmqPollImpl(tmq_t* pTmq, SMqClientTopic* pTopic, SMqClientVg* pVg, int64_t timeout,
+                             const STqOffsetVal* pOffset) {
   SMqPollReq req = {0};
-  tmqBuildConsumeReqImpl(&req, pTmq, timeout, pTopic, pVg);
+  tmqBuildConsumeReqImpl(&req, pTmq, timeout, pTopic, pVg, pOffset);
 
   int32_t msgSize = tSerializeSMqPollReq(NULL, 0, &req);
   if (msgSize < 0) {
-    return handleErrorBeforePoll(pVg, pTmq);
+    return -1;
   }
 
   char* msg = taosMemoryCalloc(1, msgSize);
   if (NULL == msg) {
-    return handleErrorBeforePoll(pVg, pTmq);
+    return -1;
   }
 
   if (tSerializeSMqPollReq(msg, msgSize, &req) < 0) {
     taosMemoryFree(msg);
-    return handleErrorBeforePoll(pVg, pTmq);
+    return -1;
   }
 
   SMqPollCbParam* pParam = taosMemoryMalloc(sizeof(SMqPollCbParam));
   if (pParam == NULL) {
     taosMemoryFree(msg);
-    return handleErrorBeforePoll(pVg, pTmq);
+    return -1;
   }
 
   pParam->refId = pTmq->refId;
@@ -1706,7 +1788,7 @@ static int32_t doTmqPollImpl(tmq_t* pTmq, SMqClientTopic* pTopic, SMqClientVg* p
   if (sendInfo == NULL) {
     taosMemoryFree(pParam);
     taosMemoryFree(msg);
-    return handleErrorBeforePoll(pVg, pTmq);
+    return -1;
   }
 
   sendInfo->msgInfo = (SDataBuf){
@@ -1723,7 +1805,7 @@ static int32_t doTmqPollImpl(tmq_t* pTmq, SMqClientTopic* pTopic, SMqClientVg* p
 
   int64_t transporterId = 0;
   char    offsetFormatBuf[80];
-  tFormatOffset(offsetFormatBuf, tListLen(offsetFormatBuf), &pVg->currentOffset);
+  tFormatOffset(offsetFormatBuf, tListLen(offsetFormatBuf), pOffset);
 
   tscDebug("consumer:0x%" PRIx64 " send poll to %s vgId:%d, epoch %d, req:%s, reqId:0x%" PRIx64,
            pTmq->consumerId, pTopic->topicName, pVg->vgId, pTmq->epoch, offsetFormatBuf, req.reqId);
@@ -1738,6 +1820,7 @@ static int32_t doTmqPollImpl(tmq_t* pTmq, SMqClientTopic* pTopic, SMqClientVg* p
 // broadcast the poll request to all related vnodes
 static int32_t tmqPollImpl(tmq_t* tmq, int64_t timeout) {
   int32_t numOfTopics = taosArrayGetSize(tmq->clientTopics);
+  atomic_store_64(&tmq->pollTimeout, timeout);
   tscDebug("consumer:0x%" PRIx64 " start to poll data, numOfTopics:%d", tmq->consumerId, numOfTopics);
 
   for (int i = 0; i < numOfTopics; i++) {
@@ -1768,9 +1851,9 @@ static int32_t tmqPollImpl(tmq_t* tmq, int64_t timeout) {
       }
 
       atomic_store_32(&pVg->vgSkipCnt, 0);
-      int32_t code = doTmqPollImpl(tmq, pTopic, pVg, timeout);
+      int32_t code = doTmqPollImpl(tmq, pTopic, pVg, timeout, &pVg->currentOffset);
       if (code != TSDB_CODE_SUCCESS) {
-        return code;
+        return handleErrorBeforePoll(pVg, tmq);
       }
     }
   }
@@ -1842,7 +1925,16 @@ static void* tmqHandleAllRsp(tmq_t* tmq, int64_t timeout, bool pollIfReset) {
         }
 
         pVg->currentOffset = pDataRsp->rspOffset;
-        atomic_store_32(&pVg->vgStatus, TMQ_VG_STATUS__IDLE);
+        if (pollRspWrapper->prefetched) {
+          // the next poll is in flight already, unless it failed after the last prefetched rsp was queued
+          taosThreadMutexLock(&tmq->lock);
+          if (tmqPrefetchedRspConsumed(&pVg->prefetch)) {
+            atomic_store_32(&pVg->vgStatus, TMQ_VG_STATUS__IDLE);
+          }
+          taosThreadMutexUnlock(&tmq->lock);
+        } else {
+          atomic_store_32(&pVg->vgStatus, TMQ_VG_STATUS__IDLE);
+        }
 
         char buf[80];
         tFormatOffset(buf, 80, &pDataRsp->rspOffset);
@@ -1867,6 +1959,9 @@ static void* tmqHandleAllRsp(tmq_t* tmq, int64_t timeout, bool pollIfReset) {
         SMqClientVg* pVg = pollRspWrapper->vgHandle;
         tscDebug("consumer:0x%" PRIx64 " vgId:%d msg discard since epoch mismatch: msg epoch %d, consumer epoch %d",
                  tmq->consumerId, pVg->vgId, pDataRsp->head.epoch, consumerEpoch);
+        if (pollRspWrapper->prefetched) {
+          atomic_sub_fetch_32(&pVg->prefetch.cnt, 1);
+        }
         pRspWrapper = tmqFreeRspWrapper(pRspWrapper);
         taosFreeQitem(pollRspWrapper);
       }
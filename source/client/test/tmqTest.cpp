@@ -18,6 +18,7 @@
 #include <taoserror.h>
 #include <tglobal.h>
 #include <iostream>
+#include <string>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wwrite-strings"
@@ -87,6 +88,93 @@ TEST(testCase, create_topic_stb_Test) {
   taos_close(pConn);
 }
 
+static void execQuery(TAOS* pConn, const char* sql) {
+  TAOS_RES* pRes = taos_query(pConn, sql);
+  ASSERT_EQ(taos_errno(pRes), 0) << sql << ": " << taos_errstr(pRes);
+  taos_free_result(pRes);
+}
+
+// the next poll of a vgroup is sent before the rsp in hand is consumed, the rows still arrive in the order written
+TEST(testCase, tmq_prefetch_order_Test) {
+  const int32_t numOfBatches = 200;
+  const int32_t batchRows = 50;
+
+  TAOS* pConn = taos_connect("localhost", "root", "taosdata", NULL, 0);
+  ASSERT_NE(pConn, nullptr);
+
+  execQuery(pConn, "drop topic if exists prefetch_topic");
+  execQuery(pConn, "drop database if exists prefetch_db");
+  execQuery(pConn, "create database prefetch_db vgroups 1 wal_retention_period 3600");
+  execQuery(pConn, "create table prefetch_db.t1 (ts timestamp, c1 int)");
+  for (int32_t i = 0; i < numOfBatches; i++) {
+    std::string sql = "insert into prefetch_db.t1 values";
+    for (int32_t j = 0; j < batchRows; j++) {
+      int32_t n = i * batchRows + j;
+      sql += " (" + std::to_string(1648791213000LL + n) + "," + std::to_string(n) + ")";
+    }
+    execQuery(pConn, sql.c_str());
+  }
+  execQuery(pConn, "create topic prefetch_topic as select ts, c1 from prefetch_db.t1");
+
+  tmq_conf_t* conf = tmq_conf_new();
+  tmq_conf_set(conf, "group.id", "prefetch_group");
+  tmq_conf_set(conf, "td.connect.user", "root");
+  tmq_conf_set(conf, "td.connect.pass", "taosdata");
+  tmq_conf_set(conf, "auto.offset.reset", "earliest");
+  tmq_conf_set(conf, "msg.prefetch.num", "4");
+  tmq_t* tmq = tmq_consumer_new(conf, NULL, 0);
+  tmq_conf_destroy(conf);
+  ASSERT_NE(tmq, nullptr);
+
+  tmq_list_t* topicList = tmq_list_new();
+  tmq_list_append(topicList, "prefetch_topic");
+  ASSERT_EQ(tmq_subscribe(tmq, topicList), 0);
+  tmq_list_destroy(topicList);
+
+  int64_t total = 0;
+  int32_t emptyPolls = 0;
+  while (total < numOfBatches * batchRows && emptyPolls < 10) {
+    TAOS_RES* pRes = tmq_consumer_poll(tmq, 1000);
+    if (pRes == NULL) {
+      emptyPolls++;
+      continue;
+    }
+
+    TAOS_ROW row;
+    while ((row = taos_fetch_row(pRes)) != NULL) {
+      ASSERT_EQ(*(int64_t*)row[0], 1648791213000LL + total);
+      ASSERT_EQ(*(int32_t*)row[1], total);
+      total++;
+    }
+    taos_free_result(pRes);
+  }
+  EXPECT_EQ(total, numOfBatches * batchRows);
+
+  tmq_consumer_close(tmq);
+  execQuery(pConn, "drop topic prefetch_topic");
+  taos_close(pConn);
+}
+
+// the vgroup stays busy while a prefetched rsp is queued, and goes idle once the last of them is consumed
+TEST(testCase, tmq_prefetch_poll_fail_Test) {
+  SMqPrefetchState state = {0};
+
+  state.cnt = 2;
+  EXPECT_FALSE(tmqPrefetchPollFailed(&state));
+  EXPECT_FALSE(tmqPrefetchedRspConsumed(&state));
+  EXPECT_TRUE(tmqPrefetchedRspConsumed(&state));
+  EXPECT_EQ(state.cnt, 0);
+  EXPECT_EQ(state.failed, 0);
+
+  // consuming a prefetched rsp whose poll succeeded leaves the vgroup busy
+  state.cnt = 1;
+  EXPECT_FALSE(tmqPrefetchedRspConsumed(&state));
+
+  // no rsp is queued, the vgroup is idle at once
+  EXPECT_TRUE(tmqPrefetchPollFailed(&state));
+  EXPECT_EQ(state.failed, 0);
+}
+
 #if 0
 TEST(testCase, tmq_subscribe_ctb_Test) {
   TAOS* pConn = taos_connect("localhost", "root", "taosdata", NULL, 0);
@@ -2538,6 +2538,103 @@ int32_t blockEncode(const SSDataBlock* pBlock, char* data, int32_t numOfCols) {
   return dataLen;
 }
 
+/*
+ * Convert the nchar columns of a block built by blockEncode from ucs4 to utf-8 in place and compact the block, so that
+ * the client can use them without conversion. The block is left unchanged if any nchar column shares value buffers
+ * between rows, since the utf-8 result might not fit in place then.
+ */
+int32_t blockEncodeNcharToUtf8(char* data, int32_t* pDataLen) {
+  int32_t* actualLen = (int32_t*)(data + sizeof(int32_t));
+  int32_t  rows = *(int32_t*)(data + sizeof(int32_t) * 2);
+  int32_t  numOfCols = *(int32_t*)(data + sizeof(int32_t) * 3);
+  int32_t* flagSegment = (int32_t*)(data + sizeof(int32_t) * 4);
+  char*    pSchema = data + sizeof(int32_t) * 5 + sizeof(uint64_t);
+  int32_t* colSizes = (int32_t*)(pSchema + numOfCols * (sizeof(int8_t) + sizeof(int32_t)));
+  char*    pStart = (char*)(colSizes + numOfCols);
+  char*    pDst = pStart;
+  char*    pBuf = NULL;
+  int32_t  bufLen = 0;
+  bool     hasNchar = false;
+
+  // check first, nothing may be touched if the conversion cannot be done in place
+  char* p = pStart;
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    int8_t  type = *(int8_t*)(pSchema + i * (sizeof(int8_t) + sizeof(int32_t)));
+    int32_t colSize = htonl(colSizes[i]);
+    int32_t metaSize = IS_VAR_DATA_TYPE(type) ? rows * sizeof(int32_t) : BitmapLen(rows);
+
+    if (type == TSDB_DATA_TYPE_NCHAR) {
+      int32_t* offset = (int32_t*)p;
+      int64_t  total = 0;
+      for (int32_t j = 0; j < rows; ++j) {
+        if (offset[j] != -1) {
+          total += varDataTLen(p + metaSize + offset[j]);
+        }
+      }
+      if (total > colSize) {
+        return TSDB_CODE_SUCCESS;
+      }
+
+      hasNchar = true;
+      bufLen = TMAX(bufLen, colSize);
+    }
+
+    p += metaSize + colSize;
+  }
+
+  if (!hasNchar) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  pBuf = taosMemoryMalloc(bufLen);
+  if (NULL == pBuf) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    int8_t  type = *(int8_t*)(pSchema + i * (sizeof(int8_t) + sizeof(int32_t)));
+    int32_t colSize = htonl(colSizes[i]);
+    int32_t metaSize = IS_VAR_DATA_TYPE(type) ? rows * sizeof(int32_t) : BitmapLen(rows);
+
+    if (type != TSDB_DATA_TYPE_NCHAR) {
+      memmove(pDst, pStart, metaSize + colSize);
+      pDst += metaSize + colSize;
+      pStart += metaSize + colSize;
+      continue;
+    }
+
+    int32_t* offset = (int32_t*)pStart;
+    char*    pData = pStart + metaSize;
+    int32_t  len = 0;
+    for (int32_t j = 0; j < rows; ++j) {
+      if (offset[j] == -1) {
+        continue;
+      }
+
+      char*   pVal = pData + offset[j];
+      int32_t n = taosUcs4ToUtf8((TdUcs4*)varDataVal(pVal), varDataLen(pVal), varDataVal(pBuf + len));
+      varDataSetLen(pBuf + len, n);
+      offset[j] = len;
+      len += VARSTR_HEADER_SIZE + n;
+    }
+
+    memmove(pDst, pStart, metaSize);
+    memcpy(pDst + metaSize, pBuf, len);
+    colSizes[i] = htonl(len);
+
+    pDst += metaSize + len;
+    pStart += metaSize + colSize;
+  }
+
+  taosMemoryFree(pBuf);
+
+  *actualLen -= (int32_t)(pStart - pDst);
+  *flagSegment |= BLOCK_FLAG_NCHAR_UTF8;
+  *pDataLen = *actualLen;
+
+  return TSDB_CODE_SUCCESS;
+}
+
 const char* blockDecode(SSDataBlock* pBlock, const char* pData) {
   const char* pStart = pData;
 
@@ -1557,7 +1557,9 @@ void tColDataDestroy(void *ph) {
 
   tFree(pColData->pBitMap);
   tFree(pColData->aOffset);
-  tFree(pColData->pData);
+  if (!(pColData->cflag & COL_DATA_REF_BUF)) {
+    tFree(pColData->pData);
+  }
 }
 
 void tColDataInit(SColData *pColData, int16_t cid, int8_t type, int8_t smaOn) {
@@ -1568,6 +1570,10 @@ void tColDataInit(SColData *pColData, int16_t cid, int8_t type, int8_t smaOn) {
 }
 
 void tColDataClear(SColData *pColData) {
+  if (pColData->cflag & COL_DATA_REF_BUF) {
+    pColData->pData = NULL;
+    pColData->cflag &= ~COL_DATA_REF_BUF;
+  }
   pColData->numOfNone = 0;
   pColData->numOfNull = 0;
   pColData->numOfValue = 0;
@@ -1580,10 +1586,34 @@ void tColDataDeepClear(SColData *pColData) {
   pColData->pBitMap = NULL;
   pColData->aOffset = NULL;
   pColData->pData = NULL;
+  pColData->cflag &= ~COL_DATA_REF_BUF;
 
   tColDataClear(pColData);
 }
 
+// copy a referenced caller buffer into an owned one before the column is modified in place
+static int32_t tColDataUnRef(SColData *pColData) {
+  int32_t code = 0;
+
+  if (!(pColData->cflag & COL_DATA_REF_BUF)) return code;
+
+  uint8_t *pRef = pColData->pData;
+  pColData->pData = NULL;
+  pColData->cflag &= ~COL_DATA_REF_BUF;
+
+  if (pColData->nData) {
+    code = tRealloc(&pColData->pData, pColData->nData);
+    if (code) {
+      pColData->pData = pRef;
+      pColData->cflag |= COL_DATA_REF_BUF;
+      return code;
+    }
+    memcpy(pColData->pData, pRef, pColData->nData);
+  }
+
+  return code;
+}
+
 static FORCE_INLINE int32_t tColDataPutValue(SColData *pColData, uint8_t *pData, uint32_t nData) {
   int32_t code = 0;
 
@@ -1949,6 +1979,10 @@ static int32_t (*tColDataAppendValueImpl[8][3])(SColData *pColData, uint8_t *pDa
 };
 int32_t tColDataAppendValue(SColData *pColData, SColVal *pColVal) {
   ASSERT(pColData->cid == pColVal->cid && pColData->type == pColVal->type);
+  if (pColData->cflag & COL_DATA_REF_BUF) {
+    int32_t code = tColDataUnRef(pColData);
+    if (code) return code;
+  }
   return tColDataAppendValueImpl[pColData->flag][pColVal->flag](
       pColData, IS_VAR_DATA_TYPE(pColData->type) ? pColVal->value.pData : (uint8_t *)&pColVal->value.val,
       pColVal->value.nData);
@@ -2260,6 +2294,11 @@ int32_t tColDataUpdateValue(SColData *pColData, SColVal *pColVal, bool forward)
 
   if (tColDataUpdateValueImpl[pColData->flag][pColVal->flag] == NULL) return 0;
 
+  if (pColData->cflag & COL_DATA_REF_BUF) {
+    int32_t code = tColDataUnRef(pColData);
+    if (code) return code;
+  }
+
   return tColDataUpdateValueImpl[pColData->flag][pColVal->flag](
       pColData, IS_VAR_DATA_TYPE(pColData->type) ? pColVal->value.pData : (uint8_t *)&pColVal->value.val,
       pColVal->value.nData, forward);
@@ -2438,7 +2477,8 @@ _exit:
 
 int32_t tColDataAddValueByDataBlock(SColData *pColData, int8_t type, int32_t bytes, int32_t nRows, char *lengthOrbitmap,
                                     char *data) {
-  int32_t code = 0;
+  int32_t code = tColDataUnRef(pColData);
+  if (code) goto _exit;
 
   if (IS_VAR_DATA_TYPE(type)) {  // var-length data type
     for (int32_t i = 0; i < nRows; ++i) {
@@ -2494,6 +2534,9 @@ int32_t tColDataAddValueByBind(SColData *pColData, TAOS_MULTI_BIND *pBind) {
 
   ASSERT(pColData->type == pBind->buffer_type);
 
+  code = tColDataUnRef(pColData);
+  if (code) goto _exit;
+
   if (IS_VAR_DATA_TYPE(pBind->buffer_type)) {  // var-length data type
     for (int32_t i = 0; i < pBind->num; ++i) {
       if (pBind->is_null && pBind->is_null[i]) {
@@ -2545,6 +2588,43 @@ _exit:
   return code;
 }
 
+/*
+ * Reference the bound buffer instead of copying it, so that the submit message is encoded straight from the caller's
+ * memory. Only a first bind of a fixed-length column without null values and with a packed buffer qualifies, the
+ * others fall back to tColDataAddValueByBind. The caller must keep the buffer unchanged until the data is encoded,
+ * which for stmt is at execute time: an appended batch copies the referenced values, so they must still be the bound
+ * ones then.
+ */
+int32_t tColDataRefValueByBind(SColData *pColData, TAOS_MULTI_BIND *pBind) {
+  ASSERT(pColData->type == pBind->buffer_type);
+
+  if (IS_VAR_DATA_TYPE(pBind->buffer_type) || pColData->nVal > 0 || pBind->num <= 0 ||
+      pBind->buffer_length != TYPE_BYTES[pColData->type]) {
+    return tColDataAddValueByBind(pColData, pBind);
+  }
+
+  if (pBind->is_null) {
+    for (int32_t i = 0; i < pBind->num; ++i) {
+      if (pBind->is_null[i]) {
+        return tColDataAddValueByBind(pColData, pBind);
+      }
+    }
+  }
+
+  if (!(pColData->cflag & COL_DATA_REF_BUF)) {
+    tFree(pColData->pData);
+  }
+
+  pColData->cflag |= COL_DATA_REF_BUF;
+  pColData->pData = (uint8_t *)pBind->buffer;
+  pColData->nData = TYPE_BYTES[pColData->type] * pBind->num;
+  pColData->nVal = pBind->num;
+  pColData->numOfValue = pBind->num;
+  pColData->flag = HAS_VALUE;
+
+  return TSDB_CODE_SUCCESS;
+}
+
 static int32_t tColDataSwapValue(SColData *pColData, int32_t i, int32_t j) {
   int32_t code = 0;
 
@@ -3014,7 +3094,8 @@ static void tColDataMerge(SColData *aColData, int32_t nColData) {
     iStart++;
   }
 }
-void tColDataSortMerge(SArray *colDataArr) {
+int32_t tColDataSortMerge(SArray *colDataArr) {
+  int32_t   code = 0;
   int32_t   nColData = TARRAY_SIZE(colDataArr);
   SColData *aColData = (SColData *)TARRAY_DATA(colDataArr);
 
@@ -3039,6 +3120,15 @@ void tColDataSortMerge(SArray *colDataArr) {
     }
   }
 
+  // sort and merge work in place, never on referenced buffers
+  if (doSort || doMerge) {
+    for (int32_t iColData = 0; iColData < nColData; ++iColData) {
+      code = tColDataUnRef(&aColData[iColData]);
+      if (code) goto _exit;
+    }
+    aKey = (TSKEY *)aColData[0].pData;
+  }
+
   // sort -------
   if (doSort) {
     tColDataSort(aColData, nColData);
@@ -3059,7 +3149,7 @@ void tColDataSortMerge(SArray *colDataArr) {
   }
 
 _exit:
-  return;
+  return code;
 }
 
 int32_t tPutColData(uint8_t *pBuf, SColData *pColData) {
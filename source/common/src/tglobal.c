@@ -19,6 +19,7 @@
 #include "tgrant.h"
 #include "tlog.h"
 #include "tmisce.h"
+#include "tpagedbuf.h"
 
 GRANT_CFG_DECLARE;
 
@@ -64,9 +65,15 @@ int32_t tsHeartbeatTimeout = 20 * 1000;
 
 // vnode
 int64_t tsVndCommitMaxIntervalMs = 600 * 1000;
+bool    tsRetentionRecompress = true;
+int32_t tsRetentionMaxWriteRate = 64;  // MB/s, 0 means no limit
+bool    tsBlockBloomFilter = false;
+bool    tsAdaptiveCmpr = false;
+bool    tsDictCmpr = false;
 
 // mnode
 int64_t tsMndSdbWriteDelta = 200;
+int32_t tsMndSdbMaxDeltaFiles = 16;
 int64_t tsMndLogRetention = 2000;
 
 // monitor
@@ -106,10 +113,13 @@ bool    tsQueryPlannerTrace = false;
 int32_t tsQueryNodeChunkSize = 32 * 1024;
 bool    tsQueryUseNodeAllocator = true;
 bool    tsKeepColumnName = false;
+bool    tsStmtBindZeroCopy = false;  // bound fixed-length columns are encoded from the caller's buffers at execute time,
+                                     // which the caller keeps unchanged for every batch until the execute returns
 int32_t tsRedirectPeriod = 10;
 int32_t tsRedirectFactor = 2;
 int32_t tsRedirectMaxPeriod = 1000;
 int32_t tsMaxRetryWaitTime = 10000;
+int32_t tsMetaCacheMaxSize = 0;  // MB, table metas cached by the client catalog are evicted beyond it, 0 for no limit
 bool    tsUseAdapter = false;
 
 /*
@@ -147,6 +157,7 @@ int32_t tsMaxMemUsedByInsert = 1024;
 float   tsSelectivityRatio = 1.0;
 int32_t tsTagFilterResCacheSize = 1024 * 10;
 char    tsTagFilterCache = 0;
+char    tsTagFilterBitmap = 0;
 
 // the maximum allowed query buffer size during query processing for each data node.
 // -1 no limit (default)
@@ -154,6 +165,7 @@ char    tsTagFilterCache = 0;
 // positive value (in MB)
 int32_t tsQueryBufferSize = -1;
 int64_t tsQueryBufferSizeBytes = -1;
+int32_t tsQueryBufWriteThreads = 2;
 int32_t tsCacheLazyLoadThreshold = 500;
 
 int32_t  tsDiskCfgNum = 0;
@@ -197,6 +209,7 @@ int32_t tsUptimeInterval = 300;    // seconds
 char    tsUdfdResFuncs[512] = "";  // udfd resident funcs that teardown when udfd exits
 char    tsUdfdLdLibPath[512] = "";
 bool    tsDisableStream = false;
+bool    tsSnapPhysical = true;  // ship whole tsdb file sets in full vnode snapshots
 
 #ifndef _STORAGE
 int32_t taosSetTfsCfg(SConfig *pCfg) {
@@ -324,12 +337,14 @@ static int32_t taosAddClientCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "queryNodeChunkSize", tsQueryNodeChunkSize, 1024, 128 * 1024, true) != 0) return -1;
   if (cfgAddBool(pCfg, "queryUseNodeAllocator", tsQueryUseNodeAllocator, true) != 0) return -1;
   if (cfgAddBool(pCfg, "keepColumnName", tsKeepColumnName, true) != 0) return -1;
+  if (cfgAddBool(pCfg, "stmtBindZeroCopy", tsStmtBindZeroCopy, true) != 0) return -1;
   if (cfgAddString(pCfg, "smlChildTableName", "", 1) != 0) return -1;
   if (cfgAddString(pCfg, "smlTagName", tsSmlTagName, 1) != 0) return -1;
   //  if (cfgAddBool(pCfg, "smlDataFormat", tsSmlDataFormat, 1) != 0) return -1;
   //  if (cfgAddInt32(pCfg, "smlBatchSize", tsSmlBatchSize, 1, INT32_MAX, true) != 0) return -1;
   if (cfgAddInt32(pCfg, "maxMemUsedByInsert", tsMaxMemUsedByInsert, 1, INT32_MAX, true) != 0) return -1;
   if (cfgAddInt32(pCfg, "maxRetryWaitTime", tsMaxRetryWaitTime, 0, 86400000, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "metaCacheMaxSize", tsMetaCacheMaxSize, 0, INT32_MAX, 1) != 0) return -1;
   if (cfgAddBool(pCfg, "useAdapter", tsUseAdapter, true) != 0) return -1;
   if (cfgAddBool(pCfg, "crashReporting", tsEnableCrashReport, true) != 0) return -1;
 
@@ -369,6 +384,7 @@ static int32_t taosAddSystemCfg(SConfig *pCfg) {
   if (cfgAddBool(pCfg, "FMA", tsFMAEnable, 0) != 0) return -1;
   if (cfgAddBool(pCfg, "SIMD-builtins", tsSIMDBuiltins, 0) != 0) return -1;
   if (cfgAddBool(pCfg, "tagFilterCache", tsTagFilterCache, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "tagFilterBitmap", tsTagFilterBitmap, 0) != 0) return -1;
 
   if (cfgAddInt64(pCfg, "openMax", tsOpenMax, 0, INT64_MAX, 1) != 0) return -1;
 #if !defined(_ALPINE)
@@ -404,6 +420,7 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "maxNumOfDistinctRes", tsMaxNumOfDistinctResults, 10 * 10000, 10000 * 10000, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "countAlwaysReturnValue", tsCountAlwaysReturnValue, 0, 1, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "queryBufferSize", tsQueryBufferSize, -1, 500000000000, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryBufWriteThreads", tsQueryBufWriteThreads, 0, 16, 0) != 0) return -1;
   if (cfgAddBool(pCfg, "printAuth", tsPrintAuth, 0) != 0) return -1;
   if (cfgAddInt32(pCfg, "queryRspPolicy", tsQueryRspPolicy, 0, 1, 0) != 0) return -1;
 
@@ -465,8 +482,14 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "syncHeartbeatTimeout", tsHeartbeatTimeout, 10, 1000 * 60 * 24 * 2, 0) != 0) return -1;
 
   if (cfgAddInt64(pCfg, "vndCommitMaxInterval", tsVndCommitMaxIntervalMs, 1000, 1000 * 60 * 60, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "retentionRecompress", tsRetentionRecompress, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "retentionMaxWriteRate", tsRetentionMaxWriteRate, 0, 1024 * 1024, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "blockBloomFilter", tsBlockBloomFilter, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "adaptiveCmpr", tsAdaptiveCmpr, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "dictCmpr", tsDictCmpr, 0) != 0) return -1;
 
   if (cfgAddInt64(pCfg, "mndSdbWriteDelta", tsMndSdbWriteDelta, 20, 10000, 0) != 0) return -1;
+  if (cfgAddInt32(pCfg, "mndSdbMaxDeltaFiles", tsMndSdbMaxDeltaFiles, 0, 1024, 0) != 0) return -1;
   if (cfgAddInt64(pCfg, "mndLogRetention", tsMndLogRetention, 500, 10000, 0) != 0) return -1;
 
   if (cfgAddBool(pCfg, "monitor", tsEnableMonitor, 0) != 0) return -1;
@@ -497,6 +520,7 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddString(pCfg, "udfdLdLibPath", tsUdfdLdLibPath, 0) != 0) return -1;
 
   if (cfgAddBool(pCfg, "disableStream", tsDisableStream, 0) != 0) return -1;
+  if (cfgAddBool(pCfg, "snapPhysical", tsSnapPhysical, 0) != 0) return -1;
 
   if (cfgAddInt32(pCfg, "cacheLazyLoadThreshold", tsCacheLazyLoadThreshold, 0, 100000, 0) != 0) return -1;
 
@@ -725,10 +749,12 @@ static int32_t taosSetClientCfg(SConfig *pCfg) {
   tsQueryNodeChunkSize = cfgGetItem(pCfg, "queryNodeChunkSize")->i32;
   tsQueryUseNodeAllocator = cfgGetItem(pCfg, "queryUseNodeAllocator")->bval;
   tsKeepColumnName = cfgGetItem(pCfg, "keepColumnName")->bval;
+  tsStmtBindZeroCopy = cfgGetItem(pCfg, "stmtBindZeroCopy")->bval;
   tsUseAdapter = cfgGetItem(pCfg, "useAdapter")->bval;
   tsEnableCrashReport = cfgGetItem(pCfg, "crashReporting")->bval;
 
   tsMaxRetryWaitTime = cfgGetItem(pCfg, "maxRetryWaitTime")->i32;
+  tsMetaCacheMaxSize = cfgGetItem(pCfg, "metaCacheMaxSize")->i32;
 
   tsNumOfRpcThreads = cfgGetItem(pCfg, "numOfRpcThreads")->i32;
   tsNumOfRpcSessions = cfgGetItem(pCfg, "numOfRpcSessions")->i32;
@@ -767,6 +793,7 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsMaxNumOfDistinctResults = cfgGetItem(pCfg, "maxNumOfDistinctRes")->i32;
   tsCountAlwaysReturnValue = cfgGetItem(pCfg, "countAlwaysReturnValue")->i32;
   tsQueryBufferSize = cfgGetItem(pCfg, "queryBufferSize")->i32;
+  tsQueryBufWriteThreads = cfgGetItem(pCfg, "queryBufWriteThreads")->i32;
   tsPrintAuth = cfgGetItem(pCfg, "printAuth")->bval;
 
   tsNumOfRpcThreads = cfgGetItem(pCfg, "numOfRpcThreads")->i32;
@@ -787,6 +814,7 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
 
   tsSIMDBuiltins = (bool)cfgGetItem(pCfg, "SIMD-builtins")->bval;
   tsTagFilterCache = (bool)cfgGetItem(pCfg, "tagFilterCache")->bval;
+  tsTagFilterBitmap = (bool)cfgGetItem(pCfg, "tagFilterBitmap")->bval;
 
   tsEnableMonitor = cfgGetItem(pCfg, "monitor")->bval;
   tsMonitorInterval = cfgGetItem(pCfg, "monitorInterval")->i32;
@@ -816,8 +844,14 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsHeartbeatTimeout = cfgGetItem(pCfg, "syncHeartbeatTimeout")->i32;
 
   tsVndCommitMaxIntervalMs = cfgGetItem(pCfg, "vndCommitMaxInterval")->i64;
+  tsRetentionRecompress = cfgGetItem(pCfg, "retentionRecompress")->bval;
+  tsRetentionMaxWriteRate = cfgGetItem(pCfg, "retentionMaxWriteRate")->i32;
+  tsBlockBloomFilter = cfgGetItem(pCfg, "blockBloomFilter")->bval;
+  tsAdaptiveCmpr = cfgGetItem(pCfg, "adaptiveCmpr")->bval;
+  tsDictCmpr = cfgGetItem(pCfg, "dictCmpr")->bval;
 
   tsMndSdbWriteDelta = cfgGetItem(pCfg, "mndSdbWriteDelta")->i64;
+  tsMndSdbMaxDeltaFiles = cfgGetItem(pCfg, "mndSdbMaxDeltaFiles")->i32;
   tsMndLogRetention = cfgGetItem(pCfg, "mndLogRetention")->i64;
 
   tsStartUdfd = cfgGetItem(pCfg, "udf")->bval;
@@ -826,10 +860,13 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   if (tsQueryBufferSize >= 0) {
     tsQueryBufferSizeBytes = tsQueryBufferSize * 1048576UL;
   }
+  dBufSetMemLimit(tsQueryBufferSize >= 0 ? tsQueryBufferSize * 1048576L : -1);
+  dBufSetWriterThreads(tsQueryBufWriteThreads);
 
   tsCacheLazyLoadThreshold = cfgGetItem(pCfg, "cacheLazyLoadThreshold")->i32;
 
   tsDisableStream = cfgGetItem(pCfg, "disableStream")->bval;
+  tsSnapPhysical = cfgGetItem(pCfg, "snapPhysical")->bval;
 
   GRANT_CFG_GET;
   return 0;
@@ -1082,6 +1119,7 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
         if (tsQueryBufferSize >= 0) {
           tsQueryBufferSizeBytes = tsQueryBufferSize * 1048576UL;
         }
+        dBufSetMemLimit(tsQueryBufferSize >= 0 ? tsQueryBufferSize * 1048576L : -1);
       } else if (strcasecmp("qDebugFlag", name) == 0) {
         qDebugFlag = cfgGetItem(pCfg, "qDebugFlag")->i32;
       } else if (strcasecmp("queryPlannerTrace", name) == 0) {
@@ -1118,6 +1156,8 @@ int32_t taosSetCfg(SConfig *pCfg, char *name) {
         //        tsSmlDataFormat = cfgGetItem(pCfg, "smlDataFormat")->bval;
         //      } else if (strcasecmp("smlBatchSize", name) == 0) {
         //        tsSmlBatchSize = cfgGetItem(pCfg, "smlBatchSize")->i32;
+      } else if (strcasecmp("stmtBindZeroCopy", name) == 0) {
+        tsStmtBindZeroCopy = cfgGetItem(pCfg, "stmtBindZeroCopy")->bval;
       } else if (strcasecmp("shellActivityTimer", name) == 0) {
         tsShellActivityTimer = cfgGetItem(pCfg, "shellActivityTimer")->i32;
       } else if (strcasecmp("supportVnodes", name) == 0) {
@@ -4668,6 +4668,15 @@ int32_t tSerializeSExplainRsp(void *buf, int32_t bufLen, SExplainRsp *pRsp) {
     if (tEncodeBinary(&encoder, info->verboseInfo, info->verboseLen) < 0) return -1;
   }
 
+  for (int32_t i = 0; i < pRsp->numOfPlans; ++i) {
+    SExplainExecInfo *info = &pRsp->subplanInfo[i];
+    if (tEncodeU64(&encoder, info->numOfBlocks) < 0) return -1;
+    if (tEncodeU64(&encoder, info->inputRows) < 0) return -1;
+    if (tEncodeU64(&encoder, info->inputBlocks) < 0) return -1;
+    if (tEncodeDouble(&encoder, info->selfCost) < 0) return -1;
+    if (tEncodeU64(&encoder, info->maxOutputBytes) < 0) return -1;
+  }
+
   tEndEncode(&encoder);
 
   int32_t tlen = encoder.pos;
@@ -4693,6 +4702,17 @@ int32_t tDeserializeSExplainRsp(void *buf, int32_t bufLen, SExplainRsp *pRsp) {
     if (tDecodeBinaryAlloc(&decoder, &pRsp->subplanInfo[i].verboseInfo, NULL) < 0) return -1;
   }
 
+  if (!tDecodeIsEnd(&decoder)) {
+    for (int32_t i = 0; i < pRsp->numOfPlans; ++i) {
+      SExplainExecInfo *info = &pRsp->subplanInfo[i];
+      if (tDecodeU64(&decoder, &info->numOfBlocks) < 0) return -1;
+      if (tDecodeU64(&decoder, &info->inputRows) < 0) return -1;
+      if (tDecodeU64(&decoder, &info->inputBlocks) < 0) return -1;
+      if (tDecodeDouble(&decoder, &info->selfCost) < 0) return -1;
+      if (tDecodeU64(&decoder, &info->maxOutputBytes) < 0) return -1;
+    }
+  }
+
   tEndDecode(&decoder);
 
   tDecoderClear(&decoder);
@@ -5003,6 +5023,7 @@ int32_t tSerializeSResFetchReq(void *buf, int32_t bufLen, SResFetchReq *pReq) {
   if (tEncodeU64(&encoder, pReq->queryId) < 0) return -1;
   if (tEncodeU64(&encoder, pReq->taskId) < 0) return -1;
   if (tEncodeI32(&encoder, pReq->execId) < 0) return -1;
+  if (tEncodeI8(&encoder, pReq->ncharUtf8) < 0) return -1;
 
   tEndEncode(&encoder);
 
@@ -5034,6 +5055,11 @@ int32_t tDeserializeSResFetchReq(void *buf, int32_t bufLen, SResFetchReq *pReq)
   if (tDecodeU64(&decoder, &pReq->queryId) < 0) return -1;
   if (tDecodeU64(&decoder, &pReq->taskId) < 0) return -1;
   if (tDecodeI32(&decoder, &pReq->execId) < 0) return -1;
+  if (!tDecodeIsEnd(&decoder)) {
+    if (tDecodeI8(&decoder, &pReq->ncharUtf8) < 0) return -1;
+  } else {
+    pReq->ncharUtf8 = 0;
+  }
 
   tEndDecode(&decoder);
 
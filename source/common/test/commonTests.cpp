@@ -11,6 +11,7 @@
 #include "taos.h"
 #include "tcommon.h"
 #include "tdatablock.h"
+#include "tdataformat.h"
 #include "tdef.h"
 #include "tvariant.h"
 
@@ -260,4 +261,103 @@ TEST(testCase, var_dataBlock_split_test) {
   }
 }
 
+TEST(testCase, colData_ref_bind_test) {
+  const int32_t numOfRows = 8;
+  int64_t       ts[numOfRows] = {8, 1, 2, 3, 4, 5, 6, 7};
+  int32_t       val[numOfRows] = {0, 1, 2, 3, 4, 5, 6, 7};
+
+  TAOS_MULTI_BIND tsBind = {0};
+  tsBind.buffer_type = TSDB_DATA_TYPE_TIMESTAMP;
+  tsBind.buffer = ts;
+  tsBind.buffer_length = sizeof(int64_t);
+  tsBind.num = numOfRows;
+
+  TAOS_MULTI_BIND valBind = {0};
+  valBind.buffer_type = TSDB_DATA_TYPE_INT;
+  valBind.buffer = val;
+  valBind.buffer_length = sizeof(int32_t);
+  valBind.num = numOfRows;
+
+  SArray*   pCols = taosArrayInit(2, sizeof(SColData));
+  SColData* pTs = (SColData*)taosArrayReserve(pCols, 1);
+  SColData* pVal = (SColData*)taosArrayReserve(pCols, 1);
+  tColDataInit(pTs, PRIMARYKEY_TIMESTAMP_COL_ID, TSDB_DATA_TYPE_TIMESTAMP, 0);
+  tColDataInit(pVal, PRIMARYKEY_TIMESTAMP_COL_ID + 1, TSDB_DATA_TYPE_INT, 0);
+
+  ASSERT_EQ(tColDataRefValueByBind(pTs, &tsBind), 0);
+  ASSERT_EQ(tColDataRefValueByBind(pVal, &valBind), 0);
+  ASSERT_TRUE(pTs->cflag & COL_DATA_REF_BUF);
+  ASSERT_EQ(pVal->pData, (uint8_t*)val);
+  ASSERT_EQ(pVal->nVal, numOfRows);
+  ASSERT_EQ(pVal->flag, HAS_VALUE);
+
+  // sorting must detach the columns and leave the bound buffers untouched
+  ASSERT_EQ(tColDataSortMerge(pCols), 0);
+  ASSERT_FALSE(pTs->cflag & COL_DATA_REF_BUF);
+  ASSERT_FALSE(pVal->cflag & COL_DATA_REF_BUF);
+  ASSERT_EQ(ts[0], 8);
+  ASSERT_EQ(((int64_t*)pTs->pData)[0], 1);
+  ASSERT_EQ(((int32_t*)pVal->pData)[numOfRows - 1], 0);
+
+  // a second bind appends to the detached copy
+  ASSERT_EQ(tColDataRefValueByBind(pVal, &valBind), 0);
+  ASSERT_FALSE(pVal->cflag & COL_DATA_REF_BUF);
+  ASSERT_EQ(pVal->nVal, numOfRows * 2);
+
+  tColDataDestroy(pTs);
+  tColDataDestroy(pVal);
+  taosArrayDestroy(pCols);
+}
+
+TEST(testCase, block_nchar_utf8_test) {
+  SSDataBlock*    b = createDataBlock();
+  SColumnInfoData infoData = createColumnInfoData(TSDB_DATA_TYPE_INT, 4, 1);
+  blockDataAppendColInfo(b, &infoData);
+  SColumnInfoData infoData1 = createColumnInfoData(TSDB_DATA_TYPE_NCHAR, 4 * 8 + VARSTR_HEADER_SIZE, 2);
+  blockDataAppendColInfo(b, &infoData1);
+  blockDataEnsureCapacity(b, 3);
+
+  // "a", NULL, U+00E9 U+4E2D U+1F600
+  TdUcs4 v0[] = {'a'};
+  TdUcs4 v2[] = {0xE9, 0x4E2D, 0x1F600};
+  char   varbuf[64] = {0};
+
+  SColumnInfoData* p0 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 0);
+  SColumnInfoData* p1 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, 1);
+  for (int32_t i = 0; i < 3; ++i) {
+    colDataSetVal(p0, i, (const char*)&i, false);
+  }
+  varDataSetLen(varbuf, sizeof(v0));
+  memcpy(varDataVal(varbuf), v0, sizeof(v0));
+  colDataSetVal(p1, 0, varbuf, false);
+  colDataSetVal(p1, 1, NULL, true);
+  varDataSetLen(varbuf, sizeof(v2));
+  memcpy(varDataVal(varbuf), v2, sizeof(v2));
+  colDataSetVal(p1, 2, varbuf, false);
+  b->info.rows = 3;
+
+  char*   data = (char*)taosMemoryCalloc(1, blockGetEncodeSize(b));
+  int32_t len = blockEncode(b, data, 2);
+  int32_t newLen = len;
+  ASSERT_EQ(blockEncodeNcharToUtf8(data, &newLen), 0);
+  ASSERT_LT(newLen, len);
+  ASSERT_EQ(*(int32_t*)(data + sizeof(int32_t)), newLen);
+  ASSERT_TRUE(*(int32_t*)(data + sizeof(int32_t) * 4) & BLOCK_FLAG_NCHAR_UTF8);
+
+  char* pStart = data + blockDataGetSerialMetaSize(2);
+  ASSERT_EQ(((int32_t*)(pStart + BitmapLen(3)))[2], 2);  // int column is kept
+  pStart += BitmapLen(3) + sizeof(int32_t) * 3;
+
+  int32_t* offset = (int32_t*)pStart;
+  char*    pData = pStart + sizeof(int32_t) * 3;
+  ASSERT_EQ(offset[1], -1);
+  ASSERT_EQ(varDataLen(pData + offset[0]), 1);
+  ASSERT_EQ(memcmp(varDataVal(pData + offset[0]), "a", 1), 0);
+  ASSERT_EQ(varDataLen(pData + offset[2]), 9);
+  ASSERT_EQ(memcmp(varDataVal(pData + offset[2]), "\xC3\xA9\xE4\xB8\xAD\xF0\x9F\x98\x80", 9), 0);
+
+  taosMemoryFree(data);
+  blockDataDestroy(b);
+}
+
 #pragma GCC diagnostic pop
\ No newline at end of file
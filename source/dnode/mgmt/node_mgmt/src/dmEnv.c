@@ -130,6 +130,7 @@ void dmCleanup() {
   udfcClose();
   udfStopUdfd();
   taosStopCacheRefreshWorker();
+  dBufStopWriters();
   dInfo("dnode env is cleaned up");
 
   taosCleanupCfg();
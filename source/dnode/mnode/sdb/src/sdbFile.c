@@ -17,11 +17,29 @@
 #include "sdb.h"
 #include "sync.h"
 #include "tchecksum.h"
+#include "tglobal.h"
 #include "wal.h"
 
-#define SDB_TABLE_SIZE   24
-#define SDB_RESERVE_SIZE 512
-#define SDB_FILE_VER     1
+#define SDB_TABLE_SIZE     24
+#define SDB_RESERVE_SIZE   512
+#define SDB_FILE_VER       1
+#define SDB_FILE_HEAD_SIZE (sizeof(int64_t) * (4 + SDB_TABLE_SIZE * 2) + SDB_RESERVE_SIZE)
+#define SDB_COPY_BUF_SIZE  (64 * 1024)
+
+static void sdbGetDeltaFileName(SSdb *pSdb, int32_t seq, char *fname, int32_t len) {
+  snprintf(fname, len, "%s%ssdb.data.delta.%d", pSdb->currDir, TD_DIRSEP, seq);
+}
+
+static void sdbRemoveDeltaFiles(SSdb *pSdb) {
+  char file[PATH_MAX] = {0};
+  for (int32_t seq = 1;; ++seq) {
+    sdbGetDeltaFileName(pSdb, seq, file, sizeof(file));
+    if (!taosCheckExistFile(file)) break;
+    (void)taosRemoveFile(file);
+    mInfo("sdb delta file:%s is removed", file);
+  }
+  pSdb->numOfDeltas = 0;
+}
 
 static int32_t sdbDeployData(SSdb *pSdb) {
   mInfo("start to deploy sdb");
@@ -63,6 +81,7 @@ static void sdbResetData(SSdb *pSdb) {
     if (hash == NULL) continue;
 
     taosHashClear(pSdb->hashObjs[i]);
+    taosHashClear(pSdb->dirtyObjs[i]);
     pSdb->tableVer[i] = 0;
     pSdb->maxId[i] = 0;
     mInfo("sdb:%s is reset", sdbTableName(i));
@@ -74,6 +93,8 @@ static void sdbResetData(SSdb *pSdb) {
   pSdb->commitIndex = -1;
   pSdb->commitTerm = -1;
   pSdb->commitConfig = -1;
+  pSdb->numOfDeltas = 0;
+  pSdb->dirtyLost = false;
   mInfo("sdb reset success");
 }
 
@@ -222,27 +243,33 @@ static int32_t sdbWriteFileHead(SSdb *pSdb, TdFilePtr pFile) {
   return 0;
 }
 
-static int32_t sdbReadFileImp(SSdb *pSdb) {
-  int64_t offset = 0;
-  int32_t code = 0;
-  int32_t readLen = 0;
-  int64_t ret = 0;
-  char    file[PATH_MAX] = {0};
-  int32_t bufLen = TSDB_MAX_MSG_SIZE;
-
-  snprintf(file, sizeof(file), "%s%ssdb.data", pSdb->currDir, TD_DIRSEP);
-  mInfo("start to read sdb file:%s", file);
+static int32_t sdbPeekFileIndex(const char *file, int64_t *index) {
+  TdFilePtr pFile = taosOpenFile(file, TD_FILE_READ);
+  if (pFile == NULL) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    return -1;
+  }
 
-  SSdbRaw *pRaw = taosMemoryMalloc(bufLen + 100);
-  if (pRaw == NULL) {
-    terrno = TSDB_CODE_OUT_OF_MEMORY;
-    mError("failed read sdb file since %s", terrstr());
+  int64_t head[2] = {0};
+  int64_t ret = taosReadFile(pFile, head, sizeof(head));
+  taosCloseFile(&pFile);
+  if (ret != sizeof(head) || head[0] != SDB_FILE_VER) {
+    terrno = TSDB_CODE_FILE_CORRUPTED;
     return -1;
   }
 
+  *index = head[1];
+  return 0;
+}
+
+static int32_t sdbReadOneFile(SSdb *pSdb, const char *file, SSdbRaw **ppRaw, int32_t *pBufLen) {
+  int32_t  code = 0;
+  int32_t  readLen = 0;
+  int64_t  ret = 0;
+  SSdbRaw *pRaw = *ppRaw;
+
   TdFilePtr pFile = taosOpenFile(file, TD_FILE_READ);
   if (pFile == NULL) {
-    taosMemoryFree(pRaw);
     terrno = TAOS_SYSTEM_ERROR(errno);
     mInfo("read sdb file:%s finished since %s", file, terrstr());
     return 0;
@@ -250,7 +277,6 @@ static int32_t sdbReadFileImp(SSdb *pSdb) {
 
   if (sdbReadFileHead(pSdb, pFile) != 0) {
     mError("failed to read sdb file:%s head since %s", file, terrstr());
-    taosMemoryFree(pRaw);
     taosCloseFile(&pFile);
     return -1;
   }
@@ -276,18 +302,19 @@ static int32_t sdbReadFileImp(SSdb *pSdb) {
     }
 
     readLen = pRaw->dataLen + sizeof(int32_t);
-    if (readLen >= bufLen) {
-      bufLen = pRaw->dataLen * 2;
-      SSdbRaw *pNewRaw = taosMemoryMalloc(bufLen + 100);
+    if (readLen >= *pBufLen) {
+      *pBufLen = pRaw->dataLen * 2;
+      SSdbRaw *pNewRaw = taosMemoryMalloc(*pBufLen + 100);
       if (pNewRaw == NULL) {
-        terrno = TSDB_CODE_OUT_OF_MEMORY;
-        mError("failed read sdb file since malloc new sdbRaw size:%d failed", bufLen);
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        mError("failed read sdb file since malloc new sdbRaw size:%d failed", *pBufLen);
         goto _OVER;
       }
-      mInfo("malloc new sdb raw size:%d, type:%d", bufLen, pRaw->type);
+      mInfo("malloc new sdb raw size:%d, type:%d", *pBufLen, pRaw->type);
       memcpy(pNewRaw, pRaw, sizeof(SSdbRaw));
       sdbFreeRaw(pRaw);
       pRaw = pNewRaw;
+      *ppRaw = pRaw;
     }
 
     ret = taosReadFile(pFile, pRaw->pData, readLen);
@@ -311,6 +338,10 @@ static int32_t sdbReadFileImp(SSdb *pSdb) {
     }
 
     code = sdbWriteWithoutFree(pSdb, pRaw);
+    if (code == TSDB_CODE_SDB_OBJ_NOT_THERE && pRaw->status == SDB_STATUS_DROPPED) {
+      // tombstone of a row that was created and dropped between two checkpoints
+      code = 0;
+    }
     if (code != 0) {
       mError("failed to read sdb file:%s since %s", file, terrstr());
       goto _OVER;
@@ -318,17 +349,67 @@ static int32_t sdbReadFileImp(SSdb *pSdb) {
   }
 
   code = 0;
+  memcpy(pSdb->tableVer, tableVer, sizeof(tableVer));
+
+_OVER:
+  taosCloseFile(&pFile);
+  terrno = code;
+  return code;
+}
+
+static int32_t sdbReadFileImp(SSdb *pSdb) {
+  int32_t code = 0;
+  char    file[PATH_MAX] = {0};
+  int32_t bufLen = TSDB_MAX_MSG_SIZE;
+
+  snprintf(file, sizeof(file), "%s%ssdb.data", pSdb->currDir, TD_DIRSEP);
+  mInfo("start to read sdb file:%s", file);
+
+  SSdbRaw *pRaw = taosMemoryMalloc(bufLen + 100);
+  if (pRaw == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    mError("failed read sdb file since %s", terrstr());
+    return -1;
+  }
+
+  code = sdbReadOneFile(pSdb, file, &pRaw, &bufLen);
+  if (code != 0) goto _OVER;
+
+  // replay the delta files written by incremental checkpoints, a delta not newer than what has been loaded is left
+  // over from an interrupted compaction and is discarded together with everything after it
+  for (int32_t seq = 1;; ++seq) {
+    sdbGetDeltaFileName(pSdb, seq, file, sizeof(file));
+    if (!taosCheckExistFile(file)) break;
+
+    int64_t index = -1;
+    if (sdbPeekFileIndex(file, &index) != 0 || index <= pSdb->applyIndex) {
+      mWarn("sdb delta file:%s is stale, index:%" PRId64 " apply index:%" PRId64, file, index, pSdb->applyIndex);
+      for (int32_t stale = seq;; ++stale) {
+        sdbGetDeltaFileName(pSdb, stale, file, sizeof(file));
+        if (!taosCheckExistFile(file)) break;
+        (void)taosRemoveFile(file);
+      }
+      break;
+    }
+
+    mInfo("start to read sdb delta file:%s", file);
+    code = sdbReadOneFile(pSdb, file, &pRaw, &bufLen);
+    if (code != 0) goto _OVER;
+    pSdb->numOfDeltas = seq;
+  }
+
+  for (int32_t i = 0; i < SDB_MAX; ++i) {
+    if (pSdb->dirtyObjs[i] != NULL) taosHashClear(pSdb->dirtyObjs[i]);
+  }
+
   pSdb->commitIndex = pSdb->applyIndex;
   pSdb->commitTerm = pSdb->applyTerm;
   pSdb->commitConfig = pSdb->applyConfig;
-  memcpy(pSdb->tableVer, tableVer, sizeof(tableVer));
-  mInfo("read sdb file:%s success, commit index:%" PRId64 " term:%" PRId64 " config:%" PRId64, file, pSdb->commitIndex,
-        pSdb->commitTerm, pSdb->commitConfig);
+  mInfo("read sdb file success, commit index:%" PRId64 " term:%" PRId64 " config:%" PRId64 ", deltas:%d",
+        pSdb->commitIndex, pSdb->commitTerm, pSdb->commitConfig, pSdb->numOfDeltas);
 
 _OVER:
-  taosCloseFile(&pFile);
   sdbFreeRaw(pRaw);
-
   terrno = code;
   return code;
 }
@@ -380,7 +461,7 @@ static int32_t sdbWriteFileImp(SSdb *pSdb) {
     mInfo("write %s to sdb file, total %d rows", sdbTableName(i), sdbGetSize(pSdb, i));
 
     SHashObj *hash = pSdb->hashObjs[i];
-    sdbWriteLock(pSdb, i);
+    sdbReadLock(pSdb, i);
 
     SSdbRow **ppRow = taosHashIterate(hash, NULL);
     while (ppRow != NULL) {
@@ -425,7 +506,11 @@ static int32_t sdbWriteFileImp(SSdb *pSdb) {
       sdbFreeRaw(pRaw);
       ppRow = taosHashIterate(hash, ppRow);
     }
+
+    // writers of this table are excluded by the lock, so every change up to here is covered by the full file
+    taosHashClear(pSdb->dirtyObjs[i]);
     sdbUnLock(pSdb, i);
+    if (code != 0) break;
   }
 
   if (code == 0) {
@@ -447,8 +532,11 @@ static int32_t sdbWriteFileImp(SSdb *pSdb) {
   }
 
   if (code != 0) {
+    pSdb->dirtyLost = true;
     mError("failed to write sdb file:%s since %s", curfile, tstrerror(code));
   } else {
+    sdbRemoveDeltaFiles(pSdb);
+    pSdb->dirtyLost = false;
     pSdb->commitIndex = pSdb->applyIndex;
     pSdb->commitTerm = pSdb->applyTerm;
     pSdb->commitConfig = pSdb->applyConfig;
@@ -460,6 +548,184 @@ static int32_t sdbWriteFileImp(SSdb *pSdb) {
   return code;
 }
 
+static int32_t sdbWriteRawToFile(TdFilePtr pFile, SSdbRaw *pRaw) {
+  int32_t writeLen = sizeof(SSdbRaw) + pRaw->dataLen;
+  if (taosWriteFile(pFile, pRaw, writeLen) != writeLen) {
+    return TAOS_SYSTEM_ERROR(errno);
+  }
+
+  int32_t cksum = taosCalcChecksum(0, (const uint8_t *)pRaw, sizeof(SSdbRaw) + pRaw->dataLen);
+  if (taosWriteFile(pFile, &cksum, sizeof(int32_t)) != sizeof(int32_t)) {
+    return TAOS_SYSTEM_ERROR(errno);
+  }
+
+  return 0;
+}
+
+// Give the rows taken by a failed checkpoint back to the live dirty set, unless they changed again meanwhile.
+static void sdbRestoreDirty(SSdb *pSdb, SHashObj *pending[]) {
+  for (int32_t i = 0; i < SDB_MAX; ++i) {
+    if (pending[i] == NULL) continue;
+
+    sdbWriteLock(pSdb, i);
+    void *p = taosHashIterate(pending[i], NULL);
+    while (p != NULL) {
+      size_t keyLen = 0;
+      void  *pKey = taosHashGetKey(p, &keyLen);
+      if (taosHashGet(pSdb->dirtyObjs[i], pKey, keyLen) == NULL) {
+        if (taosHashPut(pSdb->dirtyObjs[i], pKey, keyLen, p, sizeof(void *)) == 0) {
+          *(SSdbRaw **)p = NULL;
+        } else {
+          pSdb->dirtyLost = true;
+        }
+      }
+      p = taosHashIterate(pending[i], p);
+    }
+    sdbUnLock(pSdb, i);
+
+    taosHashCleanup(pending[i]);
+    pending[i] = NULL;
+  }
+}
+
+static int32_t sdbWriteDeltaFileImp(SSdb *pSdb) {
+  int32_t   code = 0;
+  int32_t   rows = 0;
+  SHashObj *pending[SDB_MAX] = {0};
+
+  char tmpfile[PATH_MAX] = {0};
+  snprintf(tmpfile, sizeof(tmpfile), "%s%ssdb.data.delta", pSdb->tmpDir, TD_DIRSEP);
+  char curfile[PATH_MAX] = {0};
+  sdbGetDeltaFileName(pSdb, pSdb->numOfDeltas + 1, curfile, sizeof(curfile));
+
+  mInfo("start to write sdb delta file, apply index:%" PRId64 " term:%" PRId64 " config:%" PRId64
+        ", commit index:%" PRId64 " term:%" PRId64 " config:%" PRId64 ", file:%s",
+        pSdb->applyIndex, pSdb->applyTerm, pSdb->applyConfig, pSdb->commitIndex, pSdb->commitTerm, pSdb->commitConfig,
+        curfile);
+
+  // detach the dirty sets, the tables only stay locked for the pointer swap
+  for (int32_t i = 0; i < SDB_MAX; ++i) {
+    if (pSdb->encodeFps[i] == NULL || pSdb->dirtyObjs[i] == NULL) continue;
+
+    SHashObj *fresh = sdbCreateDirtyHash(pSdb, i);
+    if (fresh == NULL) {
+      code = terrno;
+      sdbRestoreDirty(pSdb, pending);
+      terrno = code;
+      return code;
+    }
+
+    sdbWriteLock(pSdb, i);
+    pending[i] = pSdb->dirtyObjs[i];
+    pSdb->dirtyObjs[i] = fresh;
+    sdbUnLock(pSdb, i);
+  }
+
+  TdFilePtr pFile = taosOpenFile(tmpfile, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC);
+  if (pFile == NULL) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    mError("failed to open sdb delta file:%s for write since %s", tmpfile, tstrerror(code));
+    sdbRestoreDirty(pSdb, pending);
+    terrno = code;
+    return code;
+  }
+
+  if (sdbWriteFileHead(pSdb, pFile) != 0) {
+    code = terrno;
+    mError("failed to write sdb delta file:%s head since %s", tmpfile, terrstr());
+  }
+
+  for (int32_t i = SDB_MAX - 1; i >= 0 && code == 0; --i) {
+    if (pending[i] == NULL) continue;
+
+    SdbEncodeFp encodeFp = pSdb->encodeFps[i];
+    void       *p = taosHashIterate(pending[i], NULL);
+    while (p != NULL) {
+      SSdbRaw *pRaw = *(SSdbRaw **)p;
+      bool     needFree = false;
+
+      if (pRaw == NULL) {
+        size_t keyLen = 0;
+        void  *pKey = taosHashGetKey(p, &keyLen);
+
+        // encode under the read lock of this single row, writers are never held for the whole table
+        sdbReadLock(pSdb, i);
+        SSdbRow **ppRow = taosHashGet(pSdb->hashObjs[i], pKey, keyLen);
+        if (ppRow != NULL && *ppRow != NULL) {
+          SSdbRow *pRow = *ppRow;
+          pRaw = (*encodeFp)(pRow->pObj);
+          if (pRaw != NULL) {
+            needFree = true;
+            // rows not yet created must not survive a restart, write them as tombstones
+            if (pRow->status == SDB_STATUS_READY || pRow->status == SDB_STATUS_DROPPING) {
+              pRaw->status = pRow->status;
+            } else {
+              pRaw->status = SDB_STATUS_DROPPED;
+            }
+          } else {
+            code = TSDB_CODE_APP_ERROR;
+          }
+        }
+        sdbUnLock(pSdb, i);
+      }
+
+      if (code == 0 && pRaw != NULL) {
+        code = sdbWriteRawToFile(pFile, pRaw);
+        rows++;
+      }
+      if (needFree) sdbFreeRaw(pRaw);
+
+      if (code != 0) {
+        taosHashCancelIterate(pending[i], p);
+        break;
+      }
+      p = taosHashIterate(pending[i], p);
+    }
+  }
+
+  if (code == 0) {
+    code = taosFsyncFile(pFile);
+    if (code != 0) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      mError("failed to sync sdb delta file:%s since %s", tmpfile, tstrerror(code));
+    }
+  }
+
+  taosCloseFile(&pFile);
+
+  if (code == 0) {
+    code = taosRenameFile(tmpfile, curfile);
+    if (code != 0) {
+      code = TAOS_SYSTEM_ERROR(errno);
+    }
+  }
+
+  if (code != 0) {
+    mError("failed to write sdb delta file:%s since %s", curfile, tstrerror(code));
+    sdbRestoreDirty(pSdb, pending);
+  } else {
+    for (int32_t i = 0; i < SDB_MAX; ++i) {
+      taosHashCleanup(pending[i]);
+    }
+    pSdb->numOfDeltas++;
+    pSdb->commitIndex = pSdb->applyIndex;
+    pSdb->commitTerm = pSdb->applyTerm;
+    pSdb->commitConfig = pSdb->applyConfig;
+    mInfo("write sdb delta file success, rows:%d deltas:%d commit index:%" PRId64 " term:%" PRId64 " config:%" PRId64
+          " file:%s",
+          rows, pSdb->numOfDeltas, pSdb->commitIndex, pSdb->commitTerm, pSdb->commitConfig, curfile);
+  }
+
+  terrno = code;
+  return code;
+}
+
+static bool sdbNeedFullWrite(SSdb *pSdb) {
+  if (tsMndSdbMaxDeltaFiles <= 0) return true;
+  if (pSdb->commitIndex < 0 || pSdb->dirtyLost) return true;
+  return pSdb->numOfDeltas >= tsMndSdbMaxDeltaFiles;
+}
+
 int32_t sdbWriteFile(SSdb *pSdb, int32_t delta) {
   int32_t code = 0;
   if (pSdb->applyIndex == pSdb->commitIndex) {
@@ -477,7 +743,11 @@ int32_t sdbWriteFile(SSdb *pSdb, int32_t delta) {
     }
   }
   if (code == 0) {
-    code = sdbWriteFileImp(pSdb);
+    if (sdbNeedFullWrite(pSdb)) {
+      code = sdbWriteFileImp(pSdb);
+    } else {
+      code = sdbWriteDeltaFileImp(pSdb);
+    }
   }
   if (code == 0) {
     if (pSdb->pWal != NULL) {
@@ -542,6 +812,73 @@ static void sdbCloseIter(SSdbIter *pIter) {
   taosMemoryFree(pIter);
 }
 
+static int32_t sdbAppendFile(TdFilePtr pDst, const char *src, int64_t offset, int64_t size, char *pBuf) {
+  TdFilePtr pSrc = taosOpenFile(src, TD_FILE_READ);
+  if (pSrc == NULL) return -1;
+
+  if (taosLSeekFile(pSrc, offset, SEEK_SET) < 0) {
+    taosCloseFile(&pSrc);
+    return -1;
+  }
+
+  int64_t left = size;
+  while (left != 0) {
+    int64_t len = SDB_COPY_BUF_SIZE;
+    if (left > 0 && left < len) len = left;
+
+    int64_t readLen = taosReadFile(pSrc, pBuf, len);
+    if (readLen < 0 || (left > 0 && readLen != len)) {
+      taosCloseFile(&pSrc);
+      return -1;
+    }
+    if (readLen == 0) break;
+
+    if (taosWriteFile(pDst, pBuf, readLen) != readLen) {
+      taosCloseFile(&pSrc);
+      return -1;
+    }
+    if (left > 0) left -= readLen;
+  }
+
+  taosCloseFile(&pSrc);
+  return 0;
+}
+
+// The peer replays the snapshot as one sdb file, so the base file and its delta files are joined under the head of
+// the newest delta. Rows written more than once are simply applied in order on load.
+static int32_t sdbJoinFiles(SSdb *pSdb, const char *dstfile) {
+  char datafile[PATH_MAX] = {0};
+  snprintf(datafile, sizeof(datafile), "%s%ssdb.data", pSdb->currDir, TD_DIRSEP);
+  char deltafile[PATH_MAX] = {0};
+
+  char *pBuf = taosMemoryMalloc(SDB_COPY_BUF_SIZE);
+  if (pBuf == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  TdFilePtr pDst = taosOpenFile(dstfile, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC);
+  if (pDst == NULL) {
+    taosMemoryFree(pBuf);
+    return -1;
+  }
+
+  int32_t code = 0;
+  sdbGetDeltaFileName(pSdb, pSdb->numOfDeltas, deltafile, sizeof(deltafile));
+  code = sdbAppendFile(pDst, deltafile, 0, SDB_FILE_HEAD_SIZE, pBuf);
+  if (code == 0) {
+    code = sdbAppendFile(pDst, datafile, SDB_FILE_HEAD_SIZE, -1, pBuf);
+  }
+  for (int32_t seq = 1; seq <= pSdb->numOfDeltas && code == 0; ++seq) {
+    sdbGetDeltaFileName(pSdb, seq, deltafile, sizeof(deltafile));
+    code = sdbAppendFile(pDst, deltafile, SDB_FILE_HEAD_SIZE, -1, pBuf);
+  }
+
+  taosCloseFile(&pDst);
+  taosMemoryFree(pBuf);
+  return code;
+}
+
 int32_t sdbStartRead(SSdb *pSdb, SSdbIter **ppIter, int64_t *index, int64_t *term, int64_t *config) {
   SSdbIter *pIter = sdbCreateIter(pSdb);
   if (pIter == NULL) return -1;
@@ -553,7 +890,13 @@ int32_t sdbStartRead(SSdb *pSdb, SSdbIter **ppIter, int64_t *index, int64_t *ter
   int64_t commitIndex = pSdb->commitIndex;
   int64_t commitTerm = pSdb->commitTerm;
   int64_t commitConfig = pSdb->commitConfig;
-  if (taosCopyFile(datafile, pIter->name) < 0) {
+  int32_t code = 0;
+  if (pSdb->numOfDeltas > 0) {
+    code = sdbJoinFiles(pSdb, pIter->name);
+  } else {
+    code = taosCopyFile(datafile, pIter->name) < 0 ? -1 : 0;
+  }
+  if (code != 0) {
     taosThreadMutexUnlock(&pSdb->filelock);
     terrno = TAOS_SYSTEM_ERROR(errno);
     mError("failed to copy sdb file %s to %s since %s", datafile, pIter->name, terrstr());
@@ -650,11 +993,16 @@ int32_t sdbStopWrite(SSdb *pSdb, SSdbIter *pIter, bool isApply, int64_t index, i
 
   char datafile[PATH_MAX] = {0};
   snprintf(datafile, sizeof(datafile), "%s%ssdb.data", pSdb->currDir, TD_DIRSEP);
+  // the deltas are only removed once the snapshot replaced the data file they apply to, the same as sdbWriteFileImp
+  taosThreadMutexLock(&pSdb->filelock);
   if (taosRenameFile(pIter->name, datafile) != 0) {
     terrno = TAOS_SYSTEM_ERROR(errno);
+    taosThreadMutexUnlock(&pSdb->filelock);
     mError("sdbiter:%p, failed to rename file %s to %s since %s", pIter, pIter->name, datafile, terrstr());
     goto _OVER;
   }
+  sdbRemoveDeltaFiles(pSdb);
+  taosThreadMutexUnlock(&pSdb->filelock);
 
   if (sdbReadFile(pSdb) != 0) {
     mError("sdbiter:%p, failed to read from %s since %s", pIter, datafile, terrstr());
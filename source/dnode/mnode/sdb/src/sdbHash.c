@@ -132,6 +132,51 @@ static int32_t sdbGetkeySize(SSdb *pSdb, ESdbType type, const void *pKey) {
   return keySize;
 }
 
+static void sdbFreeDirtyRaw(void *p) { sdbFreeRaw(*(SSdbRaw **)p); }
+
+SHashObj *sdbCreateDirtyHash(SSdb *pSdb, ESdbType type) {
+  int32_t hashType = 0;
+  if (pSdb->keyTypes[type] == SDB_KEY_INT32) {
+    hashType = TSDB_DATA_TYPE_INT;
+  } else if (pSdb->keyTypes[type] == SDB_KEY_INT64) {
+    hashType = TSDB_DATA_TYPE_BIGINT;
+  } else {
+    hashType = TSDB_DATA_TYPE_BINARY;
+  }
+
+  SHashObj *hash = taosHashInit(64, taosGetDefaultHashFunction(hashType), true, HASH_NO_LOCK);
+  if (hash == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  taosHashSetFreeFp(hash, sdbFreeDirtyRaw);
+  return hash;
+}
+
+// Remember that the row changed since the last checkpoint, must be called with the table write lock held. Live rows
+// are re-encoded at checkpoint time, dropped rows keep a copy of the raw so a tombstone can be written.
+static void sdbMarkDirty(SSdb *pSdb, SSdbRaw *pRaw, const void *pKey, int32_t keySize) {
+  SHashObj *dirty = pSdb->dirtyObjs[pRaw->type];
+  if (dirty == NULL) return;
+
+  SSdbRaw *pTomb = NULL;
+  if (pRaw->status == SDB_STATUS_DROPPED) {
+    int32_t rawSize = sizeof(SSdbRaw) + pRaw->dataLen;
+    pTomb = taosMemoryMalloc(rawSize);
+    if (pTomb == NULL) {
+      pSdb->dirtyLost = true;
+      return;
+    }
+    memcpy(pTomb, pRaw, rawSize);
+  }
+
+  if (taosHashPut(dirty, pKey, keySize, &pTomb, sizeof(void *)) != 0) {
+    sdbFreeRaw(pTomb);
+    pSdb->dirtyLost = true;
+  }
+}
+
 static int32_t sdbInsertRow(SSdb *pSdb, SHashObj *hash, SSdbRaw *pRaw, SSdbRow *pRow, int32_t keySize) {
   int32_t type = pRow->type;
   sdbWriteLock(pSdb, type);
@@ -170,6 +215,7 @@ static int32_t sdbInsertRow(SSdb *pSdb, SHashObj *hash, SSdbRaw *pRaw, SSdbRow *
     }
   }
 
+  sdbMarkDirty(pSdb, pRaw, pRow->pObj, keySize);
   sdbUnLock(pSdb, type);
 
   if (pSdb->keyTypes[pRow->type] == SDB_KEY_INT32) {
@@ -196,6 +242,7 @@ static int32_t sdbUpdateRow(SSdb *pSdb, SHashObj *hash, SSdbRaw *pRaw, SSdbRow *
   SSdbRow *pOldRow = *ppOldRow;
   pOldRow->status = pRaw->status;
   sdbPrintOper(pSdb, pOldRow, "update");
+  sdbMarkDirty(pSdb, pRaw, pOldRow->pObj, keySize);
   sdbUnLock(pSdb, type);
 
   int32_t     code = 0;
@@ -228,6 +275,7 @@ static int32_t sdbDeleteRow(SSdb *pSdb, SHashObj *hash, SSdbRaw *pRaw, SSdbRow *
   atomic_add_fetch_32(&pOldRow->refCount, 1);
   sdbPrintOper(pSdb, pOldRow, "delete");
 
+  sdbMarkDirty(pSdb, pRaw, pOldRow->pObj, keySize);
   taosHashRemove(hash, pOldRow->pObj, keySize);
   pSdb->tableVer[pOldRow->type]++;
   sdbUnLock(pSdb, type);
@@ -0,0 +1,360 @@
+/**
+ * @file sdbDeltaTest.cpp
+ * @brief MNODE module sdb delta checkpoint tests
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "sdb.h"
+#include "tglobal.h"
+
+typedef struct SMnode {
+  SSdb *pSdb;
+} SMnode;
+
+typedef struct SI32Obj {
+  int32_t key;
+  int32_t v32;
+} SI32Obj;
+
+static SSdbRaw *i32Encode(SI32Obj *pObj) {
+  SSdbRaw *pRaw = sdbAllocRaw(SDB_VGROUP, 1, sizeof(SI32Obj));
+  if (pRaw == NULL) return NULL;
+
+  int32_t dataPos = 0;
+  sdbSetRawInt32(pRaw, dataPos, pObj->key);
+  dataPos += sizeof(pObj->key);
+  sdbSetRawInt32(pRaw, dataPos, pObj->v32);
+  dataPos += sizeof(pObj->v32);
+  sdbSetRawDataLen(pRaw, dataPos);
+  return pRaw;
+}
+
+static SSdbRow *i32Decode(SSdbRaw *pRaw) {
+  SSdbRow *pRow = sdbAllocRow(sizeof(SI32Obj));
+  if (pRow == NULL) return NULL;
+
+  SI32Obj *pObj = (SI32Obj *)sdbGetRowObj(pRow);
+  int32_t  dataPos = 0;
+  sdbGetRawInt32(pRaw, dataPos, &pObj->key);
+  dataPos += sizeof(pObj->key);
+  sdbGetRawInt32(pRaw, dataPos, &pObj->v32);
+  dataPos += sizeof(pObj->v32);
+  return pRow;
+}
+
+static int32_t i32Insert(SSdb *pSdb, SI32Obj *pObj) { return 0; }
+static int32_t i32Delete(SSdb *pSdb, SI32Obj *pObj, bool callFunc) { return 0; }
+static int32_t i32Update(SSdb *pSdb, SI32Obj *pOld, SI32Obj *pNew) {
+  pOld->v32 = pNew->v32;
+  return 0;
+}
+
+class SdbDeltaTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    mDebugFlag = 143;
+    tsLogEmbedded = 1;
+    tsAsyncLog = 0;
+
+    const char *logDir = TD_TMP_DIR_PATH "sdb_delta_log";
+    taosRemoveDir(logDir);
+    taosMkDir(logDir);
+    tstrncpy(tsLogDir, logDir, PATH_MAX);
+    if (taosInitLog("taosdlog", 1) != 0) {
+      printf("failed to init log file\n");
+    }
+  }
+  static void TearDownTestSuite() { taosCloseLog(); }
+
+  void SetUp() override {
+    taosRemoveDir(path);
+    maxDeltaFiles = tsMndSdbMaxDeltaFiles;
+    tsMndSdbMaxDeltaFiles = 16;
+    ASSERT_EQ(open(false), 0);
+  }
+
+  void TearDown() override {
+    close();
+    tsMndSdbMaxDeltaFiles = maxDeltaFiles;
+    taosRemoveDir(path);
+  }
+
+  int32_t open(bool read, const char *dir = NULL) {
+    SSdbOpt opt = {0};
+    opt.pMnode = &mnode;
+    opt.path = dir ? dir : path;
+    pSdb = sdbInit(&opt);
+    mnode.pSdb = pSdb;
+    if (pSdb == NULL) return -1;
+
+    SSdbTable table = {0};
+    table.sdbType = SDB_VGROUP;
+    table.keyType = SDB_KEY_INT32;
+    table.encodeFp = (SdbEncodeFp)i32Encode;
+    table.decodeFp = (SdbDecodeFp)i32Decode;
+    table.insertFp = (SdbInsertFp)i32Insert;
+    table.updateFp = (SdbUpdateFp)i32Update;
+    table.deleteFp = (SdbDeleteFp)i32Delete;
+    if (sdbSetTable(pSdb, table) != 0) return -1;
+
+    return read ? sdbReadFile(pSdb) : 0;
+  }
+
+  void close() {
+    if (pSdb != NULL) sdbCleanup(pSdb);
+    pSdb = NULL;
+  }
+
+  int32_t reopen() {
+    close();
+    return open(true);
+  }
+
+  void write(int32_t key, int32_t v32, ESdbStatus status) {
+    SI32Obj  obj = {.key = key, .v32 = v32};
+    SSdbRaw *pRaw = i32Encode(&obj);
+    sdbSetRawStatus(pRaw, status);
+    ASSERT_EQ(sdbWrite(pSdb, pRaw), 0);
+  }
+
+  void put(int32_t key, int32_t v32) { write(key, v32, SDB_STATUS_READY); }
+  void drop(int32_t key) { write(key, 0, SDB_STATUS_DROPPED); }
+
+  void checkpoint() {
+    ++index;
+    sdbSetApplyInfo(pSdb, index, 1, 0);
+    ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+  }
+
+  // value of each live row, -1 for absent keys
+  std::vector<int32_t> rows(int32_t maxKey) {
+    std::vector<int32_t> values;
+    for (int32_t key = 0; key <= maxKey; ++key) {
+      SI32Obj *pObj = (SI32Obj *)sdbAcquire(pSdb, SDB_VGROUP, &key);
+      values.push_back(pObj ? pObj->v32 : -1);
+      if (pObj) sdbRelease(pSdb, pObj);
+    }
+    return values;
+  }
+
+  std::string file(const char *name, const char *dir = NULL) {
+    return std::string(dir ? dir : path) + TD_DIRSEP + "data" + TD_DIRSEP + name;
+  }
+
+  bool exist(const char *name) { return taosCheckExistFile(file(name).c_str()); }
+
+  int64_t commitIndex() {
+    int64_t index = 0, term = 0, config = 0;
+    sdbGetCommitInfo(pSdb, &index, &term, &config);
+    return index;
+  }
+
+  const char *path = TD_TMP_DIR_PATH "sdb_delta_test";
+  SMnode      mnode = {0};
+  SSdb       *pSdb = NULL;
+  int64_t     index = 0;
+  int32_t     maxDeltaFiles = 0;
+};
+
+#ifndef WINDOWS
+
+TEST_F(SdbDeltaTest, write) {
+  for (int32_t key = 1; key <= 10; ++key) put(key, key * 10);
+
+  // the first checkpoint has nothing to build on
+  checkpoint();
+  EXPECT_TRUE(exist("sdb.data"));
+  EXPECT_FALSE(exist("sdb.data.delta.1"));
+
+  int64_t size = 0;
+  ASSERT_EQ(taosStatFile(file("sdb.data").c_str(), &size, NULL), 0);
+
+  put(3, 33);
+  checkpoint();
+  EXPECT_TRUE(exist("sdb.data.delta.1"));
+
+  drop(4);
+  checkpoint();
+  EXPECT_TRUE(exist("sdb.data.delta.2"));
+  EXPECT_EQ(commitIndex(), index);
+
+  // only changed rows are written, the base file is left alone
+  int64_t newSize = 0, deltaSize = 0;
+  ASSERT_EQ(taosStatFile(file("sdb.data").c_str(), &newSize, NULL), 0);
+  ASSERT_EQ(taosStatFile(file("sdb.data.delta.1").c_str(), &deltaSize, NULL), 0);
+  EXPECT_EQ(newSize, size);
+  EXPECT_LT(deltaSize, size);
+
+  // nothing applied since the last checkpoint, nothing written
+  ASSERT_EQ(sdbWriteFile(pSdb, 0), 0);
+  EXPECT_FALSE(exist("sdb.data.delta.3"));
+}
+
+TEST_F(SdbDeltaTest, replay) {
+  for (int32_t key = 1; key <= 10; ++key) put(key, key * 10);
+  checkpoint();
+
+  put(3, 33);
+  drop(5);
+  put(11, 110);
+  checkpoint();
+
+  drop(11);
+  put(12, 120);  // created and dropped between two checkpoints
+  drop(12);
+  put(1, 11);
+  write(13, 130, SDB_STATUS_CREATING);  // not created yet, must not come back
+  checkpoint();
+
+  std::vector<int32_t> expect = rows(13);
+  ASSERT_EQ(reopen(), 0);
+
+  EXPECT_EQ(rows(13), expect);
+  EXPECT_EQ(expect[1], 11);
+  EXPECT_EQ(expect[3], 33);
+  EXPECT_EQ(expect[5], -1);
+  EXPECT_EQ(expect[11], -1);
+  EXPECT_EQ(expect[12], -1);
+  EXPECT_EQ(commitIndex(), index);
+
+  // the deltas are kept and counted, so the next checkpoint is a delta again
+  put(2, 22);
+  checkpoint();
+  EXPECT_TRUE(exist("sdb.data.delta.3"));
+  ASSERT_EQ(reopen(), 0);
+  EXPECT_EQ(rows(13)[2], 22);
+}
+
+TEST_F(SdbDeltaTest, compact) {
+  tsMndSdbMaxDeltaFiles = 2;
+
+  for (int32_t key = 1; key <= 10; ++key) put(key, key * 10);
+  checkpoint();
+  put(1, 11);
+  checkpoint();
+  put(2, 22);
+  checkpoint();
+  EXPECT_TRUE(exist("sdb.data.delta.2"));
+
+  // the delta limit is reached, a full file replaces the base and the deltas
+  put(3, 33);
+  checkpoint();
+  EXPECT_FALSE(exist("sdb.data.delta.1"));
+  EXPECT_FALSE(exist("sdb.data.delta.2"));
+
+  std::vector<int32_t> expect = rows(10);
+  ASSERT_EQ(reopen(), 0);
+  EXPECT_EQ(rows(10), expect);
+
+  // deltas disabled
+  tsMndSdbMaxDeltaFiles = 0;
+  put(4, 44);
+  checkpoint();
+  EXPECT_FALSE(exist("sdb.data.delta.1"));
+}
+
+TEST_F(SdbDeltaTest, staleDelta) {
+  for (int32_t key = 1; key <= 10; ++key) put(key, key * 10);
+  checkpoint();
+  put(1, 11);
+  checkpoint();
+
+  std::string delta = file("sdb.data.delta.1");
+  std::string saved = delta + ".saved";
+  ASSERT_GE(taosCopyFile(delta.c_str(), saved.c_str()), 0);
+
+  // a full write that crashed before removing the deltas leaves ones not newer than the base file
+  tsMndSdbMaxDeltaFiles = 1;
+  put(1, 12);
+  checkpoint();
+  EXPECT_FALSE(exist("sdb.data.delta.1"));
+  ASSERT_EQ(taosRenameFile(saved.c_str(), delta.c_str()), 0);
+
+  ASSERT_EQ(reopen(), 0);
+  EXPECT_EQ(rows(1)[1], 12);
+  EXPECT_FALSE(exist("sdb.data.delta.1"));
+  EXPECT_EQ(commitIndex(), index);
+}
+
+TEST_F(SdbDeltaTest, corruptTail) {
+  for (int32_t key = 1; key <= 10; ++key) put(key, key * 10);
+  checkpoint();
+  put(1, 11);
+  put(2, 22);
+  checkpoint();
+
+  int64_t size = 0;
+  std::string delta = file("sdb.data.delta.1");
+  ASSERT_EQ(taosStatFile(delta.c_str(), &size, NULL), 0);
+
+  // flip a byte of the last row, its checksum no longer matches
+  TdFilePtr pFile = taosOpenFile(delta.c_str(), TD_FILE_READ | TD_FILE_WRITE);
+  ASSERT_NE(pFile, nullptr);
+  char c = 0;
+  ASSERT_EQ(taosPReadFile(pFile, &c, 1, size - 8), 1);
+  c = ~c;
+  ASSERT_EQ(taosPWriteFile(pFile, &c, 1, size - 8), 1);
+  taosCloseFile(&pFile);
+
+  // a damaged delta fails the load, rather than silently losing the rows in it
+  EXPECT_NE(reopen(), 0);
+  EXPECT_EQ(sdbGetSize(pSdb, SDB_VGROUP), 0);
+
+  // a torn tail fails it too
+  pFile = taosOpenFile(delta.c_str(), TD_FILE_READ | TD_FILE_WRITE);
+  ASSERT_NE(pFile, nullptr);
+  ASSERT_EQ(taosFtruncateFile(pFile, size - 3), 0);
+  taosCloseFile(&pFile);
+  EXPECT_NE(reopen(), 0);
+  EXPECT_EQ(sdbGetSize(pSdb, SDB_VGROUP), 0);
+}
+
+TEST_F(SdbDeltaTest, snapshot) {
+  for (int32_t key = 1; key <= 10; ++key) put(key, key * 10);
+  checkpoint();
+  put(1, 11);
+  drop(2);
+  checkpoint();
+  put(11, 110);
+  checkpoint();
+  std::vector<int32_t> expect = rows(11);
+
+  // the base file and the deltas are shipped as one file
+  SSdbIter *pReader = NULL;
+  int64_t   readIndex = 0, term = 0, config = 0;
+  ASSERT_EQ(sdbStartRead(pSdb, &pReader, &readIndex, &term, &config), 0);
+  EXPECT_EQ(readIndex, index);
+
+  std::string peer = std::string(path) + "_peer";
+  taosRemoveDir(peer.c_str());
+  SSdb *pLeader = pSdb;
+  ASSERT_EQ(open(false, peer.c_str()), 0);
+  SSdb *pPeer = pSdb;
+
+  SSdbIter *pWriter = NULL;
+  ASSERT_EQ(sdbStartWrite(pPeer, &pWriter), 0);
+  void   *pBuf = NULL;
+  int32_t len = 0;
+  while (sdbDoRead(pLeader, pReader, &pBuf, &len) == 0 && pBuf != NULL && len != 0) {
+    ASSERT_EQ(sdbDoWrite(pPeer, pWriter, pBuf, len), 0);
+    taosMemoryFree(pBuf);
+  }
+  sdbStopRead(pLeader, pReader);
+  ASSERT_EQ(sdbStopWrite(pPeer, pWriter, true, readIndex, term, config), 0);
+
+  EXPECT_EQ(rows(11), expect);
+  EXPECT_EQ(commitIndex(), index);
+
+  sdbCleanup(pPeer);
+  taosRemoveDir(peer.c_str());
+  pSdb = pLeader;
+  mnode.pSdb = pLeader;
+}
+
+#endif
@@ -241,7 +241,7 @@ int32_t sndProcessTaskDispatchRsp(SSnode *pSnode, SRpcMsg *pMsg) {
   int32_t             taskId = ntohl(pRsp->upstreamTaskId);
   SStreamTask        *pTask = streamMetaAcquireTask(pSnode->pMeta, taskId);
   if (pTask) {
-    streamProcessDispatchRsp(pTask, pRsp, pMsg->code);
+    streamProcessDispatchRsp(pTask, pRsp, pMsg->contLen - sizeof(SMsgHead), pMsg->code);
     streamMetaReleaseTask(pSnode->pMeta, pTask);
     return 0;
   } else {
@@ -122,6 +122,16 @@ int32_t  metaGetCachedTableUidList(SMeta *pMeta, tb_uid_t suid, const uint8_t *k
 int32_t  metaUidFilterCachePut(SMeta *pMeta, uint64_t suid, const void *pKey, int32_t keyLen, void *pPayload,
                                int32_t payloadLen, double selectivityRatio);
 int32_t  metaUidCacheClear(SMeta *pMeta, uint64_t suid);
+
+// tag bitmap index, the bitmap cache read lock is held until the reader is released
+typedef struct SMetaTagBitmapReader SMetaTagBitmapReader;
+
+int32_t metaTagBitmapAcquire(SMeta *pMeta, tb_uid_t suid, const SArray *pCids, SMetaTagBitmapReader **ppReader);
+void    metaTagBitmapRelease(SMetaTagBitmapReader *pReader);
+int32_t metaTagBitmapBytes(SMetaTagBitmapReader *pReader);
+int32_t metaTagBitmapOrEqual(SMetaTagBitmapReader *pReader, const STagVal *pVal, uint8_t *pBits);
+int32_t metaTagBitmapToUidList(SMetaTagBitmapReader *pReader, const uint8_t *pBits, SArray *pUidList);
+
 tb_uid_t metaGetTableEntryUidByName(SMeta *pMeta, const char *name);
 int64_t  metaGetTbNum(SMeta *pMeta);
 int64_t  metaGetNtbNum(SMeta *pMeta);
@@ -176,6 +186,14 @@ typedef struct STsdbReader STsdbReader;
 #define CACHESCAN_RETRIEVE_LAST_ROW    0x4
 #define CACHESCAN_RETRIEVE_LAST        0x8
 
+// an equality condition `col = key` that is checked against the block bloom filters, the key is the value in the
+// column type: the fixed-width bytes for numeric columns, the string without its length header for var types
+typedef struct SBlockBloomCond {
+  int16_t  colId;
+  uint32_t len;
+  void    *pKey;
+} SBlockBloomCond;
+
 int32_t tsdbSetTableList(STsdbReader *pReader, const void *pTableList, int32_t num);
 int32_t tsdbReaderOpen(SVnode *pVnode, SQueryTableDataCond *pCond, void *pTableList, int32_t numOfTables,
                        SSDataBlock *pResBlock, STsdbReader **ppReader, const char *idstr);
@@ -184,10 +202,13 @@ void         tsdbReaderSetId(STsdbReader* pReader, const char* idstr);
 void         tsdbReaderClose(STsdbReader *pReader);
 bool         tsdbNextDataBlock(STsdbReader *pReader);
 int32_t      tsdbRetrieveDatablockSMA(STsdbReader *pReader, SSDataBlock *pDataBlock, bool *allHave);
+int32_t      tsdbBloomFilterOutBlock(STsdbReader *pReader, const SArray *pConds, bool *filterOut);
 void         tsdbReleaseDataBlock(STsdbReader *pReader);
 SSDataBlock *tsdbRetrieveDataBlock(STsdbReader *pTsdbReadHandle, SArray *pColumnIdList);
+SSDataBlock *tsdbRetrieveDataBlockPartial(STsdbReader *pReader, const int16_t *colIds, int32_t numOfCols);
 int32_t      tsdbReaderReset(STsdbReader *pReader, SQueryTableDataCond *pCond);
 int32_t      tsdbGetFileBlocksDistInfo(STsdbReader *pReader, STableBlockDistInfo *pTableBlockInfo);
+void         tsdbReaderGetIOCost(STsdbReader *pReader, int64_t *pLoadBytes, int64_t *pCacheHits);
 int64_t      tsdbGetNumOfRowsInMemTable(STsdbReader *pHandle);
 void        *tsdbGetIdx(SMeta *pMeta);
 void        *tsdbGetIvtIdx(SMeta *pMeta);
@@ -284,7 +305,7 @@ int32_t vnodeEnqueueStreamMsg(SVnode *pVnode, SRpcMsg *pMsg);
 int32_t smaGetTSmaDays(SVnodeCfg *pCfg, void *pCont, uint32_t contLen, int32_t *days);
 
 // SVSnapReader
-int32_t vnodeSnapReaderOpen(SVnode *pVnode, int64_t sver, int64_t ever, SVSnapReader **ppReader);
+int32_t vnodeSnapReaderOpen(SVnode *pVnode, SSnapshotParam *pParam, SVSnapReader **ppReader);
 void    vnodeSnapReaderClose(SVSnapReader *pReader);
 int32_t vnodeSnapRead(SVSnapReader *pReader, uint8_t **ppData, uint32_t *nData);
 // SVSnapWriter
@@ -73,6 +73,10 @@ int32_t metaStatsCacheGet(SMeta* pMeta, int64_t uid, SMetaStbStats* pInfo);
 void    metaUpdateStbStats(SMeta* pMeta, int64_t uid, int64_t delta);
 int32_t metaUidFilterCacheGet(SMeta* pMeta, uint64_t suid, const void* pKey, int32_t keyLen, LRUHandle** pHandle);
 
+void metaTagBitmapUpsert(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid, const STag* pTag);
+void metaTagBitmapRemove(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid);
+void metaTagBitmapClear(SMeta* pMeta, tb_uid_t suid);
+
 struct SMeta {
   TdThreadRwlock lock;
 
@@ -44,6 +44,8 @@ extern "C" {
 
 typedef struct STqOffsetStore STqOffsetStore;
 
+#define TQ_RSP_CACHE_SIZE (16 * 1024 * 1024)  // per vnode
+
 // tqPush
 
 typedef struct {
@@ -106,6 +108,7 @@ typedef struct {
   SMqDataRsp*    pDataRsp;
   char           subKey[TSDB_SUBSCRIBE_KEY_LEN];
   SRpcHandleInfo info;
+  int64_t        deadline;  // rsp with empty block at this time if no data arrives, 0 to wait forever
 } STqPushEntry;
 
 struct STQ {
@@ -114,10 +117,14 @@ struct STQ {
   int64_t walLogLastVer;
 
   SRWLatch pushLock;
+  int8_t   closing;
+  tmr_h    pushTimer;  // expire the push entries
+  int64_t  refId;      // held by the push timer, the tq is freed with the last ref
 
   SHashObj* pPushMgr;    // consumerId -> STqPushEntry
   SHashObj* pHandle;     // subKey -> STqHandle
   SHashObj* pCheckInfo;  // topic -> SAlterCheckInfo
+  SLRUCache* pRspCache;  // (topic, version) -> encoded data rsp, shared by all consumer groups of a topic
 
   STqOffsetStore* pOffsetStore;
 
@@ -129,8 +136,9 @@ struct STQ {
 };
 
 typedef struct {
-  int8_t inited;
-  tmr_h  timer;
+  int8_t  inited;
+  tmr_h   timer;
+  int32_t rsetId;
 } STqMgmt;
 
 static STqMgmt tqMgmt = {0};
@@ -138,9 +146,15 @@ static STqMgmt tqMgmt = {0};
 int32_t tEncodeSTqHandle(SEncoder* pEncoder, const STqHandle* pHandle);
 int32_t tDecodeSTqHandle(SDecoder* pDecoder, STqHandle* pHandle);
 
+// tq
+int32_t tqStartPushTimer(STQ* pTq);
+void    tqStopPushTimer(STQ* pTq);
+void    tqRemoveRef(STQ* pTq);
+
 // tqRead
 int32_t tqScanTaosx(STQ* pTq, const STqHandle* pHandle, STaosxRsp* pRsp, SMqMetaRsp* pMetaRsp, STqOffsetVal* offset);
 int32_t tqScanData(STQ* pTq, const STqHandle* pHandle, SMqDataRsp* pRsp, STqOffsetVal* pOffset);
+int32_t tqScanDataCached(STQ* pTq, const STqHandle* pHandle, SMqDataRsp* pRsp, STqOffsetVal* pOffset);
 int32_t tqFetchLog(STQ* pTq, STqHandle* pHandle, int64_t* fetchOffset, SWalCkHead** pHeadWithCkSum);
 
 // tqExec
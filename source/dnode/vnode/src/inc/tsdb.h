@@ -71,6 +71,9 @@ typedef struct SDiskDataBuilder SDiskDataBuilder;
 typedef struct SBlkInfo         SBlkInfo;
 typedef struct STsdbDataIter2   STsdbDataIter2;
 typedef struct STsdbFilterInfo  STsdbFilterInfo;
+typedef struct SBlockBloom      SBlockBloom;
+typedef struct SDelSkyline      SDelSkyline;
+typedef struct SRetentionFSet   SRetentionFSet;
 
 #define TSDBROW_ROW_FMT ((int8_t)0x0)
 #define TSDBROW_COL_FMT ((int8_t)0x1)
@@ -79,6 +82,13 @@ typedef struct STsdbFilterInfo  STsdbFilterInfo;
 #define TSDB_MAX_SUBBLOCKS 8
 #define TSDB_FHDR_SIZE     512
 
+// column id that never belongs to a real column, it separates the column aggs of a block from its bloom filters
+#define TSDB_SMA_BLOOM_MARK         0
+#define TSDB_BLOCK_BLOOM_ERROR_RATE 0.01
+// column types a block bloom filter is built for
+#define TSDB_BLOOM_TYPE(type) \
+  (IS_INTEGER_TYPE(type) || (type) == TSDB_DATA_TYPE_TIMESTAMP || (type) == TSDB_DATA_TYPE_VARCHAR)
+
 #define VERSION_MIN 0
 #define VERSION_MAX INT64_MAX
 
@@ -136,9 +146,10 @@ int32_t tTABLEIDCmprFn(const void *p1, const void *p2);
 #define MIN_TSDBKEY(KEY1, KEY2) ((tsdbKeyCmprFn(&(KEY1), &(KEY2)) < 0) ? (KEY1) : (KEY2))
 #define MAX_TSDBKEY(KEY1, KEY2) ((tsdbKeyCmprFn(&(KEY1), &(KEY2)) > 0) ? (KEY1) : (KEY2))
 // SBlockCol
-int32_t tPutBlockCol(uint8_t *p, void *ph);
-int32_t tGetBlockCol(uint8_t *p, void *ph);
-int32_t tBlockColCmprFn(const void *p1, const void *p2);
+int32_t  tPutBlockCol(uint8_t *p, void *ph);
+int32_t  tGetBlockCol(uint8_t *p, void *ph);
+int32_t  tBlockColCmprFn(const void *p1, const void *p2);
+uint32_t tBlockColFmtVer(const SBlockCol *pBlockCol);
 // SDataBlk
 void    tDataBlkReset(SDataBlk *pBlock);
 int32_t tPutDataBlk(uint8_t *p, void *ph);
@@ -169,8 +180,8 @@ int32_t tBlockDataTryUpsertRow(SBlockData *pBlockData, TSDBROW *pRow, int64_t ui
 int32_t tBlockDataUpsertRow(SBlockData *pBlockData, TSDBROW *pRow, STSchema *pTSchema, int64_t uid);
 void    tBlockDataClear(SBlockData *pBlockData);
 void    tBlockDataGetColData(SBlockData *pBlockData, int16_t cid, SColData **ppColData);
-int32_t tCmprBlockData(SBlockData *pBlockData, int8_t cmprAlg, uint8_t **ppOut, int32_t *szOut, uint8_t *aBuf[],
-                       int32_t aBufN[]);
+int32_t tCmprBlockData(SBlockData *pBlockData, int8_t cmprAlg, int8_t toLast, uint8_t **ppOut, int32_t *szOut,
+                       uint8_t *aBuf[], int32_t aBufN[]);
 int32_t tDecmprBlockData(uint8_t *pIn, int32_t szIn, SBlockData *pBlockData, uint8_t *aBuf[]);
 // SDiskDataHdr
 int32_t tPutDiskDataHdr(uint8_t *p, const SDiskDataHdr *pHdr);
@@ -260,6 +271,7 @@ int32_t tsdbFSRef(STsdb *pTsdb, STsdbFS *pFS);
 void    tsdbFSUnref(STsdb *pTsdb, STsdbFS *pFS);
 
 int32_t tsdbFSUpsertFSet(STsdbFS *pFS, SDFileSet *pSet);
+int32_t tsdbFSReplaceFSet(STsdbFS *pFS, SDFileSet *pSet);
 int32_t tsdbFSUpsertDelFile(STsdbFS *pFS, SDelFile *pDelFile);
 // tsdbReaderWriter.c ==============================================================================================
 // SDataFWriter
@@ -280,9 +292,13 @@ int32_t tsdbDataFReaderClose(SDataFReader **ppReader);
 int32_t tsdbReadBlockIdx(SDataFReader *pReader, SArray *aBlockIdx);
 int32_t tsdbReadDataBlk(SDataFReader *pReader, SBlockIdx *pBlockIdx, SMapData *mDataBlk);
 int32_t tsdbReadSttBlk(SDataFReader *pReader, int32_t iStt, SArray *aSttBlk);
-int32_t tsdbReadBlockSma(SDataFReader *pReader, SDataBlk *pBlock, SArray *aColumnDataAgg);
+int32_t tsdbReadBlockSma(SDataFReader *pReader, SDataBlk *pBlock, SArray *aColumnDataAgg, SArray *aBlockBloom);
+void    tsdbClearBlockBloom(SArray *aBlockBloom);
 int32_t tsdbReadDataBlock(SDataFReader *pReader, SDataBlk *pBlock, SBlockData *pBlockData);
 int32_t tsdbReadDataBlockEx(SDataFReader *pReader, SDataBlk *pDataBlk, SBlockData *pBlockData);
+int32_t tsdbReadDataBlockCols(SDataFReader *pReader, SDataBlk *pDataBlk, SBlockData *pBlockData, const int16_t *aCid,
+                              int32_t nCid);
+int32_t tsdbReadDataBlockRest(SDataFReader *pReader, SDataBlk *pDataBlk, SBlockData *pBlockData);
 int32_t tsdbReadSttBlock(SDataFReader *pReader, int32_t iStt, SSttBlk *pSttBlk, SBlockData *pBlockData);
 int32_t tsdbReadSttBlockEx(SDataFReader *pReader, int32_t iStt, SSttBlk *pSttBlk, SBlockData *pBlockData);
 // SDelFWriter
@@ -299,8 +315,39 @@ int32_t tsdbReadDelIdx(SDelFReader *pReader, SArray *aDelIdx);
 // tsdbRead.c ==============================================================================================
 int32_t tsdbTakeReadSnap(STsdbReader *pReader, _query_reseek_func_t reseek, STsdbReadSnap **ppSnap);
 void    tsdbUntakeReadSnap(STsdbReader *pReader, STsdbReadSnap *pSnap, bool proactive);
+bool    tsdbColCopiedInPass(const int16_t *pPartialColIds, int32_t numOfPartialCols, bool restPass, int16_t cid);
+bool    tsdbBlockCoveredByDelSkyline(const SArray *pSkyline, const SDataBlk *pBlock, const SVersionRange *pVerRange);
 // tsdbMerge.c ==============================================================================================
 int32_t tsdbMerge(STsdb *pTsdb);
+// tsdbRetention.c ==============================================================================================
+int32_t tsdbPrepareRetention(STsdb *pTsdb, int64_t now, int64_t commitID, SArray **paRFSet);
+int32_t tsdbDoRetention(STsdb *pTsdb, int64_t now, SArray *aRFSet);
+void    tsdbClearRetention(STsdb *pTsdb, SArray *aRFSet, bool committed);
+int32_t tsdbCommitRetention(STsdb *pTsdb);
+// tsdbSnapshot.c ==============================================================================================
+enum {
+  TSDB_SNAP_FILE_HEAD = 0,
+  TSDB_SNAP_FILE_DATA,
+  TSDB_SNAP_FILE_SMA,
+  TSDB_SNAP_FILE_STT,  // TSDB_SNAP_FILE_STT + iStt
+};
+
+// header of a SNAP_DATA_TSDB_FILE message, followed by cSize bytes of the file
+typedef struct {
+  int32_t  fid;
+  int32_t  szPage;
+  int8_t   nSttF;
+  int8_t   fIdx;     // TSDB_SNAP_FILE_*
+  int64_t  size;     // logic size recorded in the file set
+  int64_t  offset;   // logic offset recorded in the file set, for head and stt files
+  int64_t  fSize;    // physical size of the file
+  int64_t  cOffset;  // physical offset of the chunk
+  int32_t  cSize;
+  uint32_t cksum;
+} STsdbSnapFileChunk;
+
+int32_t tPutSnapFileChunk(uint8_t *p, STsdbSnapFileChunk *pChunk);
+int32_t tGetSnapFileChunk(uint8_t *p, STsdbSnapFileChunk *pChunk);
 
 #define TSDB_CACHE_NO(c)       ((c).cacheLast == 0)
 #define TSDB_CACHE_LAST_ROW(c) (((c).cacheLast & 1) > 0)
@@ -353,6 +400,13 @@ struct STsdb {
   TdThreadMutex  lruMutex;
   SLRUCache     *biCache;
   TdThreadMutex  biMutex;
+  SLRUCache     *dsCache;  // delete skylines of the del file, keyed by uid and del file commit ID
+  TdThreadMutex  dsMutex;
+  int8_t         cacheLoading;   // persisted last cache is being loaded in background
+  int8_t         cacheLoadStop;
+  SHashObj      *pCacheTouched;  // uids written since the load started, their persisted entries are stale
+  TdThreadMutex  cacheLoadMutex;
+  TdThreadCond   cacheLoadCond;  // signaled when the load ends
 };
 
 struct TSDBKEY {
@@ -441,6 +495,20 @@ struct SMapData {
   uint8_t *pData;
 };
 
+// SDiskDataHdr.fmtVer, a block is written with the lowest version able to read it
+#define TSDB_DISK_DATA_FMT_VER_PLAIN 0
+#define TSDB_DISK_DATA_FMT_VER_DICT  1  // SBlockCol.encode is saved in the high bits of the flag byte
+#define TSDB_DISK_DATA_FMT_VER_CMPR  2  // SBlockCol.cmprAlg follows the flag byte when its top bit is set
+#define TSDB_DISK_DATA_FMT_VER       TSDB_DISK_DATA_FMT_VER_CMPR
+
+// SBlockCol.encode, saved in the high bits of the flag byte
+#define TSDB_COL_ENCODE_PLAIN ((int8_t)0x0)
+#define TSDB_COL_ENCODE_DICT  ((int8_t)0x1)  // variant data type only: offset part holds codes, value part the dictionary
+
+// SBlockCol.cmprAlg, 0 means the column follows SDiskDataHdr.cmprAlg
+#define TSDB_COL_CMPR_ALG_SET(alg)           ((int8_t)((alg) + 1))
+#define TSDB_COL_CMPR_ALG(pBlockCol, blkAlg) ((pBlockCol)->cmprAlg ? ((pBlockCol)->cmprAlg - 1) : (blkAlg))
+
 struct SBlockCol {
   int16_t cid;
   int8_t  type;
@@ -451,6 +519,8 @@ struct SBlockCol {
   int32_t szOffset;  // offset size, 0 only for non-variant-length type
   int32_t szValue;   // value size, 0 when flag == (HAS_NULL | HAS_NONE)
   int32_t offset;
+  int8_t  encode;    // TSDB_COL_ENCODE_PLAIN|TSDB_COL_ENCODE_DICT
+  int8_t  cmprAlg;   // compression algorithm chosen for this column, see TSDB_COL_CMPR_ALG
 };
 
 struct SBlockInfo {
@@ -464,6 +534,11 @@ struct SSmaInfo {
   int32_t size;
 };
 
+struct SBlockBloom {
+  int16_t       cid;
+  SBloomFilter *pBF;
+};
+
 struct SBlkInfo {
   int64_t minUid;
   int64_t maxUid;
@@ -541,6 +616,12 @@ struct SDelIdx {
   int64_t  size;
 };
 
+// tombstones of a table in one version of the del file, cached with the skyline built from them
+struct SDelSkyline {
+  SArray *aDelData;  // SArray<SDelData>
+  SArray *aSkyline;  // SArray<TSDBKEY>
+};
+
 struct SDiskDataHdr {
   uint32_t delimiter;
   uint32_t fmtVer;
@@ -683,6 +764,7 @@ typedef struct SSttBlockLoadInfo {
   int32_t    blockIndex[2];  // to denote the loaded block in the corresponding position.
   int32_t    currentLoadBlockIndex;
   int32_t    loadBlocks;
+  int32_t    cacheHits;  // requests answered by the two loaded block buffers
   double     elapsedTime;
   STSchema  *pSchema;
   int16_t   *colIds;
@@ -721,6 +803,7 @@ struct SDiskCol {
   const uint8_t *pOff;
   const uint8_t *pVal;
   SColumnDataAgg agg;
+  SBloomFilter  *pBF;  // owned by the builder, NULL if the column has no bloom filter
 };
 
 struct SDiskData {
@@ -758,7 +841,7 @@ void    tMergeTreeClose(SMergeTree *pMTree);
 
 SSttBlockLoadInfo *tCreateLastBlockLoadInfo(STSchema *pSchema, int16_t *colList, int32_t numOfCols, int32_t numOfStt);
 void               resetLastBlockLoadInfo(SSttBlockLoadInfo *pLoadInfo);
-void               getLastBlockLoadInfo(SSttBlockLoadInfo *pLoadInfo, int64_t *blocks, double *el);
+void               getLastBlockLoadInfo(SSttBlockLoadInfo *pLoadInfo, int64_t *blocks, int64_t *hits, double *el);
 void              *destroyLastBlockLoadInfo(SSttBlockLoadInfo *pLoadInfo);
 
 // tsdbCache ==============================================================================================
@@ -801,9 +884,19 @@ int32_t tsdbCacheRelease(SLRUCache *pCache, LRUHandle *h);
 int32_t tsdbCacheGetBlockIdx(SLRUCache *pCache, SDataFReader *pFileReader, LRUHandle **handle);
 int32_t tsdbBICacheRelease(SLRUCache *pCache, LRUHandle *h);
 
+int32_t tsdbCacheGetDelSkyline(SLRUCache *pCache, STsdb *pTsdb, SDelFReader *pDelFReader, int64_t commitID,
+                               SDelIdx *pDelIdx, LRUHandle **handle);
+int32_t tsdbDSCacheRelease(SLRUCache *pCache, LRUHandle *h);
+
 int32_t tsdbCacheDeleteLastrow(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
 int32_t tsdbCacheDeleteLast(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
 int32_t tsdbCacheDelete(SLRUCache *pCache, tb_uid_t uid, TSKEY eKey);
+void    tsdbCacheTouch(STsdb *pTsdb, tb_uid_t uid);
+int32_t tsdbCacheDump(STsdb *pTsdb);
+int32_t tsdbCacheLoad(STsdb *pTsdb);
+void    tsdbCacheStopLoad(STsdb *pTsdb);
+int32_t tPutLastCacheEntry(uint8_t *p, uint64_t key, SArray *pLast);
+int32_t tGetLastCacheEntry(uint8_t *p, uint64_t *key, SArray **ppLast);
 
 void   tsdbCacheSetCapacity(SVnode *pVnode, size_t capacity);
 size_t tsdbCacheGetCapacity(SVnode *pVnode);
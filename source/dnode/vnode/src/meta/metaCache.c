@@ -18,6 +18,10 @@
 #define META_CACHE_BASE_BUCKET  1024
 #define META_CACHE_STATS_BUCKET 16
 
+// a tag column is not indexed by bitmap once it holds more distinct values than this
+#define META_TAG_BITMAP_MAX_CARD 64
+#define META_TAG_BITMAP_MIN_CAP  1024
+
 // (uid , suid) : child table
 // (uid,     0) : normal table
 // (suid, suid) : super table
@@ -32,6 +36,29 @@ typedef struct SMetaStbStatsEntry {
   SMetaStbStats              info;
 } SMetaStbStatsEntry;
 
+// bitmap of child tables per distinct value of a low-cardinality tag column
+typedef struct STagBitmapCol {
+  int16_t   cid;
+  int8_t    disabled;  // too many distinct values or json tag, fall back to tag scan
+  SHashObj* pVals;     // tag value -> uint8_t* bitmap over the slots of STagBitmapIdx
+} STagBitmapCol;
+
+// each child table of a super table is given a slot, which is its bit position in the bitmaps
+typedef struct STagBitmapIdx {
+  int32_t   nSlot;  // number of slots ever allocated, including the freed ones
+  int32_t   nCap;   // capacity of each bitmap, in bits
+  SArray*   aUid;   // slot -> uid, 0 for a freed slot
+  SArray*   aFree;  // freed slots, reused by later created child tables
+  SHashObj* pSlot;  // uid -> slot
+  SHashObj* pCols;  // cid -> STagBitmapCol*
+} STagBitmapIdx;
+
+struct SMetaTagBitmapReader {
+  SMeta*         pMeta;
+  STagBitmapIdx* pIdx;
+  char*          pKeyBuf;  // readers share the cache lock, so each of them builds the value key in its own buffer
+};
+
 typedef struct STagFilterResEntry {
   SList    list;      // the linked list of md5 digest, extracted from the serialized tag query condition
   uint32_t hitTimes;  // queried times for current super table
@@ -59,6 +86,13 @@ struct SMetaCache {
     SHashObj*     pTableEntry;
     SLRUCache*    pUidResCache;
   } sTagFilterResCache;
+
+  // tag bitmap index
+  struct STagBitmapCache {
+    TdThreadRwlock lock;     // read locked by the readers, write locked to build or update the bitmaps
+    SHashObj*      pIdx;     // suid -> STagBitmapIdx*
+    char*          pKeyBuf;  // buffer to build the value key, protected by the write lock
+  } sTagBitmapCache;
 };
 
 static void entryCacheClose(SMeta* pMeta) {
@@ -97,6 +131,10 @@ static void freeCacheEntryFp(void* param) {
   taosMemoryFreeClear(*p);
 }
 
+static void tagBitmapIdxDestroy(STagBitmapIdx* pIdx);
+
+static void freeTagBitmapIdxFp(void* param) { tagBitmapIdxDestroy(*(STagBitmapIdx**)param); }
+
 int32_t metaCacheOpen(SMeta* pMeta) {
   int32_t     code = 0;
   SMetaCache* pCache = NULL;
@@ -144,6 +182,17 @@ int32_t metaCacheOpen(SMeta* pMeta) {
   taosHashSetFreeFp(pCache->sTagFilterResCache.pTableEntry, freeCacheEntryFp);
   taosThreadMutexInit(&pCache->sTagFilterResCache.lock, NULL);
 
+  pCache->sTagBitmapCache.pKeyBuf = NULL;
+  pCache->sTagBitmapCache.pIdx =
+      taosHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
+  if (pCache->sTagBitmapCache.pIdx == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err2;
+  }
+
+  taosHashSetFreeFp(pCache->sTagBitmapCache.pIdx, freeTagBitmapIdxFp);
+  taosThreadRwlockInit(&pCache->sTagBitmapCache.lock, NULL);
+
   pMeta->pCache = pCache;
   return code;
 
@@ -165,6 +214,10 @@ void metaCacheClose(SMeta* pMeta) {
     taosThreadMutexDestroy(&pMeta->pCache->sTagFilterResCache.lock);
     taosHashCleanup(pMeta->pCache->sTagFilterResCache.pTableEntry);
 
+    taosThreadRwlockDestroy(&pMeta->pCache->sTagBitmapCache.lock);
+    taosHashCleanup(pMeta->pCache->sTagBitmapCache.pIdx);
+    taosMemoryFree(pMeta->pCache->sTagBitmapCache.pKeyBuf);
+
     taosMemoryFree(pMeta->pCache);
     pMeta->pCache = NULL;
   }
@@ -670,3 +723,548 @@ int32_t metaUidCacheClear(SMeta* pMeta, uint64_t suid) {
   metaDebug("vgId:%d suid:%"PRId64" cached related tag filter uid list cleared", vgId, suid);
   return TSDB_CODE_SUCCESS;
 }
+
+// tag bitmap index ==================
+#define TAG_BITMAP_SET(_b, _i)   ((_b)[(_i) >> 3] |= (uint8_t)(1u << ((_i)&7)))
+#define TAG_BITMAP_UNSET(_b, _i) ((_b)[(_i) >> 3] &= (uint8_t)(~(1u << ((_i)&7))))
+#define TAG_BITMAP_GET(_b, _i)   (((_b)[(_i) >> 3] >> ((_i)&7)) & 1)
+
+static void freeTagBitmapFp(void* param) { taosMemoryFree(*(uint8_t**)param); }
+
+static void tagBitmapColDestroy(STagBitmapCol* pCol) {
+  if (pCol == NULL) {
+    return;
+  }
+
+  taosHashCleanup(pCol->pVals);
+  taosMemoryFree(pCol);
+}
+
+static void freeTagBitmapColFp(void* param) { tagBitmapColDestroy(*(STagBitmapCol**)param); }
+
+static void tagBitmapIdxDestroy(STagBitmapIdx* pIdx) {
+  if (pIdx == NULL) {
+    return;
+  }
+
+  taosArrayDestroy(pIdx->aUid);
+  taosArrayDestroy(pIdx->aFree);
+  taosHashCleanup(pIdx->pSlot);
+  taosHashCleanup(pIdx->pCols);
+  taosMemoryFree(pIdx);
+}
+
+static STagBitmapIdx* tagBitmapIdxCreate() {
+  STagBitmapIdx* pIdx = taosMemoryCalloc(1, sizeof(STagBitmapIdx));
+  if (pIdx == NULL) {
+    return NULL;
+  }
+
+  pIdx->nCap = META_TAG_BITMAP_MIN_CAP;
+  pIdx->aUid = taosArrayInit(META_TAG_BITMAP_MIN_CAP, sizeof(tb_uid_t));
+  pIdx->aFree = taosArrayInit(16, sizeof(int32_t));
+  pIdx->pSlot =
+      taosHashInit(META_TAG_BITMAP_MIN_CAP, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
+  pIdx->pCols = taosHashInit(8, taosGetDefaultHashFunction(TSDB_DATA_TYPE_SMALLINT), false, HASH_NO_LOCK);
+  if (pIdx->aUid == NULL || pIdx->aFree == NULL || pIdx->pSlot == NULL || pIdx->pCols == NULL) {
+    tagBitmapIdxDestroy(pIdx);
+    return NULL;
+  }
+
+  taosHashSetFreeFp(pIdx->pCols, freeTagBitmapColFp);
+  return pIdx;
+}
+
+static STagBitmapCol* tagBitmapColCreate(int16_t cid) {
+  STagBitmapCol* pCol = taosMemoryCalloc(1, sizeof(STagBitmapCol));
+  if (pCol == NULL) {
+    return NULL;
+  }
+
+  pCol->cid = cid;
+  pCol->pVals = taosHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_VARCHAR), false, HASH_NO_LOCK);
+  if (pCol->pVals == NULL) {
+    taosMemoryFree(pCol);
+    return NULL;
+  }
+
+  taosHashSetFreeFp(pCol->pVals, freeTagBitmapFp);
+  return pCol;
+}
+
+// the format of key: type(1byte) + value. All integer types are keyed as bigint, unless the unsigned value is out of
+// the range of bigint, so that a tag of any integer type is matched by a constant of another integer type.
+static int32_t tagBitmapKey(char** ppBuf, const STagVal* pVal, char** ppKey) {
+  if (*ppBuf == NULL) {
+    *ppBuf = taosMemoryMalloc(TSDB_MAX_TAGS_LEN + sizeof(int64_t) + 1);
+    if (*ppBuf == NULL) {
+      return -1;
+    }
+  }
+
+  char* pKey = *ppBuf;
+  pKey[0] = pVal->type;
+  *ppKey = pKey;
+
+  if (IS_VAR_DATA_TYPE(pVal->type)) {
+    if (pVal->nData > TSDB_MAX_TAGS_LEN) {
+      return -1;
+    }
+    memcpy(pKey + 1, pVal->pData, pVal->nData);
+    return pVal->nData + 1;
+  } else if (IS_SIGNED_NUMERIC_TYPE(pVal->type)) {
+    int64_t v = 0;
+    GET_TYPED_DATA(v, int64_t, pVal->type, &pVal->i64);
+    pKey[0] = TSDB_DATA_TYPE_BIGINT;
+    memcpy(pKey + 1, &v, sizeof(int64_t));
+    return sizeof(int64_t) + 1;
+  } else if (IS_UNSIGNED_NUMERIC_TYPE(pVal->type)) {
+    uint64_t v = 0;
+    GET_TYPED_DATA(v, uint64_t, pVal->type, &pVal->i64);
+    pKey[0] = (v > INT64_MAX) ? TSDB_DATA_TYPE_UBIGINT : TSDB_DATA_TYPE_BIGINT;
+    memcpy(pKey + 1, &v, sizeof(uint64_t));
+    return sizeof(uint64_t) + 1;
+  } else {
+    memcpy(pKey + 1, &pVal->i64, tDataTypes[pVal->type].bytes);
+    return tDataTypes[pVal->type].bytes + 1;
+  }
+}
+
+static int32_t tagBitmapIdxEnsureCap(STagBitmapIdx* pIdx, int32_t nSlot) {
+  if (nSlot <= pIdx->nCap) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t nCap = pIdx->nCap * 2;
+  while (nCap < nSlot) {
+    nCap *= 2;
+  }
+
+  void* pIter = taosHashIterate(pIdx->pCols, NULL);
+  while (pIter) {
+    STagBitmapCol* pCol = *(STagBitmapCol**)pIter;
+
+    void* pValIter = taosHashIterate(pCol->pVals, NULL);
+    while (pValIter) {
+      uint8_t* pBits = taosMemoryRealloc(*(uint8_t**)pValIter, nCap / 8);
+      if (pBits == NULL) {
+        taosHashCancelIterate(pCol->pVals, pValIter);
+        taosHashCancelIterate(pIdx->pCols, pIter);
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+
+      memset(pBits + pIdx->nCap / 8, 0, (nCap - pIdx->nCap) / 8);
+      *(uint8_t**)pValIter = pBits;
+      pValIter = taosHashIterate(pCol->pVals, pValIter);
+    }
+
+    pIter = taosHashIterate(pIdx->pCols, pIter);
+  }
+
+  pIdx->nCap = nCap;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t tagBitmapIdxGetSlot(STagBitmapIdx* pIdx, tb_uid_t uid, int32_t* pSlot) {
+  int32_t* p = taosHashGet(pIdx->pSlot, &uid, sizeof(tb_uid_t));
+  if (p != NULL) {
+    *pSlot = *p;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t slot = 0;
+  if (taosArrayGetSize(pIdx->aFree) > 0) {
+    slot = *(int32_t*)taosArrayPop(pIdx->aFree);
+    *(tb_uid_t*)taosArrayGet(pIdx->aUid, slot) = uid;
+  } else {
+    int32_t code = tagBitmapIdxEnsureCap(pIdx, pIdx->nSlot + 1);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    if (taosArrayPush(pIdx->aUid, &uid) == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    slot = pIdx->nSlot++;
+  }
+
+  if (taosHashPut(pIdx->pSlot, &uid, sizeof(tb_uid_t), &slot, sizeof(int32_t)) != 0) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  *pSlot = slot;
+  return TSDB_CODE_SUCCESS;
+}
+
+static void tagBitmapColUnset(STagBitmapCol* pCol, int32_t slot) {
+  void* pIter = taosHashIterate(pCol->pVals, NULL);
+  while (pIter) {
+    TAG_BITMAP_UNSET(*(uint8_t**)pIter, slot);
+    pIter = taosHashIterate(pCol->pVals, pIter);
+  }
+}
+
+static int32_t tagBitmapColSet(SMetaCache* pCache, STagBitmapIdx* pIdx, STagBitmapCol* pCol, const STag* pTag,
+                               int32_t slot) {
+  if (pCol->disabled) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (tTagIsJson(pTag)) {
+    taosHashClear(pCol->pVals);
+    pCol->disabled = 1;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  // a null tag value never matches an equality predicate, nothing to set
+  STagVal val = {.cid = pCol->cid};
+  if (!tTagGet(pTag, &val)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  char*   pKey = NULL;
+  int32_t keyLen = tagBitmapKey(&pCache->sTagBitmapCache.pKeyBuf, &val, &pKey);
+  if (keyLen < 0) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  uint8_t** ppBits = taosHashGet(pCol->pVals, pKey, keyLen);
+  if (ppBits == NULL) {
+    if (taosHashGetSize(pCol->pVals) >= META_TAG_BITMAP_MAX_CARD) {
+      taosHashClear(pCol->pVals);
+      pCol->disabled = 1;
+      return TSDB_CODE_SUCCESS;
+    }
+
+    uint8_t* pBits = taosMemoryCalloc(1, pIdx->nCap / 8);
+    if (pBits == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    if (taosHashPut(pCol->pVals, pKey, keyLen, &pBits, POINTER_BYTES) != 0) {
+      taosMemoryFree(pBits);
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    ppBits = taosHashGet(pCol->pVals, pKey, keyLen);
+  }
+
+  TAG_BITMAP_SET(*ppBits, slot);
+  return TSDB_CODE_SUCCESS;
+}
+
+// scan all child tables of the super table to fill the bitmaps of the newly added tag columns, the meta read lock
+// is held by the caller
+static int32_t tagBitmapIdxBuild(SMeta* pMeta, tb_uid_t suid, STagBitmapIdx* pIdx, SArray* pNewCols) {
+  int32_t code = TSDB_CODE_SUCCESS;
+  TBC*    pCtbIdxc = NULL;
+  void*   pKey = NULL;
+  int     nKey = 0;
+  void*   pVal = NULL;
+  int     nVal = 0;
+  int     c = 0;
+
+  if (tdbTbcOpen(pMeta->pCtbIdx, &pCtbIdxc, NULL) < 0) {
+    return TSDB_CODE_FAILED;
+  }
+
+  if (tdbTbcMoveTo(pCtbIdxc, &(SCtbIdxKey){.suid = suid, .uid = INT64_MIN}, sizeof(SCtbIdxKey), &c) < 0) {
+    code = TSDB_CODE_FAILED;
+    goto _exit;
+  }
+
+  while (tdbTbcNext(pCtbIdxc, &pKey, &nKey, &pVal, &nVal) >= 0) {
+    SCtbIdxKey* pCtbIdxKey = pKey;
+    if (pCtbIdxKey->suid < suid) {
+      continue;
+    } else if (pCtbIdxKey->suid > suid) {
+      break;
+    }
+
+    int32_t slot = 0;
+    code = tagBitmapIdxGetSlot(pIdx, pCtbIdxKey->uid, &slot);
+    if (code != TSDB_CODE_SUCCESS) {
+      goto _exit;
+    }
+
+    for (int32_t i = 0; i < taosArrayGetSize(pNewCols); ++i) {
+      STagBitmapCol* pCol = *(STagBitmapCol**)taosArrayGet(pNewCols, i);
+      code = tagBitmapColSet(pMeta->pCache, pIdx, pCol, pVal, slot);
+      if (code != TSDB_CODE_SUCCESS) {
+        goto _exit;
+      }
+    }
+  }
+
+_exit:
+  tdbFree(pKey);
+  tdbFree(pVal);
+  tdbTbcClose(pCtbIdxc);
+  return code;
+}
+
+// check if all the columns are indexed and usable, with the cache lock held
+static bool tagBitmapIdxCovers(STagBitmapIdx* pIdx, const SArray* pCids) {
+  for (int32_t i = 0; i < taosArrayGetSize(pCids); ++i) {
+    int16_t         cid = *(int16_t*)taosArrayGet(pCids, i);
+    STagBitmapCol** ppCol = taosHashGet(pIdx->pCols, &cid, sizeof(int16_t));
+    if (ppCol == NULL || (*ppCol)->disabled) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// build the bitmaps of the columns not indexed yet, with the meta read lock and the cache write lock held
+static int32_t tagBitmapIdxPrepare(SMeta* pMeta, tb_uid_t suid, const SArray* pCids) {
+  int32_t        code = TSDB_CODE_SUCCESS;
+  SArray*        pNewCols = NULL;
+  STagBitmapIdx* pIdx = NULL;
+  SHashObj*      pIdxMap = pMeta->pCache->sTagBitmapCache.pIdx;
+
+  STagBitmapIdx** ppIdx = taosHashGet(pIdxMap, &suid, sizeof(tb_uid_t));
+  if (ppIdx == NULL) {
+    pIdx = tagBitmapIdxCreate();
+    if (pIdx == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+
+    if (taosHashPut(pIdxMap, &suid, sizeof(tb_uid_t), &pIdx, POINTER_BYTES) != 0) {
+      tagBitmapIdxDestroy(pIdx);
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+  } else {
+    pIdx = *ppIdx;
+  }
+
+  pNewCols = taosArrayInit(4, POINTER_BYTES);
+  if (pNewCols == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(pCids); ++i) {
+    int16_t         cid = *(int16_t*)taosArrayGet(pCids, i);
+    STagBitmapCol** ppCol = taosHashGet(pIdx->pCols, &cid, sizeof(int16_t));
+    if (ppCol != NULL) {
+      continue;
+    }
+
+    STagBitmapCol* pCol = tagBitmapColCreate(cid);
+    if (pCol == NULL || taosHashPut(pIdx->pCols, &cid, sizeof(int16_t), &pCol, POINTER_BYTES) != 0) {
+      tagBitmapColDestroy(pCol);
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+    taosArrayPush(pNewCols, &pCol);
+  }
+
+  if (taosArrayGetSize(pNewCols) > 0) {
+    code = tagBitmapIdxBuild(pMeta, suid, pIdx, pNewCols);
+    if (code != TSDB_CODE_SUCCESS) {
+      goto _exit;
+    }
+
+    metaDebug("vgId:%d, suid:%" PRId64 " tag bitmap built for %d columns, tables:%d", TD_VID(pMeta->pVnode), suid,
+              (int32_t)taosArrayGetSize(pNewCols), (int32_t)taosHashGetSize(pIdx->pSlot));
+  }
+
+_exit:
+  // a partially built index is never kept, it is rebuilt by the next query
+  if (code != TSDB_CODE_SUCCESS) {
+    taosHashRemove(pIdxMap, &suid, sizeof(tb_uid_t));
+    metaError("vgId:%d, suid:%" PRId64 " failed to build tag bitmap since %s", TD_VID(pMeta->pVnode), suid,
+              tstrerror(code));
+  }
+
+  taosArrayDestroy(pNewCols);
+  return code;
+}
+
+int32_t metaTagBitmapAcquire(SMeta* pMeta, tb_uid_t suid, const SArray* pCids, SMetaTagBitmapReader** ppReader) {
+  int32_t         code = TSDB_CODE_SUCCESS;
+  TdThreadRwlock* pLock = &pMeta->pCache->sTagBitmapCache.lock;
+
+  *ppReader = NULL;
+  if (!tsTagFilterBitmap) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SMetaTagBitmapReader* pReader = taosMemoryCalloc(1, sizeof(SMetaTagBitmapReader));
+  if (pReader == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  pReader->pMeta = pMeta;
+
+  // fast path, all the columns are indexed already
+  taosThreadRwlockRdlock(pLock);
+  STagBitmapIdx** ppIdx = taosHashGet(pMeta->pCache->sTagBitmapCache.pIdx, &suid, sizeof(tb_uid_t));
+  if (ppIdx != NULL && tagBitmapIdxCovers(*ppIdx, pCids)) {
+    pReader->pIdx = *ppIdx;
+    *ppReader = pReader;
+    return code;
+  }
+  taosThreadRwlockUnlock(pLock);
+
+  // lock order: meta lock first, then the cache lock, the same as the writers. The meta read lock is only needed to
+  // scan the child tables, the bitmaps are kept up to date by the writers under the cache write lock.
+  metaRLock(pMeta);
+  taosThreadRwlockWrlock(pLock);
+  code = tagBitmapIdxPrepare(pMeta, suid, pCids);
+  taosThreadRwlockUnlock(pLock);
+  metaULock(pMeta);
+
+  if (code != TSDB_CODE_SUCCESS) {
+    taosMemoryFree(pReader);
+    return code;
+  }
+
+  // the index may be dropped by a writer in between, the query falls back to tag scan then
+  taosThreadRwlockRdlock(pLock);
+  ppIdx = taosHashGet(pMeta->pCache->sTagBitmapCache.pIdx, &suid, sizeof(tb_uid_t));
+  if (ppIdx == NULL || !tagBitmapIdxCovers(*ppIdx, pCids)) {
+    taosThreadRwlockUnlock(pLock);
+    taosMemoryFree(pReader);
+    return code;
+  }
+
+  // keep the cache read lock until the reader is released
+  pReader->pIdx = *ppIdx;
+  *ppReader = pReader;
+  return code;
+}
+
+void metaTagBitmapRelease(SMetaTagBitmapReader* pReader) {
+  if (pReader == NULL) {
+    return;
+  }
+
+  taosThreadRwlockUnlock(&pReader->pMeta->pCache->sTagBitmapCache.lock);
+  taosMemoryFree(pReader->pKeyBuf);
+  taosMemoryFree(pReader);
+}
+
+int32_t metaTagBitmapBytes(SMetaTagBitmapReader* pReader) { return (pReader->pIdx->nSlot + 7) / 8; }
+
+int32_t metaTagBitmapOrEqual(SMetaTagBitmapReader* pReader, const STagVal* pVal, uint8_t* pBits) {
+  STagBitmapCol** ppCol = taosHashGet(pReader->pIdx->pCols, &pVal->cid, sizeof(int16_t));
+  if (ppCol == NULL || (*ppCol)->disabled) {
+    return TSDB_CODE_FAILED;
+  }
+
+  char*   pKey = NULL;
+  int32_t keyLen = tagBitmapKey(&pReader->pKeyBuf, pVal, &pKey);
+  if (keyLen < 0) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  uint8_t** ppBits = taosHashGet((*ppCol)->pVals, pKey, keyLen);
+  if (ppBits == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t len = metaTagBitmapBytes(pReader);
+  for (int32_t i = 0; i < len; ++i) {
+    pBits[i] |= (*ppBits)[i];
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t metaTagBitmapToUidList(SMetaTagBitmapReader* pReader, const uint8_t* pBits, SArray* pUidList) {
+  STagBitmapIdx* pIdx = pReader->pIdx;
+
+  for (int32_t slot = 0; slot < pIdx->nSlot; ++slot) {
+    if (TAG_BITMAP_GET(pBits, slot)) {
+      if (taosArrayPush(pUidList, taosArrayGet(pIdx->aUid, slot)) == NULL) {
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// update the bitmaps of an indexed super table when a child table is created or its tags are altered
+void metaTagBitmapUpsert(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid, const STag* pTag) {
+  int32_t         code = TSDB_CODE_SUCCESS;
+  TdThreadRwlock* pLock = &pMeta->pCache->sTagBitmapCache.lock;
+
+  taosThreadRwlockWrlock(pLock);
+
+  STagBitmapIdx** ppIdx = taosHashGet(pMeta->pCache->sTagBitmapCache.pIdx, &suid, sizeof(tb_uid_t));
+  if (ppIdx == NULL) {
+    taosThreadRwlockUnlock(pLock);
+    return;
+  }
+
+  STagBitmapIdx* pIdx = *ppIdx;
+  int32_t        slot = 0;
+
+  code = tagBitmapIdxGetSlot(pIdx, uid, &slot);
+  if (code == TSDB_CODE_SUCCESS) {
+    void* pIter = taosHashIterate(pIdx->pCols, NULL);
+    while (pIter) {
+      STagBitmapCol* pCol = *(STagBitmapCol**)pIter;
+
+      tagBitmapColUnset(pCol, slot);
+      code = tagBitmapColSet(pMeta->pCache, pIdx, pCol, pTag, slot);
+      if (code != TSDB_CODE_SUCCESS) {
+        taosHashCancelIterate(pIdx->pCols, pIter);
+        break;
+      }
+
+      pIter = taosHashIterate(pIdx->pCols, pIter);
+    }
+  }
+
+  // the index is rebuilt by the next query
+  if (code != TSDB_CODE_SUCCESS) {
+    taosHashRemove(pMeta->pCache->sTagBitmapCache.pIdx, &suid, sizeof(tb_uid_t));
+    metaWarn("vgId:%d, suid:%" PRId64 " tag bitmap dropped since %s", TD_VID(pMeta->pVnode), suid, tstrerror(code));
+  }
+
+  taosThreadRwlockUnlock(pLock);
+}
+
+void metaTagBitmapRemove(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid) {
+  TdThreadRwlock* pLock = &pMeta->pCache->sTagBitmapCache.lock;
+
+  taosThreadRwlockWrlock(pLock);
+
+  STagBitmapIdx** ppIdx = taosHashGet(pMeta->pCache->sTagBitmapCache.pIdx, &suid, sizeof(tb_uid_t));
+  if (ppIdx == NULL) {
+    taosThreadRwlockUnlock(pLock);
+    return;
+  }
+
+  STagBitmapIdx* pIdx = *ppIdx;
+  int32_t*       pSlot = taosHashGet(pIdx->pSlot, &uid, sizeof(tb_uid_t));
+  if (pSlot != NULL) {
+    int32_t slot = *pSlot;
+
+    void* pIter = taosHashIterate(pIdx->pCols, NULL);
+    while (pIter) {
+      tagBitmapColUnset(*(STagBitmapCol**)pIter, slot);
+      pIter = taosHashIterate(pIdx->pCols, pIter);
+    }
+
+    *(tb_uid_t*)taosArrayGet(pIdx->aUid, slot) = 0;
+    taosArrayPush(pIdx->aFree, &slot);
+    taosHashRemove(pIdx->pSlot, &uid, sizeof(tb_uid_t));
+  }
+
+  taosThreadRwlockUnlock(pLock);
+}
+
+// drop the whole index when the super table is dropped or its tag schema is altered
+void metaTagBitmapClear(SMeta* pMeta, tb_uid_t suid) {
+  TdThreadRwlock* pLock = &pMeta->pCache->sTagBitmapCache.lock;
+
+  taosThreadRwlockWrlock(pLock);
+  taosHashRemove(pMeta->pCache->sTagBitmapCache.pIdx, &suid, sizeof(tb_uid_t));
+  taosThreadRwlockUnlock(pLock);
+}
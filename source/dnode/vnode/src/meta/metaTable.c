@@ -386,6 +386,8 @@ int metaAlterSTable(SMeta *pMeta, int64_t version, SVCreateStbReq *pReq) {
 
   // metaStatsCacheDrop(pMeta, nStbEntry.uid);
 
+  metaTagBitmapClear(pMeta, nStbEntry.uid);
+
   metaULock(pMeta);
 
   if (oStbEntry.pBuf) taosMemoryFree(oStbEntry.pBuf);
@@ -999,6 +1001,7 @@ static int metaDropTableByUid(SMeta *pMeta, tb_uid_t uid, int *type) {
 
     metaUpdateStbStats(pMeta, e.ctbEntry.suid, -1);
     metaUidCacheClear(pMeta, e.ctbEntry.suid);
+    metaTagBitmapRemove(pMeta, e.ctbEntry.suid, uid);
   } else if (e.type == TSDB_NORMAL_TABLE) {
     // drop schema.db (todo)
 
@@ -1010,6 +1013,7 @@ static int metaDropTableByUid(SMeta *pMeta, tb_uid_t uid, int *type) {
 
     metaStatsCacheDrop(pMeta, uid);
     metaUidCacheClear(pMeta, uid);
+    metaTagBitmapClear(pMeta, uid);
     --pMeta->pVnode->config.vndStats.numOfSTables;
   }
 
@@ -1430,6 +1434,7 @@ static int metaUpdateTableTagVal(SMeta *pMeta, int64_t version, SVAlterTbReq *pA
               ((STag *)(ctbEntry.ctbEntry.pTags))->len, pMeta->txn);
 
   metaUidCacheClear(pMeta, ctbEntry.ctbEntry.suid);
+  metaTagBitmapUpsert(pMeta, ctbEntry.ctbEntry.suid, uid, (const STag *)ctbEntry.ctbEntry.pTags);
 
   metaULock(pMeta);
 
@@ -2082,6 +2087,8 @@ int metaHandleEntry(SMeta *pMeta, const SMetaEntry *pME) {
 
     // update tag.idx
     if (metaUpdateTagIdx(pMeta, pME) < 0) goto _err;
+
+    metaTagBitmapUpsert(pMeta, pME->ctbEntry.suid, pME->uid, (const STag *)pME->ctbEntry.pTags);
   } else {
     // update schema.db
     if (metaSaveToSkmDb(pMeta, pME) < 0) goto _err;
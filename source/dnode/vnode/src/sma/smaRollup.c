@@ -611,7 +611,7 @@ int32_t smaDoRetention(SSma *pSma, int64_t now) {
 
   for (int32_t i = 0; i < TSDB_RETENTION_L2; ++i) {
     if (pSma->pRSmaTsdb[i]) {
-      code = tsdbDoRetention(pSma->pRSmaTsdb[i], now);
+      code = tsdbDoRetention(pSma->pRSmaTsdb[i], now, NULL);
       if (code) goto _end;
     }
   }
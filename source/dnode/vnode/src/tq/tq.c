@@ -15,6 +15,8 @@
 
 #include "tq.h"
 
+static void tqFreeImpl(void* param) { taosMemoryFree(param); }
+
 int32_t tqInit() {
   int8_t old;
   while (1) {
@@ -28,6 +30,12 @@ int32_t tqInit() {
       atomic_store_8(&tqMgmt.inited, 0);
       return -1;
     }
+    tqMgmt.rsetId = taosOpenRef(10000, tqFreeImpl);
+    if (tqMgmt.rsetId < 0) {
+      taosTmrCleanUp(tqMgmt.timer);
+      atomic_store_8(&tqMgmt.inited, 0);
+      return -1;
+    }
     if (streamInit() < 0) {
       return -1;
     }
@@ -46,11 +54,67 @@ void tqCleanUp() {
 
   if (old == 1) {
     taosTmrCleanUp(tqMgmt.timer);
+    taosCloseRef(tqMgmt.rsetId);
     streamCleanUp();
     atomic_store_8(&tqMgmt.inited, 0);
   }
 }
 
+#define TQ_PUSH_CHECK_INTERVAL 100  // ms
+
+// the param is the ref id of the tq, a callback already running when the tq is closed keeps it alive by the ref
+static void tqPushTimerFp(void* param, void* tmrId) {
+  int64_t refId = *(int64_t*)param;
+  STQ*    pTq = taosAcquireRef(tqMgmt.rsetId, refId);
+  if (pTq == NULL) {
+    taosMemoryFree(param);
+    return;
+  }
+
+  tqExpirePushEntry(pTq, taosGetTimestampMs());
+  if (atomic_load_8(&pTq->closing)) {
+    taosMemoryFree(param);
+  } else {
+    taosTmrReset(tqPushTimerFp, TQ_PUSH_CHECK_INTERVAL, param, tqMgmt.timer, &pTq->pushTimer);
+  }
+
+  taosReleaseRef(tqMgmt.rsetId, refId);
+}
+
+int32_t tqStartPushTimer(STQ* pTq) {
+  pTq->refId = taosAddRef(tqMgmt.rsetId, pTq);
+  if (pTq->refId < 0) {
+    return -1;
+  }
+
+  int64_t* pRefId = taosMemoryMalloc(sizeof(int64_t));
+  if (pRefId == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+  *pRefId = pTq->refId;
+
+  pTq->pushTimer = taosTmrStart(tqPushTimerFp, TQ_PUSH_CHECK_INTERVAL, pRefId, tqMgmt.timer);
+  return 0;
+}
+
+void tqStopPushTimer(STQ* pTq) {
+  // no expire check runs on the push entries after this
+  taosWLockLatch(&pTq->pushLock);
+  atomic_store_8(&pTq->closing, 1);
+  taosWUnLockLatch(&pTq->pushLock);
+
+  taosTmrStopA(&pTq->pushTimer);
+}
+
+void tqRemoveRef(STQ* pTq) {
+  if (pTq->refId > 0) {
+    taosRemoveRef(tqMgmt.rsetId, pTq->refId);
+  } else {
+    taosMemoryFree(pTq);
+  }
+}
+
 static void destroySTqHandle(void* data) {
   STqHandle* pData = (STqHandle*)data;
   qDestroyTask(pData->execHandle.task);
@@ -98,6 +162,12 @@ STQ* tqOpen(const char* path, SVnode* pVnode) {
   pTq->pCheckInfo = taosHashInit(64, MurmurHash3_32, true, HASH_ENTRY_LOCK);
   taosHashSetFreeFp(pTq->pCheckInfo, (FDelete)tDeleteSTqCheckInfo);
 
+  pTq->pRspCache = taosLRUCacheInit(TQ_RSP_CACHE_SIZE, -1, .5);
+  if (pTq->pRspCache == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
   if (tqMetaOpen(pTq) < 0) {
     return NULL;
   }
@@ -112,7 +182,11 @@ STQ* tqOpen(const char* path, SVnode* pVnode) {
     return NULL;
   }
 
-  if (streamLoadTasks(pTq->pStreamMeta, walGetCommittedVer(pVnode->pWal)) < 0) {
+  if (streamLoadTasks(pTq->pStreamMeta, walGetCommittedVer(pVnode->pWal), pVnode->state.committed) < 0) {
+    return NULL;
+  }
+
+  if (tqStartPushTimer(pTq) < 0) {
     return NULL;
   }
 
@@ -124,14 +198,18 @@ void tqClose(STQ* pTq) {
     return;
   }
 
+  tqStopPushTimer(pTq);
+
   tqOffsetClose(pTq->pOffsetStore);
   taosHashCleanup(pTq->pHandle);
   taosHashCleanup(pTq->pPushMgr);
   taosHashCleanup(pTq->pCheckInfo);
+  taosLRUCacheCleanup(pTq->pRspCache);
   taosMemoryFree(pTq->path);
   tqMetaClose(pTq);
   streamMetaClose(pTq->pStreamMeta);
-  taosMemoryFree(pTq);
+  // a running push timer callback may still hold the tq
+  tqRemoveRef(pTq);
 }
 
 int32_t tqSendMetaPollRsp(STQ* pTq, const SRpcMsg* pMsg, const SMqPollReq* pReq, const SMqMetaRsp* pRsp) {
@@ -600,7 +678,7 @@ static int32_t extractDataForMq(STQ* pTq, STqHandle* pHandle, const SMqPollReq*
     taosWLockLatch(&pTq->pushLock);
 
     qSetTaskId(pHandle->execHandle.task, consumerId, pRequest->reqId);
-    code = tqScanData(pTq, pHandle, &dataRsp, &offset);
+    code = tqScanDataCached(pTq, pHandle, &dataRsp, &offset);
 
     // till now, all data has been transferred to consumer, new data needs to push client once arrived.
     if (dataRsp.blockNum == 0 && dataRsp.reqOffset.type == TMQ_OFFSET__LOG &&
@@ -1229,7 +1307,7 @@ int32_t tqProcessTaskRecover1Req(STQ* pTq, SRpcMsg* pMsg) {
 
   // check param
   int64_t fillVer1 = pTask->startVer;
-  if (fillVer1 <= 0) {
+  if (pTask->fillHistory && fillVer1 <= 0) {
     streamMetaReleaseTask(pTq->pStreamMeta, pTask);
     return -1;
   }
@@ -1237,6 +1315,17 @@ int32_t tqProcessTaskRecover1Req(STQ* pTq, SRpcMsg* pMsg) {
   // do recovery step 1
   streamSourceRecoverScanStep1(pTask);
 
+  // replaying the wal tail behind a checkpoint is done in a single scan
+  if (!pTask->fillHistory) {
+    if (atomic_load_8(&pTask->taskStatus) != TASK_STATUS__DROPPING) {
+      streamSourceReplayFinish(pTask);
+      streamSetStatusNormal(pTask);
+      streamSchedExec(pTask);
+    }
+    streamMetaReleaseTask(pTq->pStreamMeta, pTask);
+    return 0;
+  }
+
   if (atomic_load_8(&pTask->taskStatus) == TASK_STATUS__DROPPING) {
     streamMetaReleaseTask(pTq->pStreamMeta, pTask);
     return 0;
@@ -1496,8 +1585,20 @@ int32_t tqProcessSubmitReq(STQ* pTq, SPackedData submit) {
 
     SStreamTask* pTask = *(SStreamTask**)pIter;
     if (pTask->taskLevel != TASK_LEVEL__SOURCE) continue;
+
+    // a task replaying its wal tail keeps the submits behind the replay in the queue until it is done
+    bool replaying = false;
     if (pTask->taskStatus == TASK_STATUS__RECOVER_PREPARE || pTask->taskStatus == TASK_STATUS__WAIT_DOWNSTREAM) {
-      tqDebug("skip push task %d, task status %d", pTask->taskId, pTask->taskStatus);
+      if (pTask->fillHistory || pTask->pState == NULL || streamStateGetReplayVer(pTask->pState) < 0) {
+        tqDebug("skip push task %d, task status %d", pTask->taskId, pTask->taskStatus);
+        continue;
+      }
+      replaying = true;
+    }
+
+    // the submits applied again on restart are in the checkpointed state already
+    if (pTask->pState != NULL && submit.ver <= streamStateGetCheckpointVer(pTask->pState)) {
+      tqDebug("skip push task %d, ver %" PRId64 " in checkpoint", pTask->taskId, submit.ver);
       continue;
     }
 
@@ -1509,7 +1610,7 @@ int32_t tqProcessSubmitReq(STQ* pTq, SPackedData submit) {
         continue;
       }
 
-      if (streamSchedExec(pTask) < 0) {
+      if (!replaying && streamSchedExec(pTask) < 0) {
         tqError("stream task launch failed, task id %d", pTask->taskId);
         continue;
       }
@@ -1569,7 +1670,7 @@ int32_t tqProcessTaskDispatchRsp(STQ* pTq, SRpcMsg* pMsg) {
   SStreamTask*        pTask = streamMetaAcquireTask(pTq->pStreamMeta, taskId);
   tqDebug("recv dispatch rsp, code: %x", pMsg->code);
   if (pTask) {
-    streamProcessDispatchRsp(pTask, pRsp, pMsg->code);
+    streamProcessDispatchRsp(pTask, pRsp, pMsg->contLen - sizeof(SMsgHead), pMsg->code);
     streamMetaReleaseTask(pTq->pStreamMeta, pTask);
     return 0;
   } else {
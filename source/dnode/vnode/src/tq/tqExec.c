@@ -127,6 +127,126 @@ int32_t tqScanData(STQ* pTq, const STqHandle* pHandle, SMqDataRsp* pRsp, STqOffs
   return 0;
 }
 
+// Consumer groups subscribing the same topic run the same query against the same wal, so the encoded result of a
+// log scan starting at a given version is shared between them instead of being decoded and filtered once per group.
+typedef struct {
+  STqOffsetVal rspOffset;
+  int32_t      blockNum;
+  char         data[];  // blockNum * (int32_t len, block)
+} STqCachedRsp;
+
+#define TQ_RSP_CACHE_KEY_LEN (sizeof(int64_t) + sizeof(uint32_t) + TSDB_TOPIC_FNAME_LEN)
+
+static int32_t tqBuildRspCacheKey(const STqHandle* pHandle, int64_t ver, char* key) {
+  const char* qmsg = pHandle->execHandle.execCol.qmsg;
+  const char* topic = strchr(pHandle->subKey, TMQ_SEPARATOR);
+  topic = (topic == NULL) ? pHandle->subKey : topic + 1;
+
+  // the digest of the query keeps a re-created topic with the same name from hitting the stale results
+  uint32_t digest = MurmurHash3_32(qmsg, strlen(qmsg));
+  int32_t  len = TMIN(strlen(topic), TSDB_TOPIC_FNAME_LEN);
+
+  memcpy(key, &ver, sizeof(int64_t));
+  memcpy(key + sizeof(int64_t), &digest, sizeof(uint32_t));
+  memcpy(key + sizeof(int64_t) + sizeof(uint32_t), topic, len);
+  return sizeof(int64_t) + sizeof(uint32_t) + len;
+}
+
+static void tqFreeCachedRsp(const void* key, size_t keyLen, void* value) { taosMemoryFree(value); }
+
+static void tqPutRspCache(STQ* pTq, const char* key, int32_t keyLen, const SMqDataRsp* pRsp) {
+  int32_t size = sizeof(STqCachedRsp);
+  for (int32_t i = 0; i < pRsp->blockNum; i++) {
+    size += sizeof(int32_t) + *(int32_t*)taosArrayGet(pRsp->blockDataLen, i);
+  }
+
+  STqCachedRsp* pCached = taosMemoryMalloc(size);
+  if (pCached == NULL) {
+    return;
+  }
+
+  pCached->rspOffset = pRsp->rspOffset;
+  pCached->blockNum = pRsp->blockNum;
+
+  char* p = pCached->data;
+  for (int32_t i = 0; i < pRsp->blockNum; i++) {
+    int32_t len = *(int32_t*)taosArrayGet(pRsp->blockDataLen, i);
+    memcpy(p, &len, sizeof(int32_t));
+    memcpy(p + sizeof(int32_t), *(void**)taosArrayGet(pRsp->blockData, i), len);
+    p += sizeof(int32_t) + len;
+  }
+
+  if (taosLRUCacheInsert(pTq->pRspCache, key, keyLen, pCached, size, tqFreeCachedRsp, NULL, TAOS_LRU_PRIORITY_LOW) !=
+      TAOS_LRU_STATUS_OK) {
+    tqDebug("vgId:%d, failed to cache rsp of ver:%" PRId64, pTq->pVnode->config.vgId, pRsp->reqOffset.version);
+  }
+}
+
+static bool tqGetRspCache(STQ* pTq, const char* key, int32_t keyLen, SMqDataRsp* pRsp) {
+  LRUHandle* h = taosLRUCacheLookup(pTq->pRspCache, key, keyLen);
+  if (h == NULL) {
+    return false;
+  }
+
+  const STqCachedRsp* pCached = taosLRUCacheValue(pTq->pRspCache, h);
+  const char*         p = pCached->data;
+  bool                hit = true;
+
+  for (int32_t i = 0; i < pCached->blockNum; i++) {
+    int32_t len = *(int32_t*)p;
+    void*   buf = taosMemoryMalloc(len);
+    if (buf == NULL) {
+      hit = false;
+      break;
+    }
+
+    memcpy(buf, p + sizeof(int32_t), len);
+    taosArrayPush(pRsp->blockDataLen, &len);
+    taosArrayPush(pRsp->blockData, &buf);
+    pRsp->blockNum++;
+    p += sizeof(int32_t) + len;
+  }
+
+  if (hit) {
+    pRsp->rspOffset = pCached->rspOffset;
+  } else {  // out of memory, drop the partial copy and let the caller scan the wal as usual
+    for (int32_t i = 0; i < pRsp->blockNum; i++) {
+      taosMemoryFree(*(void**)taosArrayGet(pRsp->blockData, i));
+    }
+    taosArrayClear(pRsp->blockData);
+    taosArrayClear(pRsp->blockDataLen);
+    pRsp->blockNum = 0;
+  }
+
+  taosLRUCacheRelease(pTq->pRspCache, h, false);
+  return hit;
+}
+
+int32_t tqScanDataCached(STQ* pTq, const STqHandle* pHandle, SMqDataRsp* pRsp, STqOffsetVal* pOffset) {
+  if (pOffset->type != TMQ_OFFSET__LOG || pHandle->execHandle.subType != TOPIC_SUB_TYPE__COLUMN) {
+    return tqScanData(pTq, pHandle, pRsp, pOffset);
+  }
+
+  char    key[TQ_RSP_CACHE_KEY_LEN];
+  int32_t keyLen = tqBuildRspCacheKey(pHandle, pOffset->version, key);
+
+  if (tqGetRspCache(pTq, key, keyLen, pRsp)) {
+    tqDebug("consumer:0x%" PRIx64 " vgId:%d, subkey %s rsp cache hit, ver:%" PRId64 " blocks:%d", pHandle->consumerId,
+            pTq->pVnode->config.vgId, pHandle->subKey, pOffset->version, pRsp->blockNum);
+    return 0;
+  }
+
+  int32_t code = tqScanData(pTq, pHandle, pRsp, pOffset);
+
+  // only the committed part of wal is immutable, anything beyond it may be rolled back by sync
+  if (code == 0 && pRsp->blockNum > 0 && pRsp->rspOffset.type == TMQ_OFFSET__LOG &&
+      pRsp->rspOffset.version <= walGetCommittedVer(pTq->pVnode->pWal)) {
+    tqPutRspCache(pTq, key, keyLen, pRsp);
+  }
+
+  return code;
+}
+
 int32_t tqScanTaosx(STQ* pTq, const STqHandle* pHandle, STaosxRsp* pRsp, SMqMetaRsp* pMetaRsp, STqOffsetVal* pOffset) {
   const STqExecHandle* pExec = &pHandle->execHandle;
   qTaskInfo_t          task = pExec->task;
@@ -376,6 +376,10 @@ int32_t tqRegisterPushEntry(STQ* pTq, void* pHandle, const SMqPollReq* pRequest,
     memcpy(pPushEntry->pDataRsp, pDataRsp, sizeof(SMqDataRsp));
   }
 
+  if (pRequest->timeout > 0) {
+    pPushEntry->deadline = taosGetTimestampMs() + pRequest->timeout;
+  }
+
   SMqRspHead* pHead = &pPushEntry->pDataRsp->head;
   pHead->consumerId = consumerId;
   pHead->epoch = pRequest->epoch;
@@ -408,3 +412,33 @@ int32_t tqRemovePushEntry(STQ* pTq, const char* pKey, int32_t keyLen, uint64_t c
 
   return 0;
 }
+
+// rsp the polls which have waited for new data longer than their timeout with empty block
+void tqExpirePushEntry(STQ* pTq, int64_t now) {
+  taosWLockLatch(&pTq->pushLock);
+
+  // the push entries are released by tqClose
+  if (atomic_load_8(&pTq->closing) || taosHashGetSize(pTq->pPushMgr) == 0) {
+    taosWUnLockLatch(&pTq->pushLock);
+    return;
+  }
+
+  SArray* expired = taosArrayInit(0, sizeof(STqPushEntry*));
+  void*   pIter = NULL;
+  while ((pIter = taosHashIterate(pTq->pPushMgr, pIter)) != NULL) {
+    STqPushEntry* pPushEntry = *(STqPushEntry**)pIter;
+    if (pPushEntry->deadline > 0 && pPushEntry->deadline <= now) {
+      taosArrayPush(expired, &pPushEntry);
+    }
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(expired); i++) {
+    STqPushEntry* pPushEntry = *(STqPushEntry**)taosArrayGet(expired, i);
+    tqDebug("tmq poll: consumer:0x%" PRIx64 ", subkey %s vgId:%d poll timeout, rsp empty block",
+            pPushEntry->pDataRsp->head.consumerId, pPushEntry->subKey, TD_VID(pTq->pVnode));
+    tqRemovePushEntry(pTq, pPushEntry->subKey, strlen(pPushEntry->subKey), pPushEntry->pDataRsp->head.consumerId, true);
+  }
+
+  taosArrayDestroy(expired);
+  taosWUnLockLatch(&pTq->pushLock);
+}
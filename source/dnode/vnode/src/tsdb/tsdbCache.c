@@ -15,6 +15,10 @@
 
 #include "tsdb.h"
 
+extern int32_t vnodeScheduleTask(int32_t (*execute)(void *), void *arg);
+
+static int32_t tsdbCacheStartLoad(STsdb *pTsdb);
+
 static int32_t tsdbOpenBICache(STsdb *pTsdb) {
   int32_t    code = 0;
   SLRUCache *pCache = taosLRUCacheInit(10 * 1024 * 1024, 0, .5);
@@ -43,6 +47,34 @@ static void tsdbCloseBICache(STsdb *pTsdb) {
   }
 }
 
+static int32_t tsdbOpenDSCache(STsdb *pTsdb) {
+  int32_t    code = 0;
+  SLRUCache *pCache = taosLRUCacheInit(10 * 1024 * 1024, 0, .5);
+  if (pCache == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
+  taosLRUCacheSetStrictCapacity(pCache, false);
+
+  taosThreadMutexInit(&pTsdb->dsMutex, NULL);
+
+_err:
+  pTsdb->dsCache = pCache;
+  return code;
+}
+
+static void tsdbCloseDSCache(STsdb *pTsdb) {
+  SLRUCache *pCache = pTsdb->dsCache;
+  if (pCache) {
+    taosLRUCacheEraseUnrefEntries(pCache);
+
+    taosLRUCacheCleanup(pCache);
+
+    taosThreadMutexDestroy(&pTsdb->dsMutex);
+  }
+}
+
 int32_t tsdbOpenCache(STsdb *pTsdb) {
   int32_t    code = 0;
   SLRUCache *pCache = NULL;
@@ -60,9 +92,21 @@ int32_t tsdbOpenCache(STsdb *pTsdb) {
     goto _err;
   }
 
+  code = tsdbOpenDSCache(pTsdb);
+  if (code != TSDB_CODE_SUCCESS) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
   taosLRUCacheSetStrictCapacity(pCache, false);
 
   taosThreadMutexInit(&pTsdb->lruMutex, NULL);
+  taosThreadMutexInit(&pTsdb->cacheLoadMutex, NULL);
+  taosThreadCondInit(&pTsdb->cacheLoadCond, NULL);
+
+  pTsdb->lruCache = pCache;
+  tsdbCacheStartLoad(pTsdb);
+  return code;
 
 _err:
   pTsdb->lruCache = pCache;
@@ -72,6 +116,11 @@ _err:
 void tsdbCloseCache(STsdb *pTsdb) {
   SLRUCache *pCache = pTsdb->lruCache;
   if (pCache) {
+    tsdbCacheStopLoad(pTsdb);
+    tsdbCacheDump(pTsdb);
+    taosThreadCondDestroy(&pTsdb->cacheLoadCond);
+    taosThreadMutexDestroy(&pTsdb->cacheLoadMutex);
+
     taosLRUCacheEraseUnrefEntries(pCache);
 
     taosLRUCacheCleanup(pCache);
@@ -80,6 +129,7 @@ void tsdbCloseCache(STsdb *pTsdb) {
   }
 
   tsdbCloseBICache(pTsdb);
+  tsdbCloseDSCache(pTsdb);
 }
 
 static void getTableCacheKey(tb_uid_t uid, int cacheType, char *key, int *len) {
@@ -1982,3 +2032,477 @@ int32_t tsdbBICacheRelease(SLRUCache *pCache, LRUHandle *h) {
 
   return code;
 }
+
+// a new del file is written with a new commit ID whenever tombstones are committed, so entries of older del files are
+// never hit again and just age out of the cache
+static void getDSCacheKey(tb_uid_t uid, int64_t commitID, char *key, int *len) {
+  struct {
+    tb_uid_t uid;
+    int64_t  commitID;
+  } dsKey = {0};
+
+  dsKey.uid = uid;
+  dsKey.commitID = commitID;
+
+  *len = sizeof(dsKey);
+  memcpy(key, &dsKey, *len);
+}
+
+static void deleteDSCache(const void *key, size_t keyLen, void *value) {
+  SDelSkyline *pDelSkyline = (SDelSkyline *)value;
+
+  taosArrayDestroy(pDelSkyline->aDelData);
+  taosArrayDestroy(pDelSkyline->aSkyline);
+  taosMemoryFree(pDelSkyline);
+}
+
+static int32_t tsdbCacheLoadDelSkyline(SDelFReader *pDelFReader, SDelIdx *pDelIdx, SDelSkyline **ppDelSkyline) {
+  int32_t      code = 0;
+  SDelSkyline *pDelSkyline = taosMemoryCalloc(1, sizeof(SDelSkyline));
+  if (pDelSkyline == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
+  pDelSkyline->aDelData = taosArrayInit(4, sizeof(SDelData));
+  pDelSkyline->aSkyline = taosArrayInit(4, sizeof(TSDBKEY));
+  if (pDelSkyline->aDelData == NULL || pDelSkyline->aSkyline == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
+  code = tsdbReadDelData(pDelFReader, pDelIdx, pDelSkyline->aDelData);
+  if (code) goto _err;
+
+  if (taosArrayGetSize(pDelSkyline->aDelData) > 0) {
+    code = tsdbBuildDeleteSkyline(pDelSkyline->aDelData, 0, (int32_t)(taosArrayGetSize(pDelSkyline->aDelData) - 1),
+                                  pDelSkyline->aSkyline);
+    if (code) goto _err;
+  }
+
+  *ppDelSkyline = pDelSkyline;
+  return code;
+
+_err:
+  if (pDelSkyline) {
+    deleteDSCache(NULL, 0, pDelSkyline);
+  }
+  *ppDelSkyline = NULL;
+  return code;
+}
+
+int32_t tsdbCacheGetDelSkyline(SLRUCache *pCache, STsdb *pTsdb, SDelFReader *pDelFReader, int64_t commitID,
+                               SDelIdx *pDelIdx, LRUHandle **handle) {
+  int32_t code = 0;
+  char    key[128] = {0};
+  int     keyLen = 0;
+
+  getDSCacheKey(pDelIdx->uid, commitID, key, &keyLen);
+  LRUHandle *h = taosLRUCacheLookup(pCache, key, keyLen);
+  if (!h) {
+    // the del file is read outside the lock, so that misses on different tables load in parallel. Two readers missing
+    // the same table at once both load it, and the one inserting second takes the entry of the first.
+    SDelSkyline *pDelSkyline = NULL;
+    code = tsdbCacheLoadDelSkyline(pDelFReader, pDelIdx, &pDelSkyline);
+    if (code != TSDB_CODE_SUCCESS) {
+      *handle = NULL;
+      return code;
+    }
+
+    taosThreadMutexLock(&pTsdb->dsMutex);
+
+    h = taosLRUCacheLookup(pCache, key, keyLen);
+    if (!h) {
+      size_t charge = sizeof(*pDelSkyline) + taosArrayGetSize(pDelSkyline->aDelData) * sizeof(SDelData) +
+                      taosArrayGetSize(pDelSkyline->aSkyline) * sizeof(TSDBKEY);
+      _taos_lru_deleter_t deleter = deleteDSCache;
+      LRUStatus status =
+          taosLRUCacheInsert(pCache, key, keyLen, pDelSkyline, charge, deleter, &h, TAOS_LRU_PRIORITY_LOW);
+      if (status != TAOS_LRU_STATUS_OK) {
+        code = -1;
+      }
+    } else {
+      deleteDSCache(NULL, 0, pDelSkyline);
+    }
+
+    taosThreadMutexUnlock(&pTsdb->dsMutex);
+  }
+
+  *handle = h;
+
+  return code;
+}
+
+int32_t tsdbDSCacheRelease(SLRUCache *pCache, LRUHandle *h) {
+  int32_t code = 0;
+
+  taosLRUCacheRelease(pCache, h, false);
+
+  return code;
+}
+
+// persisted last/last_row cache ========================================================================
+// The last/last_row cache is dumped to LAST_CACHE when the tsdb closes, tagged with the vnode commit ID. On open
+// a dump of the same commit ID is loaded back by a task on the vnode worker pool, so reopened vnodes do not
+// rebuild every entry with backward scans. Tables written or deleted while the load runs (e.g. by wal replay)
+// are recorded in pCacheTouched and their persisted entries are skipped. The dump is consumed by the load.
+#define TSDB_LAST_CACHE_MAGIC   ((uint32_t)0x4C415354)
+#define TSDB_LAST_CACHE_FMT_VER ((int8_t)1)
+#define TSDB_LAST_CACHE_HDR_SIZE \
+  (sizeof(uint32_t) + sizeof(int8_t) + sizeof(int64_t) + sizeof(int64_t))  // magic, fmtVer, commitID, nEntry
+
+typedef struct {
+  uint8_t *pBuf;
+  int64_t  size;
+  int64_t  nEntry;
+  int32_t  code;
+} SCacheDumpCtx;
+
+static void tsdbLastCacheFName(STsdb *pTsdb, char *fname, char *fname_t) {
+  SVnode *pVnode = pTsdb->pVnode;
+  if (pVnode->pTfs) {
+    snprintf(fname, TSDB_FILENAME_LEN - 1, "%s%s%s%sLAST_CACHE", tfsGetPrimaryPath(pVnode->pTfs), TD_DIRSEP,
+             pTsdb->path, TD_DIRSEP);
+    if (fname_t) {
+      snprintf(fname_t, TSDB_FILENAME_LEN - 1, "%s%s%s%sLAST_CACHE.t", tfsGetPrimaryPath(pVnode->pTfs), TD_DIRSEP,
+               pTsdb->path, TD_DIRSEP);
+    }
+  } else {
+    snprintf(fname, TSDB_FILENAME_LEN - 1, "%s%sLAST_CACHE", pTsdb->path, TD_DIRSEP);
+    if (fname_t) {
+      snprintf(fname_t, TSDB_FILENAME_LEN - 1, "%s%sLAST_CACHE.t", pTsdb->path, TD_DIRSEP);
+    }
+  }
+}
+
+int32_t tPutLastCacheEntry(uint8_t *p, uint64_t key, SArray *pLast) {
+  int32_t n = 0;
+  int16_t nCol = taosArrayGetSize(pLast);
+
+  n += tPutU64(p ? p + n : p, key);
+  n += tPutI16(p ? p + n : p, nCol);
+  for (int16_t iCol = 0; iCol < nCol; ++iCol) {
+    SLastCol *pLastCol = (SLastCol *)taosArrayGet(pLast, iCol);
+    SColVal  *pColVal = &pLastCol->colVal;
+
+    n += tPutI64(p ? p + n : p, pLastCol->ts);
+    n += tPutI16(p ? p + n : p, pColVal->cid);
+    n += tPutI8(p ? p + n : p, pColVal->type);
+    n += tPutI8(p ? p + n : p, pColVal->flag);
+    if (COL_VAL_IS_VALUE(pColVal)) {
+      if (IS_VAR_DATA_TYPE(pColVal->type)) {
+        n += tPutBinary(p ? p + n : p, pColVal->value.pData, pColVal->value.nData);
+      } else {
+        n += tPutI64(p ? p + n : p, pColVal->value.val);
+      }
+    }
+  }
+
+  return n;
+}
+
+int32_t tGetLastCacheEntry(uint8_t *p, uint64_t *key, SArray **ppLast) {
+  int32_t n = 0;
+  int16_t nCol = 0;
+
+  n += tGetU64(p + n, key);
+  n += tGetI16(p + n, &nCol);
+
+  SArray *pLast = taosArrayInit(nCol, sizeof(SLastCol));
+  if (pLast == NULL) return -1;
+
+  for (int16_t iCol = 0; iCol < nCol; ++iCol) {
+    SLastCol lastCol = {0};
+    SColVal *pColVal = &lastCol.colVal;
+
+    n += tGetI64(p + n, &lastCol.ts);
+    n += tGetI16(p + n, &pColVal->cid);
+    n += tGetI8(p + n, &pColVal->type);
+    n += tGetI8(p + n, &pColVal->flag);
+    if (COL_VAL_IS_VALUE(pColVal)) {
+      if (IS_VAR_DATA_TYPE(pColVal->type)) {
+        uint8_t *pData = NULL;
+        n += tGetBinary(p + n, &pData, &pColVal->value.nData);
+        if (pColVal->value.nData > 0) {
+          pColVal->value.pData = taosMemoryMalloc(pColVal->value.nData);
+          if (pColVal->value.pData == NULL) {
+            deleteTableCacheLast(NULL, 0, pLast);
+            return -1;
+          }
+          memcpy(pColVal->value.pData, pData, pColVal->value.nData);
+        } else {
+          pColVal->value.pData = NULL;
+        }
+      } else {
+        n += tGetI64(p + n, &pColVal->value.val);
+      }
+    }
+
+    taosArrayPush(pLast, &lastCol);
+  }
+
+  *ppLast = pLast;
+  return n;
+}
+
+static void tsdbCacheDumpEntry(const void *key, size_t keyLen, void *value, void *ud) {
+  SCacheDumpCtx *pCtx = (SCacheDumpCtx *)ud;
+  SArray        *pLast = (SArray *)value;
+
+  if (pCtx->code || pLast == NULL || taosArrayGetSize(pLast) == 0 || keyLen != sizeof(uint64_t)) return;
+
+  int32_t n = tPutLastCacheEntry(NULL, *(uint64_t *)key, pLast);
+  pCtx->code = tRealloc(&pCtx->pBuf, pCtx->size + n);
+  if (pCtx->code) return;
+
+  tPutLastCacheEntry(pCtx->pBuf + pCtx->size, *(uint64_t *)key, pLast);
+  pCtx->size += n;
+  pCtx->nEntry++;
+}
+
+int32_t tsdbCacheDump(STsdb *pTsdb) {
+  int32_t       code = 0;
+  int32_t       lino = 0;
+  TdFilePtr     pFD = NULL;
+  char          fname[TSDB_FILENAME_LEN] = {0};
+  char          fname_t[TSDB_FILENAME_LEN] = {0};
+  SCacheDumpCtx ctx = {.size = TSDB_LAST_CACHE_HDR_SIZE};
+
+  if (taosLRUCacheGetElems(pTsdb->lruCache) == 0) goto _exit;
+
+  code = tRealloc(&ctx.pBuf, ctx.size);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  taosLRUCacheApply(pTsdb->lruCache, tsdbCacheDumpEntry, &ctx);
+  code = ctx.code;
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  if (ctx.nEntry == 0) goto _exit;
+
+  int32_t n = 0;
+  n += tPutU32(ctx.pBuf + n, TSDB_LAST_CACHE_MAGIC);
+  n += tPutI8(ctx.pBuf + n, TSDB_LAST_CACHE_FMT_VER);
+  n += tPutI64(ctx.pBuf + n, pTsdb->pVnode->state.commitID);
+  n += tPutI64(ctx.pBuf + n, ctx.nEntry);
+
+  code = tRealloc(&ctx.pBuf, ctx.size + sizeof(TSCKSUM));
+  TSDB_CHECK_CODE(code, lino, _exit);
+  ctx.size += sizeof(TSCKSUM);
+  taosCalcChecksumAppend(0, ctx.pBuf, ctx.size);
+
+  tsdbLastCacheFName(pTsdb, fname, fname_t);
+  pFD = taosOpenFile(fname_t, TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC);
+  if (pFD == NULL) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  if (taosWriteFile(pFD, ctx.pBuf, ctx.size) < 0 || taosFsyncFile(pFD) < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+  taosCloseFile(&pFD);
+
+  if (taosRenameFile(fname_t, fname) < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+_exit:
+  if (pFD) {
+    taosCloseFile(&pFD);
+    (void)taosRemoveFile(fname_t);
+  }
+  tFree(ctx.pBuf);
+  if (code) {
+    tsdbError("vgId:%d %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  } else if (ctx.nEntry > 0) {
+    tsdbInfo("vgId:%d %s done, entries:%" PRId64 " size:%" PRId64, TD_VID(pTsdb->pVnode), __func__, ctx.nEntry,
+             ctx.size);
+  }
+  return code;
+}
+
+static int32_t tsdbCacheLoadEntry(STsdb *pTsdb, uint64_t key, SArray *pLast) {
+  SLRUCache *pCache = pTsdb->lruCache;
+  tb_uid_t   uid = (tb_uid_t)(key & ~0x8000000000000000);
+  SMetaInfo  info;
+  LRUHandle *h = NULL;
+  size_t     charge = pLast->capacity * pLast->elemSize + sizeof(*pLast);
+
+  // table dropped
+  if (metaGetInfo(pTsdb->pVnode->pMeta, uid, &info, NULL) != 0) {
+    deleteTableCacheLast(NULL, 0, pLast);
+    return 0;
+  }
+
+  taosThreadMutexLock(&pTsdb->cacheLoadMutex);
+  if (taosHashGet(pTsdb->pCacheTouched, &uid, sizeof(uid)) != NULL ||
+      (h = taosLRUCacheLookup(pCache, &key, sizeof(key))) != NULL) {
+    taosThreadMutexUnlock(&pTsdb->cacheLoadMutex);
+    taosLRUCacheRelease(pCache, h, false);
+    deleteTableCacheLast(NULL, 0, pLast);
+    return 0;
+  }
+
+  LRUStatus status =
+      taosLRUCacheInsert(pCache, &key, sizeof(key), pLast, charge, deleteTableCacheLast, &h, TAOS_LRU_PRIORITY_LOW);
+  taosThreadMutexUnlock(&pTsdb->cacheLoadMutex);
+
+  if (status != TAOS_LRU_STATUS_OK) {
+    return -1;
+  }
+
+  taosLRUCacheRelease(pCache, h, false);
+  return 0;
+}
+
+int32_t tsdbCacheLoad(STsdb *pTsdb) {
+  int32_t  code = 0;
+  int32_t  lino = 0;
+  uint8_t *pData = NULL;
+  int64_t  size = 0;
+  int64_t  nEntry = 0;
+  int64_t  nLoad = 0;
+  char     fname[TSDB_FILENAME_LEN] = {0};
+
+  tsdbLastCacheFName(pTsdb, fname, NULL);
+
+  TdFilePtr pFD = taosOpenFile(fname, TD_FILE_READ);
+  if (pFD == NULL) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  if (taosFStatFile(pFD, &size, NULL) < 0 || size < TSDB_LAST_CACHE_HDR_SIZE + sizeof(TSCKSUM)) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+    taosCloseFile(&pFD);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  if ((pData = taosMemoryMalloc(size)) == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    taosCloseFile(&pFD);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  if (taosReadFile(pFD, pData, size) != size) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    taosCloseFile(&pFD);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+  taosCloseFile(&pFD);
+
+  if (!taosCheckChecksumWhole(pData, size)) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  uint32_t magic = 0;
+  int8_t   fmtVer = 0;
+  int64_t  commitID = 0;
+  int32_t  n = 0;
+  n += tGetU32(pData + n, &magic);
+  n += tGetI8(pData + n, &fmtVer);
+  n += tGetI64(pData + n, &commitID);
+  n += tGetI64(pData + n, &nEntry);
+  if (magic != TSDB_LAST_CACHE_MAGIC || fmtVer != TSDB_LAST_CACHE_FMT_VER) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  // data files changed after the dump, entries may be stale
+  if (commitID != pTsdb->pVnode->state.commitID) {
+    tsdbInfo("vgId:%d %s skipped, dumped at commit ID %" PRId64 " but current is %" PRId64, TD_VID(pTsdb->pVnode),
+             __func__, commitID, pTsdb->pVnode->state.commitID);
+    goto _exit;
+  }
+
+  size_t capacity = taosLRUCacheGetCapacity(pTsdb->lruCache);
+  for (int64_t iEntry = 0; iEntry < nEntry; ++iEntry) {
+    if (atomic_load_8(&pTsdb->cacheLoadStop)) break;
+    if (taosLRUCacheGetUsage(pTsdb->lruCache) >= capacity) break;
+
+    uint64_t key = 0;
+    SArray  *pLast = NULL;
+    int32_t  nt = tGetLastCacheEntry(pData + n, &key, &pLast);
+    if (nt < 0) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+    n += nt;
+
+    if (tsdbCacheLoadEntry(pTsdb, key, pLast) == 0) {
+      nLoad++;
+    }
+  }
+
+_exit:
+  // a dump is only good for one open
+  (void)taosRemoveFile(fname);
+
+  taosMemoryFree(pData);
+  if (code) {
+    tsdbError("vgId:%d %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  } else {
+    tsdbInfo("vgId:%d %s done, entries:%" PRId64 " loaded:%" PRId64, TD_VID(pTsdb->pVnode), __func__, nEntry, nLoad);
+  }
+
+  // the tsdb may be closed as soon as the load is marked done
+  taosThreadMutexLock(&pTsdb->cacheLoadMutex);
+  taosHashCleanup(pTsdb->pCacheTouched);
+  pTsdb->pCacheTouched = NULL;
+  atomic_store_8(&pTsdb->cacheLoading, 0);
+  taosThreadCondSignal(&pTsdb->cacheLoadCond);
+  taosThreadMutexUnlock(&pTsdb->cacheLoadMutex);
+  return code;
+}
+
+static int32_t tsdbCacheLoadTask(void *arg) { return tsdbCacheLoad((STsdb *)arg); }
+
+static int32_t tsdbCacheStartLoad(STsdb *pTsdb) {
+  char fname[TSDB_FILENAME_LEN] = {0};
+
+  tsdbLastCacheFName(pTsdb, fname, NULL);
+  if (!taosCheckExistFile(fname)) return 0;
+
+  if (pTsdb->pVnode->config.cacheLast == 0) {
+    (void)taosRemoveFile(fname);
+    return 0;
+  }
+
+  pTsdb->pCacheTouched = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
+  if (pTsdb->pCacheTouched == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  atomic_store_8(&pTsdb->cacheLoading, 1);
+  if (vnodeScheduleTask(tsdbCacheLoadTask, pTsdb) < 0) {
+    taosHashCleanup(pTsdb->pCacheTouched);
+    pTsdb->pCacheTouched = NULL;
+    atomic_store_8(&pTsdb->cacheLoading, 0);
+    return terrno;
+  }
+
+  return 0;
+}
+
+void tsdbCacheStopLoad(STsdb *pTsdb) {
+  atomic_store_8(&pTsdb->cacheLoadStop, 1);
+
+  taosThreadMutexLock(&pTsdb->cacheLoadMutex);
+  while (atomic_load_8(&pTsdb->cacheLoading)) {
+    taosThreadCondWait(&pTsdb->cacheLoadCond, &pTsdb->cacheLoadMutex);
+  }
+  taosThreadMutexUnlock(&pTsdb->cacheLoadMutex);
+}
+
+void tsdbCacheTouch(STsdb *pTsdb, tb_uid_t uid) {
+  if (atomic_load_8(&pTsdb->cacheLoading) == 0) return;
+
+  taosThreadMutexLock(&pTsdb->cacheLoadMutex);
+  if (pTsdb->pCacheTouched) {
+    taosHashPut(pTsdb->pCacheTouched, &uid, sizeof(uid), NULL, 0);
+  }
+  taosThreadMutexUnlock(&pTsdb->cacheLoadMutex);
+}
@@ -31,6 +31,11 @@ struct SDiskColBuilder {
   SColumnDataAgg sma;
   uint8_t        minSet;
   uint8_t        maxSet;
+  uint8_t        calcBloom;
+  int32_t        nBloomKey;
+  int32_t        szBloomKey;
+  uint8_t       *pBloomKey;  // the values of the column, the bloom filter is sized by their count at the end
+  SBloomFilter  *pBF;
   uint8_t       *aBuf[2];
 };
 
@@ -51,6 +56,8 @@ static int32_t tDiskColBuilderDestroy(SDiskColBuilder *pBuilder) {
   tFree(pBuilder->pBitMap);
   if (pBuilder->pOffC) tCompressorDestroy(pBuilder->pOffC);
   if (pBuilder->pValC) tCompressorDestroy(pBuilder->pValC);
+  tFree(pBuilder->pBloomKey);
+  tBloomFilterDestroy(pBuilder->pBF);
   for (int32_t iBuf = 0; iBuf < sizeof(pBuilder->aBuf) / sizeof(pBuilder->aBuf[0]); iBuf++) {
     tFree(pBuilder->aBuf[iBuf]);
   }
@@ -66,9 +73,12 @@ static int32_t tDiskColBuilderInit(SDiskColBuilder *pBuilder, int16_t cid, int8_
   pBuilder->type = type;
   pBuilder->cmprAlg = cmprAlg;
   pBuilder->calcSma = IS_VAR_DATA_TYPE(type) ? 0 : calcSma;
+  pBuilder->calcBloom = (calcSma && tsBlockBloomFilter && TSDB_BLOOM_TYPE(type)) ? 1 : 0;
   pBuilder->flag = 0;
   pBuilder->nVal = 0;
   pBuilder->offset = 0;
+  pBuilder->nBloomKey = 0;
+  pBuilder->szBloomKey = 0;
 
   if (IS_VAR_DATA_TYPE(type)) {
     if (pBuilder->pOffC == NULL && (code = tCompressorCreate(&pBuilder->pOffC))) return code;
@@ -103,7 +113,23 @@ static int32_t tGnrtDiskCol(SDiskColBuilder *pBuilder, SDiskCol *pDiskCol) {
                                      .szOffset = 0,
                                      .szValue = 0,
                                      .offset = 0},
-                         .pBit = NULL, .pOff = NULL, .pVal = NULL, .agg = pBuilder->sma};
+                         .pBit = NULL, .pOff = NULL, .pVal = NULL, .agg = pBuilder->sma, .pBF = NULL};
+
+  // BLOOM FILTER
+  if (pBuilder->nBloomKey > 0) {
+    tBloomFilterDestroy(pBuilder->pBF);
+    pBuilder->pBF = tBloomFilterInit(pBuilder->nBloomKey, TSDB_BLOCK_BLOOM_ERROR_RATE);
+    if (pBuilder->pBF == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+    int32_t n = 0;
+    while (n < pBuilder->szBloomKey) {
+      uint8_t *pKey = NULL;
+      uint32_t len = 0;
+      n += tGetBinary(pBuilder->pBloomKey + n, &pKey, &len);
+      tBloomFilterPut(pBuilder->pBF, pKey, len);
+    }
+    pDiskCol->pBF = pBuilder->pBF;
+  }
 
   if (pBuilder->flag == HAS_NULL) return code;
 
@@ -427,10 +453,36 @@ static int32_t (*tDiskColAddValImpl[8][3])(SDiskColBuilder *pBuilder, SColVal *p
     {tDiskColAddVal60, tDiskColAddVal61, tDiskColAddVal62},  // HAS_VALUE|HAS_NULL
     {tDiskColAddVal70, tDiskColAddVal71, tDiskColAddVal72}   // HAS_VALUE|HAS_NULL|HAS_NONE
 };
+static int32_t tDiskColPutBloomKey(SDiskColBuilder *pBuilder, SColVal *pColVal) {
+  int32_t  code = 0;
+  uint8_t *pKey = NULL;
+  uint32_t len = 0;
+
+  if (IS_VAR_DATA_TYPE(pBuilder->type)) {
+    pKey = pColVal->value.pData;
+    len = pColVal->value.nData;
+  } else {
+    pKey = (uint8_t *)&pColVal->value.val;
+    len = tDataTypes[pBuilder->type].bytes;
+  }
+
+  code = tRealloc(&pBuilder->pBloomKey, pBuilder->szBloomKey + sizeof(uint32_t) + 1 + len);
+  if (code) return code;
+
+  pBuilder->szBloomKey += tPutBinary(pBuilder->pBloomKey + pBuilder->szBloomKey, pKey, len);
+  pBuilder->nBloomKey++;
+  return code;
+}
+
 // extern void (*tSmaUpdateImpl[])(SColumnDataAgg *pColAgg, SColVal *pColVal, uint8_t *minSet, uint8_t *maxSet);
 static int32_t tDiskColAddVal(SDiskColBuilder *pBuilder, SColVal *pColVal) {
   int32_t code = 0;
 
+  if (pBuilder->calcBloom && COL_VAL_IS_VALUE(pColVal)) {
+    code = tDiskColPutBloomKey(pBuilder, pColVal);
+    if (code) return code;
+  }
+
   if (pBuilder->calcSma) {
     if (COL_VAL_IS_VALUE(pColVal)) {
       // tSmaUpdateImpl[pBuilder->type](&pBuilder->sma, pColVal, &pBuilder->minSet, &pBuilder->maxSet);
@@ -631,7 +683,7 @@ int32_t tGnrtDiskData(SDiskDataBuilder *pBuilder, const SDiskData **ppDiskData,
   SDiskData *pDiskData = &pBuilder->dd;
   // reset SDiskData
   pDiskData->hdr = (SDiskDataHdr){.delimiter = TSDB_FILE_DLMT,
-                                  .fmtVer = 0,
+                                  .fmtVer = TSDB_DISK_DATA_FMT_VER_PLAIN,
                                   .suid = pBuilder->suid,
                                   .uid = pBuilder->uid,
                                   .szUid = 0,
@@ -689,6 +741,7 @@ int32_t tGnrtDiskData(SDiskDataBuilder *pBuilder, const SDiskData **ppDiskData,
     }
 
     pDiskData->hdr.szBlkCol += tPutBlockCol(NULL, &dCol.bCol);
+    pDiskData->hdr.fmtVer = TMAX(pDiskData->hdr.fmtVer, tBlockColFmtVer(&dCol.bCol));
   }
 
   *ppDiskData = pDiskData;
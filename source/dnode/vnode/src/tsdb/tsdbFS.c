@@ -433,6 +433,23 @@ _exit:
   return code;
 }
 
+// the stt files of the new set are not the old ones plus (or merged into) a new file, e.g. a file set
+// installed by a physical snapshot, so they have to be replaced as a whole
+static bool tsdbSttFilesReplaced(SDFileSet *pSetOld, SDFileSet *pSetNew) {
+  if (pSetNew->nSttF == pSetOld->nSttF + 1) {
+    for (int32_t iStt = 0; iStt < pSetOld->nSttF; iStt++) {
+      if (pSetOld->aSttF[iStt]->commitID != pSetNew->aSttF[iStt]->commitID) return true;
+    }
+    return false;
+  } else if (pSetNew->nSttF > pSetOld->nSttF) {
+    return true;
+  } else if (pSetNew->nSttF < pSetOld->nSttF) {
+    return pSetNew->nSttF != 1;
+  }
+
+  return false;
+}
+
 static int32_t tsdbMergeFileSet(STsdb *pTsdb, SDFileSet *pSetOld, SDFileSet *pSetNew) {
   int32_t code = 0;
   int32_t lino = 0;
@@ -505,7 +522,7 @@ static int32_t tsdbMergeFileSet(STsdb *pTsdb, SDFileSet *pSetOld, SDFileSet *pSe
   }
 
   // stt
-  if (sameDisk) {
+  if (sameDisk && !tsdbSttFilesReplaced(pSetOld, pSetNew)) {
     if (pSetNew->nSttF > pSetOld->nSttF) {
       ASSERT(pSetNew->nSttF == pSetOld->nSttF + 1);
       pSetOld->aSttF[pSetOld->nSttF] = (SSttFile *)taosMemoryMalloc(sizeof(SSttFile));
@@ -1021,6 +1038,63 @@ _exit:
   return code;
 }
 
+int32_t tsdbFSReplaceFSet(STsdbFS *pFS, SDFileSet *pSet) {
+  int32_t   code = 0;
+  int32_t   idx = taosArraySearchIdx(pFS->aDFileSet, pSet, tDFileSetCmprFn, TD_GE);
+  SDFileSet fSet = {.diskId = pSet->diskId, .fid = pSet->fid, .nSttF = 0};
+
+  if (idx < 0) {
+    idx = taosArrayGetSize(pFS->aDFileSet);
+  } else {
+    SDFileSet *pDFileSet = (SDFileSet *)taosArrayGet(pFS->aDFileSet, idx);
+    if (pDFileSet->fid == pSet->fid) {
+      taosMemoryFree(pDFileSet->pHeadF);
+      taosMemoryFree(pDFileSet->pDataF);
+      taosMemoryFree(pDFileSet->pSmaF);
+      for (int32_t iStt = 0; iStt < pDFileSet->nSttF; iStt++) {
+        taosMemoryFree(pDFileSet->aSttF[iStt]);
+      }
+      taosArrayRemove(pFS->aDFileSet, idx);
+    }
+  }
+
+  fSet.pHeadF = (SHeadFile *)taosMemoryMalloc(sizeof(SHeadFile));
+  fSet.pDataF = (SDataFile *)taosMemoryMalloc(sizeof(SDataFile));
+  fSet.pSmaF = (SSmaFile *)taosMemoryMalloc(sizeof(SSmaFile));
+  if (fSet.pHeadF == NULL || fSet.pDataF == NULL || fSet.pSmaF == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+  *fSet.pHeadF = *pSet->pHeadF;
+  *fSet.pDataF = *pSet->pDataF;
+  *fSet.pSmaF = *pSet->pSmaF;
+
+  for (; fSet.nSttF < pSet->nSttF; fSet.nSttF++) {
+    fSet.aSttF[fSet.nSttF] = (SSttFile *)taosMemoryMalloc(sizeof(SSttFile));
+    if (fSet.aSttF[fSet.nSttF] == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+    *fSet.aSttF[fSet.nSttF] = *pSet->aSttF[fSet.nSttF];
+  }
+
+  if (taosArrayInsert(pFS->aDFileSet, idx, &fSet) == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+_exit:
+  if (code) {
+    taosMemoryFree(fSet.pHeadF);
+    taosMemoryFree(fSet.pDataF);
+    taosMemoryFree(fSet.pSmaF);
+    for (int32_t iStt = 0; iStt < fSet.nSttF; iStt++) {
+      taosMemoryFree(fSet.aSttF[iStt]);
+    }
+  }
+  return code;
+}
+
 int32_t tsdbFSPrepareCommit(STsdb *pTsdb, STsdbFS *pFSNew) {
   int32_t code = 0;
   int32_t lino = 0;
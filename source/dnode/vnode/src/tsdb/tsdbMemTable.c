@@ -110,6 +110,8 @@ int32_t tsdbInsertTableData(STsdb *pTsdb, int64_t version, SSubmitTbData *pSubmi
   tb_uid_t   suid = pSubmitTbData->suid;
   tb_uid_t   uid = pSubmitTbData->uid;
 
+  tsdbCacheTouch(pTsdb, uid);
+
   // create/get STbData to op
   code = tsdbGetOrCreateTbData(pMemTable, suid, uid, &pTbData);
   if (code) {
@@ -142,6 +144,8 @@ int32_t tsdbDeleteTableData(STsdb *pTsdb, int64_t version, tb_uid_t suid, tb_uid
   SVBufPool *pPool = pTsdb->pVnode->inUse;
   TSDBKEY    lastKey = {.version = version, .ts = eKey};
 
+  tsdbCacheTouch(pTsdb, uid);
+
   // check if table exists
   SMetaInfo info;
   code = metaGetInfo(pTsdb->pVnode->pMeta, uid, &info, NULL);
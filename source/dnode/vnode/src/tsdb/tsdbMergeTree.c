@@ -76,14 +76,16 @@ void resetLastBlockLoadInfo(SSttBlockLoadInfo *pLoadInfo) {
 
     pLoadInfo[i].elapsedTime = 0;
     pLoadInfo[i].loadBlocks = 0;
+    pLoadInfo[i].cacheHits = 0;
     pLoadInfo[i].sttBlockLoaded = false;
   }
 }
 
-void getLastBlockLoadInfo(SSttBlockLoadInfo *pLoadInfo, int64_t *blocks, double *el) {
+void getLastBlockLoadInfo(SSttBlockLoadInfo *pLoadInfo, int64_t *blocks, int64_t *hits, double *el) {
   for (int32_t i = 0; i < pLoadInfo->numOfStt; ++i) {
     *el += pLoadInfo[i].elapsedTime;
     *blocks += pLoadInfo[i].loadBlocks;
+    *hits += pLoadInfo[i].cacheHits;
   }
 }
 
@@ -113,6 +115,7 @@ static SBlockData *loadLastBlock(SLDataIter *pIter, const char *idStr) {
                 pIter->iSttBlk, pIter->iStt, pIter->uid, idStr);
       pInfo->currentLoadBlockIndex = 0;
     }
+    pInfo->cacheHits += 1;
     return &pInfo->blockData[0];
   }
 
@@ -122,6 +125,7 @@ static SBlockData *loadLastBlock(SLDataIter *pIter, const char *idStr) {
                 pIter->iSttBlk, pIter->iStt, pIter->uid, idStr);
       pInfo->currentLoadBlockIndex = 1;
     }
+    pInfo->cacheHits += 1;
     return &pInfo->blockData[1];
   }
 
@@ -77,6 +77,8 @@ typedef struct SIOCostSummary {
   double  smaLoadTime;
   int64_t lastBlockLoad;
   double  lastBlockLoadTime;
+  int64_t lastBlockCacheHit;
+  int64_t fileBlockBytes;
   int64_t composedBlocks;
   double  buildComposedBlockTime;
   double  createScanInfoList;
@@ -87,12 +89,14 @@ typedef struct SIOCostSummary {
 
 typedef struct SBlockLoadSuppInfo {
   SArray*        pColAgg;
+  SArray*        pBloom;  // SArray<SBlockBloom>, loaded on demand
   SColumnDataAgg tsColAgg;
   int16_t*       colId;
   int16_t*       slotId;
   int32_t        numOfCols;
   char**         buildBuf;  // build string tmp buffer, todo remove it later after all string format being updated.
-  bool           smaValid;  // the sma on all queried columns are activated
+  bool           smaValid;   // the sma on all queried columns are activated
+  bool           smaLoaded;  // pColAgg already holds the sma of the current block, read along with the bloom filters
 } SBlockLoadSuppInfo;
 
 typedef struct SLastBlockReader {
@@ -150,6 +154,9 @@ typedef struct SReaderStatus {
   SBlockData            fileBlockData;
   SFilesetIter          fileIter;
   SDataBlockIter        blockIter;
+  bool                  partialLoaded;      // only some columns of the current file block are decoded
+  const int16_t*        pPartialColIds;     // the columns decoded and copied by the partial load, in ascending order
+  int32_t               numOfPartialCols;
 } SReaderStatus;
 
 typedef struct SBlockInfoBuf {
@@ -223,6 +230,7 @@ static TSDBKEY       getCurrentKeyInBuf(STableBlockScanInfo* pScanInfo, STsdbRea
 static bool          hasDataInFileBlock(const SBlockData* pBlockData, const SFileBlockDumpInfo* pDumpInfo);
 static void          initBlockDumpInfo(STsdbReader* pReader, SDataBlockIter* pBlockIter);
 static int32_t       getInitialDelIndex(const SArray* pDelSkyline, int32_t order);
+static void          resetPartialLoad(SReaderStatus* pStatus);
 
 static STableBlockScanInfo* getTableBlockScanInfo(SHashObj* pTableMap, uint64_t uid, const char* id);
 
@@ -550,7 +558,8 @@ static int32_t filesetIteratorNext(SFilesetIter* pIter, STsdbReader* pReader, bo
   }
 
   SIOCostSummary* pSum = &pReader->cost;
-  getLastBlockLoadInfo(pIter->pLastBlockReader->pInfo, &pSum->lastBlockLoad, &pReader->cost.lastBlockLoadTime);
+  getLastBlockLoadInfo(pIter->pLastBlockReader->pInfo, &pSum->lastBlockLoad, &pSum->lastBlockCacheHit,
+                       &pReader->cost.lastBlockLoadTime);
 
   pIter->pLastBlockReader->uid = 0;
   tMergeTreeClose(&pIter->pLastBlockReader->mergeTree);
@@ -701,6 +710,7 @@ static int32_t tsdbReleaseReader(STsdbReader* pReader) {
 
 void tsdbReleaseDataBlock(STsdbReader* pReader) {
   SReaderStatus* pStatus = &pReader->status;
+  resetPartialLoad(pStatus);
   if (!pStatus->composedDataBlock) {
     tsdbReleaseReader(pReader);
   }
@@ -1156,6 +1166,36 @@ static void copyNumericCols(const SColData* pData, SFileBlockDumpInfo* pDumpInfo
   }
 }
 
+static int32_t compareColId(const void* p1, const void* p2) {
+  int16_t left = *(const int16_t*)p1;
+  int16_t right = *(const int16_t*)p2;
+  return (left == right) ? 0 : ((left < right) ? -1 : 1);
+}
+
+// A partially loaded block is copied in two passes: the partial columns and the primary timestamp first, the rest of
+// them after the remaining columns are decoded. Each column is copied, and its copy time counted, by one pass only.
+bool tsdbColCopiedInPass(const int16_t* pPartialColIds, int32_t numOfPartialCols, bool restPass, int16_t cid) {
+  if (pPartialColIds == NULL) {
+    return true;
+  }
+
+  bool partial = (cid == PRIMARYKEY_TIMESTAMP_COL_ID);
+  if (!partial) {
+    partial = bsearch(&cid, pPartialColIds, numOfPartialCols, sizeof(int16_t), compareColId) != NULL;
+  }
+  return restPass ? !partial : partial;
+}
+
+static bool isColCopiedInPass(SReaderStatus* pStatus, int16_t cid) {
+  return tsdbColCopiedInPass(pStatus->pPartialColIds, pStatus->numOfPartialCols, pStatus->partialLoaded, cid);
+}
+
+static void resetPartialLoad(SReaderStatus* pStatus) {
+  pStatus->partialLoaded = false;
+  pStatus->pPartialColIds = NULL;
+  pStatus->numOfPartialCols = 0;
+}
+
 static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader) {
   SReaderStatus*      pStatus = &pReader->status;
   SDataBlockIter*     pBlockIter = &pStatus->blockIter;
@@ -1221,7 +1261,9 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader) {
 
   SColumnInfoData* pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
   if (pSupInfo->colId[i] == PRIMARYKEY_TIMESTAMP_COL_ID) {
-    copyPrimaryTsCol(pBlockData, pDumpInfo, pColData, dumpedRows, asc);
+    if (isColCopiedInPass(pStatus, PRIMARYKEY_TIMESTAMP_COL_ID)) {
+      copyPrimaryTsCol(pBlockData, pDumpInfo, pColData, dumpedRows, asc);
+    }
     i += 1;
   }
 
@@ -1233,6 +1275,9 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader) {
     SColData* pData = tBlockDataGetColDataByIdx(pBlockData, colIndex);
     if (pData->cid < pSupInfo->colId[i]) {
       colIndex += 1;
+    } else if (!isColCopiedInPass(pStatus, pSupInfo->colId[i])) {
+      colIndex += (pData->cid == pSupInfo->colId[i]) ? 1 : 0;
+      i += 1;
     } else if (pData->cid == pSupInfo->colId[i]) {
       pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
 
@@ -1260,8 +1305,10 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader) {
 
   // fill the mis-matched columns with null value
   while (i < numOfOutputCols) {
-    pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
-    colDataSetNNULL(pColData, 0, dumpedRows);
+    if (isColCopiedInPass(pStatus, pSupInfo->colId[i])) {
+      pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
+      colDataSetNNULL(pColData, 0, dumpedRows);
+    }
     i += 1;
   }
 
@@ -1293,7 +1340,7 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader) {
 }
 
 static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockIter, SBlockData* pBlockData,
-                                   uint64_t uid) {
+                                   uint64_t uid, const int16_t* pColIds, int32_t numOfCols) {
   int32_t code = 0;
   int64_t st = taosGetTimestampUs();
 
@@ -1315,7 +1362,11 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
   SFileBlockDumpInfo* pDumpInfo = &pReader->status.fBlockDumpInfo;
 
   SDataBlk* pBlock = getCurrentBlock(pBlockIter);
-  code = tsdbReadDataBlock(pReader->pFileReader, pBlock, pBlockData);
+  if (pColIds != NULL) {
+    code = tsdbReadDataBlockCols(pReader->pFileReader, pBlock, pBlockData, pColIds, numOfCols);
+  } else {
+    code = tsdbReadDataBlock(pReader->pFileReader, pBlock, pBlockData);
+  }
   if (code != TSDB_CODE_SUCCESS) {
     tsdbError("%p error occurs in loading file block, global index:%d, table index:%d, brange:%" PRId64 "-%" PRId64
               ", rows:%d, code:%s %s",
@@ -1332,6 +1383,9 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
             pBlock->minVer, pBlock->maxVer, elapsedTime, pReader->idStr);
 
   pReader->cost.blockLoadTime += elapsedTime;
+  for (int32_t i = 0; i < pBlock->nSubBlock; ++i) {
+    pReader->cost.fileBlockBytes += pBlock->aSubBlock[i].szBlock;
+  }
   pDumpInfo->allDumped = false;
 
   return TSDB_CODE_SUCCESS;
@@ -1676,6 +1730,47 @@ static bool overlapWithDelSkyline(STableBlockScanInfo* pBlockScanInfo, const SDa
   }
 }
 
+// all rows of the block are covered by the tombstones visible to this reader, if every part of the skyline that spans
+// the time range of the block is no lower than the max version of the block
+bool tsdbBlockCoveredByDelSkyline(const SArray* pSkyline, const SDataBlk* pBlock, const SVersionRange* pVerRange) {
+  int32_t num = (int32_t)taosArrayGetSize(pSkyline);
+  if (num < 2) {
+    return false;
+  }
+
+  // find the last point of the skyline that is not greater than the minKey.ts of the block
+  int32_t s = 0, e = num - 1, index = -1;
+  while (s <= e) {
+    int32_t  mid = (s + e) >> 1;
+    TSDBKEY* p = taosArrayGet(pSkyline, mid);
+    if (p->ts <= pBlock->minKey.ts) {
+      index = mid;
+      s = mid + 1;
+    } else {
+      e = mid - 1;
+    }
+  }
+
+  if (index < 0) {
+    return false;
+  }
+
+  for (int32_t i = index; i < num - 1; ++i) {
+    TSDBKEY* p = taosArrayGet(pSkyline, i);
+    TSDBKEY* pNext = taosArrayGet(pSkyline, i + 1);
+    if (p->version == 0 || p->version < pBlock->maxVer || p->version > pVerRange->maxVer ||
+        p->version < pVerRange->minVer) {
+      return false;
+    }
+
+    if (pNext->ts >= pBlock->maxKey.ts) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 typedef struct {
   bool overlapWithNeighborBlock;
   bool hasDupTs;
@@ -1741,6 +1836,28 @@ static bool fileBlockShouldLoad(STsdbReader* pReader, SFileDataBlockInfo* pBlock
   return loadDataBlock;
 }
 
+// the block would be returned directly if it did not overlap with the tombstones, and all of its rows are deleted
+static bool isDeletedFileDataBlock(STsdbReader* pReader, SFileDataBlockInfo* pBlockInfo, SDataBlk* pBlock,
+                                   STableBlockScanInfo* pScanInfo, TSDBKEY keyInBuf,
+                                   SLastBlockReader* pLastBlockReader) {
+  if (pScanInfo->delSkyline == NULL) {
+    return false;
+  }
+
+  SDataBlockToLoadInfo info = {0};
+  getBlockToLoadInfo(&info, pBlockInfo, pBlock, pScanInfo, keyInBuf, pLastBlockReader, pReader);
+  if (info.overlapWithNeighborBlock || info.overlapWithKeyInBuf || info.overlapWithLastBlock ||
+      bufferDataInFileBlockGap(pReader->order, keyInBuf, pBlock)) {
+    return false;
+  }
+
+  if (hasDataInLastBlock(pLastBlockReader) && !ASCENDING_TRAVERSE(pReader->order)) {
+    return false;
+  }
+
+  return tsdbBlockCoveredByDelSkyline(pScanInfo->delSkyline, pBlock, &pReader->verRange);
+}
+
 static bool isCleanFileDataBlock(STsdbReader* pReader, SFileDataBlockInfo* pBlockInfo, SDataBlk* pBlock,
                                  STableBlockScanInfo* pScanInfo, TSDBKEY keyInBuf, SLastBlockReader* pLastBlockReader) {
   SDataBlockToLoadInfo info = {0};
@@ -2596,7 +2713,7 @@ static int32_t loadNeighborIfOverlap(SFileDataBlockInfo* pBlockInfo, STableBlock
     setFileBlockActiveInBlockIter(pBlockIter, neighborIndex, step);
 
     // 3. load the neighbor block, and set it to be the currently accessed file data block
-    code = doLoadFileBlockData(pReader, pBlockIter, &pStatus->fileBlockData, pBlockInfo->uid);
+    code = doLoadFileBlockData(pReader, pBlockIter, &pStatus->fileBlockData, pBlockInfo->uid, NULL, 0);
     if (code != TSDB_CODE_SUCCESS) {
       return code;
     }
@@ -2740,45 +2857,79 @@ int32_t initDelSkylineIterator(STableBlockScanInfo* pBlockScanInfo, STsdbReader*
     return TSDB_CODE_SUCCESS;
   }
 
-  int32_t code = 0;
-  SArray* pDelData = taosArrayInit(4, sizeof(SDelData));
+  int32_t      code = 0;
+  SArray*      pDelData = NULL;
+  STsdb*       pTsdb = pReader->pTsdb;
+  LRUHandle*   handle = NULL;
+  SDelSkyline* pFileDel = NULL;
 
+  // tombstones in the del file and the skyline built from them are shared by all readers of the same del file
   SDelFile* pDelFile = pReader->pReadSnap->fs.pDelFile;
   if (pDelFile && taosArrayGetSize(pReader->pDelIdx) > 0) {
     SDelIdx  idx = {.suid = pReader->suid, .uid = pBlockScanInfo->uid};
     SDelIdx* pIdx = taosArraySearch(pReader->pDelIdx, &idx, tCmprDelIdx, TD_EQ);
 
     if (pIdx != NULL) {
-      code = tsdbReadDelData(pReader->pDelFReader, pIdx, pDelData);
+      code = tsdbCacheGetDelSkyline(pTsdb->dsCache, pTsdb, pReader->pDelFReader, pDelFile->commitID, pIdx, &handle);
+      if (code != TSDB_CODE_SUCCESS || handle == NULL) {
+        code = (code != TSDB_CODE_SUCCESS) ? code : TSDB_CODE_OUT_OF_MEMORY;
+        goto _err;
+      }
+      pFileDel = (SDelSkyline*)taosLRUCacheValue(pTsdb->dsCache, handle);
     }
-    if (code != TSDB_CODE_SUCCESS) {
+  }
+
+  bool hasMemDel = (pMemTbData != NULL && pMemTbData->pHead != NULL) ||
+                   (piMemTbData != NULL && piMemTbData->pHead != NULL);
+
+  if (!hasMemDel) {
+    if (pFileDel != NULL && taosArrayGetSize(pFileDel->aSkyline) > 0) {
+      pBlockScanInfo->delSkyline = taosArrayDup(pFileDel->aSkyline, NULL);
+      if (pBlockScanInfo->delSkyline == NULL) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        goto _err;
+      }
+    }
+  } else {
+    pDelData = taosArrayInit(4, sizeof(SDelData));
+    if (pDelData == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
       goto _err;
     }
-  }
 
-  SDelData* p = NULL;
-  if (pMemTbData != NULL) {
-    p = pMemTbData->pHead;
-    while (p) {
-      taosArrayPush(pDelData, p);
-      p = p->pNext;
+    if (pFileDel != NULL) {
+      taosArrayAddAll(pDelData, pFileDel->aDelData);
+    }
+
+    SDelData* p = NULL;
+    if (pMemTbData != NULL) {
+      p = pMemTbData->pHead;
+      while (p) {
+        taosArrayPush(pDelData, p);
+        p = p->pNext;
+      }
     }
-  }
 
-  if (piMemTbData != NULL) {
-    p = piMemTbData->pHead;
-    while (p) {
-      taosArrayPush(pDelData, p);
-      p = p->pNext;
+    if (piMemTbData != NULL) {
+      p = piMemTbData->pHead;
+      while (p) {
+        taosArrayPush(pDelData, p);
+        p = p->pNext;
+      }
+    }
+
+    if (taosArrayGetSize(pDelData) > 0) {
+      pBlockScanInfo->delSkyline = taosArrayInit(4, sizeof(TSDBKEY));
+      code = tsdbBuildDeleteSkyline(pDelData, 0, (int32_t)(taosArrayGetSize(pDelData) - 1), pBlockScanInfo->delSkyline);
     }
+
+    taosArrayDestroy(pDelData);
   }
 
-  if (taosArrayGetSize(pDelData) > 0) {
-    pBlockScanInfo->delSkyline = taosArrayInit(4, sizeof(TSDBKEY));
-    code = tsdbBuildDeleteSkyline(pDelData, 0, (int32_t)(taosArrayGetSize(pDelData) - 1), pBlockScanInfo->delSkyline);
+  if (handle != NULL) {
+    tsdbDSCacheRelease(pTsdb->dsCache, handle);
   }
 
-  taosArrayDestroy(pDelData);
   int32_t index = getInitialDelIndex(pBlockScanInfo->delSkyline, pReader->order);
 
   pBlockScanInfo->iter.index = index;
@@ -2789,6 +2940,9 @@ int32_t initDelSkylineIterator(STableBlockScanInfo* pBlockScanInfo, STsdbReader*
   return code;
 
 _err:
+  if (handle != NULL) {
+    tsdbDSCacheRelease(pTsdb->dsCache, handle);
+  }
   taosArrayDestroy(pDelData);
   return code;
 }
@@ -2997,8 +3151,16 @@ static int32_t doBuildDataBlock(STsdbReader* pReader) {
   initLastBlockReader(pLastBlockReader, pScanInfo, pReader);
   TSDBKEY keyInBuf = getCurrentKeyInBuf(pScanInfo, pReader);
 
-  if (fileBlockShouldLoad(pReader, pBlockInfo, pBlock, pScanInfo, keyInBuf, pLastBlockReader)) {
-    code = doLoadFileBlockData(pReader, pBlockIter, &pStatus->fileBlockData, pScanInfo->uid);
+  if (isDeletedFileDataBlock(pReader, pBlockInfo, pBlock, pScanInfo, keyInBuf, pLastBlockReader)) {
+    // skip the block without loading it
+    setBlockAllDumped(&pStatus->fBlockDumpInfo, pBlock->maxKey.ts, pReader->order);
+    pScanInfo->lastKey = ASCENDING_TRAVERSE(pReader->order) ? pBlock->maxKey.ts : pBlock->minKey.ts;
+    tsdbDebug("%p uid:%" PRIu64 " file block skipped since all rows are deleted, global index:%d, rows:%d, "
+              "brange:%" PRId64 "-%" PRId64 ", %s",
+              pReader, pScanInfo->uid, pBlockIter->index, pBlock->nRow, pBlock->minKey.ts, pBlock->maxKey.ts,
+              pReader->idStr);
+  } else if (fileBlockShouldLoad(pReader, pBlockInfo, pBlock, pScanInfo, keyInBuf, pLastBlockReader)) {
+    code = doLoadFileBlockData(pReader, pBlockIter, &pStatus->fileBlockData, pScanInfo->uid, NULL, 0);
     if (code != TSDB_CODE_SUCCESS) {
       return code;
     }
@@ -4133,6 +4295,8 @@ void tsdbReaderClose(STsdbReader* pReader) {
   SBlockLoadSuppInfo* pSupInfo = &pReader->suppInfo;
 
   taosArrayDestroy(pSupInfo->pColAgg);
+  tsdbClearBlockBloom(pSupInfo->pBloom);
+  taosArrayDestroy(pSupInfo->pBloom);
   for (int32_t i = 0; i < pSupInfo->numOfCols; ++i) {
     if (pSupInfo->buildBuf[i] != NULL) {
       taosMemoryFreeClear(pSupInfo->buildBuf[i]);
@@ -4182,7 +4346,7 @@ void tsdbReaderClose(STsdbReader* pReader) {
     SLastBlockReader* pLReader = pFilesetIter->pLastBlockReader;
     tMergeTreeClose(&pLReader->mergeTree);
 
-    getLastBlockLoadInfo(pLReader->pInfo, &pCost->lastBlockLoad, &pCost->lastBlockLoadTime);
+    getLastBlockLoadInfo(pLReader->pInfo, &pCost->lastBlockLoad, &pCost->lastBlockCacheHit, &pCost->lastBlockLoadTime);
 
     pLReader->pInfo = destroyLastBlockLoadInfo(pLReader->pInfo);
     taosMemoryFree(pLReader);
@@ -4404,6 +4568,7 @@ static bool doTsdbNextDataBlock(STsdbReader* pReader) {
   blockDataCleanup(pBlock);
 
   SReaderStatus* pStatus = &pReader->status;
+  resetPartialLoad(pStatus);
   if (taosHashGetSize(pStatus->pTableMap) == 0) {
     return false;
   }
@@ -4437,6 +4602,8 @@ bool tsdbNextDataBlock(STsdbReader* pReader) {
   int32_t code = tsdbAcquireReader(pReader);
   qTrace("tsdb/read: %p, take read mutex, code: %d", pReader, code);
 
+  pReader->suppInfo.smaLoaded = false;
+
   if (pReader->suspended) {
     tsdbReaderResume(pReader);
   }
@@ -4555,8 +4722,10 @@ int32_t tsdbRetrieveDatablockSMA(STsdbReader* pReader, SSDataBlock* pDataBlock,
   int64_t st = taosGetTimestampUs();
 
   SDataBlk* pBlock = getCurrentBlock(&pReader->status.blockIter);
-  if (tDataBlkHasSma(pBlock)) {
-    code = tsdbReadBlockSma(pReader->pFileReader, pBlock, pSup->pColAgg);
+  if (pSup->smaLoaded) {
+    pSup->smaLoaded = false;
+  } else if (tDataBlkHasSma(pBlock)) {
+    code = tsdbReadBlockSma(pReader->pFileReader, pBlock, pSup->pColAgg, NULL);
     if (code != TSDB_CODE_SUCCESS) {
       tsdbDebug("vgId:%d, failed to load block SMA for uid %" PRIu64 ", code:%s, %s", 0, pFBlock->uid, tstrerror(code),
                 pReader->idStr);
@@ -4622,6 +4791,67 @@ int32_t tsdbRetrieveDatablockSMA(STsdbReader* pReader, SSDataBlock* pDataBlock,
   return code;
 }
 
+int32_t tsdbBloomFilterOutBlock(STsdbReader* pReader, const SArray* pConds, bool* filterOut) {
+  int32_t code = 0;
+  *filterOut = false;
+
+  if (!tsBlockBloomFilter || taosArrayGetSize(pConds) == 0 || pReader->type == TIMEWINDOW_RANGE_EXTERNAL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  // only a block loaded as a whole from the data file has bloom filters
+  if (pReader->status.composedDataBlock) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SFileDataBlockInfo* pFBlock = getCurrentBlockInfo(&pReader->status.blockIter);
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  if (pReader->pResBlock->info.id.uid != pFBlock->uid) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SDataBlk* pBlock = getCurrentBlock(&pReader->status.blockIter);
+  if (!tDataBlkHasSma(pBlock)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (pSup->pBloom == NULL) {
+    pSup->pBloom = taosArrayInit(4, sizeof(SBlockBloom));
+    if (pSup->pBloom == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  // whether the block has bloom filters at all is only known from its sma record, which is read once and kept for
+  // tsdbRetrieveDatablockSMA
+  int64_t st = taosGetTimestampUs();
+  code = tsdbReadBlockSma(pReader->pFileReader, pBlock, pSup->pColAgg, pSup->pBloom);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+  pSup->smaLoaded = true;
+  pReader->cost.smaLoadTime += (taosGetTimestampUs() - st) / 1000.0;
+
+  if (taosArrayGetSize(pSup->pBloom) == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  // the conditions are ANDed, any single one of them missing in its bloom filter rules the block out
+  for (int32_t i = 0; i < taosArrayGetSize(pConds) && !(*filterOut); ++i) {
+    const SBlockBloomCond* pCond = taosArrayGet(pConds, i);
+    for (int32_t j = 0; j < taosArrayGetSize(pSup->pBloom); ++j) {
+      SBlockBloom* pBloom = taosArrayGet(pSup->pBloom, j);
+      if (pBloom->cid == pCond->colId) {
+        *filterOut = (tBloomFilterNoContain(pBloom->pBF, pCond->pKey, pCond->len) == TSDB_CODE_SUCCESS);
+        break;
+      }
+    }
+  }
+
+  tsdbClearBlockBloom(pSup->pBloom);
+  return code;
+}
+
 STableBlockScanInfo* getTableBlockScanInfo(SHashObj* pTableMap, uint64_t uid, const char* id) {
   STableBlockScanInfo** p = taosHashGet(pTableMap, &uid, sizeof(uid));
   if (p == NULL || *p == NULL) {
@@ -4642,14 +4872,54 @@ static SSDataBlock* doRetrieveDataBlock(STsdbReader* pReader) {
     return NULL;
   }
 
-  int32_t code = doLoadFileBlockData(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid);
+  int32_t code = 0;
+  if (pStatus->partialLoaded && pStatus->fileBlockData.nRow > 0) {
+    // the partial columns are decoded and copied already, decode and copy the rest of them only
+    int64_t st = taosGetTimestampUs();
+    code = tsdbReadDataBlockRest(pReader->pFileReader, getCurrentBlock(&pStatus->blockIter), &pStatus->fileBlockData);
+    pReader->cost.blockLoadTime += (taosGetTimestampUs() - st) / 1000.0;
+  } else {
+    resetPartialLoad(pStatus);
+    code = doLoadFileBlockData(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid, NULL, 0);
+  }
+
   if (code != TSDB_CODE_SUCCESS) {
+    resetPartialLoad(pStatus);
     tBlockDataDestroy(&pStatus->fileBlockData);
     terrno = code;
     return NULL;
   }
 
   copyBlockDataToSDataBlock(pReader);
+  resetPartialLoad(pStatus);
+  return pReader->pResBlock;
+}
+
+static SSDataBlock* doRetrieveDataBlockPartial(STsdbReader* pReader, const int16_t* colIds, int32_t numOfCols) {
+  SReaderStatus*       pStatus = &pReader->status;
+  SFileDataBlockInfo*  pBlockInfo = getCurrentBlockInfo(&pStatus->blockIter);
+  STableBlockScanInfo* pBlockScanInfo = getTableBlockScanInfo(pStatus->pTableMap, pBlockInfo->uid, pReader->idStr);
+  if (pBlockScanInfo == NULL) {
+    return NULL;
+  }
+
+  resetPartialLoad(pStatus);
+  int32_t code =
+      doLoadFileBlockData(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid, colIds, numOfCols);
+  if (code != TSDB_CODE_SUCCESS) {
+    tBlockDataDestroy(&pStatus->fileBlockData);
+    terrno = code;
+    return NULL;
+  }
+
+  // the rest of the columns are copied by the full retrieve at the same rows, so the dump position must not move here
+  SFileBlockDumpInfo dumpInfo = pStatus->fBlockDumpInfo;
+  pStatus->pPartialColIds = colIds;
+  pStatus->numOfPartialCols = numOfCols;
+  copyBlockDataToSDataBlock(pReader);
+  pStatus->fBlockDumpInfo = dumpInfo;
+
+  pStatus->partialLoaded = true;
   return pReader->pResBlock;
 }
 
@@ -4676,6 +4946,25 @@ SSDataBlock* tsdbRetrieveDataBlock(STsdbReader* pReader, SArray* pIdList) {
   return ret;
 }
 
+SSDataBlock* tsdbRetrieveDataBlockPartial(STsdbReader* pReader, const int16_t* colIds, int32_t numOfCols) {
+  STsdbReader* pTReader = pReader;
+  if (pReader->type == TIMEWINDOW_RANGE_EXTERNAL) {
+    if (pReader->step == EXTERNAL_ROWS_PREV) {
+      pTReader = pReader->innerReader[0];
+    } else if (pReader->step == EXTERNAL_ROWS_NEXT) {
+      pTReader = pReader->innerReader[1];
+    }
+  }
+
+  // a composed block is loaded completely already
+  SReaderStatus* pStatus = &pTReader->status;
+  if (pStatus->composedDataBlock) {
+    return pTReader->pResBlock;
+  }
+
+  return doRetrieveDataBlockPartial(pTReader, colIds, numOfCols);
+}
+
 int32_t tsdbReaderReset(STsdbReader* pReader, SQueryTableDataCond* pCond) {
   qTrace("tsdb/reader-reset: %p, take read mutex", pReader);
   tsdbAcquireReader(pReader);
@@ -4751,6 +5040,22 @@ static int32_t getBucketIndex(int32_t startRow, int32_t bucketRange, int32_t num
   return bucketIndex;
 }
 
+void tsdbReaderGetIOCost(STsdbReader* pReader, int64_t* pLoadBytes, int64_t* pCacheHits) {
+  SIOCostSummary* pCost = &pReader->cost;
+  int64_t         hits = pCost->lastBlockCacheHit;
+
+  // the stt block load info of the current file set has not been merged into the summary yet
+  SLastBlockReader* pLReader = pReader->status.fileIter.pLastBlockReader;
+  if (pLReader != NULL && pLReader->pInfo != NULL) {
+    int64_t blocks = 0;
+    double  el = 0;
+    getLastBlockLoadInfo(pLReader->pInfo, &blocks, &hits, &el);
+  }
+
+  *pLoadBytes = pCost->fileBlockBytes;
+  *pCacheHits = hits;
+}
+
 int32_t tsdbGetFileBlocksDistInfo(STsdbReader* pReader, STableBlockDistInfo* pTableBlockInfo) {
   int32_t code = TSDB_CODE_SUCCESS;
   pTableBlockInfo->totalSize = 0;
@@ -513,6 +513,97 @@ _err:
   return code;
 }
 
+static bool tsdbColDataBloomOn(SColData *pColData) {
+  if (!pColData->smaOn || pColData->cid == PRIMARYKEY_TIMESTAMP_COL_ID || (pColData->flag & HAS_VALUE) == 0) {
+    return false;
+  }
+
+  return TSDB_BLOOM_TYPE(pColData->type);
+}
+
+/*
+ * The bloom filters are appended to the block aggs in the sma file:
+ *
+ * | aggs ... | TSDB_SMA_BLOOM_MARK | cid | size | bloom filter | cid | size | bloom filter | ...
+ *
+ * so old files, which have no mark, are still read as aggs only.
+ */
+static int32_t tsdbPutBlockBloom(SDataFWriter *pWriter, int16_t cid, SBloomFilter *pBF, SSmaInfo *pSmaInfo,
+                                 bool *hasMark) {
+  int32_t code = 0;
+  int32_t size = 0;
+  int32_t ret = 0;
+
+  tEncodeSize(tBloomFilterEncode, pBF, size, ret);
+  if (ret < 0) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  code = tRealloc(&pWriter->aBuf[0], pSmaInfo->size + 3 * sizeof(int32_t) + size);
+  if (code) return code;
+
+  if (!(*hasMark)) {
+    pSmaInfo->size += tPutI16v(pWriter->aBuf[0] + pSmaInfo->size, TSDB_SMA_BLOOM_MARK);
+    *hasMark = true;
+  }
+  pSmaInfo->size += tPutI16v(pWriter->aBuf[0] + pSmaInfo->size, cid);
+  pSmaInfo->size += tPutI32v(pWriter->aBuf[0] + pSmaInfo->size, size);
+
+  SEncoder encoder = {0};
+  tEncoderInit(&encoder, pWriter->aBuf[0] + pSmaInfo->size, size);
+  ret = tBloomFilterEncode(pBF, &encoder);
+  tEncoderClear(&encoder);
+  if (ret < 0) {
+    return TSDB_CODE_FAILED;
+  }
+  pSmaInfo->size += size;
+
+  return code;
+}
+
+static int32_t tsdbWriteBlockBloom(SDataFWriter *pWriter, SBlockData *pBlockData, SSmaInfo *pSmaInfo) {
+  int32_t       code = 0;
+  SBloomFilter *pBF = NULL;
+  bool          hasMark = false;
+
+  for (int32_t iColData = 0; iColData < pBlockData->nColData; iColData++) {
+    SColData *pColData = tBlockDataGetColDataByIdx(pBlockData, iColData);
+
+    if (!tsdbColDataBloomOn(pColData)) continue;
+
+    pBF = tBloomFilterInit(pColData->nVal, TSDB_BLOCK_BLOOM_ERROR_RATE);
+    if (pBF == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+
+    for (int32_t iVal = 0; iVal < pColData->nVal; iVal++) {
+      SColVal cv;
+      tColDataGetValue(pColData, iVal, &cv);
+      if (!COL_VAL_IS_VALUE(&cv)) continue;
+
+      if (IS_VAR_DATA_TYPE(cv.type)) {
+        tBloomFilterPut(pBF, cv.value.pData, cv.value.nData);
+      } else {
+        tBloomFilterPut(pBF, &cv.value.val, tDataTypes[cv.type].bytes);
+      }
+    }
+
+    code = tsdbPutBlockBloom(pWriter, pColData->cid, pBF, pSmaInfo, &hasMark);
+    if (code) goto _exit;
+
+    tBloomFilterDestroy(pBF);
+    pBF = NULL;
+  }
+
+_exit:
+  tBloomFilterDestroy(pBF);
+  if (code) {
+    tsdbError("vgId:%d, tsdb write block bloom failed since %s", TD_VID(pWriter->pTsdb->pVnode), tstrerror(code));
+  }
+  return code;
+}
+
 static int32_t tsdbWriteBlockSma(SDataFWriter *pWriter, SBlockData *pBlockData, SSmaInfo *pSmaInfo) {
   int32_t code = 0;
 
@@ -533,6 +624,12 @@ static int32_t tsdbWriteBlockSma(SDataFWriter *pWriter, SBlockData *pBlockData,
     pSmaInfo->size += tPutColumnDataAgg(pWriter->aBuf[0] + pSmaInfo->size, &sma);
   }
 
+  // bloom filters only ride along with the aggs, a block without aggs is never checked against them
+  if (pSmaInfo->size && tsBlockBloomFilter) {
+    code = tsdbWriteBlockBloom(pWriter, pBlockData, pSmaInfo);
+    if (code) goto _err;
+  }
+
   // write
   if (pSmaInfo->size) {
     code = tsdbWriteFile(pWriter->pSmaFD, pWriter->fSma.size, pWriter->aBuf[0], pSmaInfo->size);
@@ -564,7 +661,7 @@ int32_t tsdbWriteBlockData(SDataFWriter *pWriter, SBlockData *pBlockData, SBlock
   pBlkInfo->szKey = 0;
 
   int32_t aBufN[4] = {0};
-  code = tCmprBlockData(pBlockData, cmprAlg, NULL, NULL, pWriter->aBuf, aBufN);
+  code = tCmprBlockData(pBlockData, cmprAlg, toLast, NULL, NULL, pWriter->aBuf, aBufN);
   if (code) goto _err;
 
   // write =================
@@ -727,6 +824,18 @@ int32_t tsdbWriteDiskData(SDataFWriter *pWriter, const SDiskData *pDiskData, SBl
     pSmaInfo->size += tPutColumnDataAgg(pWriter->aBuf[0] + pSmaInfo->size, &pDiskCol->agg);
   }
 
+  // the builder collected the bloom filters while the rows were added
+  if (pSmaInfo->size && tsBlockBloomFilter) {
+    bool hasMark = false;
+    for (int32_t iDiskCol = 0; iDiskCol < taosArrayGetSize(pDiskData->aDiskCol); iDiskCol++) {
+      SDiskCol *pDiskCol = (SDiskCol *)taosArrayGet(pDiskData->aDiskCol, iDiskCol);
+      if (pDiskCol->pBF == NULL) continue;
+
+      code = tsdbPutBlockBloom(pWriter, pDiskCol->bCol.cid, pDiskCol->pBF, pSmaInfo, &hasMark);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+  }
+
   if (pSmaInfo->size) {
     pSmaInfo->offset = pWriter->fSma.size;
 
@@ -1033,46 +1142,106 @@ _err:
   return code;
 }
 
-int32_t tsdbReadBlockSma(SDataFReader *pReader, SDataBlk *pDataBlk, SArray *aColumnDataAgg) {
+/*
+ * The aggs and the bloom filters of a block share one record in the sma file, so they are read and decoded in one
+ * go. aBlockBloom may be NULL when only the aggs are wanted.
+ */
+int32_t tsdbReadBlockSma(SDataFReader *pReader, SDataBlk *pDataBlk, SArray *aColumnDataAgg, SArray *aBlockBloom) {
   int32_t   code = 0;
+  int32_t   lino = 0;
   SSmaInfo *pSmaInfo = &pDataBlk->smaInfo;
-
-  ASSERT(pSmaInfo->size > 0);
+  int32_t   n = 0;
 
   taosArrayClear(aColumnDataAgg);
+  tsdbClearBlockBloom(aBlockBloom);
+
+  if (pSmaInfo->size <= 0) return code;
 
   // alloc
   code = tRealloc(&pReader->aBuf[0], pSmaInfo->size);
-  if (code) goto _err;
+  TSDB_CHECK_CODE(code, lino, _exit);
 
   // read
   code = tsdbReadFile(pReader->pSmaFD, pSmaInfo->offset, pReader->aBuf[0], pSmaInfo->size);
-  if (code) goto _err;
+  TSDB_CHECK_CODE(code, lino, _exit);
 
-  // decode
-  int32_t n = 0;
+  // decode the aggs
   while (n < pSmaInfo->size) {
+    int16_t cid;
+    tGetI16v(pReader->aBuf[0] + n, &cid);
+    if (cid == TSDB_SMA_BLOOM_MARK) break;
+
     SColumnDataAgg sma;
     n += tGetColumnDataAgg(pReader->aBuf[0] + n, &sma);
 
     if (taosArrayPush(aColumnDataAgg, &sma) == NULL) {
       code = TSDB_CODE_OUT_OF_MEMORY;
-      goto _err;
+      TSDB_CHECK_CODE(code, lino, _exit);
     }
   }
-  ASSERT(n == pSmaInfo->size);
-  return code;
+  if (n > pSmaInfo->size) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
 
-_err:
-  tsdbError("vgId:%d, tsdb read block sma failed since %s", TD_VID(pReader->pTsdb->pVnode), tstrerror(code));
+  if (n == pSmaInfo->size || aBlockBloom == NULL) goto _exit;
+
+  // decode the bloom filters behind the mark
+  int16_t mark;
+  n += tGetI16v(pReader->aBuf[0] + n, &mark);
+  while (n < pSmaInfo->size) {
+    SBlockBloom bloom = {0};
+    int32_t     size = 0;
+
+    n += tGetI16v(pReader->aBuf[0] + n, &bloom.cid);
+    n += tGetI32v(pReader->aBuf[0] + n, &size);
+    if (size <= 0 || n + size > pSmaInfo->size) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    SDecoder decoder = {0};
+    tDecoderInit(&decoder, pReader->aBuf[0] + n, size);
+    bloom.pBF = tBloomFilterDecode(&decoder);
+    tDecoderClear(&decoder);
+    if (bloom.pBF == NULL) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+    n += size;
+
+    if (taosArrayPush(aBlockBloom, &bloom) == NULL) {
+      tBloomFilterDestroy(bloom.pBF);
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+  }
+  if (n != pSmaInfo->size) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+_exit:
+  if (code) {
+    taosArrayClear(aColumnDataAgg);
+    tsdbClearBlockBloom(aBlockBloom);
+    tsdbError("vgId:%d %s failed at line %d since %s, offset:%" PRId64 " size:%d", TD_VID(pReader->pTsdb->pVnode),
+              __func__, lino, tstrerror(code), pSmaInfo->offset, pSmaInfo->size);
+  }
   return code;
 }
 
-static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo, SBlockData *pBlockData,
-                                     int32_t iStt) {
-  int32_t code = 0;
+void tsdbClearBlockBloom(SArray *aBlockBloom) {
+  for (int32_t i = 0; i < taosArrayGetSize(aBlockBloom); i++) {
+    SBlockBloom *pBloom = taosArrayGet(aBlockBloom, i);
+    tBloomFilterDestroy(pBloom->pBF);
+  }
+  taosArrayClear(aBlockBloom);
+}
 
-  tBlockDataClear(pBlockData);
+static int32_t tsdbReadBlockHdrImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo, SBlockData *pBlockData, int32_t iStt,
+                                    SDiskDataHdr *pHdr, bool decodeKey) {
+  int32_t code = 0;
 
   STsdbFD *pFD = (iStt < 0) ? pReader->pDataFD : pReader->aSttFD[iStt];
 
@@ -1083,88 +1252,122 @@ static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo
   code = tsdbReadFile(pFD, pBlkInfo->offset, pReader->aBuf[0], pBlkInfo->szKey);
   if (code) goto _err;
 
-  SDiskDataHdr hdr;
-  uint8_t     *p = pReader->aBuf[0] + tGetDiskDataHdr(pReader->aBuf[0], &hdr);
+  uint8_t *p = pReader->aBuf[0] + tGetDiskDataHdr(pReader->aBuf[0], pHdr);
 
-  ASSERT(hdr.delimiter == TSDB_FILE_DLMT);
-  ASSERT(pBlockData->suid == hdr.suid);
+  ASSERT(pHdr->delimiter == TSDB_FILE_DLMT);
+  ASSERT(pBlockData->suid == pHdr->suid);
+  if (pHdr->fmtVer > TSDB_DISK_DATA_FMT_VER) {
+    code = TSDB_CODE_VERSION_NOT_COMPATIBLE;
+    goto _err;
+  }
 
-  pBlockData->uid = hdr.uid;
-  pBlockData->nRow = hdr.nRow;
+  if (!decodeKey) goto _exit;
+
+  pBlockData->uid = pHdr->uid;
+  pBlockData->nRow = pHdr->nRow;
 
   // uid
-  if (hdr.uid == 0) {
-    ASSERT(hdr.szUid);
-    code = tsdbDecmprData(p, hdr.szUid, TSDB_DATA_TYPE_BIGINT, hdr.cmprAlg, (uint8_t **)&pBlockData->aUid,
-                          sizeof(int64_t) * hdr.nRow, &pReader->aBuf[1]);
+  if (pHdr->uid == 0) {
+    ASSERT(pHdr->szUid);
+    code = tsdbDecmprData(p, pHdr->szUid, TSDB_DATA_TYPE_BIGINT, pHdr->cmprAlg, (uint8_t **)&pBlockData->aUid,
+                          sizeof(int64_t) * pHdr->nRow, &pReader->aBuf[1]);
     if (code) goto _err;
   } else {
-    ASSERT(!hdr.szUid);
+    ASSERT(!pHdr->szUid);
   }
-  p += hdr.szUid;
+  p += pHdr->szUid;
 
   // version
-  code = tsdbDecmprData(p, hdr.szVer, TSDB_DATA_TYPE_BIGINT, hdr.cmprAlg, (uint8_t **)&pBlockData->aVersion,
-                        sizeof(int64_t) * hdr.nRow, &pReader->aBuf[1]);
+  code = tsdbDecmprData(p, pHdr->szVer, TSDB_DATA_TYPE_BIGINT, pHdr->cmprAlg, (uint8_t **)&pBlockData->aVersion,
+                        sizeof(int64_t) * pHdr->nRow, &pReader->aBuf[1]);
   if (code) goto _err;
-  p += hdr.szVer;
+  p += pHdr->szVer;
 
   // TSKEY
-  code = tsdbDecmprData(p, hdr.szKey, TSDB_DATA_TYPE_TIMESTAMP, hdr.cmprAlg, (uint8_t **)&pBlockData->aTSKEY,
-                        sizeof(TSKEY) * hdr.nRow, &pReader->aBuf[1]);
+  code = tsdbDecmprData(p, pHdr->szKey, TSDB_DATA_TYPE_TIMESTAMP, pHdr->cmprAlg, (uint8_t **)&pBlockData->aTSKEY,
+                        sizeof(TSKEY) * pHdr->nRow, &pReader->aBuf[1]);
   if (code) goto _err;
-  p += hdr.szKey;
+  p += pHdr->szKey;
 
   ASSERT(p - pReader->aBuf[0] == pBlkInfo->szKey);
 
-  // read and decode columns
+_exit:
+  return code;
+
+_err:
+  tsdbError("vgId:%d, tsdb read block hdr impl failed since %s", TD_VID(pReader->pTsdb->pVnode), tstrerror(code));
+  return code;
+}
+
+/*
+ * Decode the columns of pBlockData that are not decoded yet. If aCid is given, only the columns in it (sorted by
+ * cid) are decoded and the others are left empty, so they can be decoded by a later call.
+ */
+static int32_t tsdbReadBlockColsImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo, SBlockData *pBlockData,
+                                     int32_t iStt, const SDiskDataHdr *pHdr, const int16_t *aCid, int32_t nCid) {
+  int32_t code = 0;
+
+  STsdbFD *pFD = (iStt < 0) ? pReader->pDataFD : pReader->aSttFD[iStt];
+
   if (pBlockData->nColData == 0) goto _exit;
 
-  if (hdr.szBlkCol > 0) {
+  if (pHdr->szBlkCol > 0) {
     int64_t offset = pBlkInfo->offset + pBlkInfo->szKey;
 
-    code = tRealloc(&pReader->aBuf[0], hdr.szBlkCol);
+    code = tRealloc(&pReader->aBuf[0], pHdr->szBlkCol);
     if (code) goto _err;
 
-    code = tsdbReadFile(pFD, offset, pReader->aBuf[0], hdr.szBlkCol);
+    code = tsdbReadFile(pFD, offset, pReader->aBuf[0], pHdr->szBlkCol);
     if (code) goto _err;
   }
 
   SBlockCol  blockCol = {.cid = 0};
   SBlockCol *pBlockCol = &blockCol;
   int32_t    n = 0;
+  int32_t    iCid = 0;
 
   for (int32_t iColData = 0; iColData < pBlockData->nColData; iColData++) {
     SColData *pColData = tBlockDataGetColDataByIdx(pBlockData, iColData);
 
+    if (pColData->nVal > 0) continue;  // decoded already
+
+    if (aCid) {
+      while (iCid < nCid && aCid[iCid] < pColData->cid) iCid++;
+      if (iCid >= nCid || aCid[iCid] != pColData->cid) continue;
+    }
+
     while (pBlockCol && pBlockCol->cid < pColData->cid) {
-      if (n < hdr.szBlkCol) {
+      if (n < pHdr->szBlkCol) {
         n += tGetBlockCol(pReader->aBuf[0] + n, pBlockCol);
       } else {
-        ASSERT(n == hdr.szBlkCol);
+        ASSERT(n == pHdr->szBlkCol);
         pBlockCol = NULL;
       }
     }
 
     if (pBlockCol == NULL || pBlockCol->cid > pColData->cid) {
       // add a lot of NONE
-      for (int32_t iRow = 0; iRow < hdr.nRow; iRow++) {
+      for (int32_t iRow = 0; iRow < pHdr->nRow; iRow++) {
         code = tColDataAppendValue(pColData, &COL_VAL_NONE(pColData->cid, pColData->type));
         if (code) goto _err;
       }
     } else {
       ASSERT(pBlockCol->type == pColData->type);
       ASSERT(pBlockCol->flag && pBlockCol->flag != HAS_NONE);
+      if (tBlockColFmtVer(pBlockCol) > pHdr->fmtVer) {
+        code = TSDB_CODE_FILE_CORRUPTED;
+        goto _err;
+      }
 
       if (pBlockCol->flag == HAS_NULL) {
         // add a lot of NULL
-        for (int32_t iRow = 0; iRow < hdr.nRow; iRow++) {
+        for (int32_t iRow = 0; iRow < pHdr->nRow; iRow++) {
           code = tColDataAppendValue(pColData, &COL_VAL_NULL(pBlockCol->cid, pBlockCol->type));
           if (code) goto _err;
         }
       } else {
         // decode from binary
-        int64_t offset = pBlkInfo->offset + pBlkInfo->szKey + hdr.szBlkCol + pBlockCol->offset;
+        int64_t offset = pBlkInfo->offset + pBlkInfo->szKey + pHdr->szBlkCol + pBlockCol->offset;
         int32_t size = pBlockCol->szBitmap + pBlockCol->szOffset + pBlockCol->szValue;
 
         code = tRealloc(&pReader->aBuf[1], size);
@@ -1173,7 +1376,7 @@ static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo
         code = tsdbReadFile(pFD, offset, pReader->aBuf[1], size);
         if (code) goto _err;
 
-        code = tsdbDecmprColData(pReader->aBuf[1], pBlockCol, hdr.cmprAlg, hdr.nRow, pColData, &pReader->aBuf[2]);
+        code = tsdbDecmprColData(pReader->aBuf[1], pBlockCol, pHdr->cmprAlg, pHdr->nRow, pColData, &pReader->aBuf[2]);
         if (code) goto _err;
       }
     }
@@ -1182,6 +1385,27 @@ static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo
 _exit:
   return code;
 
+_err:
+  tsdbError("vgId:%d, tsdb read block cols impl failed since %s", TD_VID(pReader->pTsdb->pVnode), tstrerror(code));
+  return code;
+}
+
+static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo, SBlockData *pBlockData,
+                                     int32_t iStt, const int16_t *aCid, int32_t nCid) {
+  int32_t      code = 0;
+  SDiskDataHdr hdr;
+
+  tBlockDataClear(pBlockData);
+
+  code = tsdbReadBlockHdrImpl(pReader, pBlkInfo, pBlockData, iStt, &hdr, true);
+  if (code) goto _err;
+
+  // read and decode columns
+  code = tsdbReadBlockColsImpl(pReader, pBlkInfo, pBlockData, iStt, &hdr, aCid, nCid);
+  if (code) goto _err;
+
+  return code;
+
 _err:
   tsdbError("vgId:%d, tsdb read block data impl failed since %s", TD_VID(pReader->pTsdb->pVnode), tstrerror(code));
   return code;
@@ -1213,7 +1437,7 @@ _err:
 int32_t tsdbReadDataBlock(SDataFReader *pReader, SDataBlk *pDataBlk, SBlockData *pBlockData) {
   int32_t code = 0;
 
-  code = tsdbReadBlockDataImpl(pReader, &pDataBlk->aSubBlock[0], pBlockData, -1);
+  code = tsdbReadBlockDataImpl(pReader, &pDataBlk->aSubBlock[0], pBlockData, -1, NULL, 0);
   if (code) goto _err;
 
   ASSERT(pDataBlk->nSubBlock == 1);
@@ -1225,11 +1449,46 @@ _err:
   return code;
 }
 
+int32_t tsdbReadDataBlockCols(SDataFReader *pReader, SDataBlk *pDataBlk, SBlockData *pBlockData, const int16_t *aCid,
+                              int32_t nCid) {
+  int32_t code = 0;
+
+  ASSERT(pDataBlk->nSubBlock == 1);
+
+  code = tsdbReadBlockDataImpl(pReader, &pDataBlk->aSubBlock[0], pBlockData, -1, aCid, nCid);
+  if (code) goto _err;
+
+  return code;
+
+_err:
+  tsdbError("vgId:%d, tsdb read data block cols failed since %s", TD_VID(pReader->pTsdb->pVnode), tstrerror(code));
+  return code;
+}
+
+int32_t tsdbReadDataBlockRest(SDataFReader *pReader, SDataBlk *pDataBlk, SBlockData *pBlockData) {
+  int32_t      code = 0;
+  SDiskDataHdr hdr;
+
+  ASSERT(pDataBlk->nSubBlock == 1 && pBlockData->nRow > 0);
+
+  code = tsdbReadBlockHdrImpl(pReader, &pDataBlk->aSubBlock[0], pBlockData, -1, &hdr, false);
+  if (code) goto _err;
+
+  code = tsdbReadBlockColsImpl(pReader, &pDataBlk->aSubBlock[0], pBlockData, -1, &hdr, NULL, 0);
+  if (code) goto _err;
+
+  return code;
+
+_err:
+  tsdbError("vgId:%d, tsdb read data block rest failed since %s", TD_VID(pReader->pTsdb->pVnode), tstrerror(code));
+  return code;
+}
+
 int32_t tsdbReadSttBlock(SDataFReader *pReader, int32_t iStt, SSttBlk *pSttBlk, SBlockData *pBlockData) {
   int32_t code = 0;
   int32_t lino = 0;
 
-  code = tsdbReadBlockDataImpl(pReader, &pSttBlk->bInfo, pBlockData, iStt);
+  code = tsdbReadBlockDataImpl(pReader, &pSttBlk->bInfo, pBlockData, iStt, NULL, 0);
   TSDB_CHECK_CODE(code, lino, _exit);
 
 _exit:
@@ -15,6 +15,332 @@
 
 #include "tsdb.h"
 
+extern int32_t tsdbUpdateTableSchema(SMeta *pMeta, int64_t suid, int64_t uid, SSkmInfo *pSkmInfo);
+extern int32_t tsdbWriteDataBlock(SDataFWriter *pWriter, SBlockData *pBlockData, SMapData *mDataBlk, int8_t cmprAlg);
+
+// A file set demoted to a colder tier is rewritten instead of copied byte by byte: all stt files are merged into
+// the data file, blocks are made TSDB_RETENTION_COLD_ROW_FACTOR times larger than the vnode maxRows and every
+// column is encoded with two-stage compression. Writes are throttled by retentionMaxWriteRate so the rewrite does
+// not starve foreground queries. The rewrite runs in tsdbPrepareRetention before commits are blocked, and
+// tsdbDoRetention only swaps in the file sets that did not change meanwhile. Any failure falls back to the plain copy.
+#define TSDB_RETENTION_COLD_ROW_FACTOR 4
+
+// a file set rewritten for a colder tier, and the files it was rewritten from
+struct SRetentionFSet {
+  int8_t    used;
+  SDFileSet src;
+  SHeadFile srcHead;
+  SDataFile srcData;
+  SSmaFile  srcSma;
+  SSttFile  srcStt[TSDB_MAX_STT_TRIGGER];
+  SDFileSet dst;
+  SHeadFile dstHead;
+  SDataFile dstData;
+  SSmaFile  dstSma;
+  SSttFile  dstStt;
+};
+
+typedef struct {
+  STsdb  *pTsdb;
+  int32_t maxRow;
+  int8_t  cmprAlg;
+  int64_t startMs;
+  int64_t nWrite;
+
+  /* reader */
+  SDataFReader   *pReader;
+  STsdbDataIter2 *iterList;
+  STsdbDataIter2 *pIter;
+  SRBTree         rbt;  // SRBTree<STsdbDataIter2>
+
+  /* writer */
+  SDataFWriter *pWriter;
+  TABLEID       tbid;
+  SSkmInfo      skmTable;
+  SArray       *aBlockIdx;  // SArray<SBlockIdx>
+  SMapData      mDataBlk;   // SMapData<SDataBlk>
+  SBlockData    bData;
+} STsdbRecompressor;
+
+static void tsdbRecompressThrottle(STsdbRecompressor *pRc, int64_t nBytes) {
+  if (tsRetentionMaxWriteRate <= 0) return;
+
+  pRc->nWrite += nBytes;
+
+  int64_t expectMs = pRc->nWrite * 1000 / ((int64_t)tsRetentionMaxWriteRate * 1024 * 1024);
+  int64_t elapsedMs = taosGetTimestampMs() - pRc->startMs;
+  if (expectMs > elapsedMs) {
+    taosMsleep((int32_t)(expectMs - elapsedMs));
+  }
+}
+
+static int32_t tsdbRecompressNextRow(STsdbRecompressor *pRc, SRowInfo **ppRowInfo) {
+  int32_t code = 0;
+
+  if (pRc->pIter) {
+    code = tsdbDataIterNext2(pRc->pIter, NULL);
+    if (code) return code;
+
+    if (pRc->pIter->rowInfo.suid == 0 && pRc->pIter->rowInfo.uid == 0) {
+      pRc->pIter = NULL;
+    } else {
+      SRBTreeNode *pNode = tRBTreeMin(&pRc->rbt);
+      if (pNode && tsdbDataIterCmprFn(&pRc->pIter->rbtn, pNode) > 0) {
+        tRBTreePut(&pRc->rbt, &pRc->pIter->rbtn);
+        pRc->pIter = NULL;
+      }
+    }
+  }
+
+  if (pRc->pIter == NULL) {
+    SRBTreeNode *pNode = tRBTreeMin(&pRc->rbt);
+    if (pNode) {
+      tRBTreeDrop(&pRc->rbt, pNode);
+      pRc->pIter = TSDB_RBTN_TO_DATA_ITER(pNode);
+    }
+  }
+
+  *ppRowInfo = pRc->pIter ? &pRc->pIter->rowInfo : NULL;
+  return code;
+}
+
+static int32_t tsdbRecompressFlushBlock(STsdbRecompressor *pRc) {
+  int32_t code = 0;
+
+  if (pRc->bData.nRow == 0) return code;
+
+  int64_t size = pRc->pWriter->fData.size + pRc->pWriter->fSma.size;
+
+  code = tsdbWriteDataBlock(pRc->pWriter, &pRc->bData, &pRc->mDataBlk, pRc->cmprAlg);
+  if (code) return code;
+
+  tsdbRecompressThrottle(pRc, pRc->pWriter->fData.size + pRc->pWriter->fSma.size - size);
+  return code;
+}
+
+static int32_t tsdbRecompressTableEnd(STsdbRecompressor *pRc) {
+  int32_t code = 0;
+
+  if (pRc->tbid.uid == 0) return code;
+
+  code = tsdbRecompressFlushBlock(pRc);
+  if (code) return code;
+
+  if (pRc->mDataBlk.nItem) {
+    SBlockIdx *pBlockIdx = taosArrayReserve(pRc->aBlockIdx, 1);
+    if (pBlockIdx == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+    pBlockIdx->suid = pRc->tbid.suid;
+    pBlockIdx->uid = pRc->tbid.uid;
+
+    code = tsdbWriteDataBlk(pRc->pWriter, &pRc->mDataBlk, pBlockIdx);
+    if (code) return code;
+  }
+
+  pRc->tbid = (TABLEID){0};
+  return code;
+}
+
+static int32_t tsdbRecompressTableStart(STsdbRecompressor *pRc, SRowInfo *pRowInfo) {
+  int32_t code = 0;
+
+  pRc->tbid = (TABLEID){.suid = pRowInfo->suid, .uid = pRowInfo->uid};
+
+  code = tsdbUpdateTableSchema(pRc->pTsdb->pVnode->pMeta, pRc->tbid.suid, pRc->tbid.uid, &pRc->skmTable);
+  if (code) return code;
+
+  tMapDataReset(&pRc->mDataBlk);
+  return tBlockDataInit(&pRc->bData, &pRc->tbid, pRc->skmTable.pTSchema, NULL, 0);
+}
+
+static int32_t tsdbRecompressRow(STsdbRecompressor *pRc, SRowInfo *pRowInfo) {
+  int32_t code = 0;
+
+  if (pRowInfo->uid != pRc->tbid.uid) {
+    code = tsdbRecompressTableEnd(pRc);
+    if (code) return code;
+
+    code = tsdbRecompressTableStart(pRc, pRowInfo);
+    if (code) return code;
+  }
+
+  // rows of the same key from different files come in version order, so a block is only cut between keys and
+  // the newer versions are merged into the row already appended
+  if (pRc->bData.nRow >= pRc->maxRow && pRc->bData.aTSKEY[pRc->bData.nRow - 1] != TSDBROW_TS(&pRowInfo->row)) {
+    code = tsdbRecompressFlushBlock(pRc);
+    if (code) return code;
+  }
+
+  return tBlockDataUpsertRow(&pRc->bData, &pRowInfo->row, pRc->skmTable.pTSchema, pRc->tbid.uid);
+}
+
+static int32_t tsdbRecompressOpen(STsdbRecompressor *pRc, STsdb *pTsdb, SDFileSet *pSet, SDiskID did,
+                                  int64_t commitID) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  pRc->pTsdb = pTsdb;
+  pRc->maxRow = TMIN(pTsdb->pVnode->config.tsdbCfg.maxRows * TSDB_RETENTION_COLD_ROW_FACTOR, TSDB_MAX_MAXROWS_FBLOCK);
+  pRc->cmprAlg = TWO_STAGE_COMP;
+  pRc->startMs = taosGetTimestampMs();
+  tRBTreeCreate(&pRc->rbt, tsdbDataIterCmprFn);
+
+  code = tBlockDataCreate(&pRc->bData);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  if ((pRc->aBlockIdx = taosArrayInit(0, sizeof(SBlockIdx))) == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  // reader: the data file and all stt files merged by key
+  code = tsdbDataFReaderOpen(&pRc->pReader, pTsdb, pSet);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  for (int32_t iStt = -1; iStt < pSet->nSttF; iStt++) {
+    if (iStt < 0) {
+      code = tsdbOpenDataFileDataIter(pRc->pReader, &pRc->pIter);
+    } else {
+      code = tsdbOpenSttFileDataIter(pRc->pReader, iStt, &pRc->pIter);
+    }
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    if (pRc->pIter == NULL) continue;
+
+    pRc->pIter->next = pRc->iterList;
+    pRc->iterList = pRc->pIter;
+
+    code = tsdbDataIterNext2(pRc->pIter, NULL);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    if (pRc->pIter->rowInfo.suid || pRc->pIter->rowInfo.uid) {
+      tRBTreePut(&pRc->rbt, &pRc->pIter->rbtn);
+    }
+  }
+  pRc->pIter = NULL;
+
+  // writer: fresh head/data/sma files and an empty stt file on the target disk
+  if (tfsMkdirRecurAt(pTsdb->pVnode->pTfs, pTsdb->path, did) < 0) {
+    code = terrno;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+  SDFileSet wSet = {.diskId = did,
+                    .fid = pSet->fid,
+                    .pHeadF = &(SHeadFile){.commitID = commitID},
+                    .pDataF = &(SDataFile){.commitID = commitID},
+                    .pSmaF = &(SSmaFile){.commitID = commitID},
+                    .nSttF = 1,
+                    .aSttF = {&(SSttFile){.commitID = commitID}}};
+  code = tsdbDataFWriterOpen(&pRc->pWriter, pTsdb, &wSet);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at line %d since %s, fid:%d", TD_VID(pTsdb->pVnode), __func__, lino,
+              tstrerror(code), pSet->fid);
+  }
+  return code;
+}
+
+static void tsdbRemoveFSetFiles(STsdb *pTsdb, SDFileSet *pSet) {
+  char fname[TSDB_FILENAME_LEN];
+
+  tsdbHeadFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pHeadF, fname);
+  (void)taosRemoveFile(fname);
+  tsdbDataFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pDataF, fname);
+  (void)taosRemoveFile(fname);
+  tsdbSmaFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pSmaF, fname);
+  (void)taosRemoveFile(fname);
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    tsdbSttFileName(pTsdb, pSet->diskId, pSet->fid, pSet->aSttF[iStt], fname);
+    (void)taosRemoveFile(fname);
+  }
+}
+
+static void tsdbRecompressClose(STsdbRecompressor *pRc, bool failed) {
+  if (pRc->pWriter) {
+    SHeadFile fHead = pRc->pWriter->fHead;
+    SDataFile fData = pRc->pWriter->fData;
+    SSmaFile  fSma = pRc->pWriter->fSma;
+    SSttFile  fStt = pRc->pWriter->fStt[0];
+    SDFileSet wSet = {.diskId = pRc->pWriter->wSet.diskId,
+                      .fid = pRc->pWriter->wSet.fid,
+                      .pHeadF = &fHead,
+                      .pDataF = &fData,
+                      .pSmaF = &fSma,
+                      .nSttF = 1,
+                      .aSttF = {&fStt}};
+
+    tsdbDataFWriterClose(&pRc->pWriter, 0);
+    if (failed) {
+      tsdbRemoveFSetFiles(pRc->pTsdb, &wSet);
+    }
+  }
+
+  while (pRc->iterList) {
+    STsdbDataIter2 *pIter = pRc->iterList;
+    pRc->iterList = pIter->next;
+    tsdbCloseDataIter2(pIter);
+  }
+  tsdbDataFReaderClose(&pRc->pReader);
+
+  tBlockDataDestroy(&pRc->bData);
+  tMapDataClear(&pRc->mDataBlk);
+  taosArrayDestroy(pRc->aBlockIdx);
+  tDestroyTSchema(pRc->skmTable.pTSchema);
+}
+
+static int32_t tsdbRecompressFSet(STsdb *pTsdb, SDFileSet *pSet, SDiskID did, int64_t commitID, SDFileSet *pSetOut) {
+  int32_t           code = 0;
+  int32_t           lino = 0;
+  STsdbRecompressor rc = {0};
+  SRowInfo         *pRowInfo = NULL;
+
+  code = tsdbRecompressOpen(&rc, pTsdb, pSet, did, commitID);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  for (;;) {
+    code = tsdbRecompressNextRow(&rc, &pRowInfo);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    if (pRowInfo == NULL) break;
+
+    code = tsdbRecompressRow(&rc, pRowInfo);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  code = tsdbRecompressTableEnd(&rc);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbWriteBlockIdx(rc.pWriter, rc.aBlockIdx);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbUpdateDFileSetHeader(rc.pWriter);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  pSetOut->diskId = did;
+  pSetOut->fid = pSet->fid;
+  *pSetOut->pHeadF = rc.pWriter->fHead;
+  *pSetOut->pDataF = rc.pWriter->fData;
+  *pSetOut->pSmaF = rc.pWriter->fSma;
+  *pSetOut->aSttF[0] = rc.pWriter->fStt[0];
+  pSetOut->nSttF = 1;
+
+  code = tsdbDataFWriterClose(&rc.pWriter, 1);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at line %d since %s, fid:%d", TD_VID(pTsdb->pVnode), __func__, lino,
+              tstrerror(code), pSet->fid);
+  } else {
+    tsdbInfo("vgId:%d %s done, fid:%d level:%d data size:%" PRId64, TD_VID(pTsdb->pVnode), __func__, pSet->fid,
+             did.level, pSetOut->pDataF->size);
+  }
+  tsdbRecompressClose(&rc, code != 0);
+  return code;
+}
+
 static bool tsdbShouldDoRetentionImpl(STsdb *pTsdb, int64_t now) {
   for (int32_t iSet = 0; iSet < taosArrayGetSize(pTsdb->fs.aDFileSet); iSet++) {
     SDFileSet *pSet = (SDFileSet *)taosArrayGet(pTsdb->fs.aDFileSet, iSet);
@@ -46,7 +372,116 @@ bool tsdbShouldDoRetention(STsdb *pTsdb, int64_t now) {
   return should;
 }
 
-int32_t tsdbDoRetention(STsdb *pTsdb, int64_t now) {
+static bool tsdbSameFSet(SDFileSet *pSet1, SDFileSet *pSet2) {
+  if (pSet1->fid != pSet2->fid || pSet1->diskId.level != pSet2->diskId.level ||
+      pSet1->diskId.id != pSet2->diskId.id || pSet1->nSttF != pSet2->nSttF) {
+    return false;
+  }
+
+  if (pSet1->pHeadF->commitID != pSet2->pHeadF->commitID || pSet1->pDataF->commitID != pSet2->pDataF->commitID ||
+      pSet1->pSmaF->commitID != pSet2->pSmaF->commitID || pSet1->pHeadF->size != pSet2->pHeadF->size ||
+      pSet1->pDataF->size != pSet2->pDataF->size) {
+    return false;
+  }
+
+  for (int32_t iStt = 0; iStt < pSet1->nSttF; iStt++) {
+    if (pSet1->aSttF[iStt]->commitID != pSet2->aSttF[iStt]->commitID ||
+        pSet1->aSttF[iStt]->size != pSet2->aSttF[iStt]->size) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static SRetentionFSet *tsdbGetRetentionFSet(SArray *aRFSet, SDFileSet *pSet) {
+  for (int32_t i = 0; i < taosArrayGetSize(aRFSet); i++) {
+    SRetentionFSet *pRFSet = *(SRetentionFSet **)taosArrayGet(aRFSet, i);
+    if (!pRFSet->used && tsdbSameFSet(&pRFSet->src, pSet)) return pRFSet;
+  }
+  return NULL;
+}
+
+int32_t tsdbPrepareRetention(STsdb *pTsdb, int64_t now, int64_t commitID, SArray **paRFSet) {
+  int32_t code = 0;
+  int32_t lino = 0;
+  STsdbFS fs = {0};
+
+  *paRFSet = NULL;
+  if (!tsRetentionRecompress) return code;
+
+  // the referenced files stay on disk while they are read, commits go on meanwhile
+  taosThreadRwlockRdlock(&pTsdb->rwLock);
+  code = tsdbFSRef(pTsdb, &fs);
+  taosThreadRwlockUnlock(&pTsdb->rwLock);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  for (int32_t iSet = 0; iSet < taosArrayGetSize(fs.aDFileSet); iSet++) {
+    SDFileSet *pSet = (SDFileSet *)taosArrayGet(fs.aDFileSet, iSet);
+    int32_t    expLevel = tsdbFidLevel(pSet->fid, &pTsdb->keepCfg, now);
+    SDiskID    did;
+
+    if (expLevel <= 0) continue;
+    if (tfsAllocDisk(pTsdb->pVnode->pTfs, expLevel, &did) < 0) continue;
+    if (did.level == pSet->diskId.level) continue;
+
+    if (*paRFSet == NULL && (*paRFSet = taosArrayInit(0, sizeof(SRetentionFSet *))) == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    SRetentionFSet *pRFSet = (SRetentionFSet *)taosMemoryCalloc(1, sizeof(*pRFSet));
+    if (pRFSet == NULL || taosArrayPush(*paRFSet, &pRFSet) == NULL) {
+      taosMemoryFree(pRFSet);
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    pRFSet->src = *pSet;
+    pRFSet->srcHead = *pSet->pHeadF;
+    pRFSet->srcData = *pSet->pDataF;
+    pRFSet->srcSma = *pSet->pSmaF;
+    pRFSet->src.pHeadF = &pRFSet->srcHead;
+    pRFSet->src.pDataF = &pRFSet->srcData;
+    pRFSet->src.pSmaF = &pRFSet->srcSma;
+    for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+      pRFSet->srcStt[iStt] = *pSet->aSttF[iStt];
+      pRFSet->src.aSttF[iStt] = &pRFSet->srcStt[iStt];
+    }
+    pRFSet->dst = (SDFileSet){.pHeadF = &pRFSet->dstHead,
+                              .pDataF = &pRFSet->dstData,
+                              .pSmaF = &pRFSet->dstSma,
+                              .aSttF = {&pRFSet->dstStt}};
+
+    if (tsdbRecompressFSet(pTsdb, pSet, did, commitID, &pRFSet->dst) != 0) {
+      taosArrayPop(*paRFSet);
+      taosMemoryFree(pRFSet);
+    }
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  } else {
+    tsdbInfo("vgId:%d %s done, rewritten:%d", TD_VID(pTsdb->pVnode), __func__, (int32_t)taosArrayGetSize(*paRFSet));
+  }
+  if (fs.aDFileSet) tsdbFSUnref(pTsdb, &fs);
+  return code;
+}
+
+void tsdbClearRetention(STsdb *pTsdb, SArray *aRFSet, bool committed) {
+  for (int32_t i = 0; i < taosArrayGetSize(aRFSet); i++) {
+    SRetentionFSet *pRFSet = *(SRetentionFSet **)taosArrayGet(aRFSet, i);
+    // a rewrite not swapped in, or swapped into a file system that was not committed, belongs to nobody
+    if (!pRFSet->used || !committed) {
+      tsdbRemoveFSetFiles(pTsdb, &pRFSet->dst);
+    }
+    taosMemoryFree(pRFSet);
+  }
+  taosArrayDestroy(aRFSet);
+}
+
+int32_t tsdbDoRetention(STsdb *pTsdb, int64_t now, SArray *aRFSet) {
   int32_t code = 0;
   int32_t lino = 0;
   STsdbFS fs = {0};
@@ -77,7 +512,16 @@ int32_t tsdbDoRetention(STsdb *pTsdb, int64_t now) {
 
       if (did.level == pSet->diskId.level) continue;
 
-      // copy file to new disk (todo)
+      // swap in the file set rewritten for the colder tier if nothing was committed to it since, or copy it to the
+      // new disk as is
+      SRetentionFSet *pRFSet = tsdbGetRetentionFSet(aRFSet, pSet);
+      if (pRFSet) {
+        code = tsdbFSUpsertFSet(&fs, &pRFSet->dst);
+        TSDB_CHECK_CODE(code, lino, _exit);
+        pRFSet->used = 1;
+        continue;
+      }
+
       SDFileSet fSet = *pSet;
       fSet.diskId = did;
 
@@ -19,12 +19,70 @@ extern int32_t tsdbUpdateTableSchema(SMeta* pMeta, int64_t suid, int64_t uid, SS
 extern int32_t tsdbWriteDataBlock(SDataFWriter* pWriter, SBlockData* pBlockData, SMapData* mDataBlk, int8_t cmprAlg);
 extern int32_t tsdbWriteSttBlock(SDataFWriter* pWriter, SBlockData* pBlockData, SArray* aSttBlk, int8_t cmprAlg);
 
+// SNAP_DATA_TSDB_FILE ========================================
+// A full snapshot (sver = 0) ships the head/data/sma/stt files of each file set verbatim, in checksummed
+// chunks, instead of decoding and re-encoding every row. The receiver writes them under new commit IDs and
+// installs each file set as a whole when the tsdb snapshot writer commits.
+#define TSDB_SNAP_FILE_CHUNK_SIZE (4 * 1024 * 1024)
+
+int32_t tPutSnapFileChunk(uint8_t* p, STsdbSnapFileChunk* pChunk) {
+  int32_t n = 0;
+  n += tPutI32(p ? p + n : p, pChunk->fid);
+  n += tPutI32(p ? p + n : p, pChunk->szPage);
+  n += tPutI8(p ? p + n : p, pChunk->nSttF);
+  n += tPutI8(p ? p + n : p, pChunk->fIdx);
+  n += tPutI64(p ? p + n : p, pChunk->size);
+  n += tPutI64(p ? p + n : p, pChunk->offset);
+  n += tPutI64(p ? p + n : p, pChunk->fSize);
+  n += tPutI64(p ? p + n : p, pChunk->cOffset);
+  n += tPutI32(p ? p + n : p, pChunk->cSize);
+  n += tPutU32(p ? p + n : p, pChunk->cksum);
+  return n;
+}
+
+int32_t tGetSnapFileChunk(uint8_t* p, STsdbSnapFileChunk* pChunk) {
+  int32_t n = 0;
+  n += tGetI32(p + n, &pChunk->fid);
+  n += tGetI32(p + n, &pChunk->szPage);
+  n += tGetI8(p + n, &pChunk->nSttF);
+  n += tGetI8(p + n, &pChunk->fIdx);
+  n += tGetI64(p + n, &pChunk->size);
+  n += tGetI64(p + n, &pChunk->offset);
+  n += tGetI64(p + n, &pChunk->fSize);
+  n += tGetI64(p + n, &pChunk->cOffset);
+  n += tGetI32(p + n, &pChunk->cSize);
+  n += tGetU32(p + n, &pChunk->cksum);
+  return n;
+}
+
+static void tsdbSnapFileName(STsdb* pTsdb, SDFileSet* pSet, int8_t fIdx, char fname[], int64_t* size,
+                             int64_t* offset) {
+  *offset = 0;
+  if (fIdx == TSDB_SNAP_FILE_HEAD) {
+    tsdbHeadFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pHeadF, fname);
+    *size = pSet->pHeadF->size;
+    *offset = pSet->pHeadF->offset;
+  } else if (fIdx == TSDB_SNAP_FILE_DATA) {
+    tsdbDataFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pDataF, fname);
+    *size = pSet->pDataF->size;
+  } else if (fIdx == TSDB_SNAP_FILE_SMA) {
+    tsdbSmaFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pSmaF, fname);
+    *size = pSet->pSmaF->size;
+  } else {
+    SSttFile* pSttF = pSet->aSttF[fIdx - TSDB_SNAP_FILE_STT];
+    tsdbSttFileName(pTsdb, pSet->diskId, pSet->fid, pSttF, fname);
+    *size = pSttF->size;
+    *offset = pSttF->offset;
+  }
+}
+
 // STsdbSnapReader ========================================
 struct STsdbSnapReader {
   STsdb*   pTsdb;
   int64_t  sver;
   int64_t  ever;
   int8_t   type;
+  int8_t   physical;
   uint8_t* aBuf[5];
 
   STsdbFS  fs;
@@ -46,6 +104,12 @@ struct STsdbSnapReader {
   SDelFReader*    pDelFReader;
   STsdbDataIter2* pTIter;
   SArray*         aDelData;
+
+  // physical file data
+  int8_t    fIdx;
+  int64_t   fSize;
+  int64_t   fOffset;
+  TdFilePtr pFD;
 };
 
 static int32_t tsdbSnapReadFileDataStart(STsdbSnapReader* pReader) {
@@ -198,7 +262,7 @@ static int32_t tsdbSnapCmprData(STsdbSnapReader* pReader, uint8_t** ppData) {
   ASSERT(pReader->bData.nRow);
 
   int32_t aBufN[5] = {0};
-  code = tCmprBlockData(&pReader->bData, NO_COMPRESSION, NULL, NULL, pReader->aBuf, aBufN);
+  code = tCmprBlockData(&pReader->bData, NO_COMPRESSION, 0, NULL, NULL, pReader->aBuf, aBufN);
   if (code) goto _exit;
 
   int32_t size = aBufN[0] + aBufN[1] + aBufN[2] + aBufN[3];
@@ -298,6 +362,88 @@ _exit:
   return code;
 }
 
+static int32_t tsdbSnapReadFileChunk(STsdbSnapReader* pReader, uint8_t** ppData) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  STsdb*             pTsdb = pReader->pTsdb;
+  int32_t            szPage = pTsdb->pVnode->config.tsdbPageSize;
+  STsdbSnapFileChunk chunk = {0};
+  char               fname[TSDB_FILENAME_LEN];
+
+  SDFileSet* pSet = taosArraySearch(pReader->fs.aDFileSet, &(SDFileSet){.fid = pReader->fid}, tDFileSetCmprFn, TD_EQ);
+
+  // open the next file of the current file set, or the first file of the next set
+  if (pReader->pFD == NULL) {
+    if (pSet == NULL || pReader->fIdx >= TSDB_SNAP_FILE_STT + pSet->nSttF) {
+      pSet = taosArraySearch(pReader->fs.aDFileSet, &(SDFileSet){.fid = pReader->fid}, tDFileSetCmprFn, TD_GT);
+      if (pSet == NULL) {
+        pReader->fid = INT32_MAX;
+        goto _exit;
+      }
+
+      pReader->fid = pSet->fid;
+      pReader->fIdx = TSDB_SNAP_FILE_HEAD;
+    }
+
+    int64_t size, offset;
+    tsdbSnapFileName(pTsdb, pSet, pReader->fIdx, fname, &size, &offset);
+
+    pReader->pFD = taosOpenFile(fname, TD_FILE_READ);
+    if (pReader->pFD == NULL) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+    pReader->fSize = tsdbLogicToFileSize(size, szPage);
+    pReader->fOffset = 0;
+  }
+
+  chunk.fid = pSet->fid;
+  chunk.szPage = szPage;
+  chunk.nSttF = pSet->nSttF;
+  chunk.fIdx = pReader->fIdx;
+  tsdbSnapFileName(pTsdb, pSet, pReader->fIdx, fname, &chunk.size, &chunk.offset);
+  chunk.fSize = pReader->fSize;
+  chunk.cOffset = pReader->fOffset;
+  chunk.cSize = (int32_t)TMIN(pReader->fSize - pReader->fOffset, TSDB_SNAP_FILE_CHUNK_SIZE);
+
+  int32_t nHdr = tPutSnapFileChunk(NULL, &chunk);
+  *ppData = taosMemoryMalloc(sizeof(SSnapDataHdr) + nHdr + chunk.cSize);
+  if (*ppData == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  SSnapDataHdr* pHdr = (SSnapDataHdr*)*ppData;
+  uint8_t*      pChunkData = pHdr->data + nHdr;
+  if (chunk.cSize > 0 && taosPReadFile(pReader->pFD, pChunkData, chunk.cSize, chunk.cOffset) != chunk.cSize) {
+    code = (errno != 0) ? TAOS_SYSTEM_ERROR(errno) : TSDB_CODE_FILE_CORRUPTED;
+    taosMemoryFreeClear(*ppData);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+  chunk.cksum = taosCalcChecksum(0, pChunkData, chunk.cSize);
+
+  pHdr->type = SNAP_DATA_TSDB_FILE;
+  pHdr->size = nHdr + chunk.cSize;
+  tPutSnapFileChunk(pHdr->data, &chunk);
+
+  pReader->fOffset += chunk.cSize;
+  if (pReader->fOffset >= pReader->fSize) {
+    taosCloseFile(&pReader->pFD);
+    pReader->fIdx++;
+  }
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at line %d since %s, fid:%d", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code),
+              pReader->fid);
+  } else if (*ppData) {
+    tsdbDebug("vgId:%d %s done, fid:%d file:%d offset:%" PRId64 " size:%d", TD_VID(pTsdb->pVnode), __func__,
+              chunk.fid, chunk.fIdx, chunk.cOffset, chunk.cSize);
+  }
+  return code;
+}
+
 static int32_t tsdbSnapCmprTombData(STsdbSnapReader* pReader, uint8_t** ppData) {
   int32_t code = 0;
   int32_t lino = 0;
@@ -424,7 +570,8 @@ _exit:
   return code;
 }
 
-int32_t tsdbSnapReaderOpen(STsdb* pTsdb, int64_t sver, int64_t ever, int8_t type, STsdbSnapReader** ppReader) {
+int32_t tsdbSnapReaderOpen(STsdb* pTsdb, int64_t sver, int64_t ever, int8_t type, int8_t physical,
+                           STsdbSnapReader** ppReader) {
   int32_t code = 0;
   int32_t lino = 0;
 
@@ -445,6 +592,10 @@ int32_t tsdbSnapReaderOpen(STsdb* pTsdb, int64_t sver, int64_t ever, int8_t type
     taosThreadRwlockUnlock(&pTsdb->rwLock);
     TSDB_CHECK_CODE(code, lino, _exit);
   }
+
+  // files can only be shipped as they are if the receiver understands them and nothing in them is out of [sver, ever]
+  pReader->physical = physical && tsSnapPhysical && (type == SNAP_DATA_TSDB) && (sver == 0) &&
+                      (pTsdb->pVnode->state.committed <= ever);
   taosThreadRwlockUnlock(&pTsdb->rwLock);
 
   // init
@@ -464,8 +615,8 @@ _exit:
       pReader = NULL;
     }
   } else {
-    tsdbInfo("vgId:%d %s done, sver:%" PRId64 " ever:%" PRId64 " type:%d", TD_VID(pTsdb->pVnode), __func__, sver, ever,
-             type);
+    tsdbInfo("vgId:%d %s done, sver:%" PRId64 " ever:%" PRId64 " type:%d physical:%d", TD_VID(pTsdb->pVnode),
+             __func__, sver, ever, type, pReader->physical);
   }
   *ppReader = pReader;
   return code;
@@ -498,6 +649,9 @@ int32_t tsdbSnapReaderClose(STsdbSnapReader** ppReader) {
     tsdbDataFReaderClose(&pReader->pDataFReader);
   }
   tBlockDataDestroy(&pReader->bData);
+  if (pReader->pFD) {
+    taosCloseFile(&pReader->pFD);
+  }
 
   // other
   tDestroyTSchema(pReader->skmTable.pTSchema);
@@ -525,7 +679,11 @@ int32_t tsdbSnapRead(STsdbSnapReader* pReader, uint8_t** ppData) {
 
   // read data file
   if (!pReader->dataDone) {
-    code = tsdbSnapReadTimeSeriesData(pReader, ppData);
+    if (pReader->physical) {
+      code = tsdbSnapReadFileChunk(pReader, ppData);
+    } else {
+      code = tsdbSnapReadTimeSeriesData(pReader, ppData);
+    }
     TSDB_CHECK_CODE(code, lino, _exit);
     if (*ppData) {
       goto _exit;
@@ -600,6 +758,20 @@ struct STsdbSnapWriter {
   SDelFWriter* pDelFWriter;
   SArray*      aDelIdx;
   SArray*      aDelData;
+
+  // physical file data
+  struct {
+    SDFileSet fSet;
+    SHeadFile fHead;
+    SDataFile fData;
+    SSmaFile  fSma;
+    SSttFile  fStt[TSDB_MAX_STT_TRIGGER];
+    int8_t    fIdx;
+    int64_t   fSize;
+    int64_t   fOffset;
+    int32_t   nFile;  // number of files completely received
+    TdFilePtr pFD;
+  } pf;
 };
 
 // SNAP_DATA_TSDB
@@ -887,8 +1059,15 @@ static int32_t tsdbSnapWriteFileDataStart(STsdbSnapWriter* pWriter, int32_t fid)
   if (pSet) {
     diskId = pSet->diskId;
   } else {
-    tfsAllocDisk(pTsdb->pVnode->pTfs, 0 /*TODO*/, &diskId);
-    tfsMkdirRecurAt(pTsdb->pVnode->pTfs, pTsdb->path, diskId);
+    int32_t expLevel = tsdbFidLevel(fid, &pTsdb->keepCfg, taosGetTimestampSec());
+    if (expLevel < 0 || tfsAllocDisk(pTsdb->pVnode->pTfs, expLevel, &diskId) < 0) {
+      code = terrno ? terrno : TSDB_CODE_FAILED;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+    if (tfsMkdirRecurAt(pTsdb->pVnode->pTfs, pTsdb->path, diskId) < 0) {
+      code = terrno;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
   }
   SDFileSet wSet = {.diskId = diskId,
                     .fid = fid,
@@ -1143,6 +1322,200 @@ _exit:
   return code;
 }
 
+// SNAP_DATA_TSDB_FILE
+static int32_t tsdbSnapWriteFileEnd(STsdbSnapWriter* pWriter) {
+  int32_t code = 0;
+
+  if (pWriter->pf.pFD == NULL) goto _exit;
+
+  if (pWriter->pf.fOffset != pWriter->pf.fSize) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+    goto _exit;
+  }
+
+  if (taosFsyncFile(pWriter->pf.pFD) < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    goto _exit;
+  }
+
+  pWriter->pf.nFile++;
+
+_exit:
+  if (pWriter->pf.pFD) {
+    taosCloseFile(&pWriter->pf.pFD);
+  }
+  return code;
+}
+
+static int32_t tsdbSnapWriteFSetEnd(STsdbSnapWriter* pWriter) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  SDFileSet* pSet = &pWriter->pf.fSet;
+
+  code = tsdbSnapWriteFileEnd(pWriter);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  if (pWriter->pf.nFile != TSDB_SNAP_FILE_STT + pSet->nSttF) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  code = tsdbFSReplaceFSet(&pWriter->fs, pSet);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at line %d since %s, fid:%d", TD_VID(pWriter->pTsdb->pVnode), __func__, lino,
+              tstrerror(code), pSet->fid);
+  } else {
+    tsdbInfo("vgId:%d %s done, fid:%d nSttF:%d", TD_VID(pWriter->pTsdb->pVnode), __func__, pSet->fid, pSet->nSttF);
+  }
+  pSet->pHeadF = NULL;
+  return code;
+}
+
+static int32_t tsdbSnapWriteFSetStart(STsdbSnapWriter* pWriter, STsdbSnapFileChunk* pChunk) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  STsdb* pTsdb = pWriter->pTsdb;
+
+  if (pChunk->nSttF < 1 || pChunk->nSttF > TSDB_MAX_STT_TRIGGER) {
+    code = TSDB_CODE_INVALID_MSG;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  SDiskID    diskId;
+  SDFileSet* pSet = taosArraySearch(pWriter->fs.aDFileSet, &(SDFileSet){.fid = pChunk->fid}, tDFileSetCmprFn, TD_EQ);
+  if (pSet) {
+    diskId = pSet->diskId;
+  } else {
+    // place the new file set on the tier its age belongs to, as commit does
+    int32_t expLevel = tsdbFidLevel(pChunk->fid, &pTsdb->keepCfg, taosGetTimestampSec());
+    if (expLevel < 0 || tfsAllocDisk(pTsdb->pVnode->pTfs, expLevel, &diskId) < 0) {
+      code = terrno ? terrno : TSDB_CODE_FAILED;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+    if (tfsMkdirRecurAt(pTsdb->pVnode->pTfs, pTsdb->path, diskId) < 0) {
+      code = terrno;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+  }
+
+  // commit IDs in (commitID - TSDB_MAX_STT_TRIGGER, commitID] are reserved by the vnode snapshot writer
+  pWriter->pf.fHead = (SHeadFile){.commitID = pWriter->commitID};
+  pWriter->pf.fData = (SDataFile){.commitID = pWriter->commitID};
+  pWriter->pf.fSma = (SSmaFile){.commitID = pWriter->commitID};
+  pWriter->pf.fSet = (SDFileSet){.diskId = diskId,
+                                 .fid = pChunk->fid,
+                                 .pHeadF = &pWriter->pf.fHead,
+                                 .pDataF = &pWriter->pf.fData,
+                                 .pSmaF = &pWriter->pf.fSma,
+                                 .nSttF = pChunk->nSttF};
+  for (int32_t iStt = 0; iStt < pChunk->nSttF; iStt++) {
+    pWriter->pf.fStt[iStt] = (SSttFile){.commitID = pWriter->commitID - iStt};
+    pWriter->pf.fSet.aSttF[iStt] = &pWriter->pf.fStt[iStt];
+  }
+  pWriter->pf.fIdx = -1;
+  pWriter->pf.nFile = 0;
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at line %d since %s, fid:%d", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code),
+              pChunk->fid);
+  }
+  return code;
+}
+
+static int32_t tsdbSnapWriteFileChunk(STsdbSnapWriter* pWriter, SSnapDataHdr* pHdr) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  STsdb*             pTsdb = pWriter->pTsdb;
+  STsdbSnapFileChunk chunk = {0};
+  char               fname[TSDB_FILENAME_LEN];
+
+  int32_t  nHdr = tGetSnapFileChunk(pHdr->data, &chunk);
+  uint8_t* pChunkData = pHdr->data + nHdr;
+  if (nHdr + chunk.cSize != pHdr->size || chunk.szPage != pTsdb->pVnode->config.tsdbPageSize) {
+    code = TSDB_CODE_INVALID_MSG;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  if (taosCalcChecksum(0, pChunkData, chunk.cSize) != chunk.cksum) {
+    code = TSDB_CODE_CHECKSUM_ERROR;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  // switch to a new file set
+  if (pWriter->pf.fSet.pHeadF == NULL || pWriter->pf.fSet.fid != chunk.fid) {
+    if (pWriter->pf.fSet.pHeadF) {
+      code = tsdbSnapWriteFSetEnd(pWriter);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    code = tsdbSnapWriteFSetStart(pWriter, &chunk);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  SDFileSet* pSet = &pWriter->pf.fSet;
+  if (chunk.nSttF != pSet->nSttF || chunk.fIdx < TSDB_SNAP_FILE_HEAD ||
+      chunk.fIdx >= TSDB_SNAP_FILE_STT + pSet->nSttF) {
+    code = TSDB_CODE_INVALID_MSG;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  // switch to a new file
+  if (chunk.fIdx != pWriter->pf.fIdx) {
+    code = tsdbSnapWriteFileEnd(pWriter);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    if (chunk.fIdx == TSDB_SNAP_FILE_HEAD) {
+      pSet->pHeadF->size = chunk.size;
+      pSet->pHeadF->offset = chunk.offset;
+    } else if (chunk.fIdx == TSDB_SNAP_FILE_DATA) {
+      pSet->pDataF->size = chunk.size;
+    } else if (chunk.fIdx == TSDB_SNAP_FILE_SMA) {
+      pSet->pSmaF->size = chunk.size;
+    } else {
+      pSet->aSttF[chunk.fIdx - TSDB_SNAP_FILE_STT]->size = chunk.size;
+      pSet->aSttF[chunk.fIdx - TSDB_SNAP_FILE_STT]->offset = chunk.offset;
+    }
+
+    int64_t size, offset;
+    tsdbSnapFileName(pTsdb, pSet, chunk.fIdx, fname, &size, &offset);
+
+    pWriter->pf.pFD = taosOpenFile(fname, TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC);
+    if (pWriter->pf.pFD == NULL) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+    pWriter->pf.fIdx = chunk.fIdx;
+    pWriter->pf.fSize = chunk.fSize;
+    pWriter->pf.fOffset = 0;
+  }
+
+  // chunks of a file arrive in order
+  if (chunk.cOffset != pWriter->pf.fOffset || chunk.cOffset + chunk.cSize > chunk.fSize) {
+    code = TSDB_CODE_INVALID_MSG;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  if (chunk.cSize > 0 && taosWriteFile(pWriter->pf.pFD, pChunkData, chunk.cSize) != chunk.cSize) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+  pWriter->pf.fOffset += chunk.cSize;
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d %s failed at line %d since %s, fid:%d file:%d offset:%" PRId64, TD_VID(pTsdb->pVnode), __func__,
+              lino, tstrerror(code), chunk.fid, chunk.fIdx, chunk.cOffset);
+  }
+  return code;
+}
+
 // SNAP_DATA_DEL
 static int32_t tsdbSnapWriteDelTableDataStart(STsdbSnapWriter* pWriter, TABLEID* pId) {
   int32_t code = 0;
@@ -1435,6 +1808,11 @@ int32_t tsdbSnapWriterPrepareClose(STsdbSnapWriter* pWriter) {
     TSDB_CHECK_CODE(code, lino, _exit);
   }
 
+  if (pWriter->pf.fSet.pHeadF) {
+    code = tsdbSnapWriteFSetEnd(pWriter);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
   if (pWriter->pDelFWriter) {
     code = tsdbSnapWriteDelDataEnd(pWriter);
     TSDB_CHECK_CODE(code, lino, _exit);
@@ -1479,6 +1857,11 @@ int32_t tsdbSnapWriterClose(STsdbSnapWriter** ppWriter, int8_t rollback) {
   taosArrayDestroy(pWriter->aDelData);
   taosArrayDestroy(pWriter->aDelIdx);
 
+  // SNAP_DATA_TSDB_FILE
+  if (pWriter->pf.pFD) {
+    taosCloseFile(&pWriter->pf.pFD);
+  }
+
   // SNAP_DATA_TSDB
   tBlockDataDestroy(&pWriter->sData);
   tBlockDataDestroy(&pWriter->bData);
@@ -1517,6 +1900,15 @@ int32_t tsdbSnapWrite(STsdbSnapWriter* pWriter, SSnapDataHdr* pHdr) {
     TSDB_CHECK_CODE(code, lino, _exit);
   }
 
+  if (pHdr->type == SNAP_DATA_TSDB_FILE) {
+    code = tsdbSnapWriteFileChunk(pWriter, pHdr);
+    TSDB_CHECK_CODE(code, lino, _exit);
+    goto _exit;
+  } else if (pWriter->pf.fSet.pHeadF) {
+    code = tsdbSnapWriteFSetEnd(pWriter);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
   if (pHdr->type == SNAP_DATA_DEL) {
     code = tsdbSnapWriteDelData(pWriter, pHdr);
     TSDB_CHECK_CODE(code, lino, _exit);
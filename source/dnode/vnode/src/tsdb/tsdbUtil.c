@@ -370,6 +370,11 @@ int32_t tGetSttBlk(uint8_t *p, void *ph) {
 }
 
 // SBlockCol ======================================================
+// high bits of the flag byte: bit 4-6 for SBlockCol.encode, bit 7 set when a SBlockCol.cmprAlg byte follows
+#define TSDB_COL_FLAG_MASK   0xF
+#define TSDB_COL_ENCODE_MASK 0x7
+#define TSDB_COL_HAS_CMPR    0x80
+
 int32_t tPutBlockCol(uint8_t *p, void *ph) {
   int32_t    n = 0;
   SBlockCol *pBlockCol = (SBlockCol *)ph;
@@ -379,7 +384,10 @@ int32_t tPutBlockCol(uint8_t *p, void *ph) {
   n += tPutI16v(p ? p + n : p, pBlockCol->cid);
   n += tPutI8(p ? p + n : p, pBlockCol->type);
   n += tPutI8(p ? p + n : p, pBlockCol->smaOn);
-  n += tPutI8(p ? p + n : p, pBlockCol->flag);
+  n += tPutI8(p ? p + n : p, pBlockCol->flag | (pBlockCol->encode << 4) | (pBlockCol->cmprAlg ? TSDB_COL_HAS_CMPR : 0));
+  if (pBlockCol->cmprAlg) {
+    n += tPutI8(p ? p + n : p, pBlockCol->cmprAlg);
+  }
   n += tPutI32v(p ? p + n : p, pBlockCol->szOrigin);
 
   if (pBlockCol->flag != HAS_NULL) {
@@ -410,8 +418,15 @@ int32_t tGetBlockCol(uint8_t *p, void *ph) {
   n += tGetI8(p + n, &pBlockCol->type);
   n += tGetI8(p + n, &pBlockCol->smaOn);
   n += tGetI8(p + n, &pBlockCol->flag);
+  pBlockCol->cmprAlg = 0;
+  if (pBlockCol->flag & TSDB_COL_HAS_CMPR) {
+    n += tGetI8(p + n, &pBlockCol->cmprAlg);
+  }
   n += tGetI32v(p + n, &pBlockCol->szOrigin);
 
+  pBlockCol->encode = (pBlockCol->flag >> 4) & TSDB_COL_ENCODE_MASK;
+  pBlockCol->flag &= TSDB_COL_FLAG_MASK;
+
   ASSERT(pBlockCol->flag && (pBlockCol->flag != HAS_NONE));
 
   pBlockCol->szBitmap = 0;
@@ -438,6 +453,17 @@ int32_t tGetBlockCol(uint8_t *p, void *ph) {
   return n;
 }
 
+// the lowest SDiskDataHdr.fmtVer able to read the column
+uint32_t tBlockColFmtVer(const SBlockCol *pBlockCol) {
+  if (pBlockCol->cmprAlg) {
+    return TSDB_DISK_DATA_FMT_VER_CMPR;
+  }
+  if (pBlockCol->encode != TSDB_COL_ENCODE_PLAIN) {
+    return TSDB_DISK_DATA_FMT_VER_DICT;
+  }
+  return TSDB_DISK_DATA_FMT_VER_PLAIN;
+}
+
 int32_t tBlockColCmprFn(const void *p1, const void *p2) {
   if (((SBlockCol *)p1)->cid < ((SBlockCol *)p2)->cid) {
     return -1;
@@ -1424,12 +1450,14 @@ void tBlockDataGetColData(SBlockData *pBlockData, int16_t cid, SColData **ppColD
   *ppColData = NULL;
 }
 
-int32_t tCmprBlockData(SBlockData *pBlockData, int8_t cmprAlg, uint8_t **ppOut, int32_t *szOut, uint8_t *aBuf[],
-                       int32_t aBufN[]) {
+static int32_t tsdbChooseCmprAlg(SColData *pColData, int8_t cmprAlg, int8_t *colCmprAlg, uint8_t **ppBuf);
+
+int32_t tCmprBlockData(SBlockData *pBlockData, int8_t cmprAlg, int8_t toLast, uint8_t **ppOut, int32_t *szOut,
+                       uint8_t *aBuf[], int32_t aBufN[]) {
   int32_t code = 0;
 
   SDiskDataHdr hdr = {.delimiter = TSDB_FILE_DLMT,
-                      .fmtVer = 0,
+                      .fmtVer = TSDB_DISK_DATA_FMT_VER_PLAIN,
                       .suid = pBlockData->suid,
                       .uid = pBlockData->uid,
                       .nRow = pBlockData->nRow,
@@ -1452,12 +1480,21 @@ int32_t tCmprBlockData(SBlockData *pBlockData, int8_t cmprAlg, uint8_t **ppOut,
                           .szOrigin = pColData->nData};
 
     if (pColData->flag != HAS_NULL) {
+      // stt blocks are merged again soon, they keep the block-level algorithm
+      if (!toLast) {
+        int8_t colCmprAlg;
+        code = tsdbChooseCmprAlg(pColData, cmprAlg, &colCmprAlg, &aBuf[2]);
+        if (code) goto _exit;
+        if (colCmprAlg != cmprAlg) blockCol.cmprAlg = TSDB_COL_CMPR_ALG_SET(colCmprAlg);
+      }
+
       code = tsdbCmprColData(pColData, cmprAlg, &blockCol, &aBuf[0], aBufN[0], &aBuf[2]);
       if (code) goto _exit;
 
       blockCol.offset = aBufN[0];
       aBufN[0] = aBufN[0] + blockCol.szBitmap + blockCol.szOffset + blockCol.szValue;
     }
+    hdr.fmtVer = TMAX(hdr.fmtVer, tBlockColFmtVer(&blockCol));
 
     code = tRealloc(&aBuf[1], hdr.szBlkCol + tPutBlockCol(NULL, &blockCol));
     if (code) goto _exit;
@@ -1523,6 +1560,10 @@ int32_t tDecmprBlockData(uint8_t *pIn, int32_t szIn, SBlockData *pBlockData, uin
   // SDiskDataHdr
   n += tGetDiskDataHdr(pIn + n, &hdr);
   ASSERT(hdr.delimiter == TSDB_FILE_DLMT);
+  if (hdr.fmtVer > TSDB_DISK_DATA_FMT_VER) {
+    code = TSDB_CODE_VERSION_NOT_COMPATIBLE;
+    goto _exit;
+  }
 
   pBlockData->suid = hdr.suid;
   pBlockData->uid = hdr.uid;
@@ -1574,6 +1615,11 @@ int32_t tDecmprBlockData(uint8_t *pIn, int32_t szIn, SBlockData *pBlockData, uin
 
     SColData *pColData = &pBlockData->aColData[iColData++];
 
+    if (tBlockColFmtVer(&blockCol) > hdr.fmtVer) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      goto _exit;
+    }
+
     tColDataInit(pColData, blockCol.cid, blockCol.type, blockCol.smaOn);
     if (blockCol.flag == HAS_NULL) {
       for (int32_t iRow = 0; iRow < hdr.nRow; iRow++) {
@@ -1718,6 +1764,230 @@ _exit:
   return code;
 }
 
+/*
+ * Dictionary encoding of a variant data type column. Code 0 is the empty value, which also stands for the NULL and
+ * NONE rows, and the dictionary entries get the codes from 1 in the order they first appear. The offset part holds
+ * the codes, and the value part holds the raw size of the dictionary followed by the dictionary.
+ */
+#define TSDB_DICT_MIN_ROWS  64
+#define TSDB_DICT_MAX_RATIO 4  // at least this many rows per dictionary entry
+
+static int32_t tsdbBuildColDict(SColData *pColData, uint8_t **ppCode, uint8_t **ppDict, int32_t *szDict, bool *dict) {
+  int32_t   code = 0;
+  int32_t   maxEntry = pColData->nVal / TSDB_DICT_MAX_RATIO;
+  int32_t   nEntry = 0;
+  SHashObj *pHash = NULL;
+
+  *dict = false;
+  *szDict = 0;
+
+  if (pColData->nVal < TSDB_DICT_MIN_ROWS || (pColData->flag & HAS_VALUE) == 0) goto _exit;
+
+  pHash = taosHashInit(maxEntry, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  if (pHash == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  code = tRealloc(ppCode, sizeof(int32_t) * pColData->nVal);
+  if (code) goto _exit;
+
+  int32_t *aCode = (int32_t *)*ppCode;
+  for (int32_t iVal = 0; iVal < pColData->nVal; iVal++) {
+    int32_t  nData = ((iVal + 1 < pColData->nVal) ? pColData->aOffset[iVal + 1] : pColData->nData) -
+                    pColData->aOffset[iVal];
+    uint8_t *pData = pColData->pData + pColData->aOffset[iVal];
+
+    if (nData == 0) {
+      aCode[iVal] = 0;
+      continue;
+    }
+
+    int32_t *pCode = taosHashGet(pHash, pData, nData);
+    if (pCode) {
+      aCode[iVal] = *pCode;
+      continue;
+    }
+
+    if (++nEntry > maxEntry) goto _exit;  // too many distinct values
+
+    code = tRealloc(ppDict, *szDict + sizeof(int32_t) + 1 + nData);
+    if (code) goto _exit;
+    *szDict += tPutI32v(*ppDict + *szDict, nData);
+    memcpy(*ppDict + *szDict, pData, nData);
+    *szDict += nData;
+
+    if (taosHashPut(pHash, pData, nData, &nEntry, sizeof(nEntry)) != 0) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+    aCode[iVal] = nEntry;
+  }
+
+  *dict = (*szDict < pColData->nData);
+
+_exit:
+  taosHashCleanup(pHash);
+  return code;
+}
+
+static int32_t tsdbCmprColDict(SColData *pColData, int8_t cmprAlg, SBlockCol *pBlockCol, uint8_t **ppOut, int32_t nOut,
+                               uint8_t **ppBuf, bool *dict) {
+  int32_t  code = 0;
+  uint8_t *pCode = NULL;
+  uint8_t *pDict = NULL;
+  int32_t  szDict = 0;
+
+  code = tsdbBuildColDict(pColData, &pCode, &pDict, &szDict, dict);
+  if (code || !(*dict)) goto _exit;
+
+  // codes
+  code = tsdbCmprData(pCode, sizeof(int32_t) * pColData->nVal, TSDB_DATA_TYPE_INT, cmprAlg, ppOut, nOut,
+                      &pBlockCol->szOffset, ppBuf);
+  if (code) goto _exit;
+
+  // dictionary
+  int32_t n = nOut + pBlockCol->szOffset;
+  code = tRealloc(ppOut, n + tPutI32v(NULL, szDict));
+  if (code) goto _exit;
+  n += tPutI32v(*ppOut + n, szDict);
+
+  code = tsdbCmprData(pDict, szDict, pColData->type, cmprAlg, ppOut, n, &pBlockCol->szValue, ppBuf);
+  if (code) goto _exit;
+  pBlockCol->szValue += (n - nOut - pBlockCol->szOffset);
+
+  pBlockCol->encode = TSDB_COL_ENCODE_DICT;
+
+_exit:
+  tFree(pCode);
+  tFree(pDict);
+  return code;
+}
+
+static int32_t tsdbDecmprColDict(uint8_t *pIn, SBlockCol *pBlockCol, int8_t cmprAlg, SColData *pColData,
+                                 uint8_t **ppBuf) {
+  int32_t   code = 0;
+  uint8_t  *pCode = NULL;
+  uint8_t  *pDict = NULL;
+  int32_t   szDict = 0;
+  SArray   *aEntry = NULL;  // SArray<int32_t>, offset of each dictionary entry
+  uint8_t  *p = pIn;
+
+  // codes
+  code = tsdbDecmprData(p, pBlockCol->szOffset, TSDB_DATA_TYPE_INT, cmprAlg, &pCode, sizeof(int32_t) * pColData->nVal,
+                        ppBuf);
+  if (code) goto _exit;
+  p += pBlockCol->szOffset;
+
+  // dictionary
+  int32_t n = tGetI32v(p, &szDict);
+  if (szDict > 0) {
+    code = tsdbDecmprData(p + n, pBlockCol->szValue - n, pColData->type, cmprAlg, &pDict, szDict, ppBuf);
+    if (code) goto _exit;
+  }
+
+  aEntry = taosArrayInit(64, sizeof(int32_t));
+  if (aEntry == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+  for (int32_t offset = 0; offset < szDict;) {
+    int32_t nData;
+    if (taosArrayPush(aEntry, &offset) == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+    offset += tGetI32v(pDict + offset, &nData);
+    offset += nData;
+  }
+
+  // rebuild offsets and values
+  code = tRealloc((uint8_t **)&pColData->aOffset, sizeof(int32_t) * pColData->nVal);
+  if (code) goto _exit;
+  code = tRealloc(&pColData->pData, pColData->nData);
+  if (code) goto _exit;
+
+  int32_t *aCode = (int32_t *)pCode;
+  int32_t  nEntry = taosArrayGetSize(aEntry);
+  int32_t  nData = 0;
+  for (int32_t iVal = 0; iVal < pColData->nVal; iVal++) {
+    pColData->aOffset[iVal] = nData;
+    if (aCode[iVal] == 0) continue;
+
+    if (aCode[iVal] < 0 || aCode[iVal] > nEntry) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      goto _exit;
+    }
+
+    int32_t  len;
+    uint8_t *pEntry = pDict + *(int32_t *)taosArrayGet(aEntry, aCode[iVal] - 1);
+    pEntry += tGetI32v(pEntry, &len);
+    if (nData + len > pColData->nData) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      goto _exit;
+    }
+
+    memcpy(pColData->pData + nData, pEntry, len);
+    nData += len;
+  }
+
+  if (nData != pColData->nData) {
+    code = TSDB_CODE_FILE_CORRUPTED;
+  }
+
+_exit:
+  taosArrayDestroy(aEntry);
+  tFree(pCode);
+  tFree(pDict);
+  return code;
+}
+
+/*
+ * Pick the compression algorithm of a column by compressing a sample of its values with each stage. The second stage
+ * costs another pass on decode, so it is only kept when it saves enough, and a column that does not compress is stored
+ * plain.
+ */
+#define TSDB_CMPR_SAMPLE_SIZE   4096
+#define TSDB_CMPR_TWO_STAGE_GAIN 90  // percent of the one stage size the second stage has to reach
+#define TSDB_CMPR_ONE_STAGE_GAIN 95  // percent of the raw size the first stage has to reach
+
+static int32_t tsdbChooseCmprAlg(SColData *pColData, int8_t cmprAlg, int8_t *colCmprAlg, uint8_t **ppBuf) {
+  int32_t  code = 0;
+  uint8_t *pSample = NULL;
+  int32_t  szRaw;
+  int32_t  szOne = 0;
+  int32_t  szTwo = 0;
+
+  *colCmprAlg = cmprAlg;
+
+  if (cmprAlg == NO_COMPRESSION || !tsAdaptiveCmpr || pColData->nData == 0) goto _exit;
+
+  szRaw = TMIN(pColData->nData, TSDB_CMPR_SAMPLE_SIZE);
+  if (!IS_VAR_DATA_TYPE(pColData->type)) {
+    szRaw -= szRaw % tDataTypes[pColData->type].bytes;
+  }
+  if (szRaw <= 0) goto _exit;
+
+  code = tsdbCmprData(pColData->pData, szRaw, pColData->type, ONE_STAGE_COMP, &pSample, 0, &szOne, ppBuf);
+  if (code) goto _exit;
+
+  code = tsdbCmprData(pColData->pData, szRaw, pColData->type, TWO_STAGE_COMP, &pSample, 0, &szTwo, ppBuf);
+  if (code) goto _exit;
+
+  if ((int64_t)szOne * 100 > (int64_t)szRaw * TSDB_CMPR_ONE_STAGE_GAIN &&
+      (int64_t)szTwo * 100 > (int64_t)szRaw * TSDB_CMPR_ONE_STAGE_GAIN) {
+    *colCmprAlg = NO_COMPRESSION;
+  } else if ((int64_t)szTwo * 100 <= (int64_t)szOne * TSDB_CMPR_TWO_STAGE_GAIN) {
+    *colCmprAlg = TWO_STAGE_COMP;
+  } else {
+    *colCmprAlg = ONE_STAGE_COMP;
+  }
+
+_exit:
+  tFree(pSample);
+  return code;
+}
+
 int32_t tsdbCmprColData(SColData *pColData, int8_t cmprAlg, SBlockCol *pBlockCol, uint8_t **ppOut, int32_t nOut,
                         uint8_t **ppBuf) {
   int32_t code = 0;
@@ -1727,6 +1997,7 @@ int32_t tsdbCmprColData(SColData *pColData, int8_t cmprAlg, SBlockCol *pBlockCol
   pBlockCol->szBitmap = 0;
   pBlockCol->szOffset = 0;
   pBlockCol->szValue = 0;
+  cmprAlg = TSDB_COL_CMPR_ALG(pBlockCol, cmprAlg);
 
   int32_t size = 0;
   // bitmap
@@ -1744,6 +2015,14 @@ int32_t tsdbCmprColData(SColData *pColData, int8_t cmprAlg, SBlockCol *pBlockCol
   }
   size += pBlockCol->szBitmap;
 
+  // offset and value as codes and dictionary, off by default as the versions before it can not read the file
+  if (tsDictCmpr && IS_VAR_DATA_TYPE(pColData->type) && pColData->flag != (HAS_NULL | HAS_NONE)) {
+    bool dict = false;
+    code = tsdbCmprColDict(pColData, cmprAlg, pBlockCol, ppOut, nOut + size, ppBuf, &dict);
+    if (code) goto _exit;
+    if (dict) goto _exit;
+  }
+
   // offset
   if (IS_VAR_DATA_TYPE(pColData->type) && pColData->flag != (HAS_NULL | HAS_NONE)) {
     code = tsdbCmprData((uint8_t *)pColData->aOffset, sizeof(int32_t) * pColData->nVal, TSDB_DATA_TYPE_INT, cmprAlg,
@@ -1774,6 +2053,7 @@ int32_t tsdbDecmprColData(uint8_t *pIn, SBlockCol *pBlockCol, int8_t cmprAlg, in
   pColData->flag = pBlockCol->flag;
   pColData->nVal = nVal;
   pColData->nData = pBlockCol->szOrigin;
+  cmprAlg = TSDB_COL_CMPR_ALG(pBlockCol, cmprAlg);
 
   uint8_t *p = pIn;
   // bitmap
@@ -1790,6 +2070,12 @@ int32_t tsdbDecmprColData(uint8_t *pIn, SBlockCol *pBlockCol, int8_t cmprAlg, in
   }
   p += pBlockCol->szBitmap;
 
+  // offset and value from codes and dictionary
+  if (pBlockCol->encode == TSDB_COL_ENCODE_DICT) {
+    code = tsdbDecmprColDict(p, pBlockCol, cmprAlg, pColData, ppBuf);
+    goto _exit;
+  }
+
   // offset
   if (pBlockCol->szOffset) {
     code = tsdbDecmprData(p, pBlockCol->szOffset, TSDB_DATA_TYPE_INT, cmprAlg, (uint8_t **)&pColData->aOffset,
@@ -18,12 +18,15 @@
 typedef struct {
   SVnode    *pVnode;
   int64_t    now;
+  int64_t    rewriteID;  // commit ID of the files rewritten for colder tiers
   int64_t    commitID;
   SVnodeInfo info;
 } SRetentionInfo;
 
 extern bool    tsdbShouldDoRetention(STsdb *pTsdb, int64_t now);
-extern int32_t tsdbDoRetention(STsdb *pTsdb, int64_t now);
+extern int32_t tsdbPrepareRetention(STsdb *pTsdb, int64_t now, int64_t commitID, SArray **paRFSet);
+extern int32_t tsdbDoRetention(STsdb *pTsdb, int64_t now, SArray *aRFSet);
+extern void    tsdbClearRetention(STsdb *pTsdb, SArray *aRFSet, bool committed);
 extern int32_t tsdbCommitRetention(STsdb *pTsdb);
 
 static int32_t vnodePrepareRentention(SVnode *pVnode, SRetentionInfo *pInfo) {
@@ -63,6 +66,17 @@ static int32_t vnodeRetentionTask(void *param) {
   SRetentionInfo *pInfo = (SRetentionInfo *)param;
   SVnode         *pVnode = pInfo->pVnode;
   char            dir[TSDB_FILENAME_LEN] = {0};
+  SArray         *aRFSet = NULL;
+
+  // rewrite the file sets moving to colder tiers while commits go on, only the swap below blocks them
+  (void)tsdbPrepareRetention(pVnode->pTsdb, pInfo->now, pInfo->rewriteID, &aRFSet);
+
+  code = vnodePrepareRentention(pVnode, pInfo);
+  if (code) {
+    tsdbClearRetention(pVnode->pTsdb, aRFSet, false);
+    taosMemoryFree(pInfo);
+    return code;
+  }
 
   if (pVnode->pTfs) {
     snprintf(dir, TSDB_FILENAME_LEN, "%s%s%s", tfsGetPrimaryPath(pVnode->pTfs), TD_DIRSEP, pVnode->path);
@@ -79,7 +93,7 @@ static int32_t vnodeRetentionTask(void *param) {
   }
 
   // do job
-  code = tsdbDoRetention(pInfo->pVnode->pTsdb, pInfo->now);
+  code = tsdbDoRetention(pInfo->pVnode->pTsdb, pInfo->now, aRFSet);
   TSDB_CHECK_CODE(code, lino, _exit);
 
   // commit info
@@ -94,6 +108,7 @@ _exit:
   } else {
     vInfo("vgId:%d %s done", TD_VID(pInfo->pVnode), __func__);
   }
+  tsdbClearRetention(pVnode->pTsdb, aRFSet, code == 0);
   tsem_post(&pInfo->pVnode->canCommit);
   taosMemoryFree(pInfo);
   return code;
@@ -114,8 +129,10 @@ int32_t vnodeAsyncRentention(SVnode *pVnode, int64_t now) {
   pInfo->pVnode = pVnode;
   pInfo->now = now;
 
-  code = vnodePrepareRentention(pVnode, pInfo);
-  TSDB_CHECK_CODE(code, lino, _exit);
+  // reserve a commit ID for the rewritten files, so they never collide with the files of a commit
+  tsem_wait(&pVnode->canCommit);
+  pInfo->rewriteID = ++pVnode->state.commitID;
+  tsem_post(&pVnode->canCommit);
 
   vnodeScheduleTask(vnodeRetentionTask, pInfo);
 
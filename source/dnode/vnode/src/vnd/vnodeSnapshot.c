@@ -21,6 +21,7 @@ struct SVSnapReader {
   int64_t sver;
   int64_t ever;
   int64_t index;
+  int8_t  physical;  // the receiver accepts data files as they are
   // config
   int8_t cfgDone;
   // meta
@@ -44,7 +45,7 @@ struct SVSnapReader {
   SRSmaSnapReader *pRsmaReader;
 };
 
-int32_t vnodeSnapReaderOpen(SVnode *pVnode, int64_t sver, int64_t ever, SVSnapReader **ppReader) {
+int32_t vnodeSnapReaderOpen(SVnode *pVnode, SSnapshotParam *pParam, SVSnapReader **ppReader) {
   int32_t       code = 0;
   SVSnapReader *pReader = NULL;
 
@@ -54,10 +55,12 @@ int32_t vnodeSnapReaderOpen(SVnode *pVnode, int64_t sver, int64_t ever, SVSnapRe
     goto _err;
   }
   pReader->pVnode = pVnode;
-  pReader->sver = sver;
-  pReader->ever = ever;
+  pReader->sver = pParam->start;
+  pReader->ever = pParam->end;
+  pReader->physical = (pParam->peerCaps & SYNC_SNAPSHOT_CAP_FILE) ? 1 : 0;
 
-  vInfo("vgId:%d, vnode snapshot reader opened, sver:%" PRId64 " ever:%" PRId64, TD_VID(pVnode), sver, ever);
+  vInfo("vgId:%d, vnode snapshot reader opened, sver:%" PRId64 " ever:%" PRId64 " caps:%d", TD_VID(pVnode),
+        pReader->sver, pReader->ever, pParam->peerCaps);
   *ppReader = pReader;
   return code;
 
@@ -161,7 +164,7 @@ int32_t vnodeSnapRead(SVSnapReader *pReader, uint8_t **ppData, uint32_t *nData)
     // open if not
     if (pReader->pTsdbReader == NULL) {
       code = tsdbSnapReaderOpen(pReader->pVnode->pTsdb, pReader->sver, pReader->ever, SNAP_DATA_TSDB,
-                                &pReader->pTsdbReader);
+                                pReader->physical, &pReader->pTsdbReader);
       if (code) goto _err;
     }
 
@@ -310,8 +313,10 @@ int32_t vnodeSnapWriterOpen(SVnode *pVnode, int64_t sver, int64_t ever, SVSnapWr
   pWriter->sver = sver;
   pWriter->ever = ever;
 
-  // inc commit ID
-  pWriter->commitID = ++pVnode->state.commitID;
+  // inc commit ID, a range of ids is reserved so that each stt file of a file set copied physically by
+  // the tsdb snapshot gets its own name (see tsdbSnapWriteFileChunk)
+  pVnode->state.commitID += TSDB_MAX_STT_TRIGGER;
+  pWriter->commitID = pVnode->state.commitID;
 
   vInfo("vgId:%d, vnode snapshot writer opened, sver:%" PRId64 " ever:%" PRId64 " commit id:%" PRId64, TD_VID(pVnode),
         sver, ever, pWriter->commitID);
@@ -454,6 +459,7 @@ int32_t vnodeSnapWrite(SVSnapWriter *pWriter, uint8_t *pData, uint32_t nData) {
       if (code) goto _err;
     } break;
     case SNAP_DATA_TSDB:
+    case SNAP_DATA_TSDB_FILE:
     case SNAP_DATA_DEL: {
       // tsdb
       if (pWriter->pTsdbSnapWriter == NULL) {
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+#include <taoserror.h>
+#include <tglobal.h>
+#include <meta.h>
+#include <vnodeInt.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+namespace {
+
+const tb_uid_t kSuid = 1000;
+const int32_t  kTables = 20;
+const int16_t  kIntCid = 2;
+const int16_t  kStrCid = 3;
+
+STag *createTag(int32_t iv, const char *sv) {
+  SArray *pVals = taosArrayInit(2, sizeof(STagVal));
+
+  STagVal v1 = {0};
+  v1.cid = kIntCid;
+  v1.type = TSDB_DATA_TYPE_INT;
+  v1.i64 = 0;
+  memcpy(&v1.i64, &iv, sizeof(int32_t));
+  taosArrayPush(pVals, &v1);
+
+  STagVal v2 = {0};
+  v2.cid = kStrCid;
+  v2.type = TSDB_DATA_TYPE_VARCHAR;
+  v2.pData = (uint8_t *)sv;
+  v2.nData = strlen(sv);
+  taosArrayPush(pVals, &v2);
+
+  STag *pTag = NULL;
+  tTagNew(pVals, 1, 0, &pTag);
+  taosArrayDestroy(pVals);
+  return pTag;
+}
+
+STagVal intVal(int8_t type, int64_t v) {
+  STagVal val = {0};
+  val.cid = kIntCid;
+  val.type = type;
+  val.i64 = v;
+  return val;
+}
+
+}  // namespace
+
+class MetaTagBitmapTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    taosRemoveDir(path);
+    taosMkDir(path);
+
+    pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    pVnode->path = path;
+    pVnode->config.vgId = 1;
+    pVnode->config.szPage = 4096;
+    pVnode->config.szCache = 256;
+    ASSERT_EQ(metaOpen(pVnode, &pMeta, 0), 0);
+    ASSERT_EQ(metaBegin(pMeta, META_BEGIN_HEAP_OS), 0);
+
+    tsTagFilterBitmap = true;
+    for (int32_t i = 0; i < kTables; ++i) {
+      putChild(i + 1, i % 4, (i % 2) ? "odd" : "even");
+    }
+  }
+
+  void TearDown() override {
+    metaClose(&pMeta);
+    taosMemoryFree(pVnode);
+    taosRemoveDir(path);
+  }
+
+  void putChild(tb_uid_t uid, int32_t iv, const char *sv) {
+    SCtbIdxKey key = {.suid = kSuid, .uid = uid};
+    STag      *pTag = createTag(iv, sv);
+    ASSERT_EQ(tdbTbUpsert(pMeta->pCtbIdx, &key, sizeof(key), pTag, pTag->len, pMeta->txn), 0);
+    metaTagBitmapUpsert(pMeta, kSuid, uid, pTag);
+    tTagFree(pTag);
+  }
+
+  SMetaTagBitmapReader *acquire(int16_t cid) {
+    SArray *pCids = taosArrayInit(1, sizeof(int16_t));
+    taosArrayPush(pCids, &cid);
+
+    SMetaTagBitmapReader *pReader = NULL;
+    EXPECT_EQ(metaTagBitmapAcquire(pMeta, kSuid, pCids, &pReader), TSDB_CODE_SUCCESS);
+    taosArrayDestroy(pCids);
+    return pReader;
+  }
+
+  // uids of the child tables whose tag equals any of the values
+  std::vector<tb_uid_t> match(SMetaTagBitmapReader *pReader, const std::vector<STagVal> &vals) {
+    int32_t  len = metaTagBitmapBytes(pReader);
+    uint8_t *pBits = (uint8_t *)taosMemoryCalloc(1, len + 1);
+    for (const STagVal &val : vals) {
+      EXPECT_EQ(metaTagBitmapOrEqual(pReader, &val, pBits), TSDB_CODE_SUCCESS);
+    }
+
+    SArray *pUidList = taosArrayInit(8, sizeof(tb_uid_t));
+    EXPECT_EQ(metaTagBitmapToUidList(pReader, pBits, pUidList), TSDB_CODE_SUCCESS);
+
+    std::vector<tb_uid_t> uids;
+    for (int32_t i = 0; i < taosArrayGetSize(pUidList); ++i) {
+      uids.push_back(*(tb_uid_t *)taosArrayGet(pUidList, i));
+    }
+    std::sort(uids.begin(), uids.end());
+
+    taosArrayDestroy(pUidList);
+    taosMemoryFree(pBits);
+    return uids;
+  }
+
+  char    path[64] = "/tmp/metaTagBitmapTest";
+  SVnode *pVnode = NULL;
+  SMeta  *pMeta = NULL;
+};
+
+TEST_F(MetaTagBitmapTest, equalAndIn) {
+  SMetaTagBitmapReader *pReader = acquire(kIntCid);
+  ASSERT_NE(pReader, nullptr);
+
+  std::vector<tb_uid_t> uids = match(pReader, {intVal(TSDB_DATA_TYPE_INT, 1)});
+  ASSERT_EQ(uids.size(), kTables / 4);
+  for (tb_uid_t uid : uids) {
+    EXPECT_EQ((uid - 1) % 4, 1);
+  }
+
+  // the constants of an IN list are bigint for an int tag
+  uids = match(pReader, {intVal(TSDB_DATA_TYPE_BIGINT, 0), intVal(TSDB_DATA_TYPE_BIGINT, 3)});
+  ASSERT_EQ(uids.size(), kTables / 2);
+  for (tb_uid_t uid : uids) {
+    EXPECT_TRUE((uid - 1) % 4 == 0 || (uid - 1) % 4 == 3);
+  }
+
+  // out of the range of the tag type, or negative for unsigned, never matches
+  EXPECT_EQ(match(pReader, {intVal(TSDB_DATA_TYPE_BIGINT, 1LL << 40)}).size(), 0);
+  EXPECT_EQ(match(pReader, {intVal(TSDB_DATA_TYPE_UBIGINT, 2)}).size(), kTables / 4);
+  EXPECT_EQ(match(pReader, {intVal(TSDB_DATA_TYPE_UBIGINT, UINT64_MAX)}).size(), 0);
+
+  metaTagBitmapRelease(pReader);
+}
+
+TEST_F(MetaTagBitmapTest, varchar) {
+  SMetaTagBitmapReader *pReader = acquire(kStrCid);
+  ASSERT_NE(pReader, nullptr);
+
+  STagVal val = {0};
+  val.cid = kStrCid;
+  val.type = TSDB_DATA_TYPE_VARCHAR;
+  val.pData = (uint8_t *)"odd";
+  val.nData = 3;
+  std::vector<tb_uid_t> uids = match(pReader, {val});
+  ASSERT_EQ(uids.size(), kTables / 2);
+  for (tb_uid_t uid : uids) {
+    EXPECT_EQ(uid % 2, 0);
+  }
+
+  metaTagBitmapRelease(pReader);
+}
+
+TEST_F(MetaTagBitmapTest, updateAndRemove) {
+  SMetaTagBitmapReader *pReader = acquire(kIntCid);
+  ASSERT_NE(pReader, nullptr);
+  metaTagBitmapRelease(pReader);
+
+  // uid 2 is moved from 1 to 3, uid 6 is dropped, uid 100 is created with 1
+  putChild(2, 3, "odd");
+  metaTagBitmapRemove(pMeta, kSuid, 6);
+  putChild(100, 1, "even");
+
+  pReader = acquire(kIntCid);
+  ASSERT_NE(pReader, nullptr);
+
+  std::vector<tb_uid_t> uids = match(pReader, {intVal(TSDB_DATA_TYPE_INT, 1)});
+  std::vector<tb_uid_t> expect;
+  for (tb_uid_t uid = 1; uid <= kTables; ++uid) {
+    if ((uid - 1) % 4 == 1 && uid != 2 && uid != 6) expect.push_back(uid);
+  }
+  expect.push_back(100);
+  EXPECT_EQ(uids, expect);
+
+  uids = match(pReader, {intVal(TSDB_DATA_TYPE_INT, 3)});
+  EXPECT_NE(std::find(uids.begin(), uids.end(), 2), uids.end());
+
+  metaTagBitmapRelease(pReader);
+}
+
+TEST_F(MetaTagBitmapTest, concurrentReaders) {
+  SMetaTagBitmapReader *pReader1 = acquire(kIntCid);
+  ASSERT_NE(pReader1, nullptr);
+
+  // readers share the index, and the meta lock is not held by them
+  SMetaTagBitmapReader *pReader2 = acquire(kIntCid);
+  ASSERT_NE(pReader2, nullptr);
+  ASSERT_EQ(metaWLock(pMeta), 0);
+  metaULock(pMeta);
+
+  EXPECT_EQ(match(pReader1, {intVal(TSDB_DATA_TYPE_INT, 2)}), match(pReader2, {intVal(TSDB_DATA_TYPE_BIGINT, 2)}));
+
+  metaTagBitmapRelease(pReader2);
+  metaTagBitmapRelease(pReader1);
+}
+
+TEST_F(MetaTagBitmapTest, disabled) {
+  // too many distinct values, the condition can not be answered by the index
+  for (int32_t i = 0; i < 100; ++i) {
+    putChild(200 + i, 1000 + i, "even");
+  }
+
+  EXPECT_EQ(acquire(kIntCid), nullptr);
+
+  // the other column is still usable
+  SMetaTagBitmapReader *pReader = acquire(kStrCid);
+  EXPECT_NE(pReader, nullptr);
+  metaTagBitmapRelease(pReader);
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <taoserror.h>
+#include <tq.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+// A tq with the push manager only, the push timer expires its entries every 100ms.
+class TqPushTimerTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { ASSERT_EQ(tqInit(), 0); }
+  static void TearDownTestSuite() { tqCleanUp(); }
+
+  STQ *newTq() {
+    STQ *pTq = (STQ *)taosMemoryCalloc(1, sizeof(STQ));
+    taosInitRWLatch(&pTq->pushLock);
+    pTq->pPushMgr = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), true, HASH_NO_LOCK);
+    return pTq;
+  }
+
+  void putEntry(STQ *pTq, int64_t consumerId, int64_t deadline) {
+    STqPushEntry *pEntry = (STqPushEntry *)taosMemoryCalloc(1, sizeof(STqPushEntry));
+    pEntry->deadline = deadline;
+    snprintf(pEntry->subKey, sizeof(pEntry->subKey), "cgroup:topic%" PRId64, consumerId);
+    taosHashPut(pTq->pPushMgr, pEntry->subKey, strlen(pEntry->subKey), &pEntry, POINTER_BYTES);
+  }
+
+  void freeEntries(STQ *pTq) {
+    void *pIter = NULL;
+    while ((pIter = taosHashIterate(pTq->pPushMgr, pIter)) != NULL) {
+      taosMemoryFree(*(STqPushEntry **)pIter);
+    }
+    taosHashCleanup(pTq->pPushMgr);
+  }
+};
+
+TEST_F(TqPushTimerTest, stopThenFree) {
+  // the tq is released right after the timer is stopped, whether or not a check is running at that time
+  for (int32_t i = 0; i < 20; i++) {
+    STQ *pTq = newTq();
+    ASSERT_EQ(tqStartPushTimer(pTq), 0);
+    ASSERT_GT(pTq->refId, 0);
+
+    taosMsleep(i * 13 % 250);
+    tqStopPushTimer(pTq);
+    EXPECT_EQ(atomic_load_8(&pTq->closing), 1);
+
+    freeEntries(pTq);
+    tqRemoveRef(pTq);
+  }
+
+  // the callbacks armed before the stop find the tq gone
+  taosMsleep(300);
+}
+
+TEST_F(TqPushTimerTest, keepsWaitingEntries) {
+  STQ    *pTq = newTq();
+  int64_t now = taosGetTimestampMs();
+
+  putEntry(pTq, 1, 0);
+  putEntry(pTq, 2, now + 60000);
+  tqExpirePushEntry(pTq, now);
+  EXPECT_EQ(taosHashGetSize(pTq->pPushMgr), 2);
+
+  freeEntries(pTq);
+  taosMemoryFree(pTq);
+}
+
+TEST_F(TqPushTimerTest, noExpireAfterClose) {
+  STQ    *pTq = newTq();
+  int64_t now = taosGetTimestampMs();
+
+  ASSERT_EQ(tqStartPushTimer(pTq), 0);
+  tqStopPushTimer(pTq);
+
+  // due, but the tq is closing and the entries are left to tqClose
+  putEntry(pTq, 1, now - 1);
+  tqExpirePushEntry(pTq, now);
+  EXPECT_EQ(taosHashGetSize(pTq->pPushMgr), 1);
+
+  freeEntries(pTq);
+  tqRemoveRef(pTq);
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <taoserror.h>
+#include <tq.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#include "stub.h"
+
+namespace {
+
+int32_t scanCount = 0;
+int64_t committedVer = 0;
+
+// a wal scan returning one block, its content and end offset derived from the start version
+int32_t tqTestScanData(STQ *pTq, const STqHandle *pHandle, SMqDataRsp *pRsp, STqOffsetVal *pOffset) {
+  scanCount++;
+
+  int32_t len = 16;
+  char   *buf = (char *)taosMemoryMalloc(len);
+  memset(buf, (int)(pOffset->version & 0x7F), len);
+  taosArrayPush(pRsp->blockDataLen, &len);
+  taosArrayPush(pRsp->blockData, &buf);
+  pRsp->blockNum++;
+
+  pRsp->rspOffset.type = TMQ_OFFSET__LOG;
+  pRsp->rspOffset.version = pOffset->version + 10;
+  return 0;
+}
+
+int64_t tqTestGetCommittedVer(SWal *pWal) { return committedVer; }
+
+}  // namespace
+
+// The log scan results of a column topic are cached by (start version, query, topic).
+class TqRspCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    stub.set(tqScanData, tqTestScanData);
+    stub.set(walGetCommittedVer, tqTestGetCommittedVer);
+    scanCount = 0;
+    committedVer = 1000;
+
+    pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    pVnode->config.vgId = 2;
+    pTq = (STQ *)taosMemoryCalloc(1, sizeof(STQ));
+    pTq->pVnode = pVnode;
+    pTq->pRspCache = taosLRUCacheInit(1024 * 1024, -1, .5);
+    ASSERT_NE(pTq->pRspCache, nullptr);
+  }
+
+  void TearDown() override {
+    taosLRUCacheCleanup(pTq->pRspCache);
+    taosMemoryFree(pTq);
+    taosMemoryFree(pVnode);
+  }
+
+  void initHandle(STqHandle *pHandle, const char *subKey, char *qmsg) {
+    memset(pHandle, 0, sizeof(STqHandle));
+    tstrncpy(pHandle->subKey, subKey, sizeof(pHandle->subKey));
+    pHandle->consumerId = 1;
+    pHandle->execHandle.subType = TOPIC_SUB_TYPE__COLUMN;
+    pHandle->execHandle.execCol.qmsg = qmsg;
+  }
+
+  // scans from ver and returns the first byte of the only block, or -1 if there is none
+  int32_t scan(const STqHandle *pHandle, int64_t ver) {
+    SMqDataRsp rsp = {0};
+    rsp.blockDataLen = taosArrayInit(0, sizeof(int32_t));
+    rsp.blockData = taosArrayInit(0, sizeof(void *));
+
+    STqOffsetVal offset = {0};
+    offset.type = TMQ_OFFSET__LOG;
+    offset.version = ver;
+    EXPECT_EQ(tqScanDataCached(pTq, pHandle, &rsp, &offset), 0);
+
+    int32_t first = -1;
+    if (rsp.blockNum == 1) {
+      EXPECT_EQ(*(int32_t *)taosArrayGet(rsp.blockDataLen, 0), 16);
+      first = *(char *)taosArrayGetP(rsp.blockData, 0);
+      EXPECT_EQ(rsp.rspOffset.type, TMQ_OFFSET__LOG);
+      EXPECT_EQ(rsp.rspOffset.version, ver + 10);
+    } else {
+      EXPECT_EQ(rsp.blockNum, 1);
+    }
+
+    for (int32_t i = 0; i < rsp.blockNum; i++) {
+      taosMemoryFree(taosArrayGetP(rsp.blockData, i));
+    }
+    taosArrayDestroy(rsp.blockData);
+    taosArrayDestroy(rsp.blockDataLen);
+    return first;
+  }
+
+  Stub    stub;
+  SVnode *pVnode = NULL;
+  STQ    *pTq = NULL;
+  char    qmsg1[32] = "select * from t1";
+  char    qmsg2[32] = "select c1 from t1";
+};
+
+TEST_F(TqRspCacheTest, hit) {
+  STqHandle handle1, handle2;
+  initHandle(&handle1, "cgroup1:topic", qmsg1);
+  initHandle(&handle2, "cgroup2:topic", qmsg1);
+
+  // another consumer group of the topic reads the cached result instead of scanning again
+  EXPECT_EQ(scan(&handle1, 100), 100);
+  EXPECT_EQ(scanCount, 1);
+  EXPECT_EQ(scan(&handle2, 100), 100);
+  EXPECT_EQ(scanCount, 1);
+
+  // the cache is keyed by the start version too
+  EXPECT_EQ(scan(&handle2, 101), 101);
+  EXPECT_EQ(scanCount, 2);
+}
+
+TEST_F(TqRspCacheTest, missOnOtherQueryOrTopic) {
+  STqHandle handle1, handle2, handle3;
+  initHandle(&handle1, "cgroup1:topic", qmsg1);
+  initHandle(&handle2, "cgroup2:topic", qmsg2);  // a topic re-created under the same name with another query
+  initHandle(&handle3, "cgroup1:topic2", qmsg1);
+
+  EXPECT_EQ(scan(&handle1, 100), 100);
+  EXPECT_EQ(scanCount, 1);
+  EXPECT_EQ(scan(&handle2, 100), 100);
+  EXPECT_EQ(scanCount, 2);
+  EXPECT_EQ(scan(&handle3, 100), 100);
+  EXPECT_EQ(scanCount, 3);
+}
+
+TEST_F(TqRspCacheTest, uncommittedNotCached) {
+  STqHandle handle1, handle2;
+  initHandle(&handle1, "cgroup1:topic", qmsg1);
+  initHandle(&handle2, "cgroup2:topic", qmsg1);
+
+  // the scan ends beyond the committed wal, which may still be rolled back
+  committedVer = 105;
+  EXPECT_EQ(scan(&handle1, 100), 100);
+  EXPECT_EQ(scan(&handle2, 100), 100);
+  EXPECT_EQ(scanCount, 2);
+
+  // cached once the end of the scan is committed
+  committedVer = 110;
+  EXPECT_EQ(scan(&handle1, 100), 100);
+  EXPECT_EQ(scan(&handle2, 100), 100);
+  EXPECT_EQ(scanCount, 3);
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include <taoserror.h>
+#include <tglobal.h>
+#include <tsdb.h>
+
+#include "tsdbTestUtil.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+namespace {
+
+const int32_t kFid = 1;
+const int32_t kSzPage = 4096;
+const int32_t kRows = 200;
+const int16_t kIntCid = 2;
+const int16_t kStrCid = 3;
+const int16_t kDblCid = 4;
+
+int32_t intVal(int32_t iRow) { return iRow * 10; }
+
+std::string strVal(int32_t iRow) { return "v" + std::to_string(iRow * 10); }
+
+}  // namespace
+
+// Blocks of an int, a varchar and a double column, all with sma on, written to a data file by the two writer paths and
+// read back through the sma record they share with their bloom filters.
+class TsdbBlockBloomTest : public TsdbFileTest {
+ protected:
+  void SetUp() override {
+    ASSERT_NO_FATAL_FAILURE(openTsdb("tsdbBlockBloomTest", 4, kSzPage));
+
+    headF = {.nRef = 1, .commitID = 1};
+    dataF = {.nRef = 1, .commitID = 1};
+    smaF = {.nRef = 1, .commitID = 1};
+    sttF = {.nRef = 1, .commitID = 1};
+    fSet.diskId = (SDiskID){0};
+    fSet.fid = kFid;
+    fSet.pHeadF = &headF;
+    fSet.pDataF = &dataF;
+    fSet.pSmaF = &smaF;
+    fSet.nSttF = 1;
+    fSet.aSttF[0] = &sttF;
+
+    SSchema aSchema[4] = {0};
+    aSchema[0] = {
+        .type = TSDB_DATA_TYPE_TIMESTAMP, .flags = COL_SMA_ON, .colId = PRIMARYKEY_TIMESTAMP_COL_ID, .bytes = 8};
+    aSchema[1] = {.type = TSDB_DATA_TYPE_INT, .flags = COL_SMA_ON, .colId = kIntCid, .bytes = 4};
+    aSchema[2] = {.type = TSDB_DATA_TYPE_VARCHAR, .flags = COL_SMA_ON, .colId = kStrCid, .bytes = 16};
+    aSchema[3] = {.type = TSDB_DATA_TYPE_DOUBLE, .flags = COL_SMA_ON, .colId = kDblCid, .bytes = 8};
+    pTSchema = tBuildTSchema(aSchema, 4, 1);
+    ASSERT_NE(pTSchema, nullptr);
+
+    aRow = taosArrayInit(kRows, POINTER_BYTES);
+    for (int32_t iRow = 0; iRow < kRows; iRow++) {
+      pushRow(iRow);
+    }
+
+    aColAgg = taosArrayInit(4, sizeof(SColumnDataAgg));
+    aBloom = taosArrayInit(4, sizeof(SBlockBloom));
+
+    bloomFilter = tsBlockBloomFilter;
+    tsBlockBloomFilter = true;
+  }
+
+  void TearDown() override {
+    tsBlockBloomFilter = bloomFilter;
+    tsdbClearBlockBloom(aBloom);
+    taosArrayDestroy(aBloom);
+    taosArrayDestroy(aColAgg);
+    for (int32_t iRow = 0; iRow < taosArrayGetSize(aRow); iRow++) {
+      tRowDestroy(*(SRow **)taosArrayGet(aRow, iRow));
+    }
+    taosArrayDestroy(aRow);
+    tDestroyTSchema(pTSchema);
+    closeTsdb();
+  }
+
+  void pushRow(int32_t iRow) {
+    std::string s = strVal(iRow);
+    int32_t     i = intVal(iRow);
+    double      d = iRow * 0.5;
+    SColVal     aColVal[4] = {0};
+
+    aColVal[0].cid = PRIMARYKEY_TIMESTAMP_COL_ID;
+    aColVal[0].type = TSDB_DATA_TYPE_TIMESTAMP;
+    aColVal[0].value.val = 1648791213000 + iRow;
+    aColVal[1].cid = kIntCid;
+    aColVal[1].type = TSDB_DATA_TYPE_INT;
+    memcpy(&aColVal[1].value.val, &i, sizeof(i));
+    aColVal[2].cid = kStrCid;
+    aColVal[2].type = TSDB_DATA_TYPE_VARCHAR;
+    aColVal[2].value.nData = s.size();
+    aColVal[2].value.pData = (uint8_t *)s.data();
+    aColVal[3].cid = kDblCid;
+    aColVal[3].type = TSDB_DATA_TYPE_DOUBLE;
+    memcpy(&aColVal[3].value.val, &d, sizeof(d));
+
+    SArray *aColValA = taosArrayInit(4, sizeof(SColVal));
+    for (int32_t iCol = 0; iCol < 4; iCol++) taosArrayPush(aColValA, &aColVal[iCol]);
+
+    SRow *pRow = NULL;
+    EXPECT_EQ(tRowBuild(aColValA, pTSchema, &pRow), 0);
+    taosArrayDestroy(aColValA);
+    taosArrayPush(aRow, &pRow);
+  }
+
+  TSDBROW row(int32_t iRow) {
+    TSDBROW tRow = {0};
+    tRow.type = TSDBROW_ROW_FMT;
+    tRow.version = 10 + iRow;
+    tRow.pTSRow = *(SRow **)taosArrayGet(aRow, iRow);
+    return tRow;
+  }
+
+  // write the rows as one data block through tsdbWriteBlockData
+  SSmaInfo writeBlockData() {
+    SDataFWriter *pWriter = NULL;
+    SBlockData    bData = {0};
+    TABLEID       id = {.suid = 0, .uid = 100};
+    SBlockInfo    blkInfo = {0};
+    SSmaInfo      smaInfo = {0};
+
+    EXPECT_EQ(tsdbDataFWriterOpen(&pWriter, pTsdb, &fSet), 0);
+    EXPECT_EQ(tBlockDataCreate(&bData), 0);
+    EXPECT_EQ(tBlockDataInit(&bData, &id, pTSchema, NULL, 0), 0);
+    for (int32_t iRow = 0; iRow < kRows; iRow++) {
+      TSDBROW tRow = row(iRow);
+      EXPECT_EQ(tBlockDataAppendRow(&bData, &tRow, pTSchema, id.uid), 0);
+    }
+    EXPECT_EQ(tsdbWriteBlockData(pWriter, &bData, &blkInfo, &smaInfo, TWO_STAGE_COMP, 0), 0);
+    EXPECT_EQ(tsdbDataFWriterClose(&pWriter, 1), 0);
+    tBlockDataDestroy(&bData);
+    return smaInfo;
+  }
+
+  // write the rows as one data block through the disk data builder
+  SSmaInfo writeDiskData() {
+    SDataFWriter     *pWriter = NULL;
+    SDiskDataBuilder *pBuilder = NULL;
+    TABLEID           id = {.suid = 0, .uid = 100};
+    SBlockInfo        blkInfo = {0};
+    SSmaInfo          smaInfo = {0};
+    const SDiskData  *pDiskData = NULL;
+    const SBlkInfo   *pBlkInfo = NULL;
+
+    EXPECT_EQ(tsdbDataFWriterOpen(&pWriter, pTsdb, &fSet), 0);
+    EXPECT_EQ(tDiskDataBuilderCreate(&pBuilder), 0);
+    EXPECT_EQ(tDiskDataBuilderInit(pBuilder, pTSchema, &id, TWO_STAGE_COMP, 1), 0);
+    for (int32_t iRow = 0; iRow < kRows; iRow++) {
+      TSDBROW tRow = row(iRow);
+      EXPECT_EQ(tDiskDataAddRow(pBuilder, &tRow, pTSchema, &id), 0);
+    }
+    EXPECT_EQ(tGnrtDiskData(pBuilder, &pDiskData, &pBlkInfo), 0);
+    EXPECT_EQ(tsdbWriteDiskData(pWriter, pDiskData, &blkInfo, &smaInfo), 0);
+    EXPECT_EQ(tsdbDataFWriterClose(&pWriter, 1), 0);
+    tDiskDataBuilderDestroy(pBuilder);
+    return smaInfo;
+  }
+
+  int32_t readSma(SSmaInfo smaInfo, SArray *aBlockBloom) {
+    SDataFReader *pReader = NULL;
+    SDataBlk      dataBlk = {0};
+    dataBlk.smaInfo = smaInfo;
+
+    EXPECT_EQ(tsdbDataFReaderOpen(&pReader, pTsdb, &fSet), 0);
+    int32_t code = tsdbReadBlockSma(pReader, &dataBlk, aColAgg, aBlockBloom);
+    tsdbDataFReaderClose(&pReader);
+    return code;
+  }
+
+  void expectAggs() {
+    ASSERT_EQ(taosArrayGetSize(aColAgg), 2);
+
+    SColumnDataAgg *pAgg = (SColumnDataAgg *)taosArrayGet(aColAgg, 0);
+    EXPECT_EQ(pAgg->colId, kIntCid);
+    EXPECT_EQ(pAgg->min, intVal(0));
+    EXPECT_EQ(pAgg->max, intVal(kRows - 1));
+    EXPECT_EQ(pAgg->sum, (int64_t)intVal(kRows - 1) * kRows / 2);
+    EXPECT_EQ(pAgg->numOfNull, 0);
+
+    pAgg = (SColumnDataAgg *)taosArrayGet(aColAgg, 1);
+    EXPECT_EQ(pAgg->colId, kDblCid);
+    EXPECT_EQ(pAgg->numOfNull, 0);
+  }
+
+  SBloomFilter *bloom(int16_t cid) {
+    for (int32_t i = 0; i < taosArrayGetSize(aBloom); i++) {
+      SBlockBloom *pBloom = (SBlockBloom *)taosArrayGet(aBloom, i);
+      if (pBloom->cid == cid) return pBloom->pBF;
+    }
+    return NULL;
+  }
+
+  void expectBlooms() {
+    // a double column gets no bloom filter
+    ASSERT_EQ(taosArrayGetSize(aBloom), 2);
+    SBloomFilter *pIntBF = bloom(kIntCid);
+    SBloomFilter *pStrBF = bloom(kStrCid);
+    ASSERT_NE(pIntBF, nullptr);
+    ASSERT_NE(pStrBF, nullptr);
+    EXPECT_EQ(bloom(kDblCid), nullptr);
+
+    for (int32_t iRow = 0; iRow < kRows; iRow++) {
+      int32_t     i = intVal(iRow);
+      std::string s = strVal(iRow);
+      EXPECT_NE(tBloomFilterNoContain(pIntBF, &i, sizeof(i)), TSDB_CODE_SUCCESS) << i;
+      EXPECT_NE(tBloomFilterNoContain(pStrBF, s.data(), s.size()), TSDB_CODE_SUCCESS) << s;
+    }
+
+    // values between the written ones, allowing for the false positive rate
+    int32_t nIntHit = 0;
+    int32_t nStrHit = 0;
+    for (int32_t iRow = 0; iRow < kRows; iRow++) {
+      int32_t     i = intVal(iRow) + 5;
+      std::string s = "w" + std::to_string(i);
+      if (tBloomFilterNoContain(pIntBF, &i, sizeof(i)) != TSDB_CODE_SUCCESS) nIntHit++;
+      if (tBloomFilterNoContain(pStrBF, s.data(), s.size()) != TSDB_CODE_SUCCESS) nStrHit++;
+    }
+    EXPECT_LT(nIntHit, kRows / 10);
+    EXPECT_LT(nStrHit, kRows / 10);
+  }
+
+  SHeadFile     headF;
+  SDataFile     dataF;
+  SSmaFile      smaF;
+  SSttFile      sttF;
+  SDFileSet     fSet = {0};
+  STSchema     *pTSchema = NULL;
+  SArray       *aRow = NULL;
+  SArray       *aColAgg = NULL;
+  SArray       *aBloom = NULL;
+  bool          bloomFilter = false;
+};
+
+TEST_F(TsdbBlockBloomTest, blockDataPath) {
+  SSmaInfo smaInfo = writeBlockData();
+  ASSERT_GT(smaInfo.size, 0);
+
+  ASSERT_EQ(readSma(smaInfo, aBloom), 0);
+  expectAggs();
+  expectBlooms();
+}
+
+TEST_F(TsdbBlockBloomTest, diskDataPath) {
+  SSmaInfo smaInfo = writeDiskData();
+  ASSERT_GT(smaInfo.size, 0);
+
+  ASSERT_EQ(readSma(smaInfo, aBloom), 0);
+  expectAggs();
+  expectBlooms();
+}
+
+TEST_F(TsdbBlockBloomTest, aggsOnly) {
+  SSmaInfo smaInfo = writeBlockData();
+
+  // the aggs are read alone when the bloom filters are not asked for
+  ASSERT_EQ(readSma(smaInfo, NULL), 0);
+  expectAggs();
+
+  // and a record written without bloom filters reads as before
+  tsBlockBloomFilter = false;
+  smaInfo = writeDiskData();
+  ASSERT_EQ(readSma(smaInfo, aBloom), 0);
+  expectAggs();
+  EXPECT_EQ(taosArrayGetSize(aBloom), 0);
+}
+
+TEST_F(TsdbBlockBloomTest, corruptRecord) {
+  SSmaInfo smaInfo = writeDiskData();
+
+  // a record cut short inside its last bloom filter
+  SSmaInfo cut = smaInfo;
+  cut.size -= 3;
+  EXPECT_EQ(readSma(cut, aBloom), TSDB_CODE_FILE_CORRUPTED);
+  EXPECT_EQ(taosArrayGetSize(aColAgg), 0);
+  EXPECT_EQ(taosArrayGetSize(aBloom), 0);
+
+  ASSERT_EQ(readSma(smaInfo, aBloom), 0);
+  expectBlooms();
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,369 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include <taoserror.h>
+#include <tglobal.h>
+#include <tsdb.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+namespace {
+
+const int32_t kRows = 256;
+const int16_t kCityCid = 2;  // few distinct values, dictionary encoded
+const int16_t kIdCid = 3;    // distinct values, plain
+const int16_t kValCid = 4;
+const int16_t kRandCid = 5;  // random bits, neither stage compresses them
+
+std::string cityVal(int32_t iRow) { return "city-" + std::to_string(iRow % 8); }
+
+std::string idVal(int32_t iRow) { return "id-" + std::to_string(iRow * 7919) + "-" + std::to_string(iRow); }
+
+int64_t randVal(int32_t iRow) {
+  uint64_t x = (uint64_t)iRow * 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return (int64_t)(x ^ (x >> 31));
+}
+
+}  // namespace
+
+// A block compressed by tCmprBlockData, as data and stt blocks are, and decompressed by tDecmprBlockData.
+class TsdbBlockCodecTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    adaptiveCmpr = tsAdaptiveCmpr;
+    dictCmpr = tsDictCmpr;
+    tsAdaptiveCmpr = false;
+    tsDictCmpr = true;
+
+    SSchema aSchema[5] = {0};
+    aSchema[0] = {.type = TSDB_DATA_TYPE_TIMESTAMP, .colId = PRIMARYKEY_TIMESTAMP_COL_ID, .bytes = 8};
+    aSchema[1] = {.type = TSDB_DATA_TYPE_VARCHAR, .colId = kCityCid, .bytes = 16};
+    aSchema[2] = {.type = TSDB_DATA_TYPE_VARCHAR, .colId = kIdCid, .bytes = 32};
+    aSchema[3] = {.type = TSDB_DATA_TYPE_BIGINT, .colId = kValCid, .bytes = 8};
+    aSchema[4] = {.type = TSDB_DATA_TYPE_BIGINT, .colId = kRandCid, .bytes = 8};
+    pTSchema = tBuildTSchema(aSchema, 5, 1);
+    ASSERT_NE(pTSchema, nullptr);
+
+    ASSERT_EQ(tBlockDataCreate(&bData), 0);
+    ASSERT_EQ(tBlockDataCreate(&bDataOut), 0);
+  }
+
+  void TearDown() override {
+    tBlockDataDestroy(&bDataOut);
+    tBlockDataDestroy(&bData);
+    for (int32_t i = 0; i < 4; i++) tFree(aBuf[i]);
+    tFree(pOut);
+    tDestroyTSchema(pTSchema);
+    tsAdaptiveCmpr = adaptiveCmpr;
+    tsDictCmpr = dictCmpr;
+  }
+
+  // the rows of the block, with the city column left out if withCity is false
+  void buildBlock(bool withCity) {
+    int16_t aCid[] = {kCityCid, kIdCid, kValCid, kRandCid};
+    ASSERT_EQ(tBlockDataInit(&bData, &id, pTSchema, withCity ? &aCid[0] : &aCid[1], withCity ? 4 : 3), 0);
+
+    for (int32_t iRow = 0; iRow < kRows; iRow++) {
+      std::string city = cityVal(iRow);
+      std::string sid = idVal(iRow);
+      SArray     *aColVal = taosArrayInit(5, sizeof(SColVal));
+
+      SColVal cv = {0};
+      cv.cid = PRIMARYKEY_TIMESTAMP_COL_ID;
+      cv.type = TSDB_DATA_TYPE_TIMESTAMP;
+      cv.value.val = 1648791213000 + iRow;
+      taosArrayPush(aColVal, &cv);
+
+      // every ninth city is null
+      cv = {0};
+      cv.cid = kCityCid;
+      cv.type = TSDB_DATA_TYPE_VARCHAR;
+      if (iRow % 9 == 0) {
+        cv.flag = CV_FLAG_NULL;
+      } else {
+        cv.value.nData = city.size();
+        cv.value.pData = (uint8_t *)city.data();
+      }
+      taosArrayPush(aColVal, &cv);
+
+      cv = {0};
+      cv.cid = kIdCid;
+      cv.type = TSDB_DATA_TYPE_VARCHAR;
+      cv.value.nData = sid.size();
+      cv.value.pData = (uint8_t *)sid.data();
+      taosArrayPush(aColVal, &cv);
+
+      cv = {0};
+      cv.cid = kValCid;
+      cv.type = TSDB_DATA_TYPE_BIGINT;
+      cv.value.val = (int64_t)iRow * 1000 + iRow % 3;
+      taosArrayPush(aColVal, &cv);
+
+      cv = {0};
+      cv.cid = kRandCid;
+      cv.type = TSDB_DATA_TYPE_BIGINT;
+      cv.value.val = randVal(iRow);
+      taosArrayPush(aColVal, &cv);
+
+      SRow *pRow = NULL;
+      ASSERT_EQ(tRowBuild(aColVal, pTSchema, &pRow), 0);
+      taosArrayDestroy(aColVal);
+
+      TSDBROW tRow = {0};
+      tRow.type = TSDBROW_ROW_FMT;
+      tRow.version = 10 + iRow;
+      tRow.pTSRow = pRow;
+      ASSERT_EQ(tBlockDataAppendRow(&bData, &tRow, pTSchema, id.uid), 0);
+      tRowDestroy(pRow);
+    }
+  }
+
+  void compress(int8_t cmprAlg, int8_t toLast = 0) {
+    int32_t aBufN[4] = {0};
+    ASSERT_EQ(tCmprBlockData(&bData, cmprAlg, toLast, &pOut, &szOut, aBuf, aBufN), 0);
+    ASSERT_GT(szOut, 0);
+  }
+
+  SDiskDataHdr header() {
+    SDiskDataHdr hdr = {0};
+    tGetDiskDataHdr(pOut, &hdr);
+    return hdr;
+  }
+
+  // the SBlockCol of each column as written
+  std::vector<SBlockCol> blockCols() {
+    SDiskDataHdr hdr = {0};
+    int32_t      n = tGetDiskDataHdr(pOut, &hdr);
+    n += hdr.szUid + hdr.szVer + hdr.szKey;
+
+    std::vector<SBlockCol> aBlockCol;
+    for (int32_t nt = 0; nt < hdr.szBlkCol;) {
+      SBlockCol blockCol = {0};
+      nt += tGetBlockCol(pOut + n + nt, &blockCol);
+      aBlockCol.push_back(blockCol);
+    }
+    return aBlockCol;
+  }
+
+  // fmtVer is a one byte varint behind the delimiter for any version below 128
+  void setFmtVer(uint8_t fmtVer) {
+    ASSERT_LT(fmtVer, 128);
+    pOut[sizeof(uint32_t)] = fmtVer;
+  }
+
+  void expectSameBlock() {
+    ASSERT_EQ(bDataOut.nRow, bData.nRow);
+    for (int32_t iRow = 0; iRow < bData.nRow; iRow++) {
+      ASSERT_EQ(bDataOut.aTSKEY[iRow], bData.aTSKEY[iRow]);
+      ASSERT_EQ(bDataOut.aVersion[iRow], bData.aVersion[iRow]);
+    }
+
+    ASSERT_EQ(bDataOut.nColData, bData.nColData);
+    for (int32_t iColData = 0; iColData < bData.nColData; iColData++) {
+      SColData *pExpect = tBlockDataGetColDataByIdx(&bData, iColData);
+      SColData *pActual = tBlockDataGetColDataByIdx(&bDataOut, iColData);
+      ASSERT_EQ(pActual->cid, pExpect->cid);
+      ASSERT_EQ(pActual->nVal, pExpect->nVal);
+      for (int32_t iVal = 0; iVal < pExpect->nVal; iVal++) {
+        SColVal expect, actual;
+        tColDataGetValue(pExpect, iVal, &expect);
+        tColDataGetValue(pActual, iVal, &actual);
+        ASSERT_EQ(actual.flag, expect.flag) << "cid:" << pExpect->cid << " row:" << iVal;
+        if (!COL_VAL_IS_VALUE(&expect)) continue;
+        if (IS_VAR_DATA_TYPE(expect.type)) {
+          ASSERT_EQ(std::string((char *)actual.value.pData, actual.value.nData),
+                    std::string((char *)expect.value.pData, expect.value.nData))
+              << "cid:" << pExpect->cid << " row:" << iVal;
+        } else {
+          ASSERT_EQ(actual.value.val, expect.value.val) << "cid:" << pExpect->cid << " row:" << iVal;
+        }
+      }
+    }
+  }
+
+  bool       adaptiveCmpr = false;
+  bool       dictCmpr = false;
+  STSchema  *pTSchema = NULL;
+  TABLEID    id = {.suid = 0, .uid = 200};
+  SBlockData bData = {0};
+  SBlockData bDataOut = {0};
+  uint8_t   *aBuf[4] = {0};
+  uint8_t   *pOut = NULL;
+  int32_t    szOut = 0;
+};
+
+TEST_F(TsdbBlockCodecTest, blockColCodec) {
+  SBlockCol blockCol = {.cid = 5,
+                        .type = TSDB_DATA_TYPE_NCHAR,
+                        .smaOn = 1,
+                        .flag = HAS_VALUE | HAS_NULL,
+                        .szOrigin = 1000,
+                        .szBitmap = 32,
+                        .szOffset = 100,
+                        .szValue = 300,
+                        .offset = 4096,
+                        .encode = TSDB_COL_ENCODE_DICT};
+
+  std::vector<uint8_t> buf(tPutBlockCol(NULL, &blockCol));
+  ASSERT_EQ(tPutBlockCol(buf.data(), &blockCol), (int32_t)buf.size());
+
+  SBlockCol out = {0};
+  ASSERT_EQ(tGetBlockCol(buf.data(), &out), (int32_t)buf.size());
+  EXPECT_EQ(out.cid, blockCol.cid);
+  EXPECT_EQ(out.type, blockCol.type);
+  EXPECT_EQ(out.smaOn, blockCol.smaOn);
+  EXPECT_EQ(out.flag, blockCol.flag);
+  EXPECT_EQ(out.szOrigin, blockCol.szOrigin);
+  EXPECT_EQ(out.szBitmap, blockCol.szBitmap);
+  EXPECT_EQ(out.szOffset, blockCol.szOffset);
+  EXPECT_EQ(out.szValue, blockCol.szValue);
+  EXPECT_EQ(out.offset, blockCol.offset);
+  EXPECT_EQ(out.encode, TSDB_COL_ENCODE_DICT);
+  EXPECT_EQ(tBlockColFmtVer(&out), TSDB_DISK_DATA_FMT_VER_DICT);
+
+  blockCol.encode = TSDB_COL_ENCODE_PLAIN;
+  EXPECT_EQ(tBlockColFmtVer(&blockCol), TSDB_DISK_DATA_FMT_VER_PLAIN);
+
+  // a column compressed apart from its block carries the algorithm
+  blockCol.cmprAlg = TSDB_COL_CMPR_ALG_SET(NO_COMPRESSION);
+  buf.resize(tPutBlockCol(NULL, &blockCol));
+  ASSERT_EQ(tPutBlockCol(buf.data(), &blockCol), (int32_t)buf.size());
+
+  out = {0};
+  ASSERT_EQ(tGetBlockCol(buf.data(), &out), (int32_t)buf.size());
+  EXPECT_EQ(out.flag, blockCol.flag);
+  EXPECT_EQ(out.encode, TSDB_COL_ENCODE_PLAIN);
+  EXPECT_EQ(out.szOrigin, blockCol.szOrigin);
+  EXPECT_EQ(out.offset, blockCol.offset);
+  EXPECT_EQ(TSDB_COL_CMPR_ALG(&out, TWO_STAGE_COMP), NO_COMPRESSION);
+  EXPECT_EQ(tBlockColFmtVer(&out), TSDB_DISK_DATA_FMT_VER_CMPR);
+}
+
+TEST_F(TsdbBlockCodecTest, dictRoundTrip) {
+  buildBlock(true);
+  compress(TWO_STAGE_COMP);
+
+  // a dictionary encoded column needs the version that knows the encoding
+  EXPECT_EQ(header().fmtVer, TSDB_DISK_DATA_FMT_VER_DICT);
+  for (SBlockCol &blockCol : blockCols()) {
+    EXPECT_EQ(blockCol.encode, blockCol.cid == kCityCid ? TSDB_COL_ENCODE_DICT : TSDB_COL_ENCODE_PLAIN)
+        << "cid:" << blockCol.cid;
+  }
+
+  ASSERT_EQ(tDecmprBlockData(pOut, szOut, &bDataOut, aBuf), 0);
+  expectSameBlock();
+}
+
+TEST_F(TsdbBlockCodecTest, dictOffByDefault) {
+  EXPECT_FALSE(dictCmpr);
+
+  // with the switch off a block with dictionary friendly columns stays readable by the versions before it
+  tsDictCmpr = false;
+  buildBlock(true);
+  compress(TWO_STAGE_COMP);
+
+  EXPECT_EQ(header().fmtVer, TSDB_DISK_DATA_FMT_VER_PLAIN);
+  for (SBlockCol &blockCol : blockCols()) EXPECT_EQ(blockCol.encode, TSDB_COL_ENCODE_PLAIN) << "cid:" << blockCol.cid;
+
+  ASSERT_EQ(tDecmprBlockData(pOut, szOut, &bDataOut, aBuf), 0);
+  expectSameBlock();
+}
+
+TEST_F(TsdbBlockCodecTest, plainKeepsVersion) {
+  // a block without dictionary encoded columns stays readable by the versions before it
+  buildBlock(false);
+  compress(TWO_STAGE_COMP);
+
+  EXPECT_EQ(header().fmtVer, TSDB_DISK_DATA_FMT_VER_PLAIN);
+  for (SBlockCol &blockCol : blockCols()) EXPECT_EQ(blockCol.encode, TSDB_COL_ENCODE_PLAIN);
+
+  ASSERT_EQ(tDecmprBlockData(pOut, szOut, &bDataOut, aBuf), 0);
+  expectSameBlock();
+}
+
+TEST_F(TsdbBlockCodecTest, newerVersionRejected) {
+  buildBlock(true);
+  compress(TWO_STAGE_COMP);
+
+  setFmtVer(TSDB_DISK_DATA_FMT_VER + 1);
+  EXPECT_EQ(tDecmprBlockData(pOut, szOut, &bDataOut, aBuf), TSDB_CODE_VERSION_NOT_COMPATIBLE);
+}
+
+TEST_F(TsdbBlockCodecTest, encodingAboveVersionRejected) {
+  buildBlock(true);
+  compress(TWO_STAGE_COMP);
+
+  // a plain version header can not hold a dictionary encoded column
+  setFmtVer(TSDB_DISK_DATA_FMT_VER_PLAIN);
+  EXPECT_EQ(tDecmprBlockData(pOut, szOut, &bDataOut, aBuf), TSDB_CODE_FILE_CORRUPTED);
+}
+
+TEST_F(TsdbBlockCodecTest, adaptiveOffByDefault) {
+  EXPECT_FALSE(adaptiveCmpr);
+
+  buildBlock(true);
+  compress(TWO_STAGE_COMP);
+
+  EXPECT_EQ(header().fmtVer, TSDB_DISK_DATA_FMT_VER_DICT);
+  for (SBlockCol &blockCol : blockCols()) EXPECT_EQ(blockCol.cmprAlg, 0) << "cid:" << blockCol.cid;
+}
+
+TEST_F(TsdbBlockCodecTest, adaptiveRoundTrip) {
+  tsAdaptiveCmpr = true;
+  buildBlock(false);
+  compress(TWO_STAGE_COMP);
+
+  // the random column is stored plain, which only the version knowing per column algorithms reads
+  EXPECT_EQ(header().fmtVer, TSDB_DISK_DATA_FMT_VER_CMPR);
+  bool found = false;
+  for (SBlockCol &blockCol : blockCols()) {
+    if (blockCol.cid != kRandCid) continue;
+    found = true;
+    EXPECT_EQ(blockCol.cmprAlg, TSDB_COL_CMPR_ALG_SET(NO_COMPRESSION));
+    EXPECT_EQ(blockCol.szValue, blockCol.szOrigin);
+  }
+  EXPECT_TRUE(found);
+
+  ASSERT_EQ(tDecmprBlockData(pOut, szOut, &bDataOut, aBuf), 0);
+  expectSameBlock();
+
+  setFmtVer(TSDB_DISK_DATA_FMT_VER_DICT);
+  EXPECT_EQ(tDecmprBlockData(pOut, szOut, &bDataOut, aBuf), TSDB_CODE_FILE_CORRUPTED);
+}
+
+TEST_F(TsdbBlockCodecTest, adaptiveSkipsStt) {
+  tsAdaptiveCmpr = true;
+  buildBlock(false);
+  compress(TWO_STAGE_COMP, 1);
+
+  // an stt block keeps the block-level algorithm for every column
+  EXPECT_EQ(header().fmtVer, TSDB_DISK_DATA_FMT_VER_PLAIN);
+  for (SBlockCol &blockCol : blockCols()) EXPECT_EQ(blockCol.cmprAlg, 0) << "cid:" << blockCol.cid;
+
+  ASSERT_EQ(tDecmprBlockData(pOut, szOut, &bDataOut, aBuf), 0);
+  expectSameBlock();
+}
+
+#pragma GCC diagnostic pop
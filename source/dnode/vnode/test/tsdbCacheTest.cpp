@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <taoserror.h>
+#include <tsdb.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+namespace {
+
+const uint32_t kMagic = 0x4C415354;
+const int8_t   kFmtVer = 1;
+const int32_t  kHdrSize = sizeof(uint32_t) + sizeof(int8_t) + sizeof(int64_t) + sizeof(int64_t);
+
+void freeLast(const void *key, size_t keyLen, void *value) {
+  SArray *pLast = (SArray *)value;
+  for (int32_t iCol = 0; iCol < taosArrayGetSize(pLast); ++iCol) {
+    SLastCol *pLastCol = (SLastCol *)taosArrayGet(pLast, iCol);
+    if (IS_VAR_DATA_TYPE(pLastCol->colVal.type) && pLastCol->colVal.value.nData > 0) {
+      taosMemoryFree(pLastCol->colVal.value.pData);
+    }
+  }
+  taosArrayDestroy(pLast);
+}
+
+// a timestamp, an int, a binary and a null column
+SArray *makeLast(TSKEY ts, const char *str) {
+  SArray  *pLast = taosArrayInit(4, sizeof(SLastCol));
+  SLastCol lastCol = {.ts = ts};
+
+  lastCol.colVal = (SColVal){.cid = 1, .type = TSDB_DATA_TYPE_TIMESTAMP, .flag = CV_FLAG_VALUE};
+  lastCol.colVal.value.val = ts;
+  taosArrayPush(pLast, &lastCol);
+
+  lastCol.colVal = (SColVal){.cid = 2, .type = TSDB_DATA_TYPE_INT, .flag = CV_FLAG_VALUE};
+  lastCol.colVal.value.val = ts % 1000;
+  taosArrayPush(pLast, &lastCol);
+
+  lastCol.colVal = (SColVal){.cid = 3, .type = TSDB_DATA_TYPE_BINARY, .flag = CV_FLAG_VALUE};
+  lastCol.colVal.value.nData = strlen(str);
+  lastCol.colVal.value.pData = (uint8_t *)taosMemoryMalloc(lastCol.colVal.value.nData);
+  memcpy(lastCol.colVal.value.pData, str, lastCol.colVal.value.nData);
+  taosArrayPush(pLast, &lastCol);
+
+  lastCol.colVal = COL_VAL_NULL(4, TSDB_DATA_TYPE_DOUBLE);
+  taosArrayPush(pLast, &lastCol);
+  return pLast;
+}
+
+void expectSameLast(SArray *pExpect, SArray *pActual) {
+  ASSERT_EQ(taosArrayGetSize(pActual), taosArrayGetSize(pExpect));
+  for (int32_t iCol = 0; iCol < taosArrayGetSize(pExpect); ++iCol) {
+    SLastCol *pE = (SLastCol *)taosArrayGet(pExpect, iCol);
+    SLastCol *pA = (SLastCol *)taosArrayGet(pActual, iCol);
+    EXPECT_EQ(pA->ts, pE->ts);
+    EXPECT_EQ(pA->colVal.cid, pE->colVal.cid);
+    EXPECT_EQ(pA->colVal.type, pE->colVal.type);
+    EXPECT_EQ(pA->colVal.flag, pE->colVal.flag);
+    if (!COL_VAL_IS_VALUE(&pE->colVal)) continue;
+    if (IS_VAR_DATA_TYPE(pE->colVal.type)) {
+      ASSERT_EQ(pA->colVal.value.nData, pE->colVal.value.nData);
+      EXPECT_EQ(memcmp(pA->colVal.value.pData, pE->colVal.value.pData, pE->colVal.value.nData), 0);
+    } else {
+      EXPECT_EQ(pA->colVal.value.val, pE->colVal.value.val);
+    }
+  }
+}
+
+}  // namespace
+
+// A tsdb with only the last/last_row cache. Without tfs the dump lands in the tsdb path itself.
+class TsdbCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    taosRemoveDir(path);
+    taosMkDir(path);
+
+    pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    pVnode->config.vgId = 4;
+    pVnode->state.commitID = 5;
+
+    pTsdb = (STsdb *)taosMemoryCalloc(1, sizeof(STsdb));
+    pTsdb->path = path;
+    pTsdb->pVnode = pVnode;
+    pTsdb->lruCache = taosLRUCacheInit(1024 * 1024, 1, .5);
+    ASSERT_NE(pTsdb->lruCache, nullptr);
+    taosThreadMutexInit(&pTsdb->cacheLoadMutex, NULL);
+    taosThreadCondInit(&pTsdb->cacheLoadCond, NULL);
+
+    snprintf(fname, sizeof(fname), "%s%sLAST_CACHE", path, TD_DIRSEP);
+  }
+
+  void TearDown() override {
+    taosThreadCondDestroy(&pTsdb->cacheLoadCond);
+    taosThreadMutexDestroy(&pTsdb->cacheLoadMutex);
+    taosLRUCacheEraseUnrefEntries(pTsdb->lruCache);
+    taosLRUCacheCleanup(pTsdb->lruCache);
+    taosMemoryFree(pTsdb);
+    taosMemoryFree(pVnode);
+    taosRemoveDir(path);
+  }
+
+  void put(uint64_t key, SArray *pLast) {
+    LRUHandle *h = NULL;
+    ASSERT_EQ(taosLRUCacheInsert(pTsdb->lruCache, &key, sizeof(key), pLast, 64, freeLast, &h, TAOS_LRU_PRIORITY_LOW),
+              TAOS_LRU_STATUS_OK);
+    taosLRUCacheRelease(pTsdb->lruCache, h, false);
+  }
+
+  std::string readDump() {
+    TdFilePtr pFD = taosOpenFile(fname, TD_FILE_READ);
+    if (pFD == NULL) return std::string();
+
+    int64_t size = 0;
+    taosFStatFile(pFD, &size, NULL);
+    std::string content(size, '\0');
+    EXPECT_EQ(taosReadFile(pFD, &content[0], size), size);
+    taosCloseFile(&pFD);
+    return content;
+  }
+
+  void writeDump(const std::string &content) {
+    TdFilePtr pFD = taosOpenFile(fname, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC);
+    ASSERT_NE(pFD, nullptr);
+    taosWriteFile(pFD, content.data(), content.size());
+    taosCloseFile(&pFD);
+  }
+
+  char    path[64] = "/tmp/tsdbCacheTest";
+  char    fname[TSDB_FILENAME_LEN] = {0};
+  SVnode *pVnode = NULL;
+  STsdb  *pTsdb = NULL;
+};
+
+TEST_F(TsdbCacheTest, entryCodec) {
+  SArray  *pLast = makeLast(1648791213000, "last value");
+  uint64_t key = 1234 | 0x8000000000000000;
+
+  int32_t              n = tPutLastCacheEntry(NULL, key, pLast);
+  std::vector<uint8_t> buf(n);
+  ASSERT_EQ(tPutLastCacheEntry(buf.data(), key, pLast), n);
+
+  uint64_t outKey = 0;
+  SArray  *pOut = NULL;
+  ASSERT_EQ(tGetLastCacheEntry(buf.data(), &outKey, &pOut), n);
+  EXPECT_EQ(outKey, key);
+  expectSameLast(pLast, pOut);
+
+  freeLast(NULL, 0, pOut);
+  freeLast(NULL, 0, pLast);
+}
+
+TEST_F(TsdbCacheTest, dumpFormat) {
+  SArray *pLast1 = makeLast(1648791213000, "a");
+  SArray *pLast2 = makeLast(1648791214000, "a longer binary value");
+  put(100, pLast1);
+  put(100 | 0x8000000000000000, pLast2);
+
+  ASSERT_EQ(tsdbCacheDump(pTsdb), 0);
+  std::string content = readDump();
+  ASSERT_GT(content.size(), kHdrSize + sizeof(TSCKSUM));
+
+  uint8_t *p = (uint8_t *)&content[0];
+  EXPECT_TRUE(taosCheckChecksumWhole(p, content.size()));
+
+  uint32_t magic = 0;
+  int8_t   fmtVer = 0;
+  int64_t  commitID = 0;
+  int64_t  nEntry = 0;
+  int32_t  n = 0;
+  n += tGetU32(p + n, &magic);
+  n += tGetI8(p + n, &fmtVer);
+  n += tGetI64(p + n, &commitID);
+  n += tGetI64(p + n, &nEntry);
+  EXPECT_EQ(magic, kMagic);
+  EXPECT_EQ(fmtVer, kFmtVer);
+  EXPECT_EQ(commitID, pVnode->state.commitID);
+  ASSERT_EQ(nEntry, 2);
+
+  for (int64_t iEntry = 0; iEntry < nEntry; ++iEntry) {
+    uint64_t key = 0;
+    SArray  *pLast = NULL;
+    int32_t  nt = tGetLastCacheEntry(p + n, &key, &pLast);
+    ASSERT_GT(nt, 0);
+    n += nt;
+
+    if (key == 100) {
+      expectSameLast(pLast1, pLast);
+    } else {
+      EXPECT_EQ(key, 100 | 0x8000000000000000);
+      expectSameLast(pLast2, pLast);
+    }
+    freeLast(NULL, 0, pLast);
+  }
+  EXPECT_EQ(n + sizeof(TSCKSUM), content.size());
+}
+
+TEST_F(TsdbCacheTest, emptyCacheNotDumped) {
+  ASSERT_EQ(tsdbCacheDump(pTsdb), 0);
+  EXPECT_FALSE(taosCheckExistFile(fname));
+}
+
+TEST_F(TsdbCacheTest, staleDumpDropped) {
+  uint64_t key = 100;
+  put(key, makeLast(1648791213000, "a"));
+  ASSERT_EQ(tsdbCacheDump(pTsdb), 0);
+  taosLRUCacheErase(pTsdb->lruCache, &key, sizeof(key));
+
+  // a commit after the dump, the entries may be stale
+  pVnode->state.commitID++;
+  pTsdb->cacheLoading = 1;
+  ASSERT_EQ(tsdbCacheLoad(pTsdb), 0);
+
+  EXPECT_EQ(taosLRUCacheGetElems(pTsdb->lruCache), 0);
+  EXPECT_FALSE(taosCheckExistFile(fname));
+  EXPECT_EQ(pTsdb->cacheLoading, 0);
+}
+
+TEST_F(TsdbCacheTest, corruptDumpDropped) {
+  uint64_t key = 100;
+  put(key, makeLast(1648791213000, "a"));
+  ASSERT_EQ(tsdbCacheDump(pTsdb), 0);
+  taosLRUCacheErase(pTsdb->lruCache, &key, sizeof(key));
+
+  std::string content = readDump();
+  content[kHdrSize + 3] ^= 0x5a;
+  writeDump(content);
+
+  pTsdb->cacheLoading = 1;
+  EXPECT_EQ(tsdbCacheLoad(pTsdb), TSDB_CODE_FILE_CORRUPTED);
+  EXPECT_EQ(taosLRUCacheGetElems(pTsdb->lruCache), 0);
+  EXPECT_FALSE(taosCheckExistFile(fname));
+
+  // a truncated dump
+  writeDump(content.substr(0, kHdrSize));
+  pTsdb->cacheLoading = 1;
+  EXPECT_EQ(tsdbCacheLoad(pTsdb), TSDB_CODE_FILE_CORRUPTED);
+  EXPECT_FALSE(taosCheckExistFile(fname));
+}
+
+TEST_F(TsdbCacheTest, stopWaitsForLoad) {
+  put(100, makeLast(1648791213000, "a"));
+  ASSERT_EQ(tsdbCacheDump(pTsdb), 0);
+  pVnode->state.commitID++;
+
+  pTsdb->cacheLoading = 1;
+  std::thread loader([this]() {
+    taosMsleep(100);
+    tsdbCacheLoad(pTsdb);
+  });
+
+  // stop returns only once the loader let go of the tsdb
+  tsdbCacheStopLoad(pTsdb);
+  EXPECT_EQ(pTsdb->cacheLoading, 0);
+  EXPECT_EQ(pTsdb->cacheLoadStop, 1);
+  EXPECT_FALSE(taosCheckExistFile(fname));
+  loader.join();
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include <taoserror.h>
+#include <tsdb.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+// A file block is skipped without being loaded only if the tombstones visible to the reader delete every row of it.
+class TsdbDelSkylineTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    aDelData = taosArrayInit(4, sizeof(SDelData));
+    aSkyline = taosArrayInit(8, sizeof(TSDBKEY));
+    verRange = {.minVer = 0, .maxVer = INT64_MAX};
+  }
+
+  void TearDown() override {
+    taosArrayDestroy(aDelData);
+    taosArrayDestroy(aSkyline);
+  }
+
+  void del(TSKEY sKey, TSKEY eKey, int64_t version) {
+    SDelData delData = {.version = version, .sKey = sKey, .eKey = eKey};
+    taosArrayPush(aDelData, &delData);
+    ASSERT_EQ(tsdbBuildDeleteSkyline(aDelData, 0, taosArrayGetSize(aDelData) - 1, aSkyline), 0);
+  }
+
+  bool covered(TSKEY minTs, TSKEY maxTs, int64_t maxVer) {
+    SDataBlk block = {0};
+    block.minKey = {.version = 1, .ts = minTs};
+    block.maxKey = {.version = maxVer, .ts = maxTs};
+    block.minVer = 1;
+    block.maxVer = maxVer;
+    return tsdbBlockCoveredByDelSkyline(aSkyline, &block, &verRange);
+  }
+
+  SArray       *aDelData = NULL;
+  SArray       *aSkyline = NULL;
+  SVersionRange verRange;
+};
+
+TEST_F(TsdbDelSkylineTest, noTombstone) {
+  EXPECT_FALSE(covered(100, 200, 5));
+}
+
+TEST_F(TsdbDelSkylineTest, full) {
+  del(100, 200, 10);
+  EXPECT_TRUE(covered(100, 200, 5));
+  EXPECT_TRUE(covered(120, 180, 10));
+
+  // two overlapping tombstones cover the block together
+  del(150, 300, 12);
+  EXPECT_TRUE(covered(120, 280, 10));
+}
+
+TEST_F(TsdbDelSkylineTest, partial) {
+  del(100, 200, 10);
+  EXPECT_FALSE(covered(50, 150, 5));
+  EXPECT_FALSE(covered(150, 250, 5));
+  EXPECT_FALSE(covered(50, 250, 5));
+  EXPECT_FALSE(covered(300, 400, 5));
+}
+
+TEST_F(TsdbDelSkylineTest, gap) {
+  // the rows between the two tombstones are kept
+  del(100, 200, 10);
+  del(300, 400, 10);
+  EXPECT_FALSE(covered(150, 350, 5));
+  EXPECT_FALSE(covered(210, 290, 5));
+  EXPECT_TRUE(covered(300, 400, 5));
+}
+
+TEST_F(TsdbDelSkylineTest, versionBounded) {
+  del(100, 200, 10);
+
+  // rows written after the delete survive it
+  EXPECT_FALSE(covered(120, 180, 11));
+
+  // the lower tombstone covers the left part only
+  del(150, 200, 20);
+  EXPECT_FALSE(covered(120, 180, 15));
+  EXPECT_TRUE(covered(160, 180, 15));
+
+  // a tombstone newer than the version the reader sees deletes nothing
+  verRange.maxVer = 15;
+  EXPECT_FALSE(covered(160, 180, 5));
+  EXPECT_TRUE(covered(110, 140, 5));
+
+  // nor one older than it
+  verRange = {.minVer = 12, .maxVer = INT64_MAX};
+  EXPECT_FALSE(covered(110, 140, 5));
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include <taoserror.h>
+#include <tglobal.h>
+#include <tsdb.h>
+
+#include "tsdbTestUtil.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+namespace {
+
+const int32_t kFid = 1;
+const int32_t kSzPage = 4096;
+const int32_t kRows = 300;
+const int32_t kCols = 5;
+
+}  // namespace
+
+// One data block of an int, a varchar, a bigint and a double column. The filter columns of a block are decoded first
+// and the rest of them later, which must give the same block as decoding it at once.
+class TsdbPartialLoadTest : public TsdbFileTest {
+ protected:
+  void SetUp() override {
+    ASSERT_NO_FATAL_FAILURE(openTsdb("tsdbPartialLoadTest", 5, kSzPage));
+
+    headF = {.nRef = 1, .commitID = 1};
+    dataF = {.nRef = 1, .commitID = 1};
+    smaF = {.nRef = 1, .commitID = 1};
+    sttF = {.nRef = 1, .commitID = 1};
+    fSet.diskId = (SDiskID){0};
+    fSet.fid = kFid;
+    fSet.pHeadF = &headF;
+    fSet.pDataF = &dataF;
+    fSet.pSmaF = &smaF;
+    fSet.nSttF = 1;
+    fSet.aSttF[0] = &sttF;
+
+    SSchema aSchema[kCols] = {0};
+    aSchema[0] = {.type = TSDB_DATA_TYPE_TIMESTAMP, .colId = PRIMARYKEY_TIMESTAMP_COL_ID, .bytes = 8};
+    aSchema[1] = {.type = TSDB_DATA_TYPE_INT, .colId = 2, .bytes = 4};
+    aSchema[2] = {.type = TSDB_DATA_TYPE_VARCHAR, .colId = 3, .bytes = 16};
+    aSchema[3] = {.type = TSDB_DATA_TYPE_BIGINT, .colId = 4, .bytes = 8};
+    aSchema[4] = {.type = TSDB_DATA_TYPE_DOUBLE, .colId = 5, .bytes = 8};
+    pTSchema = tBuildTSchema(aSchema, kCols, 1);
+    ASSERT_NE(pTSchema, nullptr);
+
+    writeBlock();
+  }
+
+  void TearDown() override {
+    tDestroyTSchema(pTSchema);
+    closeTsdb();
+  }
+
+  SRow *buildRow(int32_t iRow) {
+    std::string s = "s" + std::to_string(iRow % 17);
+    int32_t     i = iRow * 3;
+    double      d = iRow * 0.25;
+    SArray     *aColVal = taosArrayInit(kCols, sizeof(SColVal));
+
+    SColVal cv = {0};
+    cv.cid = PRIMARYKEY_TIMESTAMP_COL_ID;
+    cv.type = TSDB_DATA_TYPE_TIMESTAMP;
+    cv.value.val = 1648791213000 + iRow;
+    taosArrayPush(aColVal, &cv);
+
+    cv = {0};
+    cv.cid = 2;
+    cv.type = TSDB_DATA_TYPE_INT;
+    memcpy(&cv.value.val, &i, sizeof(i));
+    taosArrayPush(aColVal, &cv);
+
+    // every seventh varchar is null
+    cv = {0};
+    cv.cid = 3;
+    cv.type = TSDB_DATA_TYPE_VARCHAR;
+    if (iRow % 7 == 0) {
+      cv.flag = CV_FLAG_NULL;
+    } else {
+      cv.value.nData = s.size();
+      cv.value.pData = (uint8_t *)s.data();
+    }
+    taosArrayPush(aColVal, &cv);
+
+    cv = {0};
+    cv.cid = 4;
+    cv.type = TSDB_DATA_TYPE_BIGINT;
+    cv.value.val = (int64_t)iRow * iRow;
+    taosArrayPush(aColVal, &cv);
+
+    cv = {0};
+    cv.cid = 5;
+    cv.type = TSDB_DATA_TYPE_DOUBLE;
+    memcpy(&cv.value.val, &d, sizeof(d));
+    taosArrayPush(aColVal, &cv);
+
+    SRow *pRow = NULL;
+    EXPECT_EQ(tRowBuild(aColVal, pTSchema, &pRow), 0);
+    taosArrayDestroy(aColVal);
+    return pRow;
+  }
+
+  void writeBlock() {
+    SDataFWriter *pWriter = NULL;
+    SBlockData    bData = {0};
+    SSmaInfo      smaInfo = {0};
+
+    ASSERT_EQ(tsdbDataFWriterOpen(&pWriter, pTsdb, &fSet), 0);
+    ASSERT_EQ(tBlockDataCreate(&bData), 0);
+    ASSERT_EQ(tBlockDataInit(&bData, &id, pTSchema, NULL, 0), 0);
+    for (int32_t iRow = 0; iRow < kRows; iRow++) {
+      SRow   *pRow = buildRow(iRow);
+      TSDBROW tRow = {0};
+      tRow.type = TSDBROW_ROW_FMT;
+      tRow.version = 10 + iRow;
+      tRow.pTSRow = pRow;
+      EXPECT_EQ(tBlockDataAppendRow(&bData, &tRow, pTSchema, id.uid), 0);
+      tRowDestroy(pRow);
+    }
+
+    dataBlk = {0};
+    dataBlk.nRow = kRows;
+    dataBlk.nSubBlock = 1;
+    ASSERT_EQ(tsdbWriteBlockData(pWriter, &bData, &dataBlk.aSubBlock[0], &smaInfo, TWO_STAGE_COMP, 0), 0);
+    dataBlk.smaInfo = smaInfo;
+    ASSERT_EQ(tsdbDataFWriterClose(&pWriter, 1), 0);
+    tBlockDataDestroy(&bData);
+  }
+
+  void expectSameCol(SColData *pExpect, SColData *pActual) {
+    ASSERT_EQ(pActual->cid, pExpect->cid);
+    ASSERT_EQ(pActual->nVal, pExpect->nVal);
+    for (int32_t iVal = 0; iVal < pExpect->nVal; iVal++) {
+      SColVal expect, actual;
+      tColDataGetValue(pExpect, iVal, &expect);
+      tColDataGetValue(pActual, iVal, &actual);
+      ASSERT_EQ(actual.flag, expect.flag) << "cid:" << pExpect->cid << " row:" << iVal;
+      if (!COL_VAL_IS_VALUE(&expect)) continue;
+      if (IS_VAR_DATA_TYPE(expect.type)) {
+        ASSERT_EQ(actual.value.nData, expect.value.nData);
+        ASSERT_EQ(memcmp(actual.value.pData, expect.value.pData, expect.value.nData), 0);
+      } else {
+        ASSERT_EQ(actual.value.val, expect.value.val) << "cid:" << pExpect->cid << " row:" << iVal;
+      }
+    }
+  }
+
+  SHeadFile    headF;
+  SDataFile    dataF;
+  SSmaFile     smaF;
+  SSttFile     sttF;
+  SDFileSet    fSet = {0};
+  STSchema    *pTSchema = NULL;
+  TABLEID      id = {.suid = 0, .uid = 100};
+  SDataBlk     dataBlk = {0};
+};
+
+TEST_F(TsdbPartialLoadTest, colsThenRest) {
+  SDataFReader *pReader = NULL;
+  SBlockData    full = {0};
+  SBlockData    partial = {0};
+  int16_t       aFilterCid[] = {3, 5};
+
+  ASSERT_EQ(tsdbDataFReaderOpen(&pReader, pTsdb, &fSet), 0);
+  ASSERT_EQ(tBlockDataCreate(&full), 0);
+  ASSERT_EQ(tBlockDataCreate(&partial), 0);
+  ASSERT_EQ(tBlockDataInit(&full, &id, pTSchema, NULL, 0), 0);
+  ASSERT_EQ(tBlockDataInit(&partial, &id, pTSchema, NULL, 0), 0);
+
+  ASSERT_EQ(tsdbReadDataBlock(pReader, &dataBlk, &full), 0);
+  ASSERT_EQ(full.nRow, kRows);
+
+  // the filter columns only, the others are left for later
+  ASSERT_EQ(tsdbReadDataBlockCols(pReader, &dataBlk, &partial, aFilterCid, 2), 0);
+  ASSERT_EQ(partial.nRow, kRows);
+  for (int32_t iRow = 0; iRow < kRows; iRow++) ASSERT_EQ(partial.aTSKEY[iRow], full.aTSKEY[iRow]);
+  ASSERT_EQ(partial.nColData, full.nColData);
+  for (int32_t iColData = 0; iColData < partial.nColData; iColData++) {
+    SColData *pColData = tBlockDataGetColDataByIdx(&partial, iColData);
+    if (pColData->cid == 3 || pColData->cid == 5) {
+      expectSameCol(tBlockDataGetColDataByIdx(&full, iColData), pColData);
+    } else {
+      EXPECT_EQ(pColData->nVal, 0) << "cid:" << pColData->cid;
+    }
+  }
+
+  // the rest of them complete the block without touching the filter columns
+  ASSERT_EQ(tsdbReadDataBlockRest(pReader, &dataBlk, &partial), 0);
+  for (int32_t iColData = 0; iColData < partial.nColData; iColData++) {
+    expectSameCol(tBlockDataGetColDataByIdx(&full, iColData), tBlockDataGetColDataByIdx(&partial, iColData));
+  }
+
+  tBlockDataDestroy(&partial);
+  tBlockDataDestroy(&full);
+  tsdbDataFReaderClose(&pReader);
+}
+
+TEST_F(TsdbPartialLoadTest, copyPasses) {
+  int16_t aCid[] = {PRIMARYKEY_TIMESTAMP_COL_ID, 2, 3, 4, 5, 6};
+  int16_t aFilterCid[] = {3, 5};
+
+  // each column is copied, and its copy time counted, by one of the two passes
+  for (int16_t cid : aCid) {
+    bool first = tsdbColCopiedInPass(aFilterCid, 2, false, cid);
+    bool rest = tsdbColCopiedInPass(aFilterCid, 2, true, cid);
+    EXPECT_NE(first, rest) << "cid:" << cid;
+    EXPECT_EQ(first, cid == PRIMARYKEY_TIMESTAMP_COL_ID || cid == 3 || cid == 5) << "cid:" << cid;
+  }
+
+  // a filter on the primary timestamp only leaves every other column to the second pass
+  for (int16_t cid : aCid) {
+    EXPECT_EQ(tsdbColCopiedInPass(aFilterCid, 0, false, cid), cid == PRIMARYKEY_TIMESTAMP_COL_ID) << "cid:" << cid;
+  }
+
+  // a block loaded at once is copied in one pass
+  for (int16_t cid : aCid) {
+    EXPECT_TRUE(tsdbColCopiedInPass(NULL, 0, false, cid));
+  }
+}
+
+#pragma GCC diagnostic pop
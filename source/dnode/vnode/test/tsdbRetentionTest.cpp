@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <taoserror.h>
+#include <tglobal.h>
+#include <tsdb.h>
+
+#include "tsdbTestUtil.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+namespace {
+
+const int32_t kSzPage = 4096;
+const int32_t kDayMin = 24 * 60;
+
+}  // namespace
+
+// One file set on level 0 that the keep config moves to level 1. Its files hold no block, so the rewrite produces an
+// empty file set, which is enough to follow the files through prepare, swap and commit.
+class TsdbRetentionTest : public TsdbFileTest {
+ protected:
+  void SetUp() override {
+    ASSERT_NO_FATAL_FAILURE(openTsdb("tsdbRetentionTest", 3, kSzPage, 2));
+    pVnode->config.szPage = kSzPage;
+    pVnode->config.tsdbCfg.maxRows = 4096;
+    pTsdb->keepCfg = {.precision = TSDB_TIME_PRECISION_MILLI,
+                      .days = kDayMin,
+                      .keep0 = kDayMin * 2,
+                      .keep1 = kDayMin * 100,
+                      .keep2 = kDayMin * 1000};
+    taosThreadRwlockInit(&pTsdb->rwLock, NULL);
+    pTsdb->fs.aDFileSet = taosArrayInit(1, sizeof(SDFileSet));
+
+    // ten days old, on level 0 but due for level 1
+    now = taosGetTimestampSec();
+    fid = tsdbKeyFid((now - 10 * 86400) * 1000, kDayMin, TSDB_TIME_PRECISION_MILLI);
+    ASSERT_EQ(tsdbFidLevel(fid, &pTsdb->keepCfg, now), 1);
+
+    SDFileSet fSet = {0};
+    fSet.diskId = (SDiskID){0};
+    fSet.fid = fid;
+    fSet.pHeadF = (SHeadFile *)taosMemoryCalloc(1, sizeof(SHeadFile));
+    fSet.pDataF = (SDataFile *)taosMemoryCalloc(1, sizeof(SDataFile));
+    fSet.pSmaF = (SSmaFile *)taosMemoryCalloc(1, sizeof(SSmaFile));
+    fSet.nSttF = 1;
+    fSet.aSttF[0] = (SSttFile *)taosMemoryCalloc(1, sizeof(SSttFile));
+    *fSet.pHeadF = {.nRef = 1, .commitID = 1, .size = 100, .offset = 100};
+    *fSet.pDataF = {.nRef = 1, .commitID = 1, .size = 100};
+    *fSet.pSmaF = {.nRef = 1, .commitID = 1, .size = 100};
+    *fSet.aSttF[0] = {.nRef = 1, .commitID = 1, .size = 100, .offset = 100};
+    taosArrayPush(pTsdb->fs.aDFileSet, &fSet);
+    writeFSet(&fSet);
+
+    recompress = tsRetentionRecompress;
+    tsRetentionRecompress = true;
+  }
+
+  void TearDown() override {
+    tsRetentionRecompress = recompress;
+    tsdbFSDestroy(&pTsdb->fs);
+    taosThreadRwlockDestroy(&pTsdb->rwLock);
+    closeTsdb();
+  }
+
+  void writeFile(const char *fname, int64_t lSize) {
+    std::string content(tsdbLogicToFileSize(lSize, kSzPage), 'x');
+    TdFilePtr   pFD = taosOpenFile(fname, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC);
+    ASSERT_NE(pFD, nullptr);
+    taosWriteFile(pFD, content.data(), content.size());
+    taosCloseFile(&pFD);
+  }
+
+  void writeFSet(SDFileSet *pSet) {
+    char fname[TSDB_FILENAME_LEN];
+    tsdbHeadFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pHeadF, fname);
+    writeFile(fname, pSet->pHeadF->size);
+    tsdbDataFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pDataF, fname);
+    writeFile(fname, pSet->pDataF->size);
+    tsdbSmaFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pSmaF, fname);
+    writeFile(fname, pSet->pSmaF->size);
+    for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+      tsdbSttFileName(pTsdb, pSet->diskId, pSet->fid, pSet->aSttF[iStt], fname);
+      writeFile(fname, pSet->aSttF[iStt]->size);
+    }
+  }
+
+  SDFileSet *fset() { return (SDFileSet *)taosArrayGet(pTsdb->fs.aDFileSet, 0); }
+
+  bool headExist(SDiskID did, int64_t commitID) {
+    char      fname[TSDB_FILENAME_LEN];
+    SHeadFile fHead = {.commitID = commitID};
+    tsdbHeadFileName(pTsdb, did, fid, &fHead, fname);
+    return taosCheckExistFile(fname);
+  }
+
+  int64_t now = 0;
+  int32_t fid = 0;
+  bool    recompress = false;
+};
+
+TEST_F(TsdbRetentionTest, rewriteBeforeSwap) {
+  const int64_t rewriteID = 77;
+
+  // the rewrite leaves the live file system alone, it only becomes visible at the swap
+  SArray *aRFSet = NULL;
+  ASSERT_EQ(tsdbPrepareRetention(pTsdb, now, rewriteID, &aRFSet), 0);
+  ASSERT_EQ(taosArrayGetSize(aRFSet), 1);
+  EXPECT_EQ(fset()->diskId.level, 0);
+  EXPECT_EQ(fset()->pHeadF->commitID, 1);
+  EXPECT_TRUE(headExist((SDiskID){.level = 1, .id = 0}, rewriteID));
+
+  ASSERT_EQ(tsdbDoRetention(pTsdb, now, aRFSet), 0);
+  ASSERT_EQ(tsdbCommitRetention(pTsdb), 0);
+  tsdbClearRetention(pTsdb, aRFSet, true);
+
+  ASSERT_EQ(taosArrayGetSize(pTsdb->fs.aDFileSet), 1);
+  EXPECT_EQ(fset()->diskId.level, 1);
+  EXPECT_EQ(fset()->pHeadF->commitID, rewriteID);
+  EXPECT_EQ(fset()->nSttF, 1);
+  EXPECT_TRUE(headExist(fset()->diskId, rewriteID));
+  EXPECT_FALSE(headExist((SDiskID){0}, 1));
+}
+
+TEST_F(TsdbRetentionTest, staleRewriteDropped) {
+  const int64_t rewriteID = 78;
+
+  SArray *aRFSet = NULL;
+  ASSERT_EQ(tsdbPrepareRetention(pTsdb, now, rewriteID, &aRFSet), 0);
+  ASSERT_EQ(taosArrayGetSize(aRFSet), 1);
+
+  // a commit lands in the file set while it is rewritten
+  SSttFile *pSttF = (SSttFile *)taosMemoryCalloc(1, sizeof(SSttFile));
+  *pSttF = {.nRef = 1, .commitID = 2, .size = 200, .offset = 200};
+  fset()->aSttF[fset()->nSttF++] = pSttF;
+  writeFSet(fset());
+
+  // the rewrite misses that data, so the file set is copied as is and the rewrite is dropped
+  ASSERT_EQ(tsdbDoRetention(pTsdb, now, aRFSet), 0);
+  ASSERT_EQ(tsdbCommitRetention(pTsdb), 0);
+  tsdbClearRetention(pTsdb, aRFSet, true);
+
+  EXPECT_EQ(fset()->diskId.level, 1);
+  EXPECT_EQ(fset()->nSttF, 2);
+  EXPECT_EQ(fset()->pHeadF->commitID, 1);
+  EXPECT_FALSE(headExist((SDiskID){.level = 1, .id = 0}, rewriteID));
+}
+
+TEST_F(TsdbRetentionTest, uncommittedRewriteRemoved) {
+  const int64_t rewriteID = 79;
+
+  SArray *aRFSet = NULL;
+  ASSERT_EQ(tsdbPrepareRetention(pTsdb, now, rewriteID, &aRFSet), 0);
+  ASSERT_EQ(taosArrayGetSize(aRFSet), 1);
+  EXPECT_TRUE(headExist((SDiskID){.level = 1, .id = 0}, rewriteID));
+
+  tsdbClearRetention(pTsdb, aRFSet, false);
+  EXPECT_FALSE(headExist((SDiskID){.level = 1, .id = 0}, rewriteID));
+  EXPECT_EQ(fset()->diskId.level, 0);
+}
+
+TEST_F(TsdbRetentionTest, copyWhenRecompressOff) {
+  tsRetentionRecompress = false;
+
+  SArray *aRFSet = NULL;
+  ASSERT_EQ(tsdbPrepareRetention(pTsdb, now, 80, &aRFSet), 0);
+  EXPECT_EQ(aRFSet, nullptr);
+
+  ASSERT_EQ(tsdbDoRetention(pTsdb, now, aRFSet), 0);
+  ASSERT_EQ(tsdbCommitRetention(pTsdb), 0);
+  tsdbClearRetention(pTsdb, aRFSet, true);
+
+  EXPECT_EQ(fset()->diskId.level, 1);
+  EXPECT_EQ(fset()->pHeadF->commitID, 1);
+}
+
+#pragma GCC diagnostic pop
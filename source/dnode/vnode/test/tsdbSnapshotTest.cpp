@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include <taoserror.h>
+#include <tglobal.h>
+#include <tsdb.h>
+
+#include "tsdbTestUtil.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+namespace {
+
+const int32_t kFid = 1;
+const int32_t kSzPage = 4096;
+
+}  // namespace
+
+// A file set whose files hold arbitrary bytes. The head file has no block index, so the logical reader finds no rows
+// in it, while the physical reader ships every byte of every file.
+class TsdbSnapshotTest : public TsdbFileTest {
+ protected:
+  void SetUp() override {
+    ASSERT_NO_FATAL_FAILURE(openTsdb("tsdbSnapshotTest", 2, kSzPage));
+    pVnode->state.committed = 100;
+    taosThreadRwlockInit(&pTsdb->rwLock, NULL);
+    pTsdb->fs.aDFileSet = taosArrayInit(1, sizeof(SDFileSet));
+
+    headF = {.nRef = 1, .commitID = 1, .size = 3000, .offset = 3000};
+    dataF = {.nRef = 1, .commitID = 1, .size = 10000};
+    smaF = {.nRef = 1, .commitID = 1, .size = 100};
+    sttF = {.nRef = 1, .commitID = 1, .size = 5000, .offset = 5000};
+
+    SDFileSet fSet = {0};
+    fSet.diskId = (SDiskID){0};
+    fSet.fid = kFid;
+    fSet.pHeadF = &headF;
+    fSet.pDataF = &dataF;
+    fSet.pSmaF = &smaF;
+    fSet.nSttF = 1;
+    fSet.aSttF[0] = &sttF;
+    taosArrayPush(pTsdb->fs.aDFileSet, &fSet);
+
+    char fname[TSDB_FILENAME_LEN];
+    tsdbHeadFileName(pTsdb, fSet.diskId, kFid, &headF, fname);
+    files.push_back(writeFile(fname, headF.size, 'h'));
+    tsdbDataFileName(pTsdb, fSet.diskId, kFid, &dataF, fname);
+    files.push_back(writeFile(fname, dataF.size, 'd'));
+    tsdbSmaFileName(pTsdb, fSet.diskId, kFid, &smaF, fname);
+    files.push_back(writeFile(fname, smaF.size, 's'));
+    tsdbSttFileName(pTsdb, fSet.diskId, kFid, &sttF, fname);
+    files.push_back(writeFile(fname, sttF.size, 't'));
+
+    tsSnapPhysical = true;
+  }
+
+  void TearDown() override {
+    taosArrayDestroy(pTsdb->fs.aDFileSet);
+    taosThreadRwlockDestroy(&pTsdb->rwLock);
+    closeTsdb();
+  }
+
+  // the physical content of a file whose logic size is lSize
+  std::string writeFile(const char *fname, int64_t lSize, char c) {
+    std::string content(tsdbLogicToFileSize(lSize, kSzPage), c);
+    for (size_t i = 0; i < content.size(); i += 97) content[i] = (char)i;
+
+    TdFilePtr pFD = taosOpenFile(fname, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_TRUNC);
+    EXPECT_NE(pFD, nullptr);
+    EXPECT_EQ(taosWriteFile(pFD, content.data(), content.size()), (int64_t)content.size());
+    taosCloseFile(&pFD);
+    return content;
+  }
+
+  // read the whole snapshot and return the types of the messages
+  std::vector<int8_t> readAll(int64_t sver, int8_t physical, std::vector<std::string> *pFiles) {
+    STsdbSnapReader *pReader = NULL;
+    EXPECT_EQ(tsdbSnapReaderOpen(pTsdb, sver, pVnode->state.committed, SNAP_DATA_TSDB, physical, &pReader), 0);
+
+    std::vector<int8_t> types;
+    for (;;) {
+      uint8_t *pData = NULL;
+      EXPECT_EQ(tsdbSnapRead(pReader, &pData), 0);
+      if (pData == NULL) break;
+
+      SSnapDataHdr *pHdr = (SSnapDataHdr *)pData;
+      types.push_back(pHdr->type);
+      if (pHdr->type == SNAP_DATA_TSDB_FILE && pFiles) {
+        STsdbSnapFileChunk chunk = {0};
+        int32_t            nHdr = tGetSnapFileChunk(pHdr->data, &chunk);
+        EXPECT_EQ(chunk.fid, kFid);
+        EXPECT_EQ(chunk.szPage, kSzPage);
+        EXPECT_EQ(chunk.nSttF, 1);
+        EXPECT_EQ(pHdr->size, nHdr + chunk.cSize);
+        EXPECT_EQ(chunk.cksum, taosCalcChecksum(0, pHdr->data + nHdr, chunk.cSize));
+
+        if (pFiles->size() <= (size_t)chunk.fIdx) pFiles->resize(chunk.fIdx + 1);
+        std::string &file = (*pFiles)[chunk.fIdx];
+        EXPECT_EQ((int64_t)file.size(), chunk.cOffset);
+        file.append((const char *)pHdr->data + nHdr, chunk.cSize);
+        EXPECT_LE((int64_t)file.size(), chunk.fSize);
+      }
+      taosMemoryFree(pData);
+    }
+
+    tsdbSnapReaderClose(&pReader);
+    return types;
+  }
+
+  SHeadFile                headF;
+  SDataFile                dataF;
+  SSmaFile                 smaF;
+  SSttFile                 sttF;
+  std::vector<std::string> files;
+};
+
+TEST_F(TsdbSnapshotTest, chunkCodec) {
+  STsdbSnapFileChunk chunk = {.fid = -7,
+                              .szPage = kSzPage,
+                              .nSttF = 3,
+                              .fIdx = TSDB_SNAP_FILE_STT + 2,
+                              .size = 1LL << 40,
+                              .offset = 12345,
+                              .fSize = (1LL << 40) + 4096,
+                              .cOffset = 1LL << 33,
+                              .cSize = 4 * 1024 * 1024,
+                              .cksum = 0xdeadbeef};
+
+  int32_t              n = tPutSnapFileChunk(NULL, &chunk);
+  std::vector<uint8_t> buf(n);
+  ASSERT_EQ(tPutSnapFileChunk(buf.data(), &chunk), n);
+
+  STsdbSnapFileChunk out = {0};
+  ASSERT_EQ(tGetSnapFileChunk(buf.data(), &out), n);
+  EXPECT_EQ(memcmp(&chunk, &out, sizeof(chunk)), 0);
+}
+
+TEST_F(TsdbSnapshotTest, physicalToCapableReceiver) {
+  std::vector<std::string> shipped;
+  std::vector<int8_t>      types = readAll(0, 1, &shipped);
+
+  ASSERT_FALSE(types.empty());
+  for (int8_t type : types) EXPECT_EQ(type, SNAP_DATA_TSDB_FILE);
+  EXPECT_EQ(shipped, files);
+}
+
+TEST_F(TsdbSnapshotTest, logicalToOldReceiver) {
+  // a receiver that does not announce SYNC_SNAPSHOT_CAP_FILE can not parse file chunks
+  std::vector<int8_t> types = readAll(0, 0, NULL);
+  for (int8_t type : types) EXPECT_NE(type, SNAP_DATA_TSDB_FILE);
+}
+
+TEST_F(TsdbSnapshotTest, logicalWhenDisabledOrIncremental) {
+  tsSnapPhysical = false;
+  std::vector<int8_t> types = readAll(0, 1, NULL);
+  for (int8_t type : types) EXPECT_NE(type, SNAP_DATA_TSDB_FILE);
+
+  // an incremental snapshot can not ship rows older than sver
+  tsSnapPhysical = true;
+  types = readAll(10, 1, NULL);
+  for (int8_t type : types) EXPECT_NE(type, SNAP_DATA_TSDB_FILE);
+}
+
+#pragma GCC diagnostic pop
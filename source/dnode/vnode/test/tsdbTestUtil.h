@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_VNODE_TSDB_TEST_UTIL_H_
+#define _TD_VNODE_TSDB_TEST_UTIL_H_
+
+#include <gtest/gtest.h>
+
+#include <tsdb.h>
+
+// A tsdb on a tfs of one disk per level under /tmp/<name>, with a bare vnode holding only what the tsdb file code
+// reads. The tsdb directory is created on every level.
+class TsdbFileTest : public ::testing::Test {
+ protected:
+  void openTsdb(const char *name, int32_t vgId, int32_t szPage, int32_t nLevel = 1) {
+    snprintf(root, sizeof(root), "/tmp/%s", name);
+    snprintf(path, sizeof(path), "vnode%d/tsdb", vgId);
+    taosRemoveDir(root);
+    taosMkDir(root);
+
+    SDiskCfg diskCfg[TFS_MAX_TIERS] = {0};
+    for (int32_t level = 0; level < nLevel; level++) {
+      snprintf(diskCfg[level].dir, sizeof(diskCfg[level].dir), "%s/d%d", root, level);
+      diskCfg[level].level = level;
+      diskCfg[level].primary = (level == 0);
+      taosMkDir(diskCfg[level].dir);
+    }
+    pTfs = tfsOpen(diskCfg, nLevel);
+    ASSERT_NE(pTfs, nullptr);
+
+    pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    pVnode->pTfs = pTfs;
+    pVnode->config.vgId = vgId;
+    pVnode->config.tsdbPageSize = szPage;
+
+    pTsdb = (STsdb *)taosMemoryCalloc(1, sizeof(STsdb));
+    pTsdb->path = path;
+    pTsdb->pVnode = pVnode;
+    for (int32_t level = 0; level < nLevel; level++) {
+      ASSERT_EQ(tfsMkdirRecurAt(pTfs, path, (SDiskID){.level = level, .id = 0}), 0);
+    }
+  }
+
+  void closeTsdb() {
+    taosMemoryFreeClear(pTsdb);
+    taosMemoryFreeClear(pVnode);
+    tfsClose(pTfs);
+    pTfs = NULL;
+    taosRemoveDir(root);
+  }
+
+  char    root[64] = {0};
+  char    path[64] = {0};
+  STfs   *pTfs = NULL;
+  SVnode *pVnode = NULL;
+  STsdb  *pTsdb = NULL;
+};
+
+#endif /*_TD_VNODE_TSDB_TEST_UTIL_H_*/
@@ -181,8 +181,10 @@ typedef STableIndexRsp STableIndex;
 typedef struct SCtgTbCache {
   SRWLatch     metaLock;
   STableMeta*  pMeta;
+  int32_t      metaSize;  // bytes of pMeta charged to cacheSize, a child table meta is only a SCTableMeta
   SRWLatch     indexLock;
   STableIndex* pIndex;
+  int64_t      accessTs;  // last hit time in ms, for LRU eviction
 } SCtgTbCache;
 
 typedef struct SCtgVgCache {
@@ -364,6 +366,8 @@ typedef struct SCtgCacheStat {
   uint64_t numOfUserHit;
   uint64_t numOfUserMiss;
   uint64_t numOfClear;
+  uint64_t numOfMetaEvict;
+  uint64_t cacheSize;  // bytes of cached table meta, index and vgroup info
 } SCtgCacheStat;
 
 typedef struct SCatalogStat {
@@ -539,6 +543,9 @@ typedef struct SCtgOperation {
 #define CTG_META_SIZE(pMeta) \
   (sizeof(STableMeta) + ((pMeta)->tableInfo.numOfTags + (pMeta)->tableInfo.numOfColumns) * sizeof(SSchema))
 
+#define CTG_CACHE_TOUCH(_pCache)        atomic_store_64(&(_pCache)->accessTs, taosGetTimestampMs())
+#define CTG_CACHE_LOW_WATERMARK(_limit) ((_limit) / 10 * 9)
+
 #define CTG_TABLE_NOT_EXIST(code) (code == CTG_ERR_CODE_TABLE_NOT_EXIST)
 #define CTG_DB_NOT_EXIST(code) \
   (code == TSDB_CODE_MND_DB_NOT_EXIST || code == TSDB_CODE_MND_DB_IN_CREATING || code == TSDB_CODE_MND_DB_IN_DROPPING)
@@ -796,6 +803,9 @@ void    ctgClearSubTaskRes(SCtgSubRes* pRes);
 void    ctgFreeQNode(SCtgQNode* node);
 void    ctgClearHandle(SCatalog* pCtg);
 void    ctgFreeTbCacheImpl(SCtgTbCache* pCache);
+int64_t ctgGetTbIndexSize(STableIndex* pIndex);
+int64_t ctgGetVgInfoSize(SDBVgInfo* vgInfo);
+void    ctgEvictTbMetaCache(void);
 int32_t ctgRemoveTbMeta(SCatalog* pCtg, SName* pTableName);
 int32_t ctgGetTbHashVgroup(SCatalog* pCtg, SRequestConnInfo* pConn, const SName* pTableName, SVgroupInfo* pVgroup, bool* exists);
 SName*  ctgGetFetchName(SArray* pNames, SCtgFetch* pFetch);
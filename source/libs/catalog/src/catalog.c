@@ -1522,6 +1522,14 @@ int32_t catalogClearCache(void) {
   CTG_API_LEAVE_NOLOCK(code);
 }
 
+void catalogGetCacheStat(SCatalogCacheStat* pStat) {
+  pStat->cacheSize = CTG_STAT_GET(gCtgMgmt.stat.cache.cacheSize);
+  pStat->numOfTbl = CTG_STAT_GET(gCtgMgmt.stat.cache.numOfTbl);
+  pStat->numOfMetaHit = CTG_STAT_GET(gCtgMgmt.stat.cache.numOfMetaHit);
+  pStat->numOfMetaMiss = CTG_STAT_GET(gCtgMgmt.stat.cache.numOfMetaMiss);
+  pStat->numOfMetaEvict = CTG_STAT_GET(gCtgMgmt.stat.cache.numOfMetaEvict);
+}
+
 void catalogDestroy(void) {
   qInfo("start to destroy catalog");
 
@@ -222,6 +222,7 @@ int32_t ctgAcquireTbMetaFromCache(SCatalog *pCtg, char *dbFName, char *tbName, S
 
   *pDb = dbCache;
   *pTb = pCache;
+  CTG_CACHE_TOUCH(pCache);
 
   ctgDebug("tb %s meta got in cache, dbFName:%s", tbName, dbFName);
 
@@ -278,6 +279,7 @@ int32_t ctgAcquireVgMetaFromCache(SCatalog *pCtg, const char *dbFName, const cha
   }
 
   *pTb = tbCache;
+  CTG_CACHE_TOUCH(tbCache);
 
   ctgDebug("tb %s meta got in cache, dbFName:%s", tbName, dbFName);
 
@@ -426,6 +428,7 @@ int32_t ctgAcquireTbIndexFromCache(SCatalog *pCtg, char *dbFName, char *tbName,
 
   *pDb = dbCache;
   *pTb = pCache;
+  CTG_CACHE_TOUCH(pCache);
 
   ctgDebug("tb %s index got in cache, dbFName:%s", tbName, dbFName);
 
@@ -1551,6 +1554,8 @@ int32_t ctgWriteTbMetaToCache(SCatalog *pCtg, SCtgDBCache *dbCache, char *dbFNam
   if (NULL == pCache) {
     SCtgTbCache cache = {0};
     cache.pMeta = meta;
+    cache.metaSize = metaSize;
+    cache.accessTs = taosGetTimestampMs();
     if (taosHashPut(dbCache->tbCache, tbName, strlen(tbName), &cache, sizeof(SCtgTbCache)) != 0) {
       ctgError("taosHashPut new tbCache failed, dbFName:%s, tbName:%s, tbType:%d", dbFName, tbName, meta->tableType);
       taosMemoryFree(meta);
@@ -1560,11 +1565,18 @@ int32_t ctgWriteTbMetaToCache(SCatalog *pCtg, SCtgDBCache *dbCache, char *dbFNam
     pCache = taosHashGet(dbCache->tbCache, tbName, strlen(tbName));
   } else {
     CTG_LOCK(CTG_WRITE, &pCache->metaLock);
+    if (pCache->pMeta) {
+      CTG_CACHE_STAT_DEC(cacheSize, pCache->metaSize);
+    }
     taosMemoryFree(pCache->pMeta);
     pCache->pMeta = meta;
+    pCache->metaSize = metaSize;
     CTG_UNLOCK(CTG_WRITE, &pCache->metaLock);
+    CTG_CACHE_TOUCH(pCache);
   }
 
+  CTG_CACHE_STAT_INC(cacheSize, metaSize);
+
   if (NULL == orig) {
     CTG_CACHE_STAT_INC(numOfTbl, 1);
   }
@@ -1607,6 +1619,7 @@ int32_t ctgWriteTbIndexToCache(SCatalog *pCtg, SCtgDBCache *dbCache, char *dbFNa
   if (NULL == pCache) {
     SCtgTbCache cache = {0};
     cache.pIndex = pIndex;
+    cache.accessTs = taosGetTimestampMs();
 
     if (taosHashPut(dbCache->tbCache, tbName, strlen(tbName), &cache, sizeof(cache)) != 0) {
       ctgFreeSTableIndex(*index);
@@ -1615,6 +1628,7 @@ int32_t ctgWriteTbIndexToCache(SCatalog *pCtg, SCtgDBCache *dbCache, char *dbFNa
       CTG_ERR_RET(TSDB_CODE_OUT_OF_MEMORY);
     }
 
+    CTG_CACHE_STAT_INC(cacheSize, ctgGetTbIndexSize(pIndex));
     *index = NULL;
     ctgDebug("table %s index updated to cache, ver:%d, num:%d", tbName, pIndex->version,
              (int32_t)taosArrayGetSize(pIndex->pIndex));
@@ -1632,12 +1646,14 @@ int32_t ctgWriteTbIndexToCache(SCatalog *pCtg, SCtgDBCache *dbCache, char *dbFNa
     if (0 == suid) {
       suid = pCache->pIndex->suid;
     }
+    CTG_CACHE_STAT_DEC(cacheSize, ctgGetTbIndexSize(pCache->pIndex));
     taosArrayDestroyEx(pCache->pIndex->pIndex, tFreeSTableIndexInfo);
     taosMemoryFreeClear(pCache->pIndex);
   }
 
   pCache->pIndex = pIndex;
   CTG_UNLOCK(CTG_WRITE, &pCache->indexLock);
+  CTG_CACHE_STAT_INC(cacheSize, ctgGetTbIndexSize(pIndex));
 
   *index = NULL;
 
@@ -1765,11 +1781,13 @@ int32_t ctgOpUpdateVgroup(SCtgCacheOperation *operation) {
       goto _return;
     }
 
+    CTG_CACHE_STAT_DEC(cacheSize, ctgGetVgInfoSize(vgInfo));
     freeVgInfo(vgInfo);
   }
 
   vgCache->vgInfo = dbInfo;
   msg->dbInfo = NULL;
+  CTG_CACHE_STAT_INC(cacheSize, ctgGetVgInfoSize(dbInfo));
 
   ctgDebug("db vgInfo updated, dbFName:%s, vgVer:%d, stateTs:%" PRId64 ", dbId:0x%" PRIx64, dbFName,
            vgVersion.vgVersion, vgVersion.stateTs, vgVersion.dbId);
@@ -1839,6 +1857,7 @@ int32_t ctgOpDropDbVgroup(SCtgCacheOperation *operation) {
 
   CTG_ERR_JRET(ctgWLockVgInfo(pCtg, dbCache));
 
+  CTG_CACHE_STAT_DEC(cacheSize, ctgGetVgInfoSize(dbCache->vgCache.vgInfo));
   freeVgInfo(dbCache->vgCache.vgInfo);
   dbCache->vgCache.vgInfo = NULL;
 
@@ -2320,6 +2339,157 @@ void ctgCleanupCacheQueue(void) {
   gCtgMgmt.queue.tail = NULL;
 }
 
+typedef struct SCtgEvictCand {
+  int64_t accessTs;
+  int64_t size;
+} SCtgEvictCand;
+
+static int32_t ctgEvictCandCompare(const void *lp, const void *rp) {
+  const SCtgEvictCand *l = lp;
+  const SCtgEvictCand *r = rp;
+  if (l->accessTs == r->accessTs) {
+    return 0;
+  }
+
+  return l->accessTs < r->accessTs ? -1 : 1;
+}
+
+static bool ctgTbCacheEvictable(SCtgTbCache *pCache) {
+  STableMeta *pMeta = pCache->pMeta;
+  // stable metas are shared by all their child tables and tracked by the stb rent, keep them
+  return pMeta && pMeta->tableType != TSDB_SUPER_TABLE;
+}
+
+static int64_t ctgTbCacheSize(SCtgTbCache *pCache) {
+  int64_t size = pCache->pMeta ? pCache->metaSize : 0;
+  if (pCache->pIndex) {
+    size += ctgGetTbIndexSize(pCache->pIndex);
+  }
+
+  return size;
+}
+
+static int32_t ctgEvictDbTbCache(SCatalog *pCtg, SCtgDBCache *dbCache, int64_t cutoffTs) {
+  SArray *pNames = taosArrayInit(16, TSDB_TABLE_NAME_LEN);
+  if (NULL == pNames) {
+    CTG_ERR_RET(TSDB_CODE_OUT_OF_MEMORY);
+  }
+
+  SCtgTbCache *pCache = taosHashIterate(dbCache->tbCache, NULL);
+  while (pCache) {
+    if (ctgTbCacheEvictable(pCache) && atomic_load_64(&pCache->accessTs) <= cutoffTs) {
+      size_t len = 0;
+      char   name[TSDB_TABLE_NAME_LEN] = {0};
+      char  *key = taosHashGetKey(pCache, &len);
+      memcpy(name, key, TMIN(len, TSDB_TABLE_NAME_LEN - 1));
+      taosArrayPush(pNames, name);
+    }
+    pCache = taosHashIterate(dbCache->tbCache, pCache);
+  }
+
+  int32_t num = taosArrayGetSize(pNames);
+  for (int32_t i = 0; i < num; ++i) {
+    char *tbName = taosArrayGet(pNames, i);
+    pCache = taosHashGet(dbCache->tbCache, tbName, strlen(tbName));
+    if (NULL == pCache) {
+      continue;
+    }
+
+    CTG_LOCK(CTG_WRITE, &pCache->metaLock);
+    ctgFreeTbCacheImpl(pCache);
+    CTG_UNLOCK(CTG_WRITE, &pCache->metaLock);
+
+    if (0 == taosHashRemove(dbCache->tbCache, tbName, strlen(tbName))) {
+      CTG_CACHE_STAT_DEC(numOfTbl, 1);
+      CTG_CACHE_STAT_INC(numOfMetaEvict, 1);
+    }
+  }
+
+  if (num > 0) {
+    ctgDebug("%d table metas evicted from cache, dbId:0x%" PRIx64, num, dbCache->dbId);
+  }
+
+  taosArrayDestroy(pNames);
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// Evict the least recently used table metas once the cache grows beyond the configured size. Going down to the low
+// watermark keeps the scan from running again on every following update.
+void ctgEvictTbMetaCache(void) {
+  uint64_t limit = gCtgMgmt.cfg.maxCacheSize;
+  uint64_t cacheSize = CTG_STAT_GET(gCtgMgmt.stat.cache.cacheSize);
+  if (0 == limit || cacheSize <= limit) {
+    return;
+  }
+
+  int64_t toFree = cacheSize - CTG_CACHE_LOW_WATERMARK(limit);
+  SArray *pCands = taosArrayInit(1024, sizeof(SCtgEvictCand));
+  if (NULL == pCands) {
+    return;
+  }
+
+  void *pIter = taosHashIterate(gCtgMgmt.pCluster, NULL);
+  while (pIter) {
+    SCatalog *pCtg = *(SCatalog **)pIter;
+    if (pCtg && !pCtg->stopUpdate) {
+      SCtgDBCache *dbCache = taosHashIterate(pCtg->dbCache, NULL);
+      while (dbCache) {
+        if (!dbCache->deleted && dbCache->tbCache) {
+          SCtgTbCache *pCache = taosHashIterate(dbCache->tbCache, NULL);
+          while (pCache) {
+            if (ctgTbCacheEvictable(pCache)) {
+              SCtgEvictCand cand = {.accessTs = atomic_load_64(&pCache->accessTs), .size = ctgTbCacheSize(pCache)};
+              taosArrayPush(pCands, &cand);
+            }
+            pCache = taosHashIterate(dbCache->tbCache, pCache);
+          }
+        }
+        dbCache = taosHashIterate(pCtg->dbCache, dbCache);
+      }
+    }
+    pIter = taosHashIterate(gCtgMgmt.pCluster, pIter);
+  }
+
+  int32_t candNum = taosArrayGetSize(pCands);
+  if (candNum <= 0) {
+    taosArrayDestroy(pCands);
+    return;
+  }
+
+  taosArraySort(pCands, ctgEvictCandCompare);
+
+  int64_t freed = 0;
+  int64_t cutoffTs = INT64_MIN;
+  for (int32_t i = 0; i < candNum && freed < toFree; ++i) {
+    SCtgEvictCand *pCand = taosArrayGet(pCands, i);
+    freed += pCand->size;
+    cutoffTs = pCand->accessTs;
+  }
+  taosArrayDestroy(pCands);
+
+  uint64_t evicted = CTG_STAT_GET(gCtgMgmt.stat.cache.numOfMetaEvict);
+
+  pIter = taosHashIterate(gCtgMgmt.pCluster, NULL);
+  while (pIter) {
+    SCatalog *pCtg = *(SCatalog **)pIter;
+    if (pCtg && !pCtg->stopUpdate) {
+      SCtgDBCache *dbCache = taosHashIterate(pCtg->dbCache, NULL);
+      while (dbCache) {
+        if (!dbCache->deleted && dbCache->tbCache) {
+          ctgEvictDbTbCache(pCtg, dbCache, cutoffTs);
+        }
+        dbCache = taosHashIterate(pCtg->dbCache, dbCache);
+      }
+    }
+    pIter = taosHashIterate(gCtgMgmt.pCluster, pIter);
+  }
+
+  qDebug("catalog cache size %" PRIu64 " exceeds limit %" PRIu64 ", %" PRIu64 " table metas evicted, size now %" PRIu64,
+         cacheSize, limit, CTG_STAT_GET(gCtgMgmt.stat.cache.numOfMetaEvict) - evicted,
+         CTG_STAT_GET(gCtgMgmt.stat.cache.cacheSize));
+}
+
 void *ctgUpdateThreadFunc(void *param) {
   setThreadName("catalog");
 
@@ -2351,6 +2521,8 @@ void *ctgUpdateThreadFunc(void *param) {
 
     CTG_RT_STAT_INC(numOfOpDequeue, 1);
 
+    ctgEvictTbMetaCache();
+
     ctgdShowCacheInfo();
   }
 
@@ -2507,6 +2679,7 @@ int32_t ctgGetTbMetasFromCache(SCatalog *pCtg, SRequestConnInfo *pConn, SCtgTbMe
     }
 
     STableMeta *tbMeta = pCache->pMeta;
+    CTG_CACHE_TOUCH(pCache);
 
     SCtgTbMetaCtx nctx = {0};
     nctx.flag = flag;
@@ -352,6 +352,16 @@ int32_t ctgdGetStatNum(char *option, void *res) {
     return TSDB_CODE_SUCCESS;
   }
 
+  if (0 == strcasecmp(option, "cache.numOfMetaEvict")) {
+    *(uint64_t *)res = atomic_load_64(&gCtgMgmt.stat.cache.numOfMetaEvict);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (0 == strcasecmp(option, "cache.cacheSize")) {
+    *(uint64_t *)res = atomic_load_64(&gCtgMgmt.stat.cache.cacheSize);
+    return TSDB_CODE_SUCCESS;
+  }
+
   qError("invalid stat option:%s", option);
 
   return TSDB_CODE_CTG_INTERNAL_ERROR;
@@ -206,10 +206,34 @@ void ctgFreeStbMetaCache(SCtgDBCache* dbCache) {
   CTG_CACHE_STAT_DEC(numOfStb, stbNum);
 }
 
+int64_t ctgGetTbIndexSize(STableIndex* pIndex) {
+  int64_t size = sizeof(STableIndex);
+  int32_t num = taosArrayGetSize(pIndex->pIndex);
+  for (int32_t i = 0; i < num; ++i) {
+    STableIndexInfo* pInfo = taosArrayGet(pIndex->pIndex, i);
+    size += sizeof(STableIndexInfo) + (pInfo->expr ? strlen(pInfo->expr) + 1 : 0);
+  }
+
+  return size;
+}
+
+int64_t ctgGetVgInfoSize(SDBVgInfo* vgInfo) {
+  if (NULL == vgInfo) {
+    return 0;
+  }
+
+  return sizeof(SDBVgInfo) + (int64_t)taosHashGetSize(vgInfo->vgHash) * sizeof(SVgroupInfo);
+}
+
 void ctgFreeTbCacheImpl(SCtgTbCache* pCache) {
   qDebug("tbMeta freed, p:%p", pCache->pMeta);
+  if (pCache->pMeta) {
+    CTG_CACHE_STAT_DEC(cacheSize, pCache->metaSize);
+  }
   taosMemoryFreeClear(pCache->pMeta);
+  pCache->metaSize = 0;
   if (pCache->pIndex) {
+    CTG_CACHE_STAT_DEC(cacheSize, ctgGetTbIndexSize(pCache->pIndex));
     taosArrayDestroyEx(pCache->pIndex->pIndex, tFreeSTableIndexInfo);
     taosMemoryFreeClear(pCache->pIndex);
   }
@@ -231,7 +255,10 @@ void ctgFreeTbCache(SCtgDBCache* dbCache) {
   CTG_CACHE_STAT_DEC(numOfTbl, tblNum);
 }
 
-void ctgFreeVgInfoCache(SCtgDBCache* dbCache) { freeVgInfo(dbCache->vgCache.vgInfo); }
+void ctgFreeVgInfoCache(SCtgDBCache* dbCache) {
+  CTG_CACHE_STAT_DEC(cacheSize, ctgGetVgInfoSize(dbCache->vgCache.vgInfo));
+  freeVgInfo(dbCache->vgCache.vgInfo);
+}
 
 void ctgFreeDbCache(SCtgDBCache* dbCache) {
   if (NULL == dbCache) {
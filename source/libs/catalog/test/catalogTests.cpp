@@ -1783,6 +1783,133 @@ TEST(tableMeta, updateStbMeta) {
   catalogDestroy();
 }
 
+TEST(tableMeta, lruEvict) {
+  struct SCatalog *pCtg = NULL;
+  int32_t          tbNum = 20;
+  int32_t          metaSize = sizeof(STableMeta) + 2 * sizeof(SSchema);
+
+  ctgTestInitLogFile();
+
+  SCatalogCfg cfg = {0};
+  cfg.maxCacheSize = 4 * metaSize;
+  int32_t code = catalogInit(&cfg);
+  ASSERT_EQ(code, 0);
+
+  code = catalogGetHandle(ctgTestClusterId, &pCtg);
+  ASSERT_EQ(code, 0);
+
+  STableMetaRsp rsp = {0};
+  strcpy(rsp.dbFName, ctgTestDbname);
+  rsp.dbId = 1;
+  rsp.numOfColumns = 2;
+  rsp.precision = 1;
+  rsp.tableType = TSDB_NORMAL_TABLE;
+  rsp.sversion = ctgTestSVersion;
+  rsp.tversion = ctgTestTVersion;
+  rsp.vgId = 1;
+  rsp.pSchemas = (SSchema *)taosMemoryCalloc(rsp.numOfColumns, sizeof(SSchema));
+  rsp.pSchemas[0].type = TSDB_DATA_TYPE_TIMESTAMP;
+  rsp.pSchemas[0].colId = 1;
+  rsp.pSchemas[0].bytes = 8;
+  strcpy(rsp.pSchemas[0].name, "ts");
+  rsp.pSchemas[1].type = TSDB_DATA_TYPE_INT;
+  rsp.pSchemas[1].colId = 2;
+  rsp.pSchemas[1].bytes = 4;
+  strcpy(rsp.pSchemas[1].name, "col1");
+
+  for (int32_t i = 0; i < tbNum; ++i) {
+    sprintf(rsp.tbName, "%s%d", ctgTestTablename, i);
+    rsp.tuid = ctgTestNormalTblUid + i;
+    code = catalogUpdateTableMeta(pCtg, &rsp);
+    ASSERT_EQ(code, 0);
+    taosMsleep(2);
+  }
+  taosMemoryFreeClear(rsp.pSchemas);
+
+  uint64_t evicted = 0;
+  for (int32_t i = 0; i < 100 && 0 == evicted; ++i) {
+    ctgdGetStatNum("cache.numOfMetaEvict", (void *)&evicted);
+    taosMsleep(10);
+  }
+  ASSERT_GT(evicted, 0);
+
+  SCatalogCacheStat stat = {0};
+  catalogGetCacheStat(&stat);
+  ASSERT_EQ(stat.numOfMetaEvict, evicted);
+  ASSERT_LE(stat.cacheSize, cfg.maxCacheSize);
+  ASSERT_LT(ctgdGetClusterCacheNum(pCtg, CTG_DBG_META_NUM), tbNum);
+
+  // the most recently written table survives, the oldest one is gone
+  SName n = {TSDB_TABLE_NAME_T, 1, {0}, {0}};
+  strcpy(n.dbname, "db1");
+  sprintf(n.tname, "%s%d", ctgTestTablename, tbNum - 1);
+  STableMeta *tableMeta = NULL;
+  code = catalogGetCachedTableMeta(pCtg, &n, &tableMeta);
+  ASSERT_EQ(code, 0);
+  ASSERT_TRUE(tableMeta != NULL);
+  taosMemoryFreeClear(tableMeta);
+
+  sprintf(n.tname, "%s%d", ctgTestTablename, 0);
+  code = catalogGetCachedTableMeta(pCtg, &n, &tableMeta);
+  ASSERT_EQ(code, 0);
+  ASSERT_TRUE(tableMeta == NULL);
+
+  // child tables are charged the size of their SCTableMeta only, evicting them must not drift the cache size
+  rsp.numOfColumns = 2;
+  rsp.numOfTags = 1;
+  rsp.tableType = TSDB_SUPER_TABLE;
+  rsp.suid = ctgTestSuid;
+  rsp.tuid = ctgTestSuid;
+  strcpy(rsp.tbName, ctgTestSTablename);
+  strcpy(rsp.stbName, ctgTestSTablename);
+  rsp.pSchemas = (SSchema *)taosMemoryCalloc(rsp.numOfColumns + rsp.numOfTags, sizeof(SSchema));
+  rsp.pSchemas[0].type = TSDB_DATA_TYPE_TIMESTAMP;
+  rsp.pSchemas[0].colId = 1;
+  rsp.pSchemas[0].bytes = 8;
+  strcpy(rsp.pSchemas[0].name, "ts");
+  rsp.pSchemas[1].type = TSDB_DATA_TYPE_INT;
+  rsp.pSchemas[1].colId = 2;
+  rsp.pSchemas[1].bytes = 4;
+  strcpy(rsp.pSchemas[1].name, "col1");
+  rsp.pSchemas[2].type = TSDB_DATA_TYPE_INT;
+  rsp.pSchemas[2].colId = 3;
+  rsp.pSchemas[2].bytes = 4;
+  strcpy(rsp.pSchemas[2].name, "tag1");
+  code = catalogUpdateTableMeta(pCtg, &rsp);
+  ASSERT_EQ(code, 0);
+  taosMemoryFreeClear(rsp.pSchemas);
+
+  rsp.tableType = TSDB_CHILD_TABLE;
+  int32_t ctbNum = 10 * tbNum;
+  for (int32_t i = 0; i < ctbNum; ++i) {
+    sprintf(rsp.tbName, "%s%d", ctgTestCTablename, i);
+    rsp.tuid = ctgTestNormalTblUid + tbNum + i;
+    code = catalogUpdateTableMeta(pCtg, &rsp);
+    ASSERT_EQ(code, 0);
+    taosMsleep(1);
+  }
+
+  uint64_t ctbEvicted = evicted;
+  for (int32_t i = 0; i < 100 && ctbEvicted == evicted; ++i) {
+    ctgdGetStatNum("cache.numOfMetaEvict", (void *)&ctbEvicted);
+    taosMsleep(10);
+  }
+  ASSERT_GT(ctbEvicted, evicted);
+
+  catalogGetCacheStat(&stat);
+  ASSERT_LE(stat.cacheSize, cfg.maxCacheSize);
+
+  // the stable meta the child tables share is kept
+  strcpy(n.tname, ctgTestSTablename);
+  code = catalogGetCachedTableMeta(pCtg, &n, &tableMeta);
+  ASSERT_EQ(code, 0);
+  ASSERT_TRUE(tableMeta != NULL);
+  ASSERT_EQ(tableMeta->tableType, TSDB_SUPER_TABLE);
+  taosMemoryFreeClear(tableMeta);
+
+  catalogDestroy();
+}
+
 TEST(getIndexInfo, notExists) {
   struct SCatalog  *pCtg = NULL;
   SRequestConnInfo connInfo = {0};  
@@ -56,6 +56,8 @@ extern "C" {
 #define EXPLAIN_ON_CONDITIONS_FORMAT "Join Cond: "
 #define EXPLAIN_TIMERANGE_FORMAT "Time Range: [%" PRId64 ", %" PRId64 "]"
 #define EXPLAIN_OUTPUT_FORMAT "Output: "
+#define EXPLAIN_RUNTIME_FORMAT "Runtime: "
+#define EXPLAIN_IO_DETAIL_FORMAT "I/O Detail: "
 #define EXPLAIN_TIME_WINDOWS_FORMAT "Time Window: interval=%" PRId64 "%c offset=%" PRId64 "%c sliding=%" PRId64 "%c"
 #define EXPLAIN_WINDOW_FORMAT "Window: gap=%" PRId64
 #define EXPLAIN_RATIO_TIME_FORMAT "Ratio: %f"
@@ -89,6 +91,8 @@ extern "C" {
 #define EXPLAIN_INTERVAL_VALUE_FORMAT "interval=%" PRId64 "%c"
 #define EXPLAIN_FUNCTIONS_FORMAT "functions=%d"
 #define EXPLAIN_EXECINFO_FORMAT "cost=%.3f..%.3f rows=%" PRIu64
+#define EXPLAIN_RUNTIME_ROWS_FORMAT "input_rows=%" PRIu64 " input_blocks=%" PRIu64 " output_rows=%" PRIu64 " output_blocks=%" PRIu64
+#define EXPLAIN_RUNTIME_COST_FORMAT "self_cost=%.3f max_output=%.2fKb"
 #define EXPLAIN_MODE_FORMAT "mode=%s"
 #define EXPLAIN_STRING_TYPE_FORMAT "%s"
 #define EXPLAIN_INPUT_ORDER_FORMAT "input_order=%s"
@@ -412,6 +412,35 @@ int32_t qExplainResNodeToRowsImpl(SExplainResNode *pResNode, SExplainCtx *ctx, i
         EXPLAIN_ROW_END();
 
         QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level + 1));
+
+        if (verbose) {
+          STableScanAnalyzeInfo detail = {0};
+          for (int32_t i = 0; i < nodeNum; ++i) {
+            SExplainExecInfo *pExec = taosArrayGet(pResNode->pExecInfo, i);
+            if (pExec->verboseLen < sizeof(STableScanAnalyzeInfo)) {
+              continue;  // sent by an older vnode
+            }
+
+            STableScanAnalyzeInfo *pScanInfo = (STableScanAnalyzeInfo *)pExec->verboseInfo;
+            detail.loadBytes += pScanInfo->loadBytes;
+            detail.smaFilterBlocks += pScanInfo->smaFilterBlocks;
+            detail.bloomFilterBlocks += pScanInfo->bloomFilterBlocks;
+            detail.cacheHits += pScanInfo->cacheHits;
+          }
+
+          EXPLAIN_ROW_NEW(level + 1, EXPLAIN_IO_DETAIL_FORMAT);
+          EXPLAIN_ROW_APPEND("load_bytes=%.1f", ((double)detail.loadBytes) / nodeNum);
+          EXPLAIN_ROW_APPEND(EXPLAIN_BLANK_FORMAT);
+          EXPLAIN_ROW_APPEND("sma_filter_blocks=%.1f", ((double)detail.smaFilterBlocks) / nodeNum);
+          EXPLAIN_ROW_APPEND(EXPLAIN_BLANK_FORMAT);
+          EXPLAIN_ROW_APPEND("bloom_filter_blocks=%.1f", ((double)detail.bloomFilterBlocks) / nodeNum);
+          EXPLAIN_ROW_APPEND(EXPLAIN_BLANK_FORMAT);
+          EXPLAIN_ROW_APPEND("skip_blocks=%.1f", ((double)info.skipBlocks) / nodeNum);
+          EXPLAIN_ROW_APPEND(EXPLAIN_BLANK_FORMAT);
+          EXPLAIN_ROW_APPEND("cache_hits=%.1f", ((double)detail.cacheHits) / nodeNum);
+          EXPLAIN_ROW_END();
+          QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level + 1));
+        }
       }
 
       if (verbose) {
@@ -1499,6 +1528,34 @@ int32_t qExplainResNodeToRowsImpl(SExplainResNode *pResNode, SExplainCtx *ctx, i
   return TSDB_CODE_SUCCESS;
 }
 
+static int32_t qExplainAppendRuntimeRow(SExplainResNode *pResNode, SExplainCtx *ctx, int32_t level) {
+  int32_t tlen = 0;
+  bool    isVerboseLine = true;
+  char   *tbuf = ctx->tbuf;
+
+  int32_t          nodeNum = taosArrayGetSize(pResNode->pExecInfo);
+  SExplainExecInfo maxExecInfo = {0};
+  for (int32_t i = 0; i < nodeNum; ++i) {
+    SExplainExecInfo *execInfo = taosArrayGet(pResNode->pExecInfo, i);
+    maxExecInfo.inputRows = TMAX(maxExecInfo.inputRows, execInfo->inputRows);
+    maxExecInfo.inputBlocks = TMAX(maxExecInfo.inputBlocks, execInfo->inputBlocks);
+    maxExecInfo.numOfRows = TMAX(maxExecInfo.numOfRows, execInfo->numOfRows);
+    maxExecInfo.numOfBlocks = TMAX(maxExecInfo.numOfBlocks, execInfo->numOfBlocks);
+    maxExecInfo.selfCost = TMAX(maxExecInfo.selfCost, execInfo->selfCost);
+    maxExecInfo.maxOutputBytes = TMAX(maxExecInfo.maxOutputBytes, execInfo->maxOutputBytes);
+  }
+
+  EXPLAIN_ROW_NEW(level + 1, EXPLAIN_RUNTIME_FORMAT);
+  EXPLAIN_ROW_APPEND(EXPLAIN_RUNTIME_ROWS_FORMAT, maxExecInfo.inputRows, maxExecInfo.inputBlocks,
+                     maxExecInfo.numOfRows, maxExecInfo.numOfBlocks);
+  EXPLAIN_ROW_APPEND(EXPLAIN_BLANK_FORMAT);
+  EXPLAIN_ROW_APPEND(EXPLAIN_RUNTIME_COST_FORMAT, maxExecInfo.selfCost, maxExecInfo.maxOutputBytes / 1024.0);
+  EXPLAIN_ROW_END();
+  QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level + 1));
+
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t qExplainResNodeToRows(SExplainResNode *pResNode, SExplainCtx *ctx, int32_t level) {
   if (NULL == pResNode) {
     qError("explain res node is NULL");
@@ -1508,6 +1565,10 @@ int32_t qExplainResNodeToRows(SExplainResNode *pResNode, SExplainCtx *ctx, int32
   int32_t code = 0;
   QRY_ERR_RET(qExplainResNodeToRowsImpl(pResNode, ctx, level));
 
+  if (ctx->verbose && EXPLAIN_MODE_ANALYZE == ctx->mode && pResNode->pExecInfo) {
+    QRY_ERR_RET(qExplainAppendRuntimeRow(pResNode, ctx, level));
+  }
+
   SNode *pNode = NULL;
   FOREACH(pNode, pResNode->pChildren) { QRY_ERR_RET(qExplainResNodeToRows((SExplainResNode *)pNode, ctx, level + 1)); }
 
@@ -158,6 +158,9 @@ SColumn   extractColumnFromColumnNode(SColumnNode* pColNode);
 int32_t initQueryTableDataCond(SQueryTableDataCond* pCond, const STableScanPhysiNode* pTableScanNode);
 void    cleanupQueryTableDataCond(SQueryTableDataCond* pCond);
 
+SArray* extractBlockBloomConds(SNode* pConditions);
+void    destroyBlockBloomConds(SArray* pConds);
+
 int32_t convertFillType(int32_t mode);
 int32_t resultrowComparAsc(const void* p1, const void* p2);
 int32_t isQualifiedTable(STableKeyInfo* info, SNode* pTagCond, void* metaHandle, bool* pQualified);
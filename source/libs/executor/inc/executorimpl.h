@@ -95,8 +95,12 @@ typedef struct STaskCostInfo {
 } STaskCostInfo;
 
 typedef struct SOperatorCostInfo {
-  double openCost;
-  double totalCost;
+  double   openCost;
+  double   totalCost;
+  double   execCost;  // time spent in getNextFn, including the downstream operators
+  uint64_t outputRows;
+  uint64_t outputBlocks;
+  uint64_t maxOutputBytes;  // max size of an output block plus the buffer reported by reqBufFn
 } SOperatorCostInfo;
 
 struct SOperatorInfo;
@@ -200,6 +204,7 @@ enum {
 
 typedef struct SOperatorFpSet {
   __optr_open_fn_t    _openFn;  // DO NOT invoke this function directly
+  __optr_fn_t         _nextFn;  // DO NOT invoke this function directly, use getNextFn instead
   __optr_fn_t         getNextFn;
   __optr_fn_t         cleanupFn;  // call this function to release the allocated resources ASAP
   __optr_close_fn_t   closeFn;
@@ -326,6 +331,9 @@ typedef struct STableScanBase {
   int32_t                scanFlag;  // table scan flag to denote if it is a repeat/reverse/main scan
   int32_t                dataBlockLoadFlag;
   SLimitInfo             limitInfo;
+  SArray*                pBloomConds;  // SArray<SBlockBloomCond>, equality conditions checked by block bloom filters
+  int16_t*               pFilterColIds;  // columns referred by the filter, decoded before the other columns
+  int32_t                numOfFilterCols;
 } STableScanBase;
 
 typedef struct STableScanInfo {
@@ -538,8 +546,15 @@ typedef struct SIntervalAggOperatorInfo {
   EOPTR_EXEC_MODEL   execModel;          // operator execution model [batch model|stream model]
   STimeWindowAggSupp twAggSup;
   SArray*            pPrevValues;  //  SArray<SGroupKeys> used to keep the previous not null value for interpolation.
+  SArray*            pWinRanges;   //  SArray<SWinRowRange> row range of each window in the current data block
 } SIntervalAggOperatorInfo;
 
+typedef struct SWinRowRange {
+  STimeWindow win;
+  int32_t     startPos;
+  int32_t     numOfRows;
+} SWinRowRange;
+
 typedef struct SMergeAlignedIntervalAggOperatorInfo {
   SIntervalAggOperatorInfo* intervalAggOperatorInfo;
 
@@ -692,6 +707,7 @@ typedef struct SStreamFillOperatorInfo {
 
 SOperatorFpSet createOperatorFpSet(__optr_open_fn_t openFn, __optr_fn_t nextFn, __optr_fn_t cleanup,
                                    __optr_close_fn_t closeFn, __optr_reqBuf_fn_t reqBufFn, __optr_explain_fn_t explain);
+void           enableOperatorExecCost(SOperatorInfo* pOperator);
 int32_t        optrDummyOpenFn(SOperatorInfo* pOperator);
 int32_t        appendDownstream(SOperatorInfo* p, SOperatorInfo** pDownstream, int32_t num);
 void           setOperatorCompleted(SOperatorInfo* pOperator);
@@ -740,6 +756,8 @@ int32_t getBufferPgSize(int32_t rowSize, uint32_t* defaultPgsz, uint32_t* defaul
 extern void doDestroyExchangeOperatorInfo(void* param);
 
 void    doFilter(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* pColMatchInfo);
+void    doFilterByResult(SSDataBlock* pBlock, const SColumnInfoData* p, bool keep, int32_t status,
+                         SColMatchInfo* pColMatchInfo);
 int32_t addTagPseudoColumnData(SReadHandle* pHandle, const SExprInfo* pExpr, int32_t numOfExpr, SSDataBlock* pBlock,
                                int32_t rows, const char* idStr, STableMetaCacheInfo* pCache);
 
@@ -847,6 +865,10 @@ STimeWindow getActiveTimeWindow(SDiskbasedBuf* pBuf, SResultRowInfo* pResultRowI
 int32_t getNumOfRowsInTimeWindow(SDataBlockInfo* pDataBlockInfo, TSKEY* pPrimaryColumn, int32_t startPos, TSKEY ekey,
                                  __block_search_fn_t searchFn, STableQueryInfo* item, int32_t order);
 int32_t binarySearchForKey(char* pValue, int num, TSKEY key, int order);
+int32_t getNextQualifiedWindow(SInterval* pInterval, STimeWindow* pNext, SDataBlockInfo* pDataBlockInfo,
+                               TSKEY* primaryKeys, int32_t prevPosition, int32_t order);
+void    assignIntervalWindowRanges(SInterval* pInterval, SDataBlockInfo* pBlockInfo, const TSKEY* tsCols,
+                                   STimeWindow win, SArray* pRanges);
 SResultRow* getNewResultRow(SDiskbasedBuf* pResultBuf, int32_t* currentPageId, int32_t interBufSize);
 void getCurSessionWindow(SStreamAggSupporter* pAggSup, TSKEY startTs, TSKEY endTs, uint64_t groupId, SSessionKey* pKey);
 bool isInTimeWindow(STimeWindow* pWin, TSKEY ts, int64_t gap);
@@ -876,6 +898,7 @@ void    getNextIntervalWindow(SInterval* pInterval, STimeWindow* tw, int32_t ord
 int32_t qAppendTaskStopInfo(SExecTaskInfo* pTaskInfo, SExchangeOpStopInfo* pInfo);
 int32_t getForwardStepsInBlock(int32_t numOfRows, __block_search_fn_t searchFn, TSKEY ekey, int32_t pos, int32_t order,
                                int64_t* pData);
+int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableScanInfo, SSDataBlock* pBlock, uint32_t* status);
 void    appendCreateTableRow(SStreamState* pState, SExprSupp* pTableSup, SExprSupp* pTagSup, uint64_t groupId,
                              SSDataBlock* pSrcBlock, int32_t rowId, SSDataBlock* pDestBlock);
 
@@ -108,6 +108,16 @@ int32_t tsortSetComparFp(SSortHandle* pHandle, _sort_merge_compar_fn_t fp);
  */
 int32_t tsortSetCompareGroupId(SSortHandle* pHandle, bool compareGroupId);
 
+/**
+ * only the first maxRows tuples in the sort order are required, the rest of the input is discarded as early as
+ * possible. It must be set before tsortOpen.
+ *
+ * @param pHandle
+ * @param maxRows
+ * @return
+ */
+int32_t tsortSetMaxRows(SSortHandle* pHandle, int64_t maxRows);
+
 /**
  *
  * @param pHandle
@@ -1016,6 +1016,222 @@ end:
   return code;
 }
 
+static bool isTagBitmapValue(const SColumnNode* pCol, SNode* pNode) {
+  if (nodeType(pNode) != QUERY_NODE_VALUE) {
+    return false;
+  }
+
+  // the constants of an IN list are not converted to the type of an integer tag, the bitmap keys all integers alike
+  SValueNode* pVal = (SValueNode*)pNode;
+  int8_t      type = pVal->node.resType.type;
+  int8_t      colType = pCol->node.resType.type;
+  return !pVal->isNull && (type == colType || (IS_INTEGER_TYPE(type) && IS_INTEGER_TYPE(colType)));
+}
+
+// the tag column of an equality or IN predicate that can be answered by the tag bitmap index
+static SColumnNode* getTagBitmapColumn(SOperatorNode* pOper) {
+  if ((pOper->opType != OP_TYPE_EQUAL && pOper->opType != OP_TYPE_IN) || pOper->pLeft == NULL ||
+      pOper->pRight == NULL || nodeType(pOper->pLeft) != QUERY_NODE_COLUMN) {
+    return NULL;
+  }
+
+  SColumnNode* pCol = (SColumnNode*)pOper->pLeft;
+  if (pCol->colType != COLUMN_TYPE_TAG) {
+    return NULL;
+  }
+
+  // float and double are excluded, since the bitmap compares values bitwise
+  switch (pCol->node.resType.type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_UTINYINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+    case TSDB_DATA_TYPE_UINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+    case TSDB_DATA_TYPE_VARCHAR:
+    case TSDB_DATA_TYPE_NCHAR:
+      break;
+    default:
+      return NULL;
+  }
+
+  if (pOper->opType == OP_TYPE_EQUAL) {
+    return isTagBitmapValue(pCol, pOper->pRight) ? pCol : NULL;
+  }
+
+  if (nodeType(pOper->pRight) != QUERY_NODE_NODE_LIST) {
+    return NULL;
+  }
+
+  SNode* pNode = NULL;
+  FOREACH(pNode, ((SNodeListNode*)pOper->pRight)->pNodeList) {
+    if (!isTagBitmapValue(pCol, pNode)) {
+      return NULL;
+    }
+  }
+
+  return pCol;
+}
+
+// only the conjunctions and disjunctions of tag equality and IN predicates are supported
+static bool collectTagBitmapCols(SNode* pNode, SArray* pCids) {
+  if (nodeType(pNode) == QUERY_NODE_LOGIC_CONDITION) {
+    SLogicConditionNode* pCond = (SLogicConditionNode*)pNode;
+    if (pCond->condType != LOGIC_COND_TYPE_AND && pCond->condType != LOGIC_COND_TYPE_OR) {
+      return false;
+    }
+
+    SNode* p = NULL;
+    FOREACH(p, pCond->pParameterList) {
+      if (!collectTagBitmapCols(p, pCids)) {
+        return false;
+      }
+    }
+    return true;
+  } else if (nodeType(pNode) == QUERY_NODE_OPERATOR) {
+    SColumnNode* pCol = getTagBitmapColumn((SOperatorNode*)pNode);
+    return pCol != NULL && taosArrayPush(pCids, &pCol->colId) != NULL;
+  }
+
+  return false;
+}
+
+static void valueNodeToTagVal(SValueNode* pValue, int16_t cid, STagVal* pTagVal) {
+  int8_t type = pValue->node.resType.type;
+  void*  p = nodesGetValueFromNode(pValue);
+
+  pTagVal->cid = cid;
+  pTagVal->type = type;
+  if (IS_VAR_DATA_TYPE(type)) {
+    pTagVal->pData = (uint8_t*)varDataVal(p);
+    pTagVal->nData = varDataLen(p);
+  } else {
+    pTagVal->i64 = 0;
+    memcpy(&pTagVal->i64, p, tDataTypes[type].bytes);
+  }
+}
+
+static int32_t calcTagBitmap(SNode* pNode, SMetaTagBitmapReader* pReader, uint8_t* pBits, int32_t len) {
+  int32_t code = TSDB_CODE_SUCCESS;
+
+  if (nodeType(pNode) == QUERY_NODE_LOGIC_CONDITION) {
+    SLogicConditionNode* pCond = (SLogicConditionNode*)pNode;
+    SNode*               p = NULL;
+
+    if (pCond->condType == LOGIC_COND_TYPE_OR) {
+      FOREACH(p, pCond->pParameterList) {
+        code = calcTagBitmap(p, pReader, pBits, len);
+        if (code != TSDB_CODE_SUCCESS) {
+          return code;
+        }
+      }
+      return code;
+    }
+
+    uint8_t* pTmp = taosMemoryMalloc(len);
+    if (pTmp == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    bool first = true;
+    FOREACH(p, pCond->pParameterList) {
+      memset(pTmp, 0, len);
+      code = calcTagBitmap(p, pReader, first ? pBits : pTmp, len);
+      if (code != TSDB_CODE_SUCCESS) {
+        break;
+      }
+
+      if (!first) {
+        for (int32_t i = 0; i < len; ++i) {
+          pBits[i] &= pTmp[i];
+        }
+      }
+      first = false;
+    }
+
+    taosMemoryFree(pTmp);
+    return code;
+  }
+
+  SOperatorNode* pOper = (SOperatorNode*)pNode;
+  SColumnNode*   pCol = (SColumnNode*)pOper->pLeft;
+  STagVal        val = {0};
+
+  if (pOper->opType == OP_TYPE_EQUAL) {
+    valueNodeToTagVal((SValueNode*)pOper->pRight, pCol->colId, &val);
+    return metaTagBitmapOrEqual(pReader, &val, pBits);
+  }
+
+  SNode* p = NULL;
+  FOREACH(p, ((SNodeListNode*)pOper->pRight)->pNodeList) {
+    valueNodeToTagVal((SValueNode*)p, pCol->colId, &val);
+    code = metaTagBitmapOrEqual(pReader, &val, pBits);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  return code;
+}
+
+// try to answer the tag condition by the bitmap index of low-cardinality tag columns in meta, instead of evaluating
+// the condition against the tags of every child table
+static int32_t doFilterByTagBitmap(void* metaHandle, uint64_t suid, SNode* pTagCond, SArray* pUidList,
+                                   bool* pFiltered) {
+  int32_t               code = TSDB_CODE_SUCCESS;
+  SMetaTagBitmapReader* pReader = NULL;
+  uint8_t*              pBits = NULL;
+
+  *pFiltered = false;
+  if (!tsTagFilterBitmap) {
+    return code;
+  }
+
+  SArray* pCids = taosArrayInit(4, sizeof(int16_t));
+  if (pCids == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  if (!collectTagBitmapCols(pTagCond, pCids)) {
+    goto _end;
+  }
+
+  code = metaTagBitmapAcquire(metaHandle, suid, pCids, &pReader);
+  if (code != TSDB_CODE_SUCCESS || pReader == NULL) {
+    goto _end;
+  }
+
+  int32_t len = metaTagBitmapBytes(pReader);
+  pBits = taosMemoryCalloc(1, len + 1);
+  if (pBits == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _end;
+  }
+
+  code = calcTagBitmap(pTagCond, pReader, pBits, len);
+  if (code == TSDB_CODE_SUCCESS) {
+    code = metaTagBitmapToUidList(pReader, pBits, pUidList);
+  }
+
+  if (code == TSDB_CODE_SUCCESS) {
+    *pFiltered = true;
+    qDebug("retrieve table uid list from tag bitmap, suid:%" PRIu64 ", numOfTables:%d", suid,
+           (int32_t)taosArrayGetSize(pUidList));
+  } else {
+    taosArrayClear(pUidList);
+  }
+
+_end:
+  metaTagBitmapRelease(pReader);
+  taosMemoryFree(pBits);
+  taosArrayDestroy(pCids);
+  return code;
+}
+
 int32_t getTableList(void* metaHandle, void* pVnode, SScanPhysiNode* pScanNode, SNode* pTagCond, SNode* pTagIndexCond,
                      STableListInfo* pListInfo, const char* idstr) {
   int32_t code = TSDB_CODE_SUCCESS;
@@ -1050,11 +1266,18 @@ int32_t getTableList(void* metaHandle, void* pVnode, SScanPhysiNode* pScanNode,
       }
     }
 
+    bool filtered = false;
     if (!pTagCond) {  // no tag filter condition exists, let's fetch all tables of this super table
       vnodeGetCtbIdList(pVnode, pScanNode->suid, pUidList);
     } else {
+      code = doFilterByTagBitmap(metaHandle, pScanNode->suid, pTagCond, pUidList, &filtered);
+      if (code != TSDB_CODE_SUCCESS) {
+        qWarn("failed to get tableIds from tag bitmap, suid:%" PRIu64 ", %s", pScanNode->suid, tstrerror(code));
+        code = TSDB_CODE_SUCCESS;
+      }
+
       // failed to find the result in the cache, let try to calculate the results
-      if (pTagIndexCond) {
+      if (!filtered && pTagIndexCond) {
         void*         pIndex = tsdbGetIvtIdx(metaHandle);
         SIndexMetaArg metaArg = {
             .metaEx = metaHandle, .idx = tsdbGetIdx(metaHandle), .ivtIdx = pIndex, .suid = pScanNode->uid};
@@ -1070,9 +1293,11 @@ int32_t getTableList(void* metaHandle, void* pVnode, SScanPhysiNode* pScanNode,
       }
     }
 
-    code = doFilterByTagCond(pListInfo, pUidList, pTagCond, metaHandle, status);
-    if (code != TSDB_CODE_SUCCESS) {
-      goto _end;
+    if (!filtered) {
+      code = doFilterByTagCond(pListInfo, pUidList, pTagCond, metaHandle, status);
+      if (code != TSDB_CODE_SUCCESS) {
+        goto _end;
+      }
     }
 
     // let's add the filter results into meta-cache
@@ -1657,6 +1882,167 @@ void cleanupQueryTableDataCond(SQueryTableDataCond* pCond) {
   taosMemoryFreeClear(pCond->pSlotList);
 }
 
+static bool toBloomIntegerKey(int8_t type, const SValueNode* pVal, char* key, uint32_t* len) {
+  int8_t valType = pVal->node.resType.type;
+  if (!IS_INTEGER_TYPE(valType) && !IS_TIMESTAMP_TYPE(valType)) {
+    return false;
+  }
+
+  // the constant may be typed wider than the column, the key is only usable if it is representable in the column
+  if (IS_UNSIGNED_NUMERIC_TYPE(valType) && pVal->datum.u > INT64_MAX) {
+    if (type != TSDB_DATA_TYPE_UBIGINT) return false;
+    memcpy(key, &pVal->datum.u, sizeof(uint64_t));
+    *len = sizeof(uint64_t);
+    return true;
+  }
+
+  int64_t v = IS_UNSIGNED_NUMERIC_TYPE(valType) ? (int64_t)pVal->datum.u : pVal->datum.i;
+  if (IS_UNSIGNED_NUMERIC_TYPE(type) && v < 0) {
+    return false;
+  }
+
+#define SET_BLOOM_KEY(_t)        \
+  do {                           \
+    _t x = (_t)v;                \
+    if (x != v) return false;    \
+    memcpy(key, &x, sizeof(_t)); \
+    *len = sizeof(_t);           \
+  } while (0)
+
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      SET_BLOOM_KEY(int8_t);
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      SET_BLOOM_KEY(int16_t);
+      break;
+    case TSDB_DATA_TYPE_INT:
+      SET_BLOOM_KEY(int32_t);
+      break;
+    case TSDB_DATA_TYPE_UTINYINT:
+      SET_BLOOM_KEY(uint8_t);
+      break;
+    case TSDB_DATA_TYPE_USMALLINT:
+      SET_BLOOM_KEY(uint16_t);
+      break;
+    case TSDB_DATA_TYPE_UINT:
+      SET_BLOOM_KEY(uint32_t);
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      memcpy(key, &v, sizeof(int64_t));
+      *len = sizeof(int64_t);
+      break;
+    default:
+      return false;
+  }
+
+#undef SET_BLOOM_KEY
+  return true;
+}
+
+static int32_t addBlockBloomCond(SArray* pConds, const SColumnNode* pCol, const SValueNode* pVal) {
+  if (pCol->colType != COLUMN_TYPE_COLUMN || pCol->colId == PRIMARYKEY_TIMESTAMP_COL_ID || pVal->isNull) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int8_t          type = pCol->node.resType.type;
+  SBlockBloomCond cond = {.colId = pCol->colId};
+  if (type == TSDB_DATA_TYPE_VARCHAR) {
+    if (pVal->node.resType.type != TSDB_DATA_TYPE_VARCHAR) {
+      return TSDB_CODE_SUCCESS;
+    }
+
+    cond.len = varDataLen(pVal->datum.p);
+    cond.pKey = taosMemoryMalloc(cond.len + 1);
+    if (cond.pKey == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    memcpy(cond.pKey, varDataVal(pVal->datum.p), cond.len);
+  } else if (IS_INTEGER_TYPE(type) || IS_TIMESTAMP_TYPE(type)) {
+    char key[sizeof(int64_t)];
+    if (!toBloomIntegerKey(type, pVal, key, &cond.len)) {
+      return TSDB_CODE_SUCCESS;
+    }
+
+    cond.pKey = taosMemoryMalloc(cond.len);
+    if (cond.pKey == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    memcpy(cond.pKey, key, cond.len);
+  } else {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (taosArrayPush(pConds, &cond) == NULL) {
+    taosMemoryFree(cond.pKey);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t doExtractBlockBloomConds(SArray* pConds, SNode* pNode) {
+  int32_t code = TSDB_CODE_SUCCESS;
+
+  if (nodeType(pNode) == QUERY_NODE_LOGIC_CONDITION) {
+    SLogicConditionNode* pLogicCond = (SLogicConditionNode*)pNode;
+    if (pLogicCond->condType != LOGIC_COND_TYPE_AND) {
+      return code;
+    }
+
+    SNode* pParam = NULL;
+    FOREACH(pParam, pLogicCond->pParameterList) {
+      code = doExtractBlockBloomConds(pConds, pParam);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    }
+  } else if (nodeType(pNode) == QUERY_NODE_OPERATOR) {
+    SOperatorNode* pOper = (SOperatorNode*)pNode;
+    if (pOper->opType != OP_TYPE_EQUAL || pOper->pLeft == NULL || pOper->pRight == NULL) {
+      return code;
+    }
+
+    if (nodeType(pOper->pLeft) == QUERY_NODE_COLUMN && nodeType(pOper->pRight) == QUERY_NODE_VALUE) {
+      code = addBlockBloomCond(pConds, (SColumnNode*)pOper->pLeft, (SValueNode*)pOper->pRight);
+    } else if (nodeType(pOper->pLeft) == QUERY_NODE_VALUE && nodeType(pOper->pRight) == QUERY_NODE_COLUMN) {
+      code = addBlockBloomCond(pConds, (SColumnNode*)pOper->pRight, (SValueNode*)pOper->pLeft);
+    }
+  }
+
+  return code;
+}
+
+SArray* extractBlockBloomConds(SNode* pConditions) {
+  if (pConditions == NULL) {
+    return NULL;
+  }
+
+  SArray* pConds = taosArrayInit(4, sizeof(SBlockBloomCond));
+  if (pConds == NULL) {
+    return NULL;
+  }
+
+  // failing to extract them only costs the pruning, the scan filter still evaluates every condition
+  int32_t code = doExtractBlockBloomConds(pConds, pConditions);
+  if (code != TSDB_CODE_SUCCESS || taosArrayGetSize(pConds) == 0) {
+    destroyBlockBloomConds(pConds);
+    return NULL;
+  }
+
+  return pConds;
+}
+
+void destroyBlockBloomConds(SArray* pConds) {
+  for (int32_t i = 0; i < taosArrayGetSize(pConds); ++i) {
+    SBlockBloomCond* pCond = taosArrayGet(pConds, i);
+    taosMemoryFree(pCond->pKey);
+  }
+  taosArrayDestroy(pConds);
+}
+
 int32_t convertFillType(int32_t mode) {
   int32_t type = TSDB_FILL_NONE;
   switch (mode) {
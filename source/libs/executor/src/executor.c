@@ -789,6 +789,11 @@ void qDestroyTask(qTaskInfo_t qTaskHandle) {
   doDestroyTask(pTaskInfo);
 }
 
+void qEnableTaskExecCost(qTaskInfo_t tinfo) {
+  SExecTaskInfo* pTaskInfo = (SExecTaskInfo*)tinfo;
+  enableOperatorExecCost(pTaskInfo->pRoot);
+}
+
 int32_t qGetExplainExecInfo(qTaskInfo_t tinfo, SArray* pExecInfoList) {
   SExecTaskInfo* pTaskInfo = (SExecTaskInfo*)tinfo;
   return getOperatorExplainExecInfo(pTaskInfo->pRoot, pExecInfoList);
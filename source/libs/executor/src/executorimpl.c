@@ -125,11 +125,37 @@ int32_t optrDummyOpenFn(SOperatorInfo* pOperator) {
   return TSDB_CODE_SUCCESS;
 }
 
+// collect the runtime statistics of each operator for explain analyze, installed by enableOperatorExecCost only
+static SSDataBlock* optrGetNextFnWithCost(SOperatorInfo* pOperator) {
+  int64_t      st = taosGetTimestampUs();
+  SSDataBlock* pBlock = pOperator->fpSet._nextFn(pOperator);
+
+  SOperatorCostInfo* pCost = &pOperator->cost;
+  pCost->execCost += (taosGetTimestampUs() - st) / 1000.0;
+
+  if (pBlock != NULL) {
+    pCost->outputRows += pBlock->info.rows;
+    pCost->outputBlocks += 1;
+
+    uint64_t mem = blockDataGetSize(pBlock);
+    if (pOperator->fpSet.reqBufFn != NULL) {
+      mem += pOperator->fpSet.reqBufFn(pOperator);
+    }
+
+    if (mem > pCost->maxOutputBytes) {
+      pCost->maxOutputBytes = mem;
+    }
+  }
+
+  return pBlock;
+}
+
 SOperatorFpSet createOperatorFpSet(__optr_open_fn_t openFn, __optr_fn_t nextFn, __optr_fn_t cleanup,
                                    __optr_close_fn_t closeFn, __optr_reqBuf_fn_t reqBufFn,
                                    __optr_explain_fn_t explain) {
   SOperatorFpSet fpSet = {
       ._openFn = openFn,
+      ._nextFn = nextFn,
       .getNextFn = nextFn,
       .cleanupFn = cleanup,
       .closeFn = closeFn,
@@ -140,6 +166,16 @@ SOperatorFpSet createOperatorFpSet(__optr_open_fn_t openFn, __optr_fn_t nextFn,
   return fpSet;
 }
 
+void enableOperatorExecCost(SOperatorInfo* pOperator) {
+  if (pOperator->fpSet._nextFn != NULL) {
+    pOperator->fpSet.getNextFn = optrGetNextFnWithCost;
+  }
+
+  for (int32_t i = 0; i < pOperator->numOfDownstream; ++i) {
+    enableOperatorExecCost(pOperator->pDownstream[i]);
+  }
+}
+
 SResultRow* getNewResultRow(SDiskbasedBuf* pResultBuf, int32_t* currentPageId, int32_t interBufSize) {
   SFilePage* pData = NULL;
 
@@ -863,6 +899,14 @@ void doFilter(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* pCol
 
   // todo the keep seems never to be True??
   bool keep = filterExecute(pFilterInfo, pBlock, &p, NULL, param1.numOfCols, &status);
+  doFilterByResult(pBlock, p, keep, status, pColMatchInfo);
+
+  colDataDestroy(p);
+  taosMemoryFree(p);
+}
+
+void doFilterByResult(SSDataBlock* pBlock, const SColumnInfoData* p, bool keep, int32_t status,
+                      SColMatchInfo* pColMatchInfo) {
   extractQualifiedTupleByFilterResult(pBlock, p, keep, status);
 
   if (pColMatchInfo != NULL) {
@@ -878,9 +922,6 @@ void doFilter(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* pCol
       }
     }
   }
-
-  colDataDestroy(p);
-  taosMemoryFree(p);
 }
 
 void extractQualifiedTupleByFilterResult(SSDataBlock* pBlock, const SColumnInfoData* p, bool keep, int32_t status) {
@@ -2545,6 +2586,21 @@ int32_t getOperatorExplainExecInfo(SOperatorInfo* operatorInfo, SArray* pExecInf
   pExplainInfo->totalCost = operatorInfo->cost.totalCost;
   pExplainInfo->verboseLen = 0;
   pExplainInfo->verboseInfo = NULL;
+  pExplainInfo->numOfBlocks = operatorInfo->cost.outputBlocks;
+  pExplainInfo->maxOutputBytes = operatorInfo->cost.maxOutputBytes;
+
+  double childCost = 0;
+  for (int32_t i = 0; i < operatorInfo->numOfDownstream; ++i) {
+    SOperatorCostInfo* pDownstreamCost = &operatorInfo->pDownstream[i]->cost;
+    pExplainInfo->inputRows += pDownstreamCost->outputRows;
+    pExplainInfo->inputBlocks += pDownstreamCost->outputBlocks;
+    childCost += pDownstreamCost->execCost;
+  }
+
+  pExplainInfo->selfCost = operatorInfo->cost.execCost - childCost;
+  if (pExplainInfo->selfCost < 0) {
+    pExplainInfo->selfCost = 0;
+  }
 
   if (operatorInfo->fpSet.getExplainFn) {
     int32_t code =
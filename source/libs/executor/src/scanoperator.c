@@ -25,6 +25,7 @@
 
 #include "tdatablock.h"
 #include "tmsg.h"
+#include "tglobal.h"
 
 #include "query.h"
 #include "tcompare.h"
@@ -286,8 +287,97 @@ bool applyLimitOffset(SLimitInfo* pLimitInfo, SSDataBlock* pBlock, SExecTaskInfo
   return false;
 }
 
-static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableScanInfo, SSDataBlock* pBlock,
-                             uint32_t* status) {
+static EDealRes collectFilterColIdWalker(SNode* pNode, void* pContext) {
+  if (nodeType(pNode) == QUERY_NODE_COLUMN) {
+    SColumnNode* pCol = (SColumnNode*)pNode;
+    if (pCol->colType == COLUMN_TYPE_COLUMN && pCol->colId != PRIMARYKEY_TIMESTAMP_COL_ID) {
+      if (taosArrayPush((SArray*)pContext, &pCol->colId) == NULL) {
+        return DEAL_RES_ERROR;
+      }
+    }
+  }
+
+  return DEAL_RES_CONTINUE;
+}
+
+static int32_t compareColId(const void* p1, const void* p2) {
+  int16_t left = *(const int16_t*)p1;
+  int16_t right = *(const int16_t*)p2;
+  return (left == right) ? 0 : ((left < right) ? -1 : 1);
+}
+
+// the filter columns are worth decoding ahead only if some other columns are left to skip when no row survives
+static void initFilterColIds(STableScanBase* pBase, SNode* pConditions) {
+  if (pConditions == NULL) {
+    return;
+  }
+
+  SArray* pList = taosArrayInit(4, sizeof(int16_t));
+  if (pList == NULL) {
+    return;
+  }
+
+  nodesWalkExpr(pConditions, collectFilterColIdWalker, pList);
+  taosArraySort(pList, compareColId);
+  taosArrayRemoveDuplicate(pList, compareColId, NULL);
+
+  int32_t numOfDataCols = 0;
+  for (int32_t i = 0; i < pBase->cond.numOfCols; ++i) {
+    if (pBase->cond.colList[i].colId != PRIMARYKEY_TIMESTAMP_COL_ID) {
+      numOfDataCols += 1;
+    }
+  }
+
+  int32_t num = taosArrayGetSize(pList);
+  if (num < numOfDataCols) {
+    pBase->pFilterColIds = taosMemoryMalloc(sizeof(int16_t) * (num > 0 ? num : 1));
+    if (pBase->pFilterColIds != NULL) {
+      if (num > 0) {
+        memcpy(pBase->pFilterColIds, taosArrayGet(pList, 0), sizeof(int16_t) * num);
+      }
+      pBase->numOfFilterCols = num;
+    }
+  }
+
+  taosArrayDestroy(pList);
+}
+
+// Decode the filter columns of the block only and evaluate the filter on them. The filter result is kept to be applied
+// on the whole block after the other columns are decoded, or the block is dropped if no row survives. The tag columns
+// the filter may refer to are filled here, and *tagFilled tells the caller not to fill them again.
+static int32_t doFilterByFilterCols(SOperatorInfo* pOperator, STableScanBase* pTableScanInfo, SSDataBlock* pBlock,
+                                    SColumnInfoData** pRes, bool* keep, int32_t* filterStatus, bool* tagFilled) {
+  SExecTaskInfo* pTaskInfo = pOperator->pTaskInfo;
+  SFilterInfo*   pFilterInfo = pOperator->exprSupp.pFilterInfo;
+
+  SSDataBlock* p = tsdbRetrieveDataBlockPartial(pTableScanInfo->dataReader, pTableScanInfo->pFilterColIds,
+                                                pTableScanInfo->numOfFilterCols);
+  if (p == NULL) {
+    return terrno;
+  }
+
+  ASSERT(p == pBlock);
+  if (pBlock->info.rows == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  doSetTagColumnData(pTableScanInfo, pBlock, pTaskInfo, pBlock->info.rows);
+  *tagFilled = true;
+
+  int64_t st = taosGetTimestampUs();
+
+  SFilterColumnParam param = {.numOfCols = taosArrayGetSize(pBlock->pDataBlock), .pDataBlock = pBlock->pDataBlock};
+  int32_t            code = filterSetDataFromSlotId(pFilterInfo, &param);
+  if (code == TSDB_CODE_SUCCESS) {
+    *keep = filterExecute(pFilterInfo, pBlock, pRes, NULL, param.numOfCols, filterStatus);
+  }
+
+  pTableScanInfo->readRecorder.filterTime += (taosGetTimestampUs() - st) / 1000.0;
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableScanInfo, SSDataBlock* pBlock,
+                      uint32_t* status) {
   SExecTaskInfo*          pTaskInfo = pOperator->pTaskInfo;
   SFileBlockLoadRecorder* pCost = &pTableScanInfo->readRecorder;
 
@@ -336,6 +426,22 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
 
   ASSERT(*status == FUNC_DATA_REQUIRED_DATA_LOAD);
 
+  // try to filter data block according to the bloom filters of the equality conditions
+  if (pTableScanInfo->pBloomConds != NULL) {
+    bool    filterOut = false;
+    int32_t code = tsdbBloomFilterOutBlock(pTableScanInfo->dataReader, pTableScanInfo->pBloomConds, &filterOut);
+    if (code == TSDB_CODE_SUCCESS && filterOut) {
+      qDebug("%s data block filter out by block bloom filter, brange:%" PRId64 "-%" PRId64 ", rows:%d",
+             GET_TASKID(pTaskInfo), pBlockInfo->window.skey, pBlockInfo->window.ekey, pBlockInfo->rows);
+      pCost->filterOutBlocks += 1;
+      pCost->bloomFilterBlocks += 1;
+      (*status) = FUNC_DATA_REQUIRED_FILTEROUT;
+
+      tsdbReleaseDataBlock(pTableScanInfo->dataReader);
+      return TSDB_CODE_SUCCESS;
+    }
+  }
+
   // try to filter data block according to sma info
   if (pOperator->exprSupp.pFilterInfo != NULL && (!loadSMA)) {
     bool success = doLoadBlockSMA(pTableScanInfo, pBlock, pTaskInfo);
@@ -346,6 +452,7 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
         qDebug("%s data block filter out by block SMA, brange:%" PRId64 "-%" PRId64 ", rows:%d", GET_TASKID(pTaskInfo),
                pBlockInfo->window.skey, pBlockInfo->window.ekey, pBlockInfo->rows);
         pCost->filterOutBlocks += 1;
+        pCost->smaFilterBlocks += 1;
         (*status) = FUNC_DATA_REQUIRED_FILTEROUT;
 
         tsdbReleaseDataBlock(pTableScanInfo->dataReader);
@@ -371,20 +478,58 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
   pCost->totalCheckedRows += pBlock->info.rows;
   pCost->loadBlocks += 1;
 
+  // decode the filter columns first, and the others only if any row survives the filter
+  SColumnInfoData* pFilterRes = NULL;
+  bool             filterKeep = false;
+  int32_t          filterStatus = FILTER_RESULT_ALL_QUALIFIED;
+  bool             tagFilled = false;
+  if (pOperator->exprSupp.pFilterInfo != NULL && pTableScanInfo->pFilterColIds != NULL) {
+    int32_t code = doFilterByFilterCols(pOperator, pTableScanInfo, pBlock, &pFilterRes, &filterKeep, &filterStatus,
+                                        &tagFilled);
+    if (code != TSDB_CODE_SUCCESS) {
+      tsdbReleaseDataBlock(pTableScanInfo->dataReader);
+      return code;
+    }
+
+    if (pFilterRes != NULL && filterStatus == FILTER_RESULT_NONE_QUALIFIED) {
+      qDebug("%s data block filter out by filter columns, brange:%" PRId64 "-%" PRId64 ", rows:%d",
+             GET_TASKID(pTaskInfo), pBlockInfo->window.skey, pBlockInfo->window.ekey, pBlockInfo->rows);
+      pCost->filterOutBlocks += 1;
+      (*status) = FUNC_DATA_REQUIRED_FILTEROUT;
+
+      colDataDestroy(pFilterRes);
+      taosMemoryFree(pFilterRes);
+      tsdbReleaseDataBlock(pTableScanInfo->dataReader);
+      return TSDB_CODE_SUCCESS;
+    }
+  }
+
   SSDataBlock* p = tsdbRetrieveDataBlock(pTableScanInfo->dataReader, NULL);
   if (p == NULL) {
+    if (pFilterRes != NULL) {
+      colDataDestroy(pFilterRes);
+      taosMemoryFree(pFilterRes);
+    }
     return terrno;
   }
 
   ASSERT(p == pBlock);
-  doSetTagColumnData(pTableScanInfo, pBlock, pTaskInfo, pBlock->info.rows);
+  if (!tagFilled) {
+    doSetTagColumnData(pTableScanInfo, pBlock, pTaskInfo, pBlock->info.rows);
+  }
 
   // restore the previous value
   pCost->totalRows -= pBlock->info.rows;
 
   if (pOperator->exprSupp.pFilterInfo != NULL) {
     int64_t st = taosGetTimestampUs();
-    doFilter(pBlock, pOperator->exprSupp.pFilterInfo, &pTableScanInfo->matchInfo);
+    if (pFilterRes != NULL) {
+      doFilterByResult(pBlock, pFilterRes, filterKeep, filterStatus, &pTableScanInfo->matchInfo);
+      colDataDestroy(pFilterRes);
+      taosMemoryFree(pFilterRes);
+    } else {
+      doFilter(pBlock, pOperator->exprSupp.pFilterInfo, &pTableScanInfo->matchInfo);
+    }
 
     double el = (taosGetTimestampUs() - st) / 1000.0;
     pTableScanInfo->readRecorder.filterTime += el;
@@ -825,10 +970,24 @@ static SSDataBlock* doTableScan(SOperatorInfo* pOperator) {
   }
 }
 
+// the file block bytes and cache hits are kept by the tsdb reader, merge them into the recorder
+static void collectReaderIOCost(STableScanBase* pBase, SFileBlockLoadRecorder* pRecorder) {
+  if (pBase->dataReader == NULL) {
+    return;
+  }
+
+  int64_t loadBytes = 0;
+  int64_t cacheHits = 0;
+  tsdbReaderGetIOCost(pBase->dataReader, &loadBytes, &cacheHits);
+  pRecorder->loadBytes += loadBytes;
+  pRecorder->cacheHits += cacheHits;
+}
+
 static int32_t getTableScannerExecInfo(struct SOperatorInfo* pOptr, void** pOptrExplain, uint32_t* len) {
   SFileBlockLoadRecorder* pRecorder = taosMemoryCalloc(1, sizeof(SFileBlockLoadRecorder));
   STableScanInfo*         pTableScanInfo = pOptr->info;
   *pRecorder = pTableScanInfo->base.readRecorder;
+  collectReaderIOCost(&pTableScanInfo->base, pRecorder);
   *pOptrExplain = pRecorder;
   *len = sizeof(SFileBlockLoadRecorder);
   return 0;
@@ -846,6 +1005,8 @@ static void destroyTableScanOperatorInfo(void* param) {
     taosArrayDestroy(pTableScanInfo->base.matchInfo.pList);
   }
 
+  destroyBlockBloomConds(pTableScanInfo->base.pBloomConds);
+  taosMemoryFreeClear(pTableScanInfo->base.pFilterColIds);
   taosLRUCacheCleanup(pTableScanInfo->base.metaCache.pTableMetaEntryCache);
   cleanupExprSupp(&pTableScanInfo->base.pseudoSup);
   taosMemoryFreeClear(param);
@@ -900,6 +1061,10 @@ SOperatorInfo* createTableScanOperatorInfo(STableScanPhysiNode* pTableScanNode,
     goto _error;
   }
 
+  if (tsBlockBloomFilter) {
+    pInfo->base.pBloomConds = extractBlockBloomConds(pTableScanNode->scan.node.pConditions);
+  }
+  initFilterColIds(&pInfo->base, pTableScanNode->scan.node.pConditions);
   pInfo->currentGroupId = -1;
   pInfo->assignBlockUid = pTableScanNode->assignBlockUid;
   pInfo->hasGroupByTag = pTableScanNode->pGroupTags ? true : false;
@@ -2637,6 +2802,7 @@ static SSDataBlock* getTableDataBlockImpl(void* param) {
     pInfo->base.readRecorder.elapsedTime += (taosGetTimestampUs() - st) / 1000.0;
 
     qTrace("tsdb/read-table-data: %p, close reader", reader);
+    collectReaderIOCost(&pInfo->base, &pInfo->base.readRecorder);
     tsdbReaderClose(pInfo->base.dataReader);
     pInfo->base.dataReader = NULL;
     return pBlock;
@@ -2644,6 +2810,7 @@ static SSDataBlock* getTableDataBlockImpl(void* param) {
 
   qDebug("8");
 
+  collectReaderIOCost(&pInfo->base, &pInfo->base.readRecorder);
   tsdbReaderClose(pInfo->base.dataReader);
   pInfo->base.dataReader = NULL;
   return NULL;
@@ -2895,6 +3062,8 @@ void destroyTableMergeScanOperatorInfo(void* param) {
 
   taosArrayDestroy(pTableScanInfo->pSortInfo);
   cleanupExprSupp(&pTableScanInfo->base.pseudoSup);
+  destroyBlockBloomConds(pTableScanInfo->base.pBloomConds);
+  taosMemoryFreeClear(pTableScanInfo->base.pFilterColIds);
 
   tsdbReaderClose(pTableScanInfo->base.dataReader);
   pTableScanInfo->base.dataReader = NULL;
@@ -2969,6 +3138,10 @@ SOperatorInfo* createTableMergeScanOperatorInfo(STableScanPhysiNode* pTableScanN
     goto _error;
   }
 
+  if (tsBlockBloomFilter) {
+    pInfo->base.pBloomConds = extractBlockBloomConds(pTableScanNode->scan.node.pConditions);
+  }
+  initFilterColIds(&pInfo->base, pTableScanNode->scan.node.pConditions);
   initResultSizeInfo(&pOperator->resultInfo, 1024);
   pInfo->pResBlock = createDataBlockFromDescNode(pDescNode);
   blockDataEnsureCapacity(pInfo->pResBlock, pOperator->resultInfo.capacity);
@@ -35,7 +35,15 @@ static int32_t      getExplainExecInfo(SOperatorInfo* pOptr, void** pOptrExplain
 
 static void destroySortOperatorInfo(void* param);
 
-// todo add limit/offset impl
+// the number of rows required by limit/offset, 0 if all rows are required
+static int64_t getSortMaxRows(const SLimitInfo* pLimitInfo) {
+  if (pLimitInfo->limit.limit <= 0) {
+    return 0;
+  }
+
+  return pLimitInfo->limit.limit + (pLimitInfo->limit.offset > 0 ? pLimitInfo->limit.offset : 0);
+}
+
 SOperatorInfo* createSortOperatorInfo(SOperatorInfo* downstream, SSortPhysiNode* pSortNode, SExecTaskInfo* pTaskInfo) {
   SSortOperatorInfo* pInfo = taosMemoryCalloc(1, sizeof(SSortOperatorInfo));
   SOperatorInfo*     pOperator = taosMemoryCalloc(1, sizeof(SOperatorInfo));
@@ -192,6 +200,11 @@ int32_t doOpenSortOperator(SOperatorInfo* pOperator) {
 
   tsortSetFetchRawDataFp(pInfo->pSortHandle, loadNextDataBlock, applyScalarFunction, pOperator);
 
+  // the filter is applied on the sorted rows, so the limit can not be pushed down into the sort when it exists
+  if (pOperator->exprSupp.pFilterInfo == NULL) {
+    tsortSetMaxRows(pInfo->pSortHandle, getSortMaxRows(&pInfo->limitInfo));
+  }
+
   SSortSource* ps = taosMemoryCalloc(1, sizeof(SSortSource));
   ps->param = pOperator->pDownstream[0];
   ps->onlyRef = true;
@@ -566,6 +579,11 @@ int32_t openMultiwayMergeOperator(SOperatorInfo* pOperator) {
   tsortSetFetchRawDataFp(pInfo->pSortHandle, loadNextDataBlock, NULL, NULL);
   tsortSetCompareGroupId(pInfo->pSortHandle, pInfo->groupSort);
 
+  // limit is applied for each group in group sort
+  if (!pInfo->groupSort) {
+    tsortSetMaxRows(pInfo->pSortHandle, getSortMaxRows(&pInfo->limitInfo));
+  }
+
   for (int32_t i = 0; i < pOperator->numOfDownstream; ++i) {
     SOperatorInfo* pDownstream = pOperator->pDownstream[i];
     if (pDownstream->operatorType == QUERY_NODE_PHYSICAL_PLAN_EXCHANGE) {
@@ -450,8 +450,8 @@ bool inSlidingWindow(SInterval* pInterval, STimeWindow* pWin, SDataBlockInfo* pB
   return inCalSlidingWindow(pInterval, pWin, pBlockInfo->calWin.skey, pBlockInfo->calWin.ekey);
 }
 
-static int32_t getNextQualifiedWindow(SInterval* pInterval, STimeWindow* pNext, SDataBlockInfo* pDataBlockInfo,
-                                      TSKEY* primaryKeys, int32_t prevPosition, int32_t order) {
+int32_t getNextQualifiedWindow(SInterval* pInterval, STimeWindow* pNext, SDataBlockInfo* pDataBlockInfo,
+                               TSKEY* primaryKeys, int32_t prevPosition, int32_t order) {
   bool ascQuery = (order == TSDB_ORDER_ASC);
 
   int32_t precision = pInterval->precision;
@@ -914,16 +914,106 @@ bool needDeleteWindowBuf(STimeWindow* pWin, STimeWindowAggSupp* pTwSup) {
   return pTwSup->maxTs != INT64_MIN && pWin->ekey < pTwSup->maxTs - pTwSup->deleteMark;
 }
 
+// Fixed-length windows over an ascending, interpolation free input are assigned in one pass over the timestamp
+// column: two forward cursors yield the row range of every window of the block, instead of a binary search and a
+// window step per window.
+static bool isIntervalBatchAssignable(const SIntervalAggOperatorInfo* pInfo, const TSKEY* tsCols) {
+  return tsCols != NULL && pInfo->inputOrder == TSDB_ORDER_ASC && !pInfo->timeWindowInterpo &&
+         pInfo->interval.intervalUnit != 'n' && pInfo->interval.intervalUnit != 'y';
+}
+
+void assignIntervalWindowRanges(SInterval* pInterval, SDataBlockInfo* pBlockInfo, const TSKEY* tsCols,
+                                STimeWindow win, SArray* pRanges) {
+  int32_t rows = pBlockInfo->rows;
+  int32_t startPos = 0;
+  int32_t endPos = 0;
+
+  taosArrayClear(pRanges);
+
+  while (1) {
+    while (endPos < rows && tsCols[endPos] <= win.ekey) {
+      endPos++;
+    }
+
+    SWinRowRange range = {.win = win, .startPos = startPos, .numOfRows = endPos - startPos};
+    taosArrayPush(pRanges, &range);
+
+    win.skey += pInterval->sliding;
+    win.ekey = win.skey + pInterval->interval - 1;
+    if (win.skey > pBlockInfo->window.ekey || !inSlidingWindow(pInterval, &win, pBlockInfo)) {
+      break;
+    }
+
+    while (startPos < rows && tsCols[startPos] < win.skey) {
+      startPos++;
+    }
+    if (startPos >= rows) {
+      break;
+    }
+
+    // no data falls into this window, jump to the first window that covers the next row
+    if (tsCols[startPos] > win.ekey) {
+      win.ekey += ((tsCols[startPos] - win.ekey + pInterval->sliding - 1) / pInterval->sliding) * pInterval->sliding;
+      win.skey = win.ekey - pInterval->interval + 1;
+    }
+
+    if (endPos < startPos) {
+      endPos = startPos;
+    }
+  }
+}
+
+static void hashIntervalAggBatch(SOperatorInfo* pOperatorInfo, SResultRowInfo* pResultRowInfo, SSDataBlock* pBlock,
+                                 int32_t scanFlag, const TSKEY* tsCols) {
+  SIntervalAggOperatorInfo* pInfo = (SIntervalAggOperatorInfo*)pOperatorInfo->info;
+  SExecTaskInfo*            pTaskInfo = pOperatorInfo->pTaskInfo;
+  SExprSupp*                pSup = &pOperatorInfo->exprSupp;
+  uint64_t                  tableGroupId = pBlock->info.id.groupId;
+
+  if (pInfo->pWinRanges == NULL) {
+    pInfo->pWinRanges = taosArrayInit(64, sizeof(SWinRowRange));
+    if (pInfo->pWinRanges == NULL) {
+      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_OUT_OF_MEMORY);
+    }
+  }
+
+  STimeWindow win =
+      getActiveTimeWindow(pInfo->aggSup.pResultBuf, pResultRowInfo, tsCols[0], &pInfo->interval, pInfo->inputOrder);
+  assignIntervalWindowRanges(&pInfo->interval, &pBlock->info, tsCols, win, pInfo->pWinRanges);
+
+  int32_t numOfRanges = taosArrayGetSize(pInfo->pWinRanges);
+  for (int32_t i = 0; i < numOfRanges; ++i) {
+    SWinRowRange* pRange = taosArrayGet(pInfo->pWinRanges, i);
+    SResultRow*   pResult = NULL;
+
+    int32_t code = setTimeWindowOutputBuf(pResultRowInfo, &pRange->win, (scanFlag == MAIN_SCAN), &pResult,
+                                          tableGroupId, pSup->pCtx, pSup->numOfExprs, pSup->rowEntryInfoOffset,
+                                          &pInfo->aggSup, pTaskInfo);
+    if (code != TSDB_CODE_SUCCESS || pResult == NULL) {
+      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_OUT_OF_MEMORY);
+    }
+
+    updateTimeWindowInfo(&pInfo->twAggSup.timeWindowData, &pRange->win, true);
+    applyAggFunctionOnPartialTuples(pTaskInfo, pSup->pCtx, &pInfo->twAggSup.timeWindowData, pRange->startPos,
+                                    pRange->numOfRows, pBlock->info.rows, pSup->numOfExprs);
+  }
+}
+
 static void hashIntervalAgg(SOperatorInfo* pOperatorInfo, SResultRowInfo* pResultRowInfo, SSDataBlock* pBlock,
                             int32_t scanFlag) {
   SIntervalAggOperatorInfo* pInfo = (SIntervalAggOperatorInfo*)pOperatorInfo->info;
 
+  int64_t* tsCols = extractTsCol(pBlock, pInfo);
+  if (isIntervalBatchAssignable(pInfo, tsCols)) {
+    hashIntervalAggBatch(pOperatorInfo, pResultRowInfo, pBlock, scanFlag, tsCols);
+    return;
+  }
+
   SExecTaskInfo* pTaskInfo = pOperatorInfo->pTaskInfo;
   SExprSupp*     pSup = &pOperatorInfo->exprSupp;
 
   int32_t     startPos = 0;
   int32_t     numOfOutput = pSup->numOfExprs;
-  int64_t*    tsCols = extractTsCol(pBlock, pInfo);
   uint64_t    tableGroupId = pBlock->info.id.groupId;
   bool        ascScan = (pInfo->inputOrder == TSDB_ORDER_ASC);
   TSKEY       ts = getStartTsKey(&pBlock->info.window, tsCols);
@@ -1585,6 +1675,7 @@ void destroyIntervalOperatorInfo(void* param) {
   taosArrayDestroyEx(pInfo->pPrevValues, freeItem);
 
   pInfo->pPrevValues = NULL;
+  pInfo->pWinRanges = taosArrayDestroy(pInfo->pWinRanges);
 
   cleanupGroupResInfo(&pInfo->groupResInfo);
   colDataDestroy(&pInfo->twAggSup.timeWindowData);
@@ -56,6 +56,10 @@ struct SSortHandle {
   _sort_fetch_block_fn_t  fetchfp;
   _sort_merge_compar_fn_t comparFn;
   SMultiwayMergeTreeInfo* pMergeTree;
+
+  int64_t maxRows;          // only the first maxRows tuples are required, 0 for no limit
+  int64_t numOfOutputRows;  // tuples returned by tsortNextTuple
+  bool    topNSorted;       // the first maxRows rows of pDataBlock are sorted, see tsortTopNMerge
 };
 
 static int32_t msortComparFn(const void* pLeft, const void* pRight, void* param);
@@ -332,6 +336,84 @@ static void appendOneRowToDataBlock(SSDataBlock* pBlock, const SSDataBlock* pSou
   *rowIndex += 1;
 }
 
+static int32_t tsortCompareRows(SArray* pOrderInfo, const SSDataBlock* pLeftBlock, int32_t leftIndex,
+                                const SSDataBlock* pRightBlock, int32_t rightIndex) {
+  for (int32_t i = 0; i < pOrderInfo->size; ++i) {
+    SBlockOrderInfo* pOrder = TARRAY_GET_ELEM(pOrderInfo, i);
+    SColumnInfoData* pLeftColInfoData = TARRAY_GET_ELEM(pLeftBlock->pDataBlock, pOrder->slotId);
+    SColumnInfoData* pRightColInfoData = TARRAY_GET_ELEM(pRightBlock->pDataBlock, pOrder->slotId);
+
+    bool leftNull = colDataIsNull_s(pLeftColInfoData, leftIndex);
+    bool rightNull = colDataIsNull_s(pRightColInfoData, rightIndex);
+    if (leftNull && rightNull) {
+      continue;
+    }
+
+    if (rightNull) {
+      return pOrder->nullFirst ? 1 : -1;
+    }
+
+    if (leftNull) {
+      return pOrder->nullFirst ? -1 : 1;
+    }
+
+    void* left1 = colDataGetData(pLeftColInfoData, leftIndex);
+    void* right1 = colDataGetData(pRightColInfoData, rightIndex);
+
+    __compar_fn_t fn = getKeyComparFunc(pLeftColInfoData->info.type, pOrder->order);
+
+    int ret = fn(left1, right1);
+    if (ret != 0) {
+      return ret;
+    }
+  }
+
+  return 0;
+}
+
+/*
+ * Merge the input block into the in-memory buffer for a top-n sort. Once the buffer holds 2 * maxRows rows, it is
+ * sorted and truncated to maxRows rows, and the last of them becomes the bound: only the incoming rows that precede
+ * the bound are appended afterwards, so the buffer never grows beyond 2 * maxRows rows plus one input block.
+ */
+static int32_t tsortTopNMerge(SSortHandle* pHandle, SSDataBlock* pBlock) {
+  SSDataBlock* pDataBlock = pHandle->pDataBlock;
+  int32_t      code = TSDB_CODE_SUCCESS;
+
+  if (!pHandle->topNSorted) {
+    code = blockDataMerge(pDataBlock, pBlock);
+  } else {
+    int32_t bound = pHandle->maxRows - 1;
+
+    code = blockDataEnsureCapacity(pDataBlock, pDataBlock->info.rows + pBlock->info.rows);
+    for (int32_t i = 0; i < pBlock->info.rows && code == TSDB_CODE_SUCCESS; ++i) {
+      if (tsortCompareRows(pHandle->pSortInfo, pBlock, i, pDataBlock, bound) < 0) {
+        int32_t rowIndex = i;
+        appendOneRowToDataBlock(pDataBlock, pBlock, &rowIndex);
+      }
+    }
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  if (pDataBlock->info.rows >= pHandle->maxRows * 2) {
+    int64_t p = taosGetTimestampUs();
+
+    code = blockDataSort(pDataBlock, pHandle->pSortInfo);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    blockDataKeepFirstNRows(pDataBlock, pHandle->maxRows);
+    pHandle->topNSorted = true;
+    pHandle->sortElapsed += taosGetTimestampUs() - p;
+  }
+
+  return code;
+}
+
 static int32_t adjustMergeTreeForNextTuple(SSortSource* pSource, SMultiwayMergeTreeInfo* pTree, SSortHandle* pHandle,
                                            int32_t* numOfCompleted) {
   /*
@@ -562,12 +644,23 @@ static int32_t doInternalMergeSort(SSortHandle* pHandle) {
       }
 
       SArray* pPageIdList = taosArrayInit(4, sizeof(int32_t));
+      int64_t numOfMerged = 0;
       while (1) {
+        // rows beyond the first maxRows of a merged run are never returned
+        if (pHandle->maxRows > 0 && numOfMerged >= pHandle->maxRows) {
+          break;
+        }
+
         SSDataBlock* pDataBlock = getSortedBlockDataInner(pHandle, &pHandle->cmpParam, numOfRows);
         if (pDataBlock == NULL) {
           break;
         }
 
+        if (pHandle->maxRows > 0 && numOfMerged + pDataBlock->info.rows > pHandle->maxRows) {
+          blockDataKeepFirstNRows(pDataBlock, pHandle->maxRows - numOfMerged);
+        }
+        numOfMerged += pDataBlock->info.rows;
+
         int32_t pageId = -1;
         void*   pPage = getNewBufPage(pHandle->pBuf, &pageId);
         if (pPage == NULL) {
@@ -638,6 +731,7 @@ int32_t getProperSortPageSize(size_t rowSize, uint32_t numOfCols) {
 static int32_t createInitialSources(SSortHandle* pHandle) {
   size_t sortBufSize = pHandle->numOfPages * pHandle->pageSize;
   int32_t code = 0;
+  bool    topN = false;
 
   if (pHandle->type == SORT_SINGLESOURCE_SORT) {
     SSortSource** pSource = taosArrayGet(pHandle->pOrderedSource, 0);
@@ -660,13 +754,20 @@ static int32_t createInitialSources(SSortHandle* pHandle) {
         pHandle->numOfPages = 1024;
         sortBufSize = pHandle->numOfPages * pHandle->pageSize;
         pHandle->pDataBlock = createOneDataBlock(pBlock, false);
+
+        // the bounded in-memory top-n sort is used only if twice the required rows fit in the sort buffer
+        topN = pHandle->maxRows > 0 && pHandle->maxRows * 2 * blockDataGetRowSize(pBlock) <= sortBufSize;
       }
 
       if (pHandle->beforeFp != NULL) {
         pHandle->beforeFp(pBlock, pHandle->param);
       }
 
-      code = blockDataMerge(pHandle->pDataBlock, pBlock);
+      if (topN) {
+        code = tsortTopNMerge(pHandle, pBlock);
+      } else {
+        code = blockDataMerge(pHandle->pDataBlock, pBlock);
+      }
       if (code != TSDB_CODE_SUCCESS) {
         if (source->param && !source->onlyRef) {
           taosMemoryFree(source->param);
@@ -700,10 +801,17 @@ static int32_t createInitialSources(SSortHandle* pHandle) {
         int64_t el = taosGetTimestampUs() - p;
         pHandle->sortElapsed += el;
 
+        // each sorted run only needs to keep its first maxRows rows
+        if (pHandle->maxRows > 0) {
+          blockDataKeepFirstNRows(pHandle->pDataBlock, pHandle->maxRows);
+        }
+
         code = doAddToBuf(pHandle->pDataBlock, pHandle);
         if (code != TSDB_CODE_SUCCESS) {
           return code;
         }
+
+        pHandle->topNSorted = false;
       }
     }
 
@@ -714,8 +822,6 @@ static int32_t createInitialSources(SSortHandle* pHandle) {
     taosMemoryFree(source);
 
     if (pHandle->pDataBlock != NULL && pHandle->pDataBlock->info.rows > 0) {
-      size_t size = blockDataGetSize(pHandle->pDataBlock);
-
       // Perform the in-memory sort and then flush data in the buffer into disk.
       int64_t p = taosGetTimestampUs();
 
@@ -724,6 +830,12 @@ static int32_t createInitialSources(SSortHandle* pHandle) {
         return code;
       }
 
+      if (pHandle->maxRows > 0) {
+        blockDataKeepFirstNRows(pHandle->pDataBlock, pHandle->maxRows);
+      }
+
+      size_t size = blockDataGetSize(pHandle->pDataBlock);
+
       int64_t el = taosGetTimestampUs() - p;
       pHandle->sortElapsed += el;
 
@@ -807,11 +919,21 @@ int32_t tsortSetCompareGroupId(SSortHandle* pHandle, bool compareGroupId) {
   return TSDB_CODE_SUCCESS;
 }
 
+int32_t tsortSetMaxRows(SSortHandle* pHandle, int64_t maxRows) {
+  pHandle->maxRows = maxRows;
+  return TSDB_CODE_SUCCESS;
+}
+
 STupleHandle* tsortNextTuple(SSortHandle* pHandle) {
   if (pHandle->cmpParam.numOfSources == pHandle->numOfCompletedSources) {
     return NULL;
   }
 
+  // the required rows are all returned, the remaining sources are not consumed any more
+  if (pHandle->maxRows > 0 && pHandle->numOfOutputRows >= pHandle->maxRows) {
+    return NULL;
+  }
+
   // All the data are hold in the buffer, no external sort is invoked.
   if (pHandle->inMemSort) {
     pHandle->tupleHandle.rowIndex += 1;
@@ -820,6 +942,7 @@ STupleHandle* tsortNextTuple(SSortHandle* pHandle) {
       return NULL;
     }
 
+    pHandle->numOfOutputRows += 1;
     return &pHandle->tupleHandle;
   }
 
@@ -851,6 +974,7 @@ STupleHandle* tsortNextTuple(SSortHandle* pHandle) {
   pHandle->needAdjust = true;
   pSource->src.rowIndex += 1;
 
+  pHandle->numOfOutputRows += 1;
   return &pHandle->tupleHandle;
 }
 
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#include "os.h"
+
+#include "executor.h"
+#include "executorimpl.h"
+#include "tdatablock.h"
+
+namespace {
+
+SInterval makeInterval(int64_t interval, int64_t sliding) {
+  SInterval i = {0};
+  i.interval = interval;
+  i.sliding = sliding;
+  i.intervalUnit = 'a';
+  i.slidingUnit = 'a';
+  i.offsetUnit = 'a';
+  i.precision = TSDB_TIME_PRECISION_MILLI;
+  return i;
+}
+
+SDataBlockInfo makeBlockInfo(const std::vector<TSKEY>& ts) {
+  SDataBlockInfo info = {0};
+  info.rows = ts.size();
+  info.window.skey = ts.front();
+  info.window.ekey = ts.back();
+  info.calWin.skey = INT64_MIN;
+  info.calWin.ekey = INT64_MAX;
+  return info;
+}
+
+// the windows and row ranges hashIntervalAgg visits one window at a time
+std::vector<SWinRowRange> perWindowRanges(SInterval* pInterval, SDataBlockInfo* pInfo, std::vector<TSKEY>& ts) {
+  std::vector<SWinRowRange> ranges;
+  SResultRowInfo            rowInfo = {0};
+  rowInfo.cur.pageId = -1;
+
+  STimeWindow win = getActiveTimeWindow(NULL, &rowInfo, ts[0], pInterval, TSDB_ORDER_ASC);
+  int32_t     startPos = 0;
+  int32_t     forwardRows =
+      getNumOfRowsInTimeWindow(pInfo, ts.data(), startPos, win.ekey, binarySearchForKey, NULL, TSDB_ORDER_ASC);
+  ranges.push_back({win, startPos, forwardRows});
+
+  while (1) {
+    int32_t prevEndPos = forwardRows - 1 + startPos;
+    startPos = getNextQualifiedWindow(pInterval, &win, pInfo, ts.data(), prevEndPos, TSDB_ORDER_ASC);
+    if (startPos < 0) break;
+
+    forwardRows =
+        getNumOfRowsInTimeWindow(pInfo, ts.data(), startPos, win.ekey, binarySearchForKey, NULL, TSDB_ORDER_ASC);
+    ranges.push_back({win, startPos, forwardRows});
+  }
+  return ranges;
+}
+
+// the windows and row ranges hashIntervalAggBatch assigns in one pass
+std::vector<SWinRowRange> batchRanges(SInterval* pInterval, SDataBlockInfo* pInfo, std::vector<TSKEY>& ts) {
+  SResultRowInfo rowInfo = {0};
+  rowInfo.cur.pageId = -1;
+
+  SArray*     pRanges = taosArrayInit(4, sizeof(SWinRowRange));
+  STimeWindow win = getActiveTimeWindow(NULL, &rowInfo, ts[0], pInterval, TSDB_ORDER_ASC);
+  assignIntervalWindowRanges(pInterval, pInfo, ts.data(), win, pRanges);
+
+  std::vector<SWinRowRange> ranges;
+  for (int32_t i = 0; i < taosArrayGetSize(pRanges); ++i) {
+    ranges.push_back(*(SWinRowRange*)taosArrayGet(pRanges, i));
+  }
+  taosArrayDestroy(pRanges);
+  return ranges;
+}
+
+void expectSameRanges(SInterval interval, std::vector<TSKEY> ts, int64_t calSkey = INT64_MIN,
+                      int64_t calEkey = INT64_MAX) {
+  SDataBlockInfo info = makeBlockInfo(ts);
+  info.calWin.skey = calSkey;
+  info.calWin.ekey = calEkey;
+
+  std::vector<SWinRowRange> expect = perWindowRanges(&interval, &info, ts);
+  std::vector<SWinRowRange> actual = batchRanges(&interval, &info, ts);
+
+  ASSERT_EQ(actual.size(), expect.size()) << "interval:" << interval.interval << " sliding:" << interval.sliding;
+  for (size_t i = 0; i < expect.size(); ++i) {
+    EXPECT_EQ(actual[i].win.skey, expect[i].win.skey) << "window " << i;
+    EXPECT_EQ(actual[i].win.ekey, expect[i].win.ekey) << "window " << i;
+    EXPECT_EQ(actual[i].startPos, expect[i].startPos) << "window " << i;
+    EXPECT_EQ(actual[i].numOfRows, expect[i].numOfRows) << "window " << i;
+    EXPECT_GT(actual[i].numOfRows, 0) << "window " << i;
+  }
+}
+
+std::vector<TSKEY> makeTs(TSKEY start, int32_t rows, int64_t step) {
+  std::vector<TSKEY> ts;
+  for (int32_t i = 0; i < rows; ++i) ts.push_back(start + i * step);
+  return ts;
+}
+
+}  // namespace
+
+TEST(intervalWindowTest, tumbling) {
+  expectSameRanges(makeInterval(10, 10), makeTs(1648791213000, 1000, 1));
+  expectSameRanges(makeInterval(10, 10), makeTs(1648791213003, 1000, 3));
+  expectSameRanges(makeInterval(1000, 1000), makeTs(1648791213007, 1, 1));
+
+  // every row in a window of its own
+  expectSameRanges(makeInterval(10, 10), makeTs(1648791213000, 100, 10));
+}
+
+TEST(intervalWindowTest, tumblingEmptyWindows) {
+  // large gaps leave runs of windows without data between the rows
+  std::vector<TSKEY> ts = {1648791213000, 1648791213001, 1648791213095, 1648791214000,
+                           1648791214009, 1648791214010, 1648791299999};
+  expectSameRanges(makeInterval(10, 10), ts);
+  expectSameRanges(makeInterval(7, 7), ts);
+}
+
+TEST(intervalWindowTest, sliding) {
+  expectSameRanges(makeInterval(10, 5), makeTs(1648791213000, 1000, 1));
+  expectSameRanges(makeInterval(10, 3), makeTs(1648791213001, 1000, 2));
+  expectSameRanges(makeInterval(100, 1), makeTs(1648791213000, 500, 1));
+
+  // sliding windows overlapping a single row
+  expectSameRanges(makeInterval(10, 3), makeTs(1648791213005, 1, 1));
+}
+
+TEST(intervalWindowTest, slidingEmptyWindows) {
+  std::vector<TSKEY> ts = {1648791213000, 1648791213002, 1648791213050, 1648791213051,
+                           1648791214000, 1648791214013, 1648791230000};
+  expectSameRanges(makeInterval(10, 5), ts);
+  expectSameRanges(makeInterval(10, 3), ts);
+  expectSameRanges(makeInterval(20, 7), ts);
+}
+
+TEST(intervalWindowTest, slidingCalWindow) {
+  // a sliding window outside the calculation range of the block ends the block
+  std::vector<TSKEY> ts = makeTs(1648791213000, 200, 1);
+  expectSameRanges(makeInterval(10, 5), ts, 1648791213000, 1648791213100);
+  expectSameRanges(makeInterval(10, 3), ts, 1648791213050, 1648791213120);
+}
+
+TEST(intervalWindowTest, random) {
+  taosSeedRand(taosGetTimestampSec());
+
+  for (int32_t iCase = 0; iCase < 200; ++iCase) {
+    int64_t interval = taosRand() % 50 + 1;
+    int64_t sliding = taosRand() % interval + 1;
+
+    std::vector<TSKEY> ts;
+    TSKEY              key = 1648791213000 + taosRand() % 1000;
+    int32_t            rows = taosRand() % 2000 + 1;
+    for (int32_t i = 0; i < rows; ++i) {
+      ts.push_back(key);
+      key += (taosRand() % 10 == 0) ? taosRand() % (interval * 20) + 1 : taosRand() % 3 + 1;
+    }
+
+    expectSameRanges(makeInterval(interval, sliding), ts);
+    if (HasFatalFailure()) return;
+  }
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#include "os.h"
+
+#include "executorimpl.h"
+#include "functionMgt.h"
+#include "stub.h"
+#include "taoserror.h"
+#include "tdatablock.h"
+
+namespace {
+
+int32_t releaseCount = 0;
+
+int32_t scanTestRetrieveSMA(STsdbReader *pReader, SSDataBlock *pDataBlock, bool *allHave) {
+  *allHave = false;
+  return TSDB_CODE_SUCCESS;
+}
+
+SSDataBlock *scanTestRetrievePartialFail(STsdbReader *pReader, const int16_t *colIds, int32_t numOfCols) {
+  terrno = TSDB_CODE_FILE_CORRUPTED;
+  return NULL;
+}
+
+void scanTestRelease(STsdbReader *pReader) { releaseCount++; }
+
+}  // namespace
+
+TEST(scanLoadBlockTest, filterColsLoadFailReleasesBlock) {
+  Stub stub;
+  stub.set(tsdbRetrieveDatablockSMA, scanTestRetrieveSMA);
+  stub.set(tsdbRetrieveDataBlockPartial, scanTestRetrievePartialFail);
+  stub.set(tsdbReleaseDataBlock, scanTestRelease);
+
+  SExecTaskInfo  taskInfo = {0};
+  STableScanInfo scanInfo = {0};
+  SOperatorInfo  op = {0};
+  op.pTaskInfo = &taskInfo;
+  op.info = &scanInfo;
+  // never evaluated, the filter columns fail to load first
+  op.exprSupp.pFilterInfo = (SFilterInfo *)&scanInfo;
+
+  int16_t aFilterColId[] = {2};
+  scanInfo.base.pFilterColIds = aFilterColId;
+  scanInfo.base.numOfFilterCols = 1;
+  scanInfo.base.dataBlockLoadFlag = FUNC_DATA_REQUIRED_DATA_LOAD;
+
+  SSDataBlock *pBlock = createDataBlock();
+  pBlock->info.rows = 100;
+
+  // the block is released so the reader lock is not left held for tsdbReaderClose
+  releaseCount = 0;
+  uint32_t status = 0;
+  int32_t  code = loadDataBlock(&op, &scanInfo.base, pBlock, &status);
+  EXPECT_EQ(code, TSDB_CODE_FILE_CORRUPTED);
+  EXPECT_EQ(releaseCount, 1);
+
+  blockDataDestroy(pBlock);
+}
+
+#pragma GCC diagnostic pop
@@ -34,6 +34,17 @@ enum {
   TSDB_UDF_CALL_SCALA_PROC,
 };
 
+// Data blocks of a call that are at least this large are passed to udfd in a shared memory segment owned by the
+// udfc session, only the control message goes through the pipe.
+#define UDF_SHM_MIN_DATA_LEN (64 * 1024)
+#define UDF_SHM_ALIGN        (1024 * 1024)
+
+typedef struct SUdfShm {
+  int32_t id;
+  int32_t size;
+  void   *addr;
+} SUdfShm;
+
 typedef struct SUdfSetupRequest {
   char udfName[TSDB_FUNC_NAME_LEN + 1];
 } SUdfSetupRequest;
@@ -53,12 +64,17 @@ typedef struct SUdfCallRequest {
   SUdfInterBuf interBuf;
   SUdfInterBuf interBuf2;
   int8_t       initFirst;
+
+  int8_t  blockInShm;  // block is encoded at the beginning of the shared memory segment
+  int32_t shmId;
+  int32_t shmSize;
 } SUdfCallRequest;
 
 typedef struct SUdfCallResponse {
   int8_t       callType;
   SSDataBlock  resultData;
   SUdfInterBuf resultBuf;
+  int8_t       resultInShm;  // result data is encoded at the beginning of the shared memory segment of the request
 } SUdfCallResponse;
 
 typedef struct SUdfTeardownRequest {
@@ -110,6 +126,10 @@ int32_t convertDataBlockToUdfDataBlock(SSDataBlock *block, SUdfDataBlock *udfBlo
 int32_t convertUdfColumnToDataBlock(SUdfColumn *udfCol, SSDataBlock *block);
 
 int32_t getUdfdPipeName(char *pipeName, int32_t size);
+
+int32_t udfShmCreate(SUdfShm *shm, int32_t size);
+int32_t udfShmAttach(SUdfShm *shm, int32_t id, int32_t size);
+void    udfShmDetach(SUdfShm *shm);
 #ifdef __cplusplus
 }
 #endif
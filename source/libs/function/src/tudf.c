@@ -380,6 +380,9 @@ typedef struct SUdfcUvSession {
   int32_t bufSize;
 
   char udfName[TSDB_FUNC_NAME_LEN + 1];
+
+  uv_mutex_t shmLock;  // held by the call whose data is in shm, from sending the request until reading the response
+  SUdfShm    shm;
 } SUdfcUvSession;
 
 typedef struct SClientUvTaskNode {
@@ -491,6 +494,57 @@ int32_t getUdfdPipeName(char *pipeName, int32_t size) {
   return 0;
 }
 
+int32_t udfShmCreate(SUdfShm *shm, int32_t size) {
+#ifdef LINUX
+  int32_t id = shmget(IPC_PRIVATE, size, IPC_CREAT | IPC_EXCL | 0600);
+  if (id < 0) {
+    return TAOS_SYSTEM_ERROR(errno);
+  }
+
+  void *addr = shmat(id, NULL, 0);
+  // linux allows to attach a segment that is marked to be destroyed, so it is removed at once and the kernel frees it
+  // once both taosd and udfd have detached it, even if either of them crashes.
+  shmctl(id, IPC_RMID, NULL);
+  if (addr == (void *)-1) {
+    return TAOS_SYSTEM_ERROR(errno);
+  }
+
+  shm->id = id;
+  shm->size = size;
+  shm->addr = addr;
+  return 0;
+#else
+  return TSDB_CODE_OPS_NOT_SUPPORT;
+#endif
+}
+
+int32_t udfShmAttach(SUdfShm *shm, int32_t id, int32_t size) {
+#ifdef LINUX
+  void *addr = shmat(id, NULL, 0);
+  if (addr == (void *)-1) {
+    return TAOS_SYSTEM_ERROR(errno);
+  }
+
+  shm->id = id;
+  shm->size = size;
+  shm->addr = addr;
+  return 0;
+#else
+  return TSDB_CODE_OPS_NOT_SUPPORT;
+#endif
+}
+
+void udfShmDetach(SUdfShm *shm) {
+#ifdef LINUX
+  if (shm->addr != NULL) {
+    shmdt(shm->addr);
+  }
+#endif
+  shm->id = -1;
+  shm->size = 0;
+  shm->addr = NULL;
+}
+
 int32_t encodeUdfSetupRequest(void **buf, const SUdfSetupRequest *setup) {
   int32_t len = 0;
   len += taosEncodeBinary(buf, setup->udfName, TSDB_FUNC_NAME_LEN);
@@ -517,16 +571,38 @@ void *decodeUdfInterBuf(const void *buf, SUdfInterBuf *state) {
   return (void *)buf;
 }
 
+static int32_t encodeUdfCallBlock(void **buf, const SUdfCallRequest *call) {
+  int32_t len = taosEncodeFixedI8(buf, call->blockInShm);
+  if (call->blockInShm) {
+    len += taosEncodeFixedI32(buf, call->shmId);
+    len += taosEncodeFixedI32(buf, call->shmSize);
+  } else {
+    len += tEncodeDataBlock(buf, &call->block);
+  }
+  return len;
+}
+
+static void *decodeUdfCallBlock(const void *buf, SUdfCallRequest *call) {
+  buf = taosDecodeFixedI8(buf, &call->blockInShm);
+  if (call->blockInShm) {
+    buf = taosDecodeFixedI32(buf, &call->shmId);
+    buf = taosDecodeFixedI32(buf, &call->shmSize);
+  } else {
+    buf = tDecodeDataBlock(buf, &call->block);
+  }
+  return (void *)buf;
+}
+
 int32_t encodeUdfCallRequest(void **buf, const SUdfCallRequest *call) {
   int32_t len = 0;
   len += taosEncodeFixedI64(buf, call->udfHandle);
   len += taosEncodeFixedI8(buf, call->callType);
   if (call->callType == TSDB_UDF_CALL_SCALA_PROC) {
-    len += tEncodeDataBlock(buf, &call->block);
+    len += encodeUdfCallBlock(buf, call);
   } else if (call->callType == TSDB_UDF_CALL_AGG_INIT) {
     len += taosEncodeFixedI8(buf, call->initFirst);
   } else if (call->callType == TSDB_UDF_CALL_AGG_PROC) {
-    len += tEncodeDataBlock(buf, &call->block);
+    len += encodeUdfCallBlock(buf, call);
     len += encodeUdfInterBuf(buf, &call->interBuf);
   } else if (call->callType == TSDB_UDF_CALL_AGG_MERGE) {
     len += encodeUdfInterBuf(buf, &call->interBuf);
@@ -542,13 +618,13 @@ void *decodeUdfCallRequest(const void *buf, SUdfCallRequest *call) {
   buf = taosDecodeFixedI8(buf, &call->callType);
   switch (call->callType) {
     case TSDB_UDF_CALL_SCALA_PROC:
-      buf = tDecodeDataBlock(buf, &call->block);
+      buf = decodeUdfCallBlock(buf, call);
       break;
     case TSDB_UDF_CALL_AGG_INIT:
       buf = taosDecodeFixedI8(buf, &call->initFirst);
       break;
     case TSDB_UDF_CALL_AGG_PROC:
-      buf = tDecodeDataBlock(buf, &call->block);
+      buf = decodeUdfCallBlock(buf, call);
       buf = decodeUdfInterBuf(buf, &call->interBuf);
       break;
     case TSDB_UDF_CALL_AGG_MERGE:
@@ -632,7 +708,10 @@ int32_t encodeUdfCallResponse(void **buf, const SUdfCallResponse *callRsp) {
   len += taosEncodeFixedI8(buf, callRsp->callType);
   switch (callRsp->callType) {
     case TSDB_UDF_CALL_SCALA_PROC:
-      len += tEncodeDataBlock(buf, &callRsp->resultData);
+      len += taosEncodeFixedI8(buf, callRsp->resultInShm);
+      if (!callRsp->resultInShm) {
+        len += tEncodeDataBlock(buf, &callRsp->resultData);
+      }
       break;
     case TSDB_UDF_CALL_AGG_INIT:
       len += encodeUdfInterBuf(buf, &callRsp->resultBuf);
@@ -654,7 +733,10 @@ void *decodeUdfCallResponse(const void *buf, SUdfCallResponse *callRsp) {
   buf = taosDecodeFixedI8(buf, &callRsp->callType);
   switch (callRsp->callType) {
     case TSDB_UDF_CALL_SCALA_PROC:
-      buf = tDecodeDataBlock(buf, &callRsp->resultData);
+      buf = taosDecodeFixedI8(buf, &callRsp->resultInShm);
+      if (!callRsp->resultInShm) {
+        buf = tDecodeDataBlock(buf, &callRsp->resultData);
+      }
       break;
     case TSDB_UDF_CALL_AGG_INIT:
       buf = decodeUdfInterBuf(buf, &callRsp->resultBuf);
@@ -1670,6 +1752,44 @@ int32_t udfcRunUdfUvTask(SClientUdfTask *task, int8_t uvTaskType) {
   return task->errCode;
 }
 
+static void udfcFreeSession(SUdfcUvSession *session) {
+  udfShmDetach(&session->shm);
+  uv_mutex_destroy(&session->shmLock);
+  taosMemoryFree(session);
+}
+
+// Put the input block of the call into the shared memory of the session. Returns true with the shm lock of the
+// session held, which is released after the response is read. Small blocks, or a session whose shm is used by a
+// concurrent call, go through the pipe as before.
+static bool udfcPutBlockInShm(SUdfcUvSession *session, SUdfCallRequest *req) {
+#ifdef LINUX
+  int32_t len = tEncodeDataBlock(NULL, &req->block);
+  if (len < UDF_SHM_MIN_DATA_LEN || uv_mutex_trylock(&session->shmLock) != 0) {
+    return false;
+  }
+
+  if (session->shm.size < len) {
+    udfShmDetach(&session->shm);
+    int32_t code = udfShmCreate(&session->shm, ALIGN_NUM(len, UDF_SHM_ALIGN));
+    if (code != 0) {
+      fnError("udfc failed to create shm of size %d since %s, udf name: %s", len, tstrerror(code), session->udfName);
+      uv_mutex_unlock(&session->shmLock);
+      return false;
+    }
+  }
+
+  void *buf = session->shm.addr;
+  tEncodeDataBlock(&buf, &req->block);
+
+  req->blockInShm = 1;
+  req->shmId = session->shm.id;
+  req->shmSize = session->shm.size;
+  return true;
+#else
+  return false;
+#endif
+}
+
 int32_t doSetupUdf(char udfName[], UdfcFuncHandle *funcHandle) {
   if (gUdfcProxy.udfcState != UDFC_STATE_READY) {
     return TSDB_CODE_UDF_INVALID_STATE;
@@ -1678,6 +1798,8 @@ int32_t doSetupUdf(char udfName[], UdfcFuncHandle *funcHandle) {
   task->errCode = 0;
   task->session = taosMemoryCalloc(1, sizeof(SUdfcUvSession));
   task->session->udfc = &gUdfcProxy;
+  uv_mutex_init(&task->session->shmLock);
+  task->session->shm.id = -1;
   task->type = UDF_TASK_SETUP;
 
   SUdfSetupRequest *req = &task->_setup.req;
@@ -1686,7 +1808,7 @@ int32_t doSetupUdf(char udfName[], UdfcFuncHandle *funcHandle) {
   int32_t errCode = udfcRunUdfUvTask(task, UV_TASK_CONNECT);
   if (errCode != 0) {
     fnError("failed to connect to pipe. udfName: %s, pipe: %s", udfName, (&gUdfcProxy)->udfdPipeName);
-    taosMemoryFree(task->session);
+    udfcFreeSession(task->session);
     taosMemoryFree(task);
     return TSDB_CODE_UDF_PIPE_CONNECT_ERR;
   }
@@ -1752,8 +1874,20 @@ int32_t callUdf(UdfcFuncHandle handle, int8_t callType, SSDataBlock *input, SUdf
     }
   }
 
+  bool inShm = false;
+  if (callType == TSDB_UDF_CALL_AGG_PROC || callType == TSDB_UDF_CALL_SCALA_PROC) {
+    inShm = udfcPutBlockInShm(session, req);
+  }
+
   udfcRunUdfUvTask(task, UV_TASK_REQ_RSP);
 
+  if (inShm) {
+    if (task->errCode == 0 && callType == TSDB_UDF_CALL_SCALA_PROC && task->_call.rsp.resultInShm) {
+      tDecodeDataBlock(session->shm.addr, &task->_call.rsp.resultData);
+    }
+    uv_mutex_unlock(&session->shmLock);
+  }
+
   if (task->errCode != 0) {
     fnError("call udf failure. err: %d", task->errCode);
   } else {
@@ -1839,7 +1973,7 @@ int32_t doTeardownUdf(UdfcFuncHandle handle) {
 
   if (session->udfUvPipe == NULL) {
     fnError("tear down udf. pipe to udfd does not exist. udf name: %s", session->udfName);
-    taosMemoryFree(session);
+    udfcFreeSession(session);
     return TSDB_CODE_UDF_PIPE_NO_PIPE;
   }
 
@@ -1865,7 +1999,7 @@ int32_t doTeardownUdf(UdfcFuncHandle handle) {
     conn->session = NULL;
   }
   uv_mutex_unlock(&gUdfcProxy.udfcUvMutex);
-  taosMemoryFree(session);
+  udfcFreeSession(session);
   taosMemoryFree(task);
 
   return err;
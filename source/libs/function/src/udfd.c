@@ -254,6 +254,17 @@ void udfdProcessSetupRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
   return;
 }
 
+static int32_t udfdGetBlockFromShm(SUdfCallRequest *call, SUdfShm *shm) {
+  int32_t code = udfShmAttach(shm, call->shmId, call->shmSize);
+  if (code != TSDB_CODE_SUCCESS) {
+    fnError("udfd failed to attach shm %d since %s", call->shmId, tstrerror(code));
+    return code;
+  }
+
+  tDecodeDataBlock(shm->addr, &call->block);
+  return TSDB_CODE_SUCCESS;
+}
+
 void udfdProcessCallRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
   SUdfCallRequest *call = &request->call;
   fnDebug("call request. call type %d, handle: %" PRIx64 ", seq num %" PRId64, call->callType, call->udfHandle,
@@ -264,9 +275,15 @@ void udfdProcessCallRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
   SUdfResponse     *rsp = &response;
   SUdfCallResponse *subRsp = &rsp->callRsp;
 
+  // the shm is attached for this call only, since the connection may be closed while the call is running
+  SUdfShm shm = {.id = -1};
   int32_t code = TSDB_CODE_SUCCESS;
   switch (call->callType) {
     case TSDB_UDF_CALL_SCALA_PROC: {
+      if (call->blockInShm && (code = udfdGetBlockFromShm(call, &shm)) != TSDB_CODE_SUCCESS) {
+        break;
+      }
+
       SUdfColumn output = {0};
 
       SUdfDataBlock input = {0};
@@ -284,6 +301,11 @@ void udfdProcessCallRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
       break;
     }
     case TSDB_UDF_CALL_AGG_PROC: {
+      if (call->blockInShm && (code = udfdGetBlockFromShm(call, &shm)) != TSDB_CODE_SUCCESS) {
+        freeUdfInterBuf(&call->interBuf);
+        break;
+      }
+
       SUdfDataBlock input = {0};
       convertDataBlockToUdfDataBlock(&call->block, &input);
       SUdfInterBuf outBuf = {.buf = taosMemoryMalloc(udf->bufSize), .bufLen = udf->bufSize, .numOfResult = 0};
@@ -319,6 +341,15 @@ void udfdProcessCallRequest(SUvUdfWork *uvUdf, SUdfRequest *request) {
   rsp->code = code;
   subRsp->callType = call->callType;
 
+  // the input block has been decoded, so the result takes its place in shm if it fits
+  if (code == TSDB_CODE_SUCCESS && shm.addr != NULL && call->callType == TSDB_UDF_CALL_SCALA_PROC &&
+      tEncodeDataBlock(NULL, &subRsp->resultData) <= shm.size) {
+    void *buf = shm.addr;
+    tEncodeDataBlock(&buf, &subRsp->resultData);
+    subRsp->resultInShm = 1;
+  }
+  udfShmDetach(&shm);
+
   int32_t len = encodeUdfResponse(NULL, rsp);
   rsp->msgLen = len;
   void *bufBegin = taosMemoryMalloc(len);
@@ -80,6 +80,86 @@ int scalarFuncTest() {
   return 0;
 }
 
+// call udf1 on a block of one int column whose every seventh row is null
+static int32_t callUdf1(UdfcFuncHandle handle, int32_t rows, SScalarParam *output) {
+  SSDataBlock     block = {0};
+  SSDataBlock    *pBlock = &block;
+  SColumnInfoData colInfo = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 1);
+  blockDataAppendColInfo(pBlock, &colInfo);
+  blockDataEnsureCapacity(pBlock, rows);
+  pBlock->info.rows = rows;
+
+  SColumnInfoData *pCol = taosArrayGet(pBlock->pDataBlock, 0);
+  for (int32_t j = 0; j < rows; ++j) {
+    if (j % 7 == 0) {
+      colDataSetNULL(pCol, j);
+    } else {
+      colDataSetInt32(pCol, j, &j);
+    }
+  }
+
+  SScalarParam input = {0};
+  input.numOfRows = rows;
+  input.columnData = pCol;
+
+  int32_t code = doCallUdfScalarFunc(handle, &input, 1, output);
+  colDataDestroy(pCol);
+  taosArrayDestroy(pBlock->pDataBlock);
+  return code;
+}
+
+// a block of at least UDF_SHM_MIN_DATA_LEN goes to udfd through shm, the result must be the same as through the pipe
+int scalarFuncShmTest() {
+  UdfcFuncHandle handle;
+
+  if (doSetupUdf("udf1", &handle) != 0) {
+    fnError("setup udf failure");
+    return -1;
+  }
+
+  const int32_t pipeRows = 1024;
+  const int32_t shmRows = 64 * 1024;
+  SScalarParam  pipeOutput = {0};
+  SScalarParam  shmOutput = {0};
+  int32_t       code = callUdf1(handle, pipeRows, &pipeOutput);
+  if (code == 0) {
+    code = callUdf1(handle, shmRows, &shmOutput);
+  }
+
+  if (code != 0) {
+    fprintf(stderr, "shm test: call udf failure, code:%d\n", code);
+  } else if (pipeOutput.numOfRows != pipeRows || shmOutput.numOfRows != shmRows) {
+    fprintf(stderr, "shm test: rows mismatch, pipe:%d shm:%d\n", pipeOutput.numOfRows, shmOutput.numOfRows);
+    code = -1;
+  } else {
+    for (int32_t i = 0; i < shmRows; ++i) {
+      SColumnInfoData *pPipeCol = pipeOutput.columnData;
+      SColumnInfoData *pShmCol = shmOutput.columnData;
+      int32_t          j = i % 7;  // the nulls of the input repeat every seven rows
+      bool isNull = colDataIsNull_s(pShmCol, i);
+      if (isNull != colDataIsNull_s(pPipeCol, j) ||
+          (!isNull && *(int32_t *)colDataGetData(pShmCol, i) != *(int32_t *)colDataGetData(pPipeCol, j))) {
+        fprintf(stderr, "shm test: result mismatch at row %d\n", i);
+        code = -1;
+        break;
+      }
+    }
+  }
+
+  fprintf(stderr, "shm test: %s\n", code == 0 ? "passed" : "failed");
+  if (pipeOutput.columnData != NULL) {
+    colDataDestroy(pipeOutput.columnData);
+    taosMemoryFree(pipeOutput.columnData);
+  }
+  if (shmOutput.columnData != NULL) {
+    colDataDestroy(shmOutput.columnData);
+    taosMemoryFree(shmOutput.columnData);
+  }
+  doTeardownUdf(handle);
+
+  return code;
+}
+
 int aggregateFuncTest() {
   UdfcFuncHandle handle;
 
@@ -137,5 +217,7 @@ int main(int argc, char *argv[]) {
 
   scalarFuncTest();
   aggregateFuncTest();
+  int32_t code = scalarFuncShmTest();
   udfcClose();
+  return code;
 }
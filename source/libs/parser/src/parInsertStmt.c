@@ -266,7 +266,14 @@ int32_t qBindStmtColsValue(void* pBlock, TAOS_MULTI_BIND* bind, char* msgBuf, in
       pBind = bind + c;
     }
 
-    tColDataAddValueByBind(pCol, pBind);
+    if (tsStmtBindZeroCopy) {
+      code = tColDataRefValueByBind(pCol, pBind);
+    } else {
+      code = tColDataAddValueByBind(pCol, pBind);
+    }
+    if (code) {
+      goto _return;
+    }
   }
 
   qDebug("stmt all %d columns bind %d rows data", boundInfo->numOfBound, rowNum);
@@ -309,7 +316,14 @@ int32_t qBindStmtSingleColValue(void* pBlock, TAOS_MULTI_BIND* bind, char* msgBu
     pBind = bind;
   }
 
-  tColDataAddValueByBind(pCol, pBind);
+  if (tsStmtBindZeroCopy) {
+    code = tColDataRefValueByBind(pCol, pBind);
+  } else {
+    code = tColDataAddValueByBind(pCol, pBind);
+  }
+  if (code) {
+    goto _return;
+  }
 
   qDebug("stmt col %d bind %d rows data", colIdx, rowNum);
 
@@ -2448,7 +2448,8 @@ static int32_t tagScanOptimize(SOptimizeContext* pCxt, SLogicSubplan* pLogicSubp
 }
 
 static bool pushDownLimitOptShouldBeOptimized(SLogicNode* pNode) {
-  if (NULL == pNode->pLimit || 1 != LIST_LENGTH(pNode->pChildren) ||
+  // the limit of sort bounds the sorted output, the scan under it must return all rows
+  if (NULL == pNode->pLimit || QUERY_NODE_LOGIC_PLAN_SORT == nodeType(pNode) || 1 != LIST_LENGTH(pNode->pChildren) ||
       QUERY_NODE_LOGIC_PLAN_SCAN != nodeType(nodesListGetNode(pNode->pChildren, 0))) {
     return false;
   }
@@ -2470,6 +2471,40 @@ static int32_t pushDownLimitOptimize(SOptimizeContext* pCxt, SLogicSubplan* pLog
   return TSDB_CODE_SUCCESS;
 }
 
+static bool sortLimitOptShouldBeOptimized(SLogicNode* pNode) {
+  if (QUERY_NODE_LOGIC_PLAN_SORT != nodeType(pNode) || NULL != pNode->pLimit || NULL != pNode->pConditions ||
+      ((SSortLogicNode*)pNode)->groupSort) {
+    return false;
+  }
+
+  // the limit of project is applied on its filtered output, and per group with slimit
+  SLogicNode* pParent = pNode->pParent;
+  if (NULL == pParent || QUERY_NODE_LOGIC_PLAN_PROJECT != nodeType(pParent) || NULL == pParent->pLimit ||
+      NULL != pParent->pSlimit || NULL != pParent->pConditions) {
+    return false;
+  }
+  return true;
+}
+
+// the sort only needs to keep the first limit + offset rows for the project above it, which still applies the
+// original limit and offset
+static int32_t sortLimitOptimize(SOptimizeContext* pCxt, SLogicSubplan* pLogicSubplan) {
+  SLogicNode* pSort = optFindPossibleNode(pLogicSubplan->pNode, sortLimitOptShouldBeOptimized);
+  if (NULL == pSort) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  pSort->pLimit = nodesCloneNode(pSort->pParent->pLimit);
+  if (NULL == pSort->pLimit) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  ((SLimitNode*)pSort->pLimit)->limit += ((SLimitNode*)pSort->pLimit)->offset;
+  ((SLimitNode*)pSort->pLimit)->offset = 0;
+  pCxt->optimized = true;
+
+  return TSDB_CODE_SUCCESS;
+}
+
 typedef struct STbCntScanOptInfo {
   SAggLogicNode*  pAgg;
   SScanLogicNode* pScan;
@@ -2721,6 +2756,7 @@ static const SOptimizeRule optimizeRuleSet[] = {
   {.pName = "RewriteUnique",              .optimizeFunc = rewriteUniqueOptimize},
   {.pName = "LastRowScan",                .optimizeFunc = lastRowScanOptimize},
   {.pName = "TagScan",                    .optimizeFunc = tagScanOptimize},
+  {.pName = "SortLimit",                  .optimizeFunc = sortLimitOptimize},
   {.pName = "PushDownLimit",              .optimizeFunc = pushDownLimitOptimize},
   {.pName = "TableCountScan",             .optimizeFunc = tableCountScanOptimize},
 };
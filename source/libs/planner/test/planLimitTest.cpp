@@ -39,3 +39,59 @@ TEST_F(PlanLimitTest, slimit) {
 
   run("select * from t1 partition by c1 slimit 2, 5");
 }
+
+static void collectPhysiNodes(SNode* pNode, ENodeType type, vector<SPhysiNode*>& nodes) {
+  if (type == nodeType(pNode)) {
+    nodes.push_back((SPhysiNode*)pNode);
+  }
+  SNode* pChild = nullptr;
+  FOREACH(pChild, ((SPhysiNode*)pNode)->pChildren) { collectPhysiNodes(pChild, type, nodes); }
+}
+
+// the limit of project is pushed down into the sort below it as limit + offset
+TEST_F(PlanLimitTest, sortLimit) {
+  useDb("root", "test");
+
+  auto check = [this](int64_t limit, bool scanUnlimited) {
+    int32_t nSort = 0;
+    for (const auto& str : physiSubplans()) {
+      SNode* pSubplan = nullptr;
+      ASSERT_EQ(nodesStringToNode(str.c_str(), &pSubplan), TSDB_CODE_SUCCESS);
+
+      vector<SPhysiNode*> sorts;
+      collectPhysiNodes((SNode*)((SSubplan*)pSubplan)->pNode, QUERY_NODE_PHYSICAL_PLAN_SORT, sorts);
+      for (SPhysiNode* pSort : sorts) {
+        ++nSort;
+        if (limit < 0) {
+          EXPECT_EQ(pSort->pLimit, nullptr);
+        } else {
+          ASSERT_NE(pSort->pLimit, nullptr);
+          EXPECT_EQ(((SLimitNode*)pSort->pLimit)->limit, limit);
+          EXPECT_EQ(((SLimitNode*)pSort->pLimit)->offset, 0);
+        }
+      }
+
+      if (scanUnlimited) {
+        vector<SPhysiNode*> scans;
+        collectPhysiNodes((SNode*)((SSubplan*)pSubplan)->pNode, QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN, scans);
+        for (SPhysiNode* pScan : scans) {
+          EXPECT_EQ(pScan->pLimit, nullptr);
+        }
+      }
+      nodesDestroyNode(pSubplan);
+    }
+    EXPECT_GT(nSort, 0);
+  };
+
+  run("SELECT c1 FROM t1 ORDER BY c1 LIMIT 10");
+  check(10, true);
+
+  run("SELECT c1 FROM t1 ORDER BY c1 LIMIT 10 OFFSET 5");
+  check(15, true);
+
+  run("SELECT c1 FROM st1 ORDER BY c1 LIMIT 5, 10");
+  check(15, true);
+
+  run("SELECT c1 FROM t1 ORDER BY c1");
+  check(-1, true);
+}
@@ -241,6 +241,8 @@ class PlannerTestBaseImpl {
     }
   }
 
+  const vector<string>& physiSubplans() const { return res_.physiSubplans_; }
+
  private:
   struct caseEnv {
     int32_t acctId_;
@@ -525,3 +527,5 @@ void PlannerTestBase::bindParams(TAOS_MULTI_BIND* pParams, int32_t colIdx) {
 }
 
 void PlannerTestBase::exec() { return impl_->exec(); }
+
+const std::vector<std::string>& PlannerTestBase::physiSubplans() const { return impl_->physiSubplans(); }
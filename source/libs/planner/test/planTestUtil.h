@@ -17,6 +17,8 @@
 #define PLAN_TEST_UTIL_H
 
 #include <gtest/gtest.h>
+#include <string>
+#include <vector>
 
 #define ALLOW_FORBID_FUNC
 
@@ -36,6 +38,8 @@ class PlannerTestBase : public testing::Test {
   void prepare(const std::string& sql);
   void bindParams(TAOS_MULTI_BIND* pParams, int32_t colIdx);
   void exec();
+  // the physical subplans of the last run sql, in json
+  const std::vector<std::string>& physiSubplans() const;
 
  private:
   std::unique_ptr<PlannerTestBaseImpl> impl_;
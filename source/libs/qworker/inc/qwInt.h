@@ -120,6 +120,7 @@ typedef struct SQWTaskCtx {
   int8_t   explain;
   int8_t   needFetch;
   int8_t   localExec;
+  int8_t   ncharUtf8;
   int32_t  msgType;
   int32_t  level;
   uint64_t sId;
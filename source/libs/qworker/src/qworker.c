@@ -363,6 +363,13 @@ int32_t qwGetQueryResFromSink(QW_FPARAMS_DEF, SQWTaskCtx *ctx, int32_t *dataLen,
       QW_ERR_RET(code);
     }
 
+    // the client fetches exactly one block from the top level task, encode its nchar columns as it asked
+    if (ctx->ncharUtf8 && 0 == ctx->level && !output.compressed && output.numOfRows > 0) {
+      int32_t blockLen = (int32_t)len;
+      QW_ERR_RET(blockEncodeNcharToUtf8(output.pData, &blockLen));
+      *dataLen -= (int32_t)len - blockLen;
+    }
+
     pOutput->queryEnd = output.queryEnd;
     pOutput->precision = output.precision;
     pOutput->bufStatus = output.bufStatus;
@@ -684,6 +691,10 @@ int32_t qwProcessQuery(QW_FPARAMS_DEF, SQWMsg *qwMsg, char *sql) {
     QW_ERR_JRET(TSDB_CODE_APP_ERROR);
   }
 
+  if (ctx->explain) {
+    qEnableTaskExecCost(pTaskInfo);
+  }
+
   qwSendQueryRsp(QW_FPARAMS(), qwMsg->msgType + 1, ctx, code, true);
 
   ctx->level = plan->level;
@@ -832,6 +843,7 @@ int32_t qwProcessFetch(QW_FPARAMS_DEF, SQWMsg *qwMsg) {
 
   ctx->msgType = qwMsg->msgType;
   ctx->dataConnInfo = qwMsg->connInfo;
+  ctx->ncharUtf8 = qwMsg->msgInfo.ncharUtf8;
 
   SOutputData sOutput = {0};
   QW_ERR_JRET(qwGetQueryResFromSink(QW_FPARAMS(), ctx, &dataLen, &rsp, &sOutput));
@@ -1325,6 +1337,10 @@ int32_t qWorkerProcessLocalQuery(void *pMgmt, uint64_t sId, uint64_t qId, uint64
     QW_ERR_JRET(TSDB_CODE_APP_ERROR);
   }
 
+  if (ctx->explain) {
+    qEnableTaskExecCost(pTaskInfo);
+  }
+
   ctx->level = plan->level;
   atomic_store_ptr(&ctx->taskHandle, pTaskInfo);
   atomic_store_ptr(&ctx->sinkHandle, sinkHandle);
@@ -113,6 +113,7 @@ typedef struct SSchResInfo {
   schedulerExecFp  execFp;
   schedulerFetchFp fetchFp;
   void            *cbParam;
+  bool             ncharUtf8;
 } SSchResInfo;
 
 typedef struct SSchOpEvent {
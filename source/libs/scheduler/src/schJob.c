@@ -898,6 +898,7 @@ int32_t schProcessOnOpBegin(SSchJob *pJob, SCH_OP_TYPE type, SSchedulerReq *pReq
       pJob->userRes.fetchRes = pReq->pFetchRes;
       pJob->userRes.fetchFp = pReq->fetchFp;
       pJob->userRes.cbParam = pReq->cbParam;
+      pJob->userRes.ncharUtf8 = pReq->ncharUtf8;
 
       pJob->opStatus.syncReq = pReq->syncReq;
       SCH_UNLOCK(SCH_WRITE, &pJob->opStatus.lock);
@@ -1110,6 +1110,7 @@ int32_t schBuildAndSendMsg(SSchJob *pJob, SSchTask *pTask, SQueryNodeAddr *addr,
       req.queryId = pJob->queryId;
       req.taskId = pTask->taskId;
       req.execId = pTask->execId;
+      req.ncharUtf8 = pJob->userRes.ncharUtf8;
 
       msgSize = tSerializeSResFetchReq(NULL, 0, &req);
       if (msgSize < 0) {
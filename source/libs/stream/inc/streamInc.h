@@ -30,13 +30,37 @@ typedef struct {
 
 static SStreamGlobalEnv streamEnv;
 
+typedef struct {
+  int64_t stage;
+  int64_t reqId;
+} SStreamUpstreamSeq;
+
+// max dispatch reqs in flight and queued per downstream task
+#define STREAM_DISPATCH_MAX_CREDIT  4
+#define STREAM_DISPATCH_MAX_PENDING 8
+// delay before the dispatch reqs a downstream task did not take, or that failed to send, are sent again
+#define STREAM_DISPATCH_RETRY_MS 100
+// a dispatch req is taken in sequence, was taken before, or arrived ahead of a req the downstream has not taken
+#define STREAM_UPSTREAM_SEQ__NEXT 0
+#define STREAM_UPSTREAM_SEQ__DUP  1
+#define STREAM_UPSTREAM_SEQ__GAP  2
+// max groups whose destination vgroup is cached by a shuffle dispatch task
+#define STREAM_DISPATCH_MAX_CACHED_GROUPS 100000
+
 int32_t streamDispatch(SStreamTask* pTask);
+int32_t streamDispatchRelease(SStreamTask* pTask, int32_t downstreamTaskId, int64_t reqId, int8_t inputStatus);
+void    streamDispatchResume(SStreamTask* pTask);
+void    streamDispatchRetryLater(SStreamTask* pTask);
+void    streamClearDispatchDest(SStreamTask* pTask);
+int8_t  streamCheckUpstreamSeq(SStreamTask* pTask, const SStreamDispatchReq* pReq);
+void    streamUpdateUpstreamSeq(SStreamTask* pTask, const SStreamDispatchReq* pReq);
 int32_t streamDispatchReqToData(const SStreamDispatchReq* pReq, SStreamDataBlock* pData);
 int32_t streamRetrieveReqToData(const SStreamRetrieveReq* pReq, SStreamDataBlock* pData);
 int32_t streamDispatchAllBlocks(SStreamTask* pTask, const SStreamDataBlock* data);
 
 int32_t streamBroadcastToChildren(SStreamTask* pTask, const SSDataBlock* pBlock);
 
+int32_t tEncodeStreamDispatchReq(SEncoder* pEncoder, const SStreamDispatchReq* pReq);
 int32_t tEncodeStreamRetrieveReq(SEncoder* pEncoder, const SStreamRetrieveReq* pReq);
 
 int32_t streamDispatchOneCheckReq(SStreamTask* pTask, const SStreamTaskCheckReq* pReq, int32_t nodeId, SEpSet* pEpSet);
@@ -79,6 +79,24 @@ void streamSchedByTimer(void* param, void* tmrId) {
   taosTmrReset(streamSchedByTimer, (int32_t)pTask->triggerParam, pTask, streamEnv.timer, &pTask->timer);
 }
 
+static void streamDispatchByTimer(void* param, void* tmrId) {
+  SStreamTask* pTask = (void*)param;
+
+  atomic_store_8(&pTask->dispatchRetry, 0);
+  if (atomic_load_8(&pTask->taskStatus) != TASK_STATUS__DROPPING) {
+    streamDispatchResume(pTask);
+  }
+  streamMetaReleaseTask(NULL, pTask);
+}
+
+void streamDispatchRetryLater(SStreamTask* pTask) {
+  if (atomic_val_compare_exchange_8(&pTask->dispatchRetry, 0, 1) != 0) return;
+
+  // the timer holds a ref of the task until it fires
+  atomic_add_fetch_32(&pTask->refCnt, 1);
+  taosTmrReset(streamDispatchByTimer, STREAM_DISPATCH_RETRY_MS, pTask, streamEnv.timer, &pTask->dispatchTimer);
+}
+
 int32_t streamSetupTrigger(SStreamTask* pTask) {
   if (pTask->triggerParam != 0) {
     int32_t ref = atomic_add_fetch_32(&pTask->refCnt, 1);
@@ -111,27 +129,71 @@ int32_t streamSchedExec(SStreamTask* pTask) {
   return 0;
 }
 
-int32_t streamTaskEnqueue(SStreamTask* pTask, const SStreamDispatchReq* pReq, SRpcMsg* pRsp) {
-  SStreamDataBlock* pData = taosAllocateQitem(sizeof(SStreamDataBlock), DEF_QITEM, 0);
-  int8_t            status;
+int8_t streamCheckUpstreamSeq(SStreamTask* pTask, const SStreamDispatchReq* pReq) {
+  // an upstream task without reqId
+  if (pReq->reqId == 0) return STREAM_UPSTREAM_SEQ__NEXT;
 
-  // enqueue
-  if (pData != NULL) {
-    pData->type = STREAM_INPUT__DATA_BLOCK;
-    pData->srcVgId = pReq->dataSrcVgId;
-    // decode
-    /*pData->blocks = pReq->data;*/
-    /*pBlock->sourceVer = pReq->sourceVer;*/
-    streamDispatchReqToData(pReq, pData);
-    if (streamTaskInput(pTask, (SStreamQueueItem*)pData) == 0) {
-      status = TASK_INPUT_STATUS__NORMAL;
+  if (pTask->pUpstreamSeq == NULL) {
+    pTask->pUpstreamSeq = taosHashInit(4, taosGetDefaultHashFunction(TSDB_DATA_TYPE_INT), true, HASH_NO_LOCK);
+    if (pTask->pUpstreamSeq == NULL) return STREAM_UPSTREAM_SEQ__NEXT;
+  }
+
+  // the first req since either task started opens the sequence
+  SStreamUpstreamSeq* pSeq = taosHashGet(pTask->pUpstreamSeq, &pReq->upstreamTaskId, sizeof(int32_t));
+  if (pSeq == NULL || pSeq->stage != pReq->stage) {
+    SStreamUpstreamSeq seq = {.stage = pReq->stage, .reqId = pReq->reqId - 1};
+    taosHashPut(pTask->pUpstreamSeq, &pReq->upstreamTaskId, sizeof(int32_t), &seq, sizeof(SStreamUpstreamSeq));
+    return STREAM_UPSTREAM_SEQ__NEXT;
+  }
+
+  if (pReq->reqId <= pSeq->reqId) return STREAM_UPSTREAM_SEQ__DUP;
+  if (pReq->reqId > pSeq->reqId + 1) return STREAM_UPSTREAM_SEQ__GAP;
+  return STREAM_UPSTREAM_SEQ__NEXT;
+}
+
+void streamUpdateUpstreamSeq(SStreamTask* pTask, const SStreamDispatchReq* pReq) {
+  if (pReq->reqId == 0 || pTask->pUpstreamSeq == NULL) return;
+  SStreamUpstreamSeq* pSeq = taosHashGet(pTask->pUpstreamSeq, &pReq->upstreamTaskId, sizeof(int32_t));
+  if (pSeq != NULL) pSeq->reqId = pReq->reqId;
+}
+
+int32_t streamTaskEnqueue(SStreamTask* pTask, const SStreamDispatchReq* pReq, SRpcMsg* pRsp) {
+  int8_t status = TASK_INPUT_STATUS__NORMAL;
+
+  // take the reqs of an upstream task in reqId order. A req refused by the input queue is sent again ahead of the
+  // reqs in flight behind it, so those are refused too, and a req taken before is acked again without its data.
+  taosWLockLatch(&pTask->upstreamSeqLock);
+  int8_t seq = streamCheckUpstreamSeq(pTask, pReq);
+  if (seq == STREAM_UPSTREAM_SEQ__DUP) {
+    qDebug("task %d recv dispatch req from task %d, reqId %" PRId64 " already taken", pTask->taskId,
+           pReq->upstreamTaskId, pReq->reqId);
+  } else if (seq == STREAM_UPSTREAM_SEQ__GAP) {
+    qDebug("task %d recv dispatch req from task %d, reqId %" PRId64 " out of sequence", pTask->taskId,
+           pReq->upstreamTaskId, pReq->reqId);
+    status = TASK_INPUT_STATUS__FAILED;
+  } else {
+    SStreamDataBlock* pData = taosAllocateQitem(sizeof(SStreamDataBlock), DEF_QITEM, 0);
+
+    // enqueue
+    if (pData != NULL) {
+      pData->type = STREAM_INPUT__DATA_BLOCK;
+      pData->srcVgId = pReq->dataSrcVgId;
+      // decode
+      /*pData->blocks = pReq->data;*/
+      /*pBlock->sourceVer = pReq->sourceVer;*/
+      streamDispatchReqToData(pReq, pData);
+      if (streamTaskInput(pTask, (SStreamQueueItem*)pData) == 0) {
+        status = TASK_INPUT_STATUS__NORMAL;
+        streamUpdateUpstreamSeq(pTask, pReq);
+      } else {
+        status = TASK_INPUT_STATUS__FAILED;
+      }
     } else {
+      streamTaskInputFail(pTask);
       status = TASK_INPUT_STATUS__FAILED;
     }
-  } else {
-    streamTaskInputFail(pTask);
-    status = TASK_INPUT_STATUS__FAILED;
   }
+  taosWUnLockLatch(&pTask->upstreamSeqLock);
 
   // rsp by input status
   void* buf = rpcMallocCont(sizeof(SMsgHead) + sizeof(SStreamDispatchRsp));
@@ -143,6 +205,7 @@ int32_t streamTaskEnqueue(SStreamTask* pTask, const SStreamDispatchReq* pReq, SR
   pCont->upstreamTaskId = htonl(pReq->upstreamTaskId);
   pCont->downstreamNodeId = htonl(pTask->nodeId);
   pCont->downstreamTaskId = htonl(pTask->taskId);
+  pCont->reqId = htobe64(pReq->reqId);
   pRsp->pCont = buf;
   pRsp->contLen = sizeof(SMsgHead) + sizeof(SStreamDispatchRsp);
   tmsgSendRsp(pRsp);
@@ -226,25 +289,17 @@ int32_t streamProcessDispatchReq(SStreamTask* pTask, SStreamDispatchReq* pReq, S
   return 0;
 }
 
-int32_t streamProcessDispatchRsp(SStreamTask* pTask, SStreamDispatchRsp* pRsp, int32_t code) {
-  ASSERT(pRsp->inputStatus == TASK_OUTPUT_STATUS__NORMAL || pRsp->inputStatus == TASK_OUTPUT_STATUS__BLOCKED);
-
+int32_t streamProcessDispatchRsp(SStreamTask* pTask, SStreamDispatchRsp* pRsp, int32_t rspLen, int32_t code) {
   qDebug("task %d receive dispatch rsp, code: %x", pTask->taskId, code);
 
-  if (pTask->outputType == TASK_OUTPUT__SHUFFLE_DISPATCH) {
-    int32_t leftRsp = atomic_sub_fetch_32(&pTask->shuffleDispatcher.waitingRspCnt, 1);
-    qDebug("task %d is shuffle, left waiting rsp %d", pTask->taskId, leftRsp);
-    if (leftRsp > 0) return 0;
+  // a downstream task before reqId sends a shorter rsp
+  int64_t reqId = 0;
+  if (rspLen >= (int32_t)(offsetof(SStreamDispatchRsp, reqId) + sizeof(int64_t))) {
+    reqId = be64toh(pRsp->reqId);
   }
 
-  int8_t old = atomic_exchange_8(&pTask->outputStatus, pRsp->inputStatus);
-  ASSERT(old == TASK_OUTPUT_STATUS__WAIT);
-  if (pRsp->inputStatus == TASK_INPUT_STATUS__BLOCKED) {
-    // TODO: init recover timer
-    ASSERT(0);
-    return 0;
-  }
-  // continue dispatch
+  // return the credit of the downstream task and continue dispatch
+  streamDispatchRelease(pTask, ntohl(pRsp->downstreamTaskId), reqId, pRsp->inputStatus);
   streamDispatch(pTask);
   return 0;
 }
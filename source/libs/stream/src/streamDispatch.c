@@ -32,6 +32,8 @@ int32_t tEncodeStreamDispatchReq(SEncoder* pEncoder, const SStreamDispatchReq* p
     if (tEncodeI32(pEncoder, len) < 0) return -1;
     if (tEncodeBinary(pEncoder, data, len) < 0) return -1;
   }
+  if (tEncodeI64(pEncoder, pReq->reqId) < 0) return -1;
+  if (tEncodeI64(pEncoder, pReq->stage) < 0) return -1;
   tEndEncode(pEncoder);
   return pEncoder->pos;
 }
@@ -58,6 +60,14 @@ int32_t tDecodeStreamDispatchReq(SDecoder* pDecoder, SStreamDispatchReq* pReq) {
     taosArrayPush(pReq->dataLen, &len1);
     taosArrayPush(pReq->data, &data);
   }
+  pReq->reqId = 0;
+  if (!tDecodeIsEnd(pDecoder)) {
+    if (tDecodeI64(pDecoder, &pReq->reqId) < 0) return -1;
+  }
+  pReq->stage = 0;
+  if (!tDecodeIsEnd(pDecoder)) {
+    if (tDecodeI64(pDecoder, &pReq->stage) < 0) return -1;
+  }
   tEndDecode(pDecoder);
   return 0;
 }
@@ -330,196 +340,527 @@ FAIL:
   return code;
 }
 
-int32_t streamSearchAndAddBlock(SStreamTask* pTask, SStreamDispatchReq* pReqs, SSDataBlock* pDataBlock, int32_t vgSz,
-                                int64_t groupId) {
-  char* ctbName = taosMemoryCalloc(1, TSDB_TABLE_FNAME_LEN);
-  if (ctbName == NULL) {
-    return -1;
+// vgroups are sorted by hash range in tDecodeSStreamTask
+static int32_t streamSearchVgroup(SArray* vgInfo, uint32_t hashValue) {
+  int32_t l = 0;
+  int32_t r = taosArrayGetSize(vgInfo) - 1;
+  while (l <= r) {
+    int32_t      m = (l + r) >> 1;
+    SVgroupInfo* pVgInfo = taosArrayGet(vgInfo, m);
+    if (hashValue < pVgInfo->hashBegin) {
+      r = m - 1;
+    } else if (hashValue > pVgInfo->hashEnd) {
+      l = m + 1;
+    } else {
+      return m;
+    }
+  }
+  return -1;
+}
+
+static int32_t streamGetGroupVgIdx(SStreamTask* pTask, int64_t groupId, const char* tbName, int32_t tbNameLen,
+                                   int32_t* pIdx) {
+  char    key[sizeof(int64_t) + TSDB_TABLE_NAME_LEN];
+  int32_t keyLen = sizeof(int64_t) + TMIN(tbNameLen, TSDB_TABLE_NAME_LEN);
+
+  *(int64_t*)key = groupId;
+  if (tbNameLen > 0) memcpy(key + sizeof(int64_t), tbName, keyLen - sizeof(int64_t));
+
+  if (pTask->pVgCache == NULL) {
+    pTask->pVgCache = taosHashInit(64, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+    if (pTask->pVgCache == NULL) return -1;
   }
 
-  if (pDataBlock->info.parTbName[0]) {
-    snprintf(ctbName, TSDB_TABLE_NAME_LEN, "%s.%s", pTask->shuffleDispatcher.dbInfo.db, pDataBlock->info.parTbName);
+  int32_t* pCached = taosHashGet(pTask->pVgCache, key, keyLen);
+  if (pCached) {
+    *pIdx = *pCached;
+    return 0;
+  }
+
+  char ctbName[TSDB_TABLE_FNAME_LEN] = {0};
+  if (tbNameLen > 0) {
+    snprintf(ctbName, TSDB_TABLE_FNAME_LEN, "%s.%.*s", pTask->shuffleDispatcher.dbInfo.db, tbNameLen, tbName);
   } else {
     char* ctbShortName = buildCtbNameByGroupId(pTask->shuffleDispatcher.stbFullName, groupId);
-    snprintf(ctbName, TSDB_TABLE_NAME_LEN, "%s.%s", pTask->shuffleDispatcher.dbInfo.db, ctbShortName);
+    if (ctbShortName == NULL) return -1;
+    snprintf(ctbName, TSDB_TABLE_FNAME_LEN, "%s.%s", pTask->shuffleDispatcher.dbInfo.db, ctbShortName);
     taosMemoryFree(ctbShortName);
   }
 
-  SArray* vgInfo = pTask->shuffleDispatcher.dbInfo.pVgroupInfos;
-
   /*uint32_t hashValue = MurmurHash3_32(ctbName, strlen(ctbName));*/
   SUseDbRsp* pDbInfo = &pTask->shuffleDispatcher.dbInfo;
   uint32_t   hashValue =
       taosGetTbHashVal(ctbName, strlen(ctbName), pDbInfo->hashMethod, pDbInfo->hashPrefix, pDbInfo->hashSuffix);
-  taosMemoryFree(ctbName);
 
-  bool found = false;
-  // TODO: optimize search
+  *pIdx = streamSearchVgroup(pDbInfo->pVgroupInfos, hashValue);
+  ASSERT(*pIdx >= 0);
+  if (*pIdx < 0) return -1;
+
+  if (taosHashGetSize(pTask->pVgCache) >= STREAM_DISPATCH_MAX_CACHED_GROUPS) {
+    taosHashClear(pTask->pVgCache);
+  }
+  taosHashPut(pTask->pVgCache, key, keyLen, pIdx, sizeof(int32_t));
+  return 0;
+}
+
+int32_t streamSearchAndAddBlock(SStreamTask* pTask, SStreamDispatchReq* pReqs, SSDataBlock* pDataBlock, int32_t vgSz,
+                                int64_t groupId) {
   int32_t j;
-  for (j = 0; j < vgSz; j++) {
-    SVgroupInfo* pVgInfo = taosArrayGet(vgInfo, j);
-    ASSERT(pVgInfo->vgId > 0);
-    if (hashValue >= pVgInfo->hashBegin && hashValue <= pVgInfo->hashEnd) {
-      if (streamAddBlockToDispatchMsg(pDataBlock, &pReqs[j]) < 0) {
-        return -1;
-      }
-      if (pReqs[j].blockNum == 0) {
-        atomic_add_fetch_32(&pTask->shuffleDispatcher.waitingRspCnt, 1);
+  if (streamGetGroupVgIdx(pTask, groupId, pDataBlock->info.parTbName, strlen(pDataBlock->info.parTbName), &j) < 0) {
+    return -1;
+  }
+  ASSERT(j < vgSz);
+
+  if (streamAddBlockToDispatchMsg(pDataBlock, &pReqs[j]) < 0) {
+    return -1;
+  }
+  pReqs[j].blockNum++;
+  return 0;
+}
+
+// route each row of a delete result block to the vgroup owning its table only
+static int32_t streamSplitAndAddDeleteBlock(SStreamTask* pTask, SStreamDispatchReq* pReqs, SSDataBlock* pDataBlock,
+                                            int32_t vgSz) {
+  int32_t          code = -1;
+  int32_t          nRows = pDataBlock->info.rows;
+  int32_t*         aVgIdx = NULL;
+  int32_t*         aVgRows = NULL;
+  SColumnInfoData* pGidCol = taosArrayGet(pDataBlock->pDataBlock, GROUPID_COLUMN_INDEX);
+  SColumnInfoData* pTbNameCol = NULL;
+
+  if (taosArrayGetSize(pDataBlock->pDataBlock) > TABLE_NAME_COLUMN_INDEX) {
+    pTbNameCol = taosArrayGet(pDataBlock->pDataBlock, TABLE_NAME_COLUMN_INDEX);
+  }
+
+  aVgIdx = taosMemoryMalloc(sizeof(int32_t) * TMAX(nRows, 1));
+  aVgRows = taosMemoryCalloc(vgSz, sizeof(int32_t));
+  if (aVgIdx == NULL || aVgRows == NULL) goto _exit;
+
+  for (int32_t row = 0; row < nRows; row++) {
+    int64_t groupId = *(int64_t*)colDataGetData(pGidCol, row);
+    char*   tbName = NULL;
+    int32_t tbNameLen = 0;
+    if (pTbNameCol && !colDataIsNull(pTbNameCol, nRows, row, NULL)) {
+      char* varTbName = colDataGetVarData(pTbNameCol, row);
+      tbName = varDataVal(varTbName);
+      tbNameLen = varDataLen(varTbName);
+    }
+
+    if (streamGetGroupVgIdx(pTask, groupId, tbName, tbNameLen, &aVgIdx[row]) < 0) goto _exit;
+    aVgRows[aVgIdx[row]]++;
+  }
+
+  for (int32_t j = 0; j < vgSz; j++) {
+    if (aVgRows[j] == 0) continue;
+
+    SSDataBlock* pVgBlock = createOneDataBlock(pDataBlock, false);
+    if (pVgBlock == NULL || blockDataEnsureCapacity(pVgBlock, aVgRows[j]) != 0) {
+      blockDataDestroy(pVgBlock);
+      goto _exit;
+    }
+
+    int32_t nCols = taosArrayGetSize(pDataBlock->pDataBlock);
+    for (int32_t row = 0; row < nRows; row++) {
+      if (aVgIdx[row] != j) continue;
+      for (int32_t iCol = 0; iCol < nCols; iCol++) {
+        SColumnInfoData* pSrc = taosArrayGet(pDataBlock->pDataBlock, iCol);
+        SColumnInfoData* pDst = taosArrayGet(pVgBlock->pDataBlock, iCol);
+        bool             isNull = colDataIsNull(pSrc, nRows, row, NULL);
+        colDataAppend(pDst, pVgBlock->info.rows, isNull ? NULL : colDataGetData(pSrc, row), isNull);
       }
-      pReqs[j].blockNum++;
-      found = true;
-      break;
+      pVgBlock->info.rows++;
+    }
+
+    int32_t ret = streamAddBlockToDispatchMsg(pVgBlock, &pReqs[j]);
+    blockDataDestroy(pVgBlock);
+    if (ret < 0) goto _exit;
+    pReqs[j].blockNum++;
+  }
+  code = 0;
+
+_exit:
+  taosMemoryFree(aVgIdx);
+  taosMemoryFree(aVgRows);
+  return code;
+}
+
+static void streamDestroyDispatchDest(void* p) {
+  SStreamDispatchDest* pDest = (SStreamDispatchDest*)p;
+  for (int32_t i = 0; i < taosArrayGetSize(pDest->pending); i++) {
+    tDeleteStreamDispatchReq(&((SStreamDispatchEntry*)taosArrayGet(pDest->pending, i))->req);
+  }
+  taosArrayDestroy(pDest->pending);
+}
+
+void streamClearDispatchDest(SStreamTask* pTask) {
+  taosArrayDestroyEx(pTask->dispatchDest, streamDestroyDispatchDest);
+  pTask->dispatchDest = NULL;
+  taosHashCleanup(pTask->pVgCache);
+  pTask->pVgCache = NULL;
+}
+
+static int32_t streamInitDispatchDest(SStreamTask* pTask) {
+  if (pTask->dispatchDest) return 0;
+
+  int32_t nDest = 1;
+  if (pTask->outputType == TASK_OUTPUT__SHUFFLE_DISPATCH) {
+    nDest = taosArrayGetSize(pTask->shuffleDispatcher.dbInfo.pVgroupInfos);
+  }
+
+  pTask->dispatchDest = taosArrayInit(nDest, sizeof(SStreamDispatchDest));
+  if (pTask->dispatchDest == NULL) return -1;
+
+  // reqIds start over from 1, tell the downstream tasks by a new stage
+  int64_t stage = taosGetTimestampUs();
+  for (int32_t i = 0; i < nDest; i++) {
+    SStreamDispatchDest dest = {.credit = STREAM_DISPATCH_MAX_CREDIT, .stage = stage};
+    if (pTask->outputType == TASK_OUTPUT__SHUFFLE_DISPATCH) {
+      SVgroupInfo* pVgInfo = taosArrayGet(pTask->shuffleDispatcher.dbInfo.pVgroupInfos, i);
+      dest.taskId = pVgInfo->taskId;
+      dest.nodeId = pVgInfo->vgId;
+    } else {
+      dest.taskId = pTask->fixedEpDispatcher.taskId;
+      dest.nodeId = pTask->fixedEpDispatcher.nodeId;
+    }
+    dest.pending = taosArrayInit(STREAM_DISPATCH_MAX_PENDING, sizeof(SStreamDispatchEntry));
+    if (dest.pending == NULL || taosArrayPush(pTask->dispatchDest, &dest) == NULL) {
+      taosArrayDestroy(dest.pending);
+      streamClearDispatchDest(pTask);
+      return -1;
     }
   }
-  ASSERT(found);
   return 0;
 }
 
+static bool streamDispatchDestFull(SStreamTask* pTask) {
+  for (int32_t i = 0; i < taosArrayGetSize(pTask->dispatchDest); i++) {
+    SStreamDispatchDest* pDest = taosArrayGet(pTask->dispatchDest, i);
+    if (taosArrayGetSize(pDest->pending) >= STREAM_DISPATCH_MAX_PENDING) return true;
+  }
+  return false;
+}
+
+// split the output of one exec into a dispatch req per downstream task and queue them on the destinations
 int32_t streamDispatchAllBlocks(SStreamTask* pTask, const SStreamDataBlock* pData) {
   int32_t code = -1;
   int32_t blockNum = taosArrayGetSize(pData->blocks);
+  int32_t nDest = taosArrayGetSize(pTask->dispatchDest);
   ASSERT(blockNum != 0);
 
-  if (pTask->outputType == TASK_OUTPUT__FIXED_DISPATCH) {
-    SStreamDispatchReq req = {
-        .streamId = pTask->streamId,
-        .dataSrcVgId = pData->srcVgId,
-        .upstreamTaskId = pTask->taskId,
-        .upstreamChildId = pTask->selfChildId,
-        .upstreamNodeId = pTask->nodeId,
-        .blockNum = blockNum,
-    };
+  SStreamDispatchReq* pReqs = taosMemoryCalloc(nDest, sizeof(SStreamDispatchReq));
+  if (pReqs == NULL) {
+    return -1;
+  }
 
-    req.data = taosArrayInit(blockNum, sizeof(void*));
-    req.dataLen = taosArrayInit(blockNum, sizeof(int32_t));
-    if (req.data == NULL || req.dataLen == NULL) {
-      goto FAIL_FIXED_DISPATCH;
+  for (int32_t i = 0; i < nDest; i++) {
+    SStreamDispatchDest* pDest = taosArrayGet(pTask->dispatchDest, i);
+    pReqs[i].streamId = pTask->streamId;
+    pReqs[i].dataSrcVgId = pData->srcVgId;
+    pReqs[i].upstreamTaskId = pTask->taskId;
+    pReqs[i].upstreamChildId = pTask->selfChildId;
+    pReqs[i].upstreamNodeId = pTask->nodeId;
+    pReqs[i].blockNum = 0;
+    pReqs[i].taskId = pDest->taskId;
+    pReqs[i].data = taosArrayInit(0, sizeof(void*));
+    pReqs[i].dataLen = taosArrayInit(0, sizeof(int32_t));
+    if (pReqs[i].data == NULL || pReqs[i].dataLen == NULL) {
+      goto _exit;
     }
+  }
 
-    for (int32_t i = 0; i < blockNum; i++) {
-      SSDataBlock* pDataBlock = taosArrayGet(pData->blocks, i);
-      if (streamAddBlockToDispatchMsg(pDataBlock, &req) < 0) {
-        goto FAIL_FIXED_DISPATCH;
+  for (int32_t i = 0; i < blockNum; i++) {
+    SSDataBlock* pDataBlock = taosArrayGet(pData->blocks, i);
+
+    if (pTask->outputType == TASK_OUTPUT__FIXED_DISPATCH) {
+      if (streamAddBlockToDispatchMsg(pDataBlock, &pReqs[0]) < 0) {
+        goto _exit;
       }
+      pReqs[0].blockNum++;
+      continue;
     }
-    int32_t vgId = pTask->fixedEpDispatcher.nodeId;
-    SEpSet* pEpSet = &pTask->fixedEpDispatcher.epSet;
-    int32_t downstreamTaskId = pTask->fixedEpDispatcher.taskId;
 
-    req.taskId = downstreamTaskId;
+    if (pDataBlock->info.type == STREAM_DELETE_RESULT) {
+      if (streamSplitAndAddDeleteBlock(pTask, pReqs, pDataBlock, nDest) < 0) {
+        goto _exit;
+      }
+      continue;
+    }
+
+    if (streamSearchAndAddBlock(pTask, pReqs, pDataBlock, nDest, pDataBlock->info.id.groupId) < 0) {
+      goto _exit;
+    }
+  }
 
-    qDebug("dispatch from task %d (child id %d) to down stream task %d in vnode %d", pTask->taskId, pTask->selfChildId,
-           downstreamTaskId, vgId);
+  for (int32_t i = 0; i < nDest; i++) {
+    if (pReqs[i].blockNum == 0) continue;
 
-    if (streamDispatchOneDataReq(pTask, &req, vgId, pEpSet) < 0) {
-      goto FAIL_FIXED_DISPATCH;
+    SStreamDispatchDest* pDest = taosArrayGet(pTask->dispatchDest, i);
+    SStreamDispatchEntry entry = {.sent = 0, .req = pReqs[i]};
+    entry.req.reqId = pDest->reqId + 1;
+    entry.req.stage = pDest->stage;
+    if (taosArrayPush(pDest->pending, &entry) == NULL) {
+      goto _exit;
     }
-    code = 0;
-  FAIL_FIXED_DISPATCH:
-    taosArrayDestroyP(req.data, taosMemoryFree);
-    taosArrayDestroy(req.dataLen);
-    return code;
-
-  } else if (pTask->outputType == TASK_OUTPUT__SHUFFLE_DISPATCH) {
-    int32_t rspCnt = atomic_load_32(&pTask->shuffleDispatcher.waitingRspCnt);
-    ASSERT(rspCnt == 0);
-
-    SArray*             vgInfo = pTask->shuffleDispatcher.dbInfo.pVgroupInfos;
-    int32_t             vgSz = taosArrayGetSize(vgInfo);
-    SStreamDispatchReq* pReqs = taosMemoryCalloc(vgSz, sizeof(SStreamDispatchReq));
-    if (pReqs == NULL) {
-      return -1;
+    pDest->reqId++;
+    pReqs[i].data = NULL;
+    pReqs[i].dataLen = NULL;
+  }
+  code = 0;
+
+_exit:
+  for (int32_t i = 0; i < nDest; i++) {
+    taosArrayDestroyP(pReqs[i].data, taosMemoryFree);
+    taosArrayDestroy(pReqs[i].dataLen);
+  }
+  taosMemoryFree(pReqs);
+  return code;
+}
+
+typedef struct {
+  int32_t            iDest;
+  int32_t            nodeId;
+  SEpSet             epSet;
+  SStreamDispatchReq req;  // shares the data of the queued req, which stays until the send returns
+  int32_t            code;
+} SStreamDispatchSend;
+
+static SStreamDispatchEntry* streamFindDispatchEntry(SStreamDispatchDest* pDest, int64_t reqId, int32_t* pIdx) {
+  for (int32_t i = 0; i < taosArrayGetSize(pDest->pending); i++) {
+    SStreamDispatchEntry* pEntry = taosArrayGet(pDest->pending, i);
+    if (pEntry->req.reqId == reqId) {
+      if (pIdx) *pIdx = i;
+      return pEntry;
     }
+  }
+  return NULL;
+}
 
-    for (int32_t i = 0; i < vgSz; i++) {
-      pReqs[i].streamId = pTask->streamId;
-      pReqs[i].dataSrcVgId = pData->srcVgId;
-      pReqs[i].upstreamTaskId = pTask->taskId;
-      pReqs[i].upstreamChildId = pTask->selfChildId;
-      pReqs[i].upstreamNodeId = pTask->nodeId;
-      pReqs[i].blockNum = 0;
-      pReqs[i].data = taosArrayInit(0, sizeof(void*));
-      pReqs[i].dataLen = taosArrayInit(0, sizeof(int32_t));
-      if (pReqs[i].data == NULL || pReqs[i].dataLen == NULL) {
-        goto FAIL_SHUFFLE_DISPATCH;
-      }
-      SVgroupInfo* pVgInfo = taosArrayGet(vgInfo, i);
-      pReqs[i].taskId = pVgInfo->taskId;
+static void streamDispatchEntryDone(SStreamTask* pTask, SStreamDispatchDest* pDest, SStreamDispatchEntry* pEntry) {
+  if (!pEntry->sent) return;
+  pEntry->sent = 0;
+  pDest->inFlight--;
+  if (pTask->outputType == TASK_OUTPUT__SHUFFLE_DISPATCH) {
+    atomic_sub_fetch_32(&pTask->shuffleDispatcher.waitingRspCnt, 1);
+  }
+}
+
+// pick the queued reqs of each destination to send as long as it has credit left, in reqId order. The caller holds
+// the dispatch lock, the reqs are sent after it is released.
+static int32_t streamDispatchPick(SStreamTask* pTask, SArray* pSends) {
+  bool retry = false;
+
+  for (int32_t i = 0; i < taosArrayGetSize(pTask->dispatchDest); i++) {
+    SStreamDispatchDest* pDest = taosArrayGet(pTask->dispatchDest, i);
+    int32_t              nPending = taosArrayGetSize(pDest->pending);
+
+    if (pDest->hold) {
+      retry = true;
+      continue;
     }
 
-    for (int32_t i = 0; i < blockNum; i++) {
-      SSDataBlock* pDataBlock = taosArrayGet(pData->blocks, i);
-
-      // TODO: do not use broadcast
-      if (pDataBlock->info.type == STREAM_DELETE_RESULT) {
-        for (int32_t j = 0; j < vgSz; j++) {
-          if (streamAddBlockToDispatchMsg(pDataBlock, &pReqs[j]) < 0) {
-            goto FAIL_SHUFFLE_DISPATCH;
-          }
-          if (pReqs[j].blockNum == 0) {
-            atomic_add_fetch_32(&pTask->shuffleDispatcher.waitingRspCnt, 1);
-          }
-          pReqs[j].blockNum++;
-        }
-        continue;
+    SEpSet* pEpSet = &pTask->fixedEpDispatcher.epSet;
+    if (pTask->outputType == TASK_OUTPUT__SHUFFLE_DISPATCH) {
+      pEpSet = &((SVgroupInfo*)taosArrayGet(pTask->shuffleDispatcher.dbInfo.pVgroupInfos, i))->epSet;
+    }
+
+    for (int32_t j = 0; j < nPending && pDest->inFlight < pDest->credit; j++) {
+      SStreamDispatchEntry* pEntry = taosArrayGet(pDest->pending, j);
+      if (pEntry->sent || pEntry->accepted) continue;
+      // still in the hands of another sender, nothing behind it may pass it
+      if (pEntry->sending) break;
+
+      qDebug("dispatch from task %d (child id %d) to down stream task %d in vnode %d, reqId %" PRId64
+             ", in flight %d credit %d",
+             pTask->taskId, pTask->selfChildId, pDest->taskId, pDest->nodeId, pEntry->req.reqId, pDest->inFlight,
+             pDest->credit);
+
+      SStreamDispatchSend send = {.iDest = i, .nodeId = pDest->nodeId, .epSet = *pEpSet, .req = pEntry->req};
+      if (taosArrayPush(pSends, &send) == NULL) {
+        retry = true;
+        break;
+      }
+      pEntry->sent = 1;
+      pEntry->sending = 1;
+      pDest->inFlight++;
+      if (pTask->outputType == TASK_OUTPUT__SHUFFLE_DISPATCH) {
+        atomic_add_fetch_32(&pTask->shuffleDispatcher.waitingRspCnt, 1);
       }
+    }
+  }
+
+  return retry ? -1 : 0;
+}
 
-      if (streamSearchAndAddBlock(pTask, pReqs, pDataBlock, vgSz, pDataBlock->info.id.groupId) < 0) {
-        goto FAIL_SHUFFLE_DISPATCH;
+// encode and send the picked reqs without the dispatch lock. Once a req of a destination fails to send, the ones
+// behind it are not sent either.
+static void streamDispatchSendPicked(SStreamTask* pTask, SArray* pSends) {
+  int32_t failedDest = -1;
+  for (int32_t i = 0; i < taosArrayGetSize(pSends); i++) {
+    SStreamDispatchSend* pSend = taosArrayGet(pSends, i);
+    if (pSend->iDest == failedDest) {
+      pSend->code = -1;
+      continue;
+    }
+    pSend->code = streamDispatchOneDataReq(pTask, &pSend->req, pSend->nodeId, &pSend->epSet);
+    if (pSend->code < 0) {
+      qError("task %d failed to dispatch reqId %" PRId64 " to task %d since %s, retry later", pTask->taskId,
+             pSend->req.reqId, pSend->req.taskId, terrstr());
+      failedDest = pSend->iDest;
+    }
+  }
+}
+
+// hand the sent reqs back to the queues, the caller holds the dispatch lock
+static int32_t streamDispatchSendDone(SStreamTask* pTask, SArray* pSends) {
+  bool retry = false;
+
+  for (int32_t i = 0; i < taosArrayGetSize(pSends); i++) {
+    SStreamDispatchSend*  pSend = taosArrayGet(pSends, i);
+    SStreamDispatchDest*  pDest = taosArrayGet(pTask->dispatchDest, pSend->iDest);
+    int32_t               iEntry = 0;
+    SStreamDispatchEntry* pEntry = streamFindDispatchEntry(pDest, pSend->req.reqId, &iEntry);
+    ASSERT(pEntry != NULL && pEntry->sending);
+
+    pEntry->sending = 0;
+    if (pEntry->accepted) {
+      tDeleteStreamDispatchReq(&pEntry->req);
+      taosArrayRemove(pDest->pending, iEntry);
+      continue;
+    }
+    if (pSend->code < 0) {
+      streamDispatchEntryDone(pTask, pDest, pEntry);
+    }
+    if (!pEntry->sent) {
+      retry = true;
+    }
+  }
+
+  return retry ? -1 : 0;
+}
+
+int32_t streamDispatchRelease(SStreamTask* pTask, int32_t downstreamTaskId, int64_t reqId, int8_t inputStatus) {
+  taosWLockLatch(&pTask->dispatchLock);
+  for (int32_t i = 0; i < taosArrayGetSize(pTask->dispatchDest); i++) {
+    SStreamDispatchDest* pDest = taosArrayGet(pTask->dispatchDest, i);
+    if (pDest->taskId != downstreamTaskId) continue;
+
+    int32_t               iEntry = 0;
+    SStreamDispatchEntry* pEntry = NULL;
+    if (reqId == 0) {
+      // a downstream task before reqId answers with 0, which takes the oldest req sent
+      for (; iEntry < taosArrayGetSize(pDest->pending); iEntry++) {
+        pEntry = taosArrayGet(pDest->pending, iEntry);
+        if (pEntry->sent) break;
       }
+      if (iEntry == taosArrayGetSize(pDest->pending)) pEntry = NULL;
+    } else {
+      pEntry = streamFindDispatchEntry(pDest, reqId, &iEntry);
+    }
+    if (pEntry == NULL || pEntry->accepted) {
+      qDebug("task %d receive dispatch rsp from task %d for unknown reqId %" PRId64, pTask->taskId,
+             downstreamTaskId, reqId);
+      break;
     }
 
-    for (int32_t i = 0; i < vgSz; i++) {
-      if (pReqs[i].blockNum > 0) {
-        // send
-        SVgroupInfo* pVgInfo = taosArrayGet(vgInfo, i);
-        if (streamDispatchOneDataReq(pTask, &pReqs[i], pVgInfo->vgId, &pVgInfo->epSet) < 0) {
-          goto FAIL_SHUFFLE_DISPATCH;
+    // additive increase, multiplicative decrease
+    if (inputStatus == TASK_INPUT_STATUS__NORMAL) {
+      // the downstream takes the reqs in order, so the ones queued before are taken too and their rsps may still come
+      int32_t first = (reqId == 0) ? iEntry : 0;
+      for (int32_t j = iEntry; j >= first; j--) {
+        SStreamDispatchEntry* pTaken = taosArrayGet(pDest->pending, j);
+        streamDispatchEntryDone(pTask, pDest, pTaken);
+        if (pTaken->sending) {
+          pTaken->accepted = 1;
+        } else {
+          tDeleteStreamDispatchReq(&pTaken->req);
+          taosArrayRemove(pDest->pending, j);
         }
       }
-    }
-    code = 0;
-  FAIL_SHUFFLE_DISPATCH:
-    if (pReqs) {
-      for (int32_t i = 0; i < vgSz; i++) {
-        taosArrayDestroyP(pReqs[i].data, taosMemoryFree);
-        taosArrayDestroy(pReqs[i].dataLen);
+      pDest->credit = TMIN(pDest->credit + 1, STREAM_DISPATCH_MAX_CREDIT);
+    } else if (pEntry->sent) {
+      // The downstream refuses the reqs sent behind this one as well. Send them all again in order once the retry
+      // timer fires, their rsps still to come are stale.
+      for (int32_t j = iEntry; j < taosArrayGetSize(pDest->pending); j++) {
+        streamDispatchEntryDone(pTask, pDest, taosArrayGet(pDest->pending, j));
       }
-      taosMemoryFree(pReqs);
+      pDest->hold = 1;
+      pDest->credit = TMAX(pDest->credit / 2, 1);
     }
-    return code;
+
+    qDebug("task %d receive dispatch rsp from task %d, reqId %" PRId64 ", input status %d, in flight %d credit %d",
+           pTask->taskId, downstreamTaskId, reqId, inputStatus, pDest->inFlight, pDest->credit);
+    break;
   }
+  taosWUnLockLatch(&pTask->dispatchLock);
   return 0;
 }
 
+void streamDispatchResume(SStreamTask* pTask) {
+  taosWLockLatch(&pTask->dispatchLock);
+  for (int32_t i = 0; i < taosArrayGetSize(pTask->dispatchDest); i++) {
+    SStreamDispatchDest* pDest = taosArrayGet(pTask->dispatchDest, i);
+    pDest->hold = 0;
+  }
+  taosWUnLockLatch(&pTask->dispatchLock);
+
+  streamDispatch(pTask);
+}
+
 int32_t streamDispatch(SStreamTask* pTask) {
   ASSERT(pTask->outputType == TASK_OUTPUT__FIXED_DISPATCH || pTask->outputType == TASK_OUTPUT__SHUFFLE_DISPATCH);
 
-  int8_t old =
-      atomic_val_compare_exchange_8(&pTask->outputStatus, TASK_OUTPUT_STATUS__NORMAL, TASK_OUTPUT_STATUS__WAIT);
-  if (old != TASK_OUTPUT_STATUS__NORMAL) {
-    return 0;
-  }
+  int32_t code = 0;
 
-  SStreamDataBlock* pBlock = streamQueueNextItem(pTask->outputQueue);
-  if (pBlock == NULL) {
-    qDebug("stream stop dispatching since no output: task %d", pTask->taskId);
-    atomic_store_8(&pTask->outputStatus, TASK_OUTPUT_STATUS__NORMAL);
-    return 0;
+  taosWLockLatch(&pTask->dispatchLock);
+  if (streamInitDispatchDest(pTask) < 0) {
+    code = -1;
+    goto _exit;
   }
-  ASSERT(pBlock->type == STREAM_INPUT__DATA_BLOCK);
 
-  qDebug("stream dispatching: task %d", pTask->taskId);
+  // stop taking output when a destination falls behind, so the output queue applies backpressure
+  while (!streamDispatchDestFull(pTask)) {
+    SStreamDataBlock* pBlock = streamQueueNextItem(pTask->outputQueue);
+    if (pBlock == NULL) {
+      qDebug("stream stop dispatching since no output: task %d", pTask->taskId);
+      break;
+    }
+    ASSERT(pBlock->type == STREAM_INPUT__DATA_BLOCK);
 
-  int32_t code = 0;
-  if (streamDispatchAllBlocks(pTask, pBlock) < 0) {
+    qDebug("stream dispatching: task %d", pTask->taskId);
+
+    if (streamDispatchAllBlocks(pTask, pBlock) < 0) {
+      code = -1;
+      streamQueueProcessFail(pTask->outputQueue);
+      break;
+    }
+    streamQueueProcessSuccess(pTask->outputQueue);
+    taosArrayDestroyEx(pBlock->blocks, (FDelete)blockDataFreeRes);
+    taosFreeQitem(pBlock);
+  }
+
+  // reserve the credit under the lock, encode and send without it
+  SArray* pSends = taosArrayInit(STREAM_DISPATCH_MAX_CREDIT, sizeof(SStreamDispatchSend));
+  if (pSends == NULL) {
     code = -1;
-    streamQueueProcessFail(pTask->outputQueue);
-    atomic_store_8(&pTask->outputStatus, TASK_OUTPUT_STATUS__NORMAL);
-    goto FREE;
+    goto _exit;
+  }
+  bool retry = streamDispatchPick(pTask, pSends) < 0;
+  taosWUnLockLatch(&pTask->dispatchLock);
+
+  if (taosArrayGetSize(pSends) > 0) {
+    streamDispatchSendPicked(pTask, pSends);
+    taosWLockLatch(&pTask->dispatchLock);
+    retry = (streamDispatchSendDone(pTask, pSends) < 0) || retry;
+    taosWUnLockLatch(&pTask->dispatchLock);
   }
-FREE:
-  taosArrayDestroyEx(pBlock->blocks, (FDelete)blockDataFreeRes);
-  taosFreeQitem(pBlock);
+  taosArrayDestroy(pSends);
+
+  if (retry) {
+    streamDispatchRetryLater(pTask);
+  }
+  return code;
+
+_exit:
+  taosWUnLockLatch(&pTask->dispatchLock);
   return code;
 }
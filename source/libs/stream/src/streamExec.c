@@ -26,6 +26,16 @@ static int32_t streamTaskExecImpl(SStreamTask* pTask, const void* data, SArray*
     continue;
   }
 
+  // the state committed by this batch covers the wal up to the version of its last submit. It is set once the replay on
+  // restart is done, which commits the state up to the replay end.
+  if (pTask->pState != NULL) {
+    if (((SStreamQueueItem*)data)->type == STREAM_INPUT__DATA_SUBMIT) {
+      streamStateSetProcessedVer(pTask->pState, ((SStreamDataSubmit2*)data)->ver);
+    } else if (((SStreamQueueItem*)data)->type == STREAM_INPUT__MERGED_SUBMIT) {
+      streamStateSetProcessedVer(pTask->pState, ((SStreamMergedSubmit2*)data)->ver);
+    }
+  }
+
   // set input
   const SStreamQueueItem* pItem = (const SStreamQueueItem*)data;
   if (pItem->type == STREAM_INPUT__GET_RES) {
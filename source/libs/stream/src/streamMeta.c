@@ -83,6 +83,10 @@ void streamMetaClose(SStreamMeta* pMeta) {
       taosTmrStop(pTask->timer);
       pTask->timer = NULL;
     }
+    if (pTask->dispatchTimer) {
+      taosTmrStop(pTask->dispatchTimer);
+      pTask->dispatchTimer = NULL;
+    }
     tFreeSStreamTask(pTask);
     /*streamMetaReleaseTask(pMeta, pTask);*/
   }
@@ -264,7 +268,9 @@ int32_t streamMetaAbort(SStreamMeta* pMeta) {
   return 0;
 }
 
-int32_t streamLoadTasks(SStreamMeta* pMeta, int64_t ver) {
+// the checkpointed source tasks replay the wal tail up to replayVer, the version durable in tsdb, from the tsdb. The
+// later versions are applied again when the vnode restarts and reach the tasks through the push path.
+int32_t streamLoadTasks(SStreamMeta* pMeta, int64_t ver, int64_t replayVer) {
   TBC* pCur = NULL;
   if (tdbTbcOpen(pMeta->pTaskDb, &pCur, NULL) < 0) {
     return -1;
@@ -307,6 +313,13 @@ int32_t streamLoadTasks(SStreamMeta* pMeta, int64_t ver) {
     if (pTask->fillHistory) {
       pTask->taskStatus = TASK_STATUS__WAIT_DOWNSTREAM;
       streamTaskCheckDownstream(pTask, ver);
+    } else if (pTask->taskLevel == TASK_LEVEL__SOURCE && pTask->pState != NULL &&
+               streamStateGetCheckpointVer(pTask->pState) >= 0 &&
+               streamStateGetCheckpointVer(pTask->pState) < replayVer) {
+      // resume from the last checkpoint instead of rebuilding the state
+      streamStateBeginReplay(pTask->pState, replayVer);
+      pTask->taskStatus = TASK_STATUS__WAIT_DOWNSTREAM;
+      streamTaskCheckDownstream(pTask, ver);
     }
   }
 
@@ -19,8 +19,12 @@ int32_t streamTaskLaunchRecover(SStreamTask* pTask, int64_t version) {
   qDebug("task %d at node %d launch recover", pTask->taskId, pTask->nodeId);
   if (pTask->taskLevel == TASK_LEVEL__SOURCE) {
     atomic_store_8(&pTask->taskStatus, TASK_STATUS__RECOVER_PREPARE);
-    streamSetParamForRecover(pTask);
-    streamSourceRecoverPrepareStep1(pTask, version);
+    if (pTask->fillHistory) {
+      streamSetParamForRecover(pTask);
+      streamSourceRecoverPrepareStep1(pTask, version);
+    } else {
+      streamSourceReplayPrepare(pTask);
+    }
 
     SStreamRecoverStep1Req req;
     streamBuildSourceRecover1Req(pTask, &req);
@@ -178,6 +182,31 @@ int32_t streamSourceRecoverPrepareStep1(SStreamTask* pTask, int64_t ver) {
   return qStreamSourceRecoverStep1(exec, ver);
 }
 
+// replay only the wal tail written after the last checkpoint of the task state, up to the version set by
+// streamLoadTasks
+int32_t streamSourceReplayPrepare(SStreamTask* pTask) {
+  void*   exec = pTask->exec.executor;
+  int64_t checkpointVer = streamStateGetCheckpointVer(pTask->pState);
+  int64_t ver = streamStateGetReplayVer(pTask->pState);
+  qDebug("task %d at node %d replay from checkpoint ver %" PRId64 " to %" PRId64, pTask->taskId, pTask->nodeId,
+         checkpointVer, ver);
+  if (qStreamSourceRecoverStep1(exec, checkpointVer) < 0) {
+    return -1;
+  }
+  return qStreamSourceRecoverStep2(exec, ver);
+}
+
+// commit the replayed state with the checkpoint at the replay end
+int32_t streamSourceReplayFinish(SStreamTask* pTask) {
+  if (streamStateEndReplay(pTask->pState) < 0) {
+    qError("task %d at node %d failed to commit the replayed state", pTask->taskId, pTask->nodeId);
+    return -1;
+  }
+  qDebug("task %d at node %d replay finished, checkpoint ver %" PRId64, pTask->taskId, pTask->nodeId,
+         streamStateGetCheckpointVer(pTask->pState));
+  return 0;
+}
+
 int32_t streamBuildSourceRecover1Req(SStreamTask* pTask, SStreamRecoverStep1Req* pReq) {
   pReq->msgHead.vgId = pTask->nodeId;
   pReq->streamId = pTask->streamId;
@@ -30,6 +30,17 @@ typedef struct SStateSessionKey {
   int64_t     opNum;
 } SStateSessionKey;
 
+// checkpoint record, committed in the same txn as the state it describes
+#define STREAM_STATE_CHECKPOINT_KEY 0
+
+typedef struct SStateCheckpoint {
+  int64_t id;
+  int64_t ver;
+} SStateCheckpoint;
+
+static void    streamStateLoadCheckpoint(SStreamState* pState);
+static int32_t streamStatePutCheckpoint(STdbState* pTdbState, SStateCheckpoint* pCheckpoint);
+
 static inline int sessionRangeKeyCmpr(const SSessionKey* pWin1, const SSessionKey* pWin2) {
   if (pWin1->groupId > pWin2->groupId) {
     return 1;
@@ -188,6 +199,13 @@ SStreamState* streamStateOpen(char* path, SStreamTask* pTask, bool specPath, int
     goto _err;
   }
 
+  if (tdbTbOpen("checkpoint.state.db", sizeof(int32_t), sizeof(SStateCheckpoint), NULL, pState->pTdbState->db,
+                &pState->pTdbState->pCheckpointDb, 0) < 0) {
+    goto _err;
+  }
+
+  streamStateLoadCheckpoint(pState);
+
   if (streamStateBegin(pState) < 0) {
     goto _err;
   }
@@ -203,20 +221,29 @@ _err:
   tdbTbClose(pState->pTdbState->pSessionStateDb);
   tdbTbClose(pState->pTdbState->pParNameDb);
   tdbTbClose(pState->pTdbState->pParTagDb);
+  tdbTbClose(pState->pTdbState->pCheckpointDb);
   tdbClose(pState->pTdbState->db);
   streamStateDestroy(pState);
   return NULL;
 }
 
 void streamStateClose(SStreamState* pState) {
-  tdbCommit(pState->pTdbState->db, pState->pTdbState->txn);
-  tdbPostCommit(pState->pTdbState->db, pState->pTdbState->txn);
+  if (pState->pTdbState->replayVer >= 0) {
+    // a replay left halfway is done again from the last checkpoint
+    tdbAbort(pState->pTdbState->db, pState->pTdbState->txn);
+  } else {
+    SStateCheckpoint checkpoint = {0};
+    streamStatePutCheckpoint(pState->pTdbState, &checkpoint);
+    tdbCommit(pState->pTdbState->db, pState->pTdbState->txn);
+    tdbPostCommit(pState->pTdbState->db, pState->pTdbState->txn);
+  }
   tdbTbClose(pState->pTdbState->pStateDb);
   tdbTbClose(pState->pTdbState->pFuncStateDb);
   tdbTbClose(pState->pTdbState->pFillStateDb);
   tdbTbClose(pState->pTdbState->pSessionStateDb);
   tdbTbClose(pState->pTdbState->pParNameDb);
   tdbTbClose(pState->pTdbState->pParTagDb);
+  tdbTbClose(pState->pTdbState->pCheckpointDb);
   tdbClose(pState->pTdbState->db);
 
   streamStateDestroy(pState);
@@ -232,12 +259,30 @@ int32_t streamStateBegin(SStreamState* pState) {
 }
 
 int32_t streamStateCommit(SStreamState* pState) {
-  if (tdbCommit(pState->pTdbState->db, pState->pTdbState->txn) < 0) {
+  STdbState*       pTdbState = pState->pTdbState;
+  SStateCheckpoint checkpoint = {0};
+
+  // the rows replayed so far are not the wal up to any version, the replay is committed as a whole once it ends
+  if (pTdbState->replayVer >= 0) {
+    return 0;
+  }
+
+  if (streamStatePutCheckpoint(pTdbState, &checkpoint) < 0) {
     return -1;
   }
-  if (tdbPostCommit(pState->pTdbState->db, pState->pTdbState->txn) < 0) {
+
+  if (tdbCommit(pTdbState->db, pTdbState->txn) < 0) {
     return -1;
   }
+  if (tdbPostCommit(pTdbState->db, pTdbState->txn) < 0) {
+    return -1;
+  }
+
+  if (checkpoint.id != pTdbState->checkpointId) {
+    qDebug("stream state checkpoint %" PRId64 " committed, ver:%" PRId64, checkpoint.id, checkpoint.ver);
+    pTdbState->checkpointId = checkpoint.id;
+    pTdbState->checkpointVer = checkpoint.ver;
+  }
 
   if (tdbBegin(pState->pTdbState->db, &pState->pTdbState->txn, NULL, NULL, NULL,
                TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED) < 0) {
@@ -258,6 +303,66 @@ int32_t streamStateAbort(SStreamState* pState) {
   return 0;
 }
 
+// only the pages dirtied since the last commit are written, so recording the source wal version in the same txn turns
+// every commit into an incremental checkpoint of the task
+static int32_t streamStatePutCheckpoint(STdbState* pTdbState, SStateCheckpoint* pCheckpoint) {
+  int32_t key = STREAM_STATE_CHECKPOINT_KEY;
+
+  pCheckpoint->id = pTdbState->checkpointId;
+  pCheckpoint->ver = pTdbState->checkpointVer;
+  if (pTdbState->processedVer <= pTdbState->checkpointVer) {
+    return 0;
+  }
+
+  pCheckpoint->id++;
+  pCheckpoint->ver = pTdbState->processedVer;
+  return tdbTbUpsert(pTdbState->pCheckpointDb, &key, sizeof(int32_t), pCheckpoint, sizeof(SStateCheckpoint),
+                     pTdbState->txn);
+}
+
+static void streamStateLoadCheckpoint(SStreamState* pState) {
+  STdbState* pTdbState = pState->pTdbState;
+  int32_t    key = STREAM_STATE_CHECKPOINT_KEY;
+  void*      pVal = NULL;
+  int32_t    len = 0;
+
+  pTdbState->checkpointId = 0;
+  pTdbState->checkpointVer = -1;
+  if (tdbTbGet(pTdbState->pCheckpointDb, &key, sizeof(int32_t), &pVal, &len) == 0 &&
+      len == sizeof(SStateCheckpoint)) {
+    SStateCheckpoint* pCheckpoint = pVal;
+    pTdbState->checkpointId = pCheckpoint->id;
+    pTdbState->checkpointVer = pCheckpoint->ver;
+  }
+  pTdbState->processedVer = pTdbState->checkpointVer;
+  pTdbState->replayVer = -1;
+  tdbFree(pVal);
+}
+
+void streamStateSetProcessedVer(SStreamState* pState, int64_t ver) {
+  if (ver > pState->pTdbState->processedVer) {
+    pState->pTdbState->processedVer = ver;
+  }
+}
+
+int64_t streamStateGetCheckpointVer(SStreamState* pState) { return pState->pTdbState->checkpointVer; }
+
+// replay the wal tail (checkpointVer, ver] into the state, nothing is committed until the replay ends
+void streamStateBeginReplay(SStreamState* pState, int64_t ver) { pState->pTdbState->replayVer = ver; }
+
+int64_t streamStateGetReplayVer(SStreamState* pState) { return pState->pTdbState->replayVer; }
+
+int32_t streamStateEndReplay(SStreamState* pState) {
+  STdbState* pTdbState = pState->pTdbState;
+  if (pTdbState->replayVer < 0) {
+    return 0;
+  }
+
+  streamStateSetProcessedVer(pState, pTdbState->replayVer);
+  pTdbState->replayVer = -1;
+  return streamStateCommit(pState);
+}
+
 int32_t streamStateFuncPut(SStreamState* pState, const STupleKey* key, const void* value, int32_t vLen) {
   return tdbTbUpsert(pState->pTdbState->pFuncStateDb, key, sizeof(STupleKey), value, vLen, pState->pTdbState->txn);
 }
@@ -13,8 +13,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "executor.h"
-#include "tstream.h"
+#include "streamInc.h"
 
 SStreamTask* tNewSStreamTask(int64_t streamId) {
   SStreamTask* pTask = (SStreamTask*)taosMemoryCalloc(1, sizeof(SStreamTask));
@@ -48,6 +47,14 @@ int32_t tDecodeStreamEpInfo(SDecoder* pDecoder, SStreamChildEpInfo* pInfo) {
   return 0;
 }
 
+static int32_t streamCompareVgroupHash(const void* p1, const void* p2) {
+  const SVgroupInfo* pVg1 = (const SVgroupInfo*)p1;
+  const SVgroupInfo* pVg2 = (const SVgroupInfo*)p2;
+  if (pVg1->hashBegin < pVg2->hashBegin) return -1;
+  if (pVg1->hashBegin > pVg2->hashBegin) return 1;
+  return 0;
+}
+
 int32_t tEncodeSStreamTask(SEncoder* pEncoder, const SStreamTask* pTask) {
   if (tStartEncode(pEncoder) < 0) return -1;
   if (tEncodeI64(pEncoder, pTask->streamId) < 0) return -1;
@@ -155,6 +162,8 @@ int32_t tDecodeSStreamTask(SDecoder* pDecoder, SStreamTask* pTask) {
   } else if (pTask->outputType == TASK_OUTPUT__SHUFFLE_DISPATCH) {
     if (tDeserializeSUseDbRspImp(pDecoder, &pTask->shuffleDispatcher.dbInfo) < 0) return -1;
     if (tDecodeCStrTo(pDecoder, pTask->shuffleDispatcher.stbFullName) < 0) return -1;
+    // sorted once here, the dispatcher searches them by hash and the vgroup list is read without lock afterwards
+    taosArraySort(pTask->shuffleDispatcher.dbInfo.pVgroupInfos, streamCompareVgroupHash);
   }
   if (tDecodeI64(pDecoder, &pTask->triggerParam) < 0) return -1;
 
@@ -178,6 +187,8 @@ void tFreeSStreamTask(SStreamTask* pTask) {
     taosArrayDestroy(pTask->checkReqIds);
     pTask->checkReqIds = NULL;
   }
+  streamClearDispatchDest(pTask);
+  taosHashCleanup(pTask->pUpstreamSeq);
 
   if (pTask->pState) streamStateClose(pTask->pState);
 
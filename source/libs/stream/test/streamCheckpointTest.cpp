@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "streamInc.h"
+
+// The checkpoint record of a task state, reopened from disk after each step as a restarted vnode would.
+class StreamCheckpointTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    taosRemoveDir(path);
+    reopen();
+  }
+
+  void TearDown() override {
+    if (pState != NULL) streamStateClose(pState);
+    taosRemoveDir(path);
+  }
+
+  void reopen() {
+    if (pState != NULL) streamStateClose(pState);
+    pState = streamStateOpen(path, NULL, true, -1, -1);
+    ASSERT_NE(pState, nullptr);
+  }
+
+  void put(int64_t ts, int32_t val) {
+    STupleKey key = {0};
+    key.ts = ts;
+    ASSERT_EQ(streamStateFuncPut(pState, &key, &val, sizeof(val)), 0);
+  }
+
+  bool has(int64_t ts) {
+    STupleKey key = {0};
+    void     *pVal = NULL;
+    int32_t   len = 0;
+    key.ts = ts;
+    int32_t code = streamStateFuncGet(pState, &key, &pVal, &len);
+    tdbFree(pVal);
+    return code == 0;
+  }
+
+  char          path[64] = "/tmp/streamCheckpointTest";
+  SStreamState *pState = NULL;
+};
+
+TEST_F(StreamCheckpointTest, noCheckpoint) {
+  EXPECT_EQ(streamStateGetCheckpointVer(pState), -1);
+  EXPECT_EQ(streamStateGetReplayVer(pState), -1);
+
+  // a commit with nothing processed writes no checkpoint
+  ASSERT_EQ(streamStateCommit(pState), 0);
+  reopen();
+  EXPECT_EQ(streamStateGetCheckpointVer(pState), -1);
+}
+
+TEST_F(StreamCheckpointTest, commitRecordsProcessedVer) {
+  put(1, 1);
+  streamStateSetProcessedVer(pState, 10);
+  ASSERT_EQ(streamStateCommit(pState), 0);
+  EXPECT_EQ(streamStateGetCheckpointVer(pState), 10);
+
+  // the processed version never goes back
+  streamStateSetProcessedVer(pState, 5);
+  ASSERT_EQ(streamStateCommit(pState), 0);
+  EXPECT_EQ(streamStateGetCheckpointVer(pState), 10);
+
+  reopen();
+  EXPECT_EQ(streamStateGetCheckpointVer(pState), 10);
+  EXPECT_TRUE(has(1));
+}
+
+TEST_F(StreamCheckpointTest, closeRecordsProcessedVer) {
+  // the operators other than interval commit their state only when the task is closed
+  put(1, 1);
+  streamStateSetProcessedVer(pState, 20);
+  reopen();
+  EXPECT_EQ(streamStateGetCheckpointVer(pState), 20);
+  EXPECT_TRUE(has(1));
+}
+
+TEST_F(StreamCheckpointTest, replayCommitsAtEnd) {
+  put(1, 1);
+  streamStateSetProcessedVer(pState, 10);
+  ASSERT_EQ(streamStateCommit(pState), 0);
+
+  // the commits of the operators during the replay are deferred to its end
+  streamStateBeginReplay(pState, 30);
+  put(2, 2);
+  ASSERT_EQ(streamStateCommit(pState), 0);
+  EXPECT_EQ(streamStateGetCheckpointVer(pState), 10);
+
+  ASSERT_EQ(streamStateEndReplay(pState), 0);
+  EXPECT_EQ(streamStateGetReplayVer(pState), -1);
+  EXPECT_EQ(streamStateGetCheckpointVer(pState), 30);
+
+  reopen();
+  EXPECT_EQ(streamStateGetCheckpointVer(pState), 30);
+  EXPECT_TRUE(has(1));
+  EXPECT_TRUE(has(2));
+}
+
+TEST_F(StreamCheckpointTest, replayLeftHalfway) {
+  put(1, 1);
+  streamStateSetProcessedVer(pState, 10);
+  ASSERT_EQ(streamStateCommit(pState), 0);
+
+  // the rows of an unfinished replay are dropped with it, and the next restart replays from the same checkpoint
+  streamStateBeginReplay(pState, 30);
+  put(2, 2);
+  ASSERT_EQ(streamStateCommit(pState), 0);
+  reopen();
+  EXPECT_EQ(streamStateGetCheckpointVer(pState), 10);
+  EXPECT_TRUE(has(1));
+  EXPECT_FALSE(has(2));
+}
+
+int main(int argc, char *argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
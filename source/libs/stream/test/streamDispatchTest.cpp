@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "streamInc.h"
+
+namespace {
+
+const int32_t kDownstreamTaskId = 7;
+
+// a dispatch req of one block of the given length
+SStreamDispatchReq makeReq(int64_t reqId, int32_t len) {
+  SStreamDispatchReq req = {0};
+  req.streamId = 100;
+  req.taskId = kDownstreamTaskId;
+  req.upstreamTaskId = 3;
+  req.blockNum = 1;
+  req.reqId = reqId;
+  req.data = taosArrayInit(1, sizeof(void *));
+  req.dataLen = taosArrayInit(1, sizeof(int32_t));
+  void *data = taosMemoryCalloc(1, len);
+  taosArrayPush(req.data, &data);
+  taosArrayPush(req.dataLen, &len);
+  return req;
+}
+
+}  // namespace
+
+// The dispatch queue of a task with one downstream task, three reqs sent and one waiting for credit.
+class StreamDispatchTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    pTask = (SStreamTask *)taosMemoryCalloc(1, sizeof(SStreamTask));
+    pTask->outputType = TASK_OUTPUT__FIXED_DISPATCH;
+    taosInitRWLatch(&pTask->dispatchLock);
+
+    SStreamDispatchDest dest = {0};
+    dest.taskId = kDownstreamTaskId;
+    dest.credit = 3;
+    dest.pending = taosArrayInit(4, sizeof(SStreamDispatchEntry));
+    for (int64_t reqId = 1; reqId <= 4; reqId++) {
+      SStreamDispatchEntry entry = {.sent = reqId <= 3, .req = makeReq(reqId, 16)};
+      taosArrayPush(dest.pending, &entry);
+    }
+    dest.inFlight = 3;
+    dest.reqId = 4;
+
+    pTask->dispatchDest = taosArrayInit(1, sizeof(SStreamDispatchDest));
+    taosArrayPush(pTask->dispatchDest, &dest);
+  }
+
+  void TearDown() override {
+    streamClearDispatchDest(pTask);
+    taosMemoryFree(pTask);
+  }
+
+  SStreamDispatchDest *dest() { return (SStreamDispatchDest *)taosArrayGet(pTask->dispatchDest, 0); }
+
+  SStreamDispatchEntry *entry(int32_t i) { return (SStreamDispatchEntry *)taosArrayGet(dest()->pending, i); }
+
+  SStreamTask *pTask = NULL;
+};
+
+TEST_F(StreamDispatchTest, acceptedReqTakesThoseBefore) {
+  // the downstream takes the reqs in order, the rsp of a later req may come first
+  streamDispatchRelease(pTask, kDownstreamTaskId, 2, TASK_INPUT_STATUS__NORMAL);
+
+  ASSERT_EQ(taosArrayGetSize(dest()->pending), 2);
+  EXPECT_EQ(entry(0)->req.reqId, 3);
+  EXPECT_EQ(entry(1)->req.reqId, 4);
+  EXPECT_EQ(dest()->inFlight, 1);
+  EXPECT_EQ(dest()->credit, 4);
+  EXPECT_EQ(dest()->hold, 0);
+
+  // the rsp of the req taken with it is stale
+  streamDispatchRelease(pTask, kDownstreamTaskId, 1, TASK_INPUT_STATUS__NORMAL);
+  EXPECT_EQ(taosArrayGetSize(dest()->pending), 2);
+  EXPECT_EQ(dest()->inFlight, 1);
+  EXPECT_EQ(dest()->credit, 4);
+}
+
+TEST_F(StreamDispatchTest, failedReqResendsThoseBehind) {
+  streamDispatchRelease(pTask, kDownstreamTaskId, 2, TASK_INPUT_STATUS__FAILED);
+
+  // the downstream refuses the reqs sent behind it as well, they are all sent again in order after the retry timer
+  ASSERT_EQ(taosArrayGetSize(dest()->pending), 4);
+  EXPECT_EQ(entry(0)->sent, 1);
+  EXPECT_EQ(entry(1)->req.reqId, 2);
+  EXPECT_EQ(entry(1)->sent, 0);
+  EXPECT_EQ(taosArrayGetSize(entry(1)->req.data), 1);
+  EXPECT_EQ(entry(2)->sent, 0);
+  EXPECT_EQ(dest()->inFlight, 1);
+  EXPECT_EQ(dest()->credit, 1);
+  EXPECT_EQ(dest()->hold, 1);
+
+  // the refusal of a req behind it is stale
+  streamDispatchRelease(pTask, kDownstreamTaskId, 3, TASK_INPUT_STATUS__BLOCKED);
+  EXPECT_EQ(taosArrayGetSize(dest()->pending), 4);
+  EXPECT_EQ(dest()->inFlight, 1);
+  EXPECT_EQ(dest()->credit, 1);
+
+  streamDispatchRelease(pTask, kDownstreamTaskId, 1, TASK_INPUT_STATUS__NORMAL);
+  ASSERT_EQ(taosArrayGetSize(dest()->pending), 3);
+  EXPECT_EQ(entry(0)->req.reqId, 2);
+  EXPECT_EQ(dest()->inFlight, 0);
+}
+
+TEST_F(StreamDispatchTest, acceptedWhileSending) {
+  // a req being sent outside the dispatch lock stays until the send returns
+  entry(0)->sending = 1;
+  streamDispatchRelease(pTask, kDownstreamTaskId, 1, TASK_INPUT_STATUS__NORMAL);
+
+  ASSERT_EQ(taosArrayGetSize(dest()->pending), 4);
+  EXPECT_EQ(entry(0)->accepted, 1);
+  EXPECT_EQ(entry(0)->sent, 0);
+  EXPECT_EQ(dest()->inFlight, 2);
+
+  // and its rsp is not taken twice
+  streamDispatchRelease(pTask, kDownstreamTaskId, 1, TASK_INPUT_STATUS__NORMAL);
+  EXPECT_EQ(dest()->inFlight, 2);
+  EXPECT_EQ(dest()->credit, 4);
+}
+
+TEST_F(StreamDispatchTest, unknownRspIgnored) {
+  // a req never queued, and a rsp from another task is not ours
+  streamDispatchRelease(pTask, kDownstreamTaskId, 9, TASK_INPUT_STATUS__NORMAL);
+  streamDispatchRelease(pTask, kDownstreamTaskId + 1, 1, TASK_INPUT_STATUS__NORMAL);
+
+  EXPECT_EQ(taosArrayGetSize(dest()->pending), 4);
+  EXPECT_EQ(dest()->inFlight, 3);
+  EXPECT_EQ(dest()->credit, 3);
+}
+
+TEST_F(StreamDispatchTest, rspWithoutReqId) {
+  // a downstream task without reqId releases the oldest req sent
+  streamDispatchRelease(pTask, kDownstreamTaskId, 0, TASK_INPUT_STATUS__NORMAL);
+
+  ASSERT_EQ(taosArrayGetSize(dest()->pending), 3);
+  EXPECT_EQ(entry(0)->req.reqId, 2);
+  EXPECT_EQ(dest()->inFlight, 2);
+}
+
+TEST(StreamDispatchReqTest, reqIdCodec) {
+  SStreamDispatchReq req = makeReq(42, 24);
+  req.stage = 1234;
+
+  int32_t tlen;
+  int32_t code;
+  tEncodeSize(tEncodeStreamDispatchReq, &req, tlen, code);
+  ASSERT_EQ(code, 0);
+
+  void    *buf = taosMemoryMalloc(tlen);
+  SEncoder encoder;
+  tEncoderInit(&encoder, (uint8_t *)buf, tlen);
+  ASSERT_GT(tEncodeStreamDispatchReq(&encoder, &req), 0);
+  tEncoderClear(&encoder);
+
+  SStreamDispatchReq out = {0};
+  SDecoder           decoder;
+  tDecoderInit(&decoder, (uint8_t *)buf, tlen);
+  ASSERT_EQ(tDecodeStreamDispatchReq(&decoder, &out), 0);
+  tDecoderClear(&decoder);
+
+  EXPECT_EQ(out.reqId, 42);
+  EXPECT_EQ(out.stage, 1234);
+  EXPECT_EQ(out.taskId, kDownstreamTaskId);
+  EXPECT_EQ(out.blockNum, 1);
+  EXPECT_EQ(*(int32_t *)taosArrayGet(out.dataLen, 0), 24);
+
+  tDeleteStreamDispatchReq(&out);
+  tDeleteStreamDispatchReq(&req);
+  taosMemoryFree(buf);
+}
+
+TEST(StreamUpstreamSeqTest, reqsTakenInOrder) {
+  SStreamTask *pTask = (SStreamTask *)taosMemoryCalloc(1, sizeof(SStreamTask));
+
+  // the first req of an upstream task opens the sequence wherever it starts
+  SStreamDispatchReq req = {0};
+  req.upstreamTaskId = 3;
+  req.stage = 1;
+  req.reqId = 5;
+  EXPECT_EQ(streamCheckUpstreamSeq(pTask, &req), STREAM_UPSTREAM_SEQ__NEXT);
+
+  // req 5 is refused by the input queue, req 6 in flight behind it must not pass it
+  req.reqId = 6;
+  EXPECT_EQ(streamCheckUpstreamSeq(pTask, &req), STREAM_UPSTREAM_SEQ__GAP);
+  req.reqId = 5;
+  EXPECT_EQ(streamCheckUpstreamSeq(pTask, &req), STREAM_UPSTREAM_SEQ__NEXT);
+  streamUpdateUpstreamSeq(pTask, &req);
+
+  // sent again after a stale refusal
+  EXPECT_EQ(streamCheckUpstreamSeq(pTask, &req), STREAM_UPSTREAM_SEQ__DUP);
+  req.reqId = 6;
+  EXPECT_EQ(streamCheckUpstreamSeq(pTask, &req), STREAM_UPSTREAM_SEQ__NEXT);
+
+  // another upstream task has its own sequence
+  SStreamDispatchReq other = {0};
+  other.upstreamTaskId = 4;
+  other.stage = 1;
+  other.reqId = 1;
+  EXPECT_EQ(streamCheckUpstreamSeq(pTask, &other), STREAM_UPSTREAM_SEQ__NEXT);
+
+  // the upstream task restarts its reqIds with a new stage
+  req.stage = 2;
+  req.reqId = 1;
+  EXPECT_EQ(streamCheckUpstreamSeq(pTask, &req), STREAM_UPSTREAM_SEQ__NEXT);
+  streamUpdateUpstreamSeq(pTask, &req);
+  req.reqId = 3;
+  EXPECT_EQ(streamCheckUpstreamSeq(pTask, &req), STREAM_UPSTREAM_SEQ__GAP);
+
+  // an upstream task without reqId is not checked
+  req.reqId = 0;
+  EXPECT_EQ(streamCheckUpstreamSeq(pTask, &req), STREAM_UPSTREAM_SEQ__NEXT);
+
+  taosHashCleanup(pTask->pUpstreamSeq);
+  taosMemoryFree(pTask);
+}
+
+TEST(StreamTaskCodecTest, vgroupsSortedOnDecode) {
+  SStreamTask task = {0};
+  task.taskLevel = TASK_LEVEL__AGG;
+  task.outputType = TASK_OUTPUT__SHUFFLE_DISPATCH;
+  task.exec.qmsg = (char *)"";
+  task.childEpInfo = taosArrayInit(0, sizeof(void *));
+
+  // vgroups in the order mnode lists them, not by hash range
+  uint32_t aHashBegin[] = {0x80000000, 0x00000000, 0xC0000000, 0x40000000};
+  task.shuffleDispatcher.dbInfo.vgNum = 4;
+  task.shuffleDispatcher.dbInfo.pVgroupInfos = taosArrayInit(4, sizeof(SVgroupInfo));
+  for (int32_t i = 0; i < 4; i++) {
+    SVgroupInfo vgInfo = {0};
+    vgInfo.vgId = i + 2;
+    vgInfo.hashBegin = aHashBegin[i];
+    vgInfo.hashEnd = aHashBegin[i] + 0x3FFFFFFF;
+    vgInfo.taskId = 10 + i;
+    taosArrayPush(task.shuffleDispatcher.dbInfo.pVgroupInfos, &vgInfo);
+  }
+
+  int32_t tlen;
+  int32_t code;
+  tEncodeSize(tEncodeSStreamTask, &task, tlen, code);
+  ASSERT_EQ(code, 0);
+
+  void    *buf = taosMemoryMalloc(tlen);
+  SEncoder encoder;
+  tEncoderInit(&encoder, (uint8_t *)buf, tlen);
+  ASSERT_GT(tEncodeSStreamTask(&encoder, &task), 0);
+  tEncoderClear(&encoder);
+
+  SStreamTask *pTask = (SStreamTask *)taosMemoryCalloc(1, sizeof(SStreamTask));
+  SDecoder     decoder;
+  tDecoderInit(&decoder, (uint8_t *)buf, tlen);
+  ASSERT_EQ(tDecodeSStreamTask(&decoder, pTask), 0);
+  tDecoderClear(&decoder);
+
+  // the dispatcher gets them sorted by hash range, each with its own downstream task
+  SArray *pVgroupInfos = pTask->shuffleDispatcher.dbInfo.pVgroupInfos;
+  ASSERT_EQ(taosArrayGetSize(pVgroupInfos), 4);
+  for (int32_t i = 0; i < 4; i++) {
+    SVgroupInfo *pVgInfo = (SVgroupInfo *)taosArrayGet(pVgroupInfos, i);
+    EXPECT_EQ(pVgInfo->hashBegin, (uint32_t)i * 0x40000000);
+    if (i > 0) EXPECT_GT(pVgInfo->hashBegin, ((SVgroupInfo *)taosArrayGet(pVgroupInfos, i - 1))->hashEnd);
+  }
+  EXPECT_EQ(((SVgroupInfo *)taosArrayGet(pVgroupInfos, 0))->vgId, 3);
+  EXPECT_EQ(((SVgroupInfo *)taosArrayGet(pVgroupInfos, 3))->vgId, 4);
+
+  tFreeSStreamTask(pTask);
+  taosArrayDestroy(task.shuffleDispatcher.dbInfo.pVgroupInfos);
+  taosArrayDestroy(task.childEpInfo);
+  taosMemoryFree(buf);
+}
+
+int main(int argc, char *argv[]) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -82,6 +82,7 @@ int32_t snapshotSenderStart(SSyncSnapshotSender *pSender) {
   pSender->blockLen = 0;
   pSender->snapshotParam.start = SYNC_INDEX_INVALID;
   pSender->snapshotParam.end = SYNC_INDEX_INVALID;
+  pSender->snapshotParam.peerCaps = 0;
   pSender->snapshot.data = NULL;
   pSender->snapshotParam.end = SYNC_INDEX_INVALID;
   pSender->snapshot.lastApplyIndex = SYNC_INDEX_INVALID;
@@ -594,6 +595,7 @@ _SEND_REPLY:
   pRspMsg->ack = pMsg->seq;  // receiver maybe already closed
   pRspMsg->code = code;
   pRspMsg->snapBeginIndex = syncNodeGetSnapBeginIndex(pSyncNode);
+  pRspMsg->reserved = SYNC_SNAPSHOT_CAPS;  // zero from older receivers
 
   // send msg
   syncLogSendSyncSnapshotRsp(pSyncNode, pRspMsg, "snapshot receiver pre-snapshot");
@@ -850,9 +852,11 @@ static int32_t syncNodeOnSnapshotPrepRsp(SSyncNode *pSyncNode, SSyncSnapshotSend
   // prepare <begin, end>
   pSender->snapshotParam.start = pMsg->snapBeginIndex;
   pSender->snapshotParam.end = snapshot.lastApplyIndex;
+  pSender->snapshotParam.peerCaps = pMsg->reserved;
 
-  sSInfo(pSender, "prepare snapshot, recv-begin:%" PRId64 ", snapshot.last:%" PRId64 ", snapshot.term:%" PRId64,
-         pMsg->snapBeginIndex, snapshot.lastApplyIndex, snapshot.lastApplyTerm);
+  sSInfo(pSender,
+         "prepare snapshot, recv-begin:%" PRId64 ", snapshot.last:%" PRId64 ", snapshot.term:%" PRId64 ", caps:%d",
+         pMsg->snapBeginIndex, snapshot.lastApplyIndex, snapshot.lastApplyTerm, pMsg->reserved);
 
   if (pMsg->snapBeginIndex > snapshot.lastApplyIndex) {
     sSError(pSender, "prepare snapshot failed since beginIndex:%" PRId64 " larger than applyIndex:%" PRId64,
@@ -218,6 +218,7 @@ typedef struct SConnBuffer {
   int   left;
   int   total;
   int   invalid;
+  char* msg;  // message larger than cap, read directly into its final buffer
 } SConnBuffer;
 
 typedef void (*AsyncCB)(uv_async_t* handle);
@@ -101,11 +101,14 @@ int transInitBuffer(SConnBuffer* buf) {
   buf->len = 0;
   buf->total = 0;
   buf->invalid = 0;
+  buf->msg = NULL;
   return 0;
 }
 int transDestroyBuffer(SConnBuffer* p) {
   taosMemoryFree(p->buf);
   p->buf = NULL;
+  taosMemoryFree(p->msg);
+  p->msg = NULL;
   return 0;
 }
 
@@ -115,6 +118,8 @@ int transClearBuffer(SConnBuffer* buf) {
     p->cap = BUFFER_CAP;
     p->buf = taosMemoryRealloc(p->buf, BUFFER_CAP);
   }
+  taosMemoryFree(p->msg);
+  p->msg = NULL;
   p->left = -1;
   p->len = 0;
   p->total = 0;
@@ -130,7 +135,14 @@ int transDumpFromBuffer(SConnBuffer* connBuf, char** buf) {
     return -1;
   }
   int total = p->total;
-  if (total >= HEADSIZE && !p->invalid) {
+  if (p->msg != NULL) {
+    // hand the message over without copying it
+    *buf = p->msg;
+    p->msg = NULL;
+    p->left = -1;
+    p->total = 0;
+    p->len = 0;
+  } else if (total >= HEADSIZE && !p->invalid) {
     *buf = taosMemoryCalloc(1, total);
     memcpy(*buf, p->buf, total);
     if (transResetBuffer(connBuf) < 0) {
@@ -168,6 +180,12 @@ int transAllocBuffer(SConnBuffer* connBuf, uv_buf_t* uvBuf) {
    * info--->|
    */
   SConnBuffer* p = connBuf;
+  if (p->msg != NULL) {
+    uvBuf->base = p->msg + p->len;
+    uvBuf->len = p->left;
+    return 0;
+  }
+
   uvBuf->base = p->buf + p->len;
   if (p->left == -1) {
     uvBuf->len = p->cap - p->len;
@@ -193,6 +211,14 @@ bool transReadComplete(SConnBuffer* connBuf) {
       int32_t msgLen = (int32_t)htonl(head.msgLen);
       p->total = msgLen;
       p->invalid = TRANS_NOVALID_PACKET(htonl(head.magicNum));
+      if (!p->invalid && p->total > p->cap && p->total <= TRANS_PACKET_LIMIT) {
+        // the rest of a large message is read straight into the buffer handed to the upper layer, instead of growing
+        // the connection buffer and copying the whole message out of it
+        p->msg = taosMemoryCalloc(1, p->total);
+        if (p->msg != NULL) {
+          memcpy(p->msg, p->buf, p->len);
+        }
+      }
     }
     if (p->total >= p->len) {
       p->left = p->total - p->len;
@@ -16,6 +16,7 @@
 #ifdef USE_UV
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <string>
@@ -232,4 +233,89 @@ int32_t cloneVal(void *src, void **dst) {
 //  skey = (char *)transCtxDumpVal(ctx, 2);
 //  EXPECT_EQ(0, strcmp(skey, val.c_str()));
 //}
+
+// The read buffer of a connection, fed as libuv would: each read fills at most the space given by transAllocBuffer.
+class TransBufferEnv : public ::testing::Test {
+ protected:
+  virtual void SetUp() { transInitBuffer(&buf); }
+  virtual void TearDown() { transDestroyBuffer(&buf); }
+
+  // a message of len bytes, the body bytes follow from seed
+  static std::string buildMsg(int len, int seed) {
+    std::string   msg(len, 0);
+    STransMsgHead head = {0};
+    head.msgLen = htonl(len);
+    head.magicNum = htonl(TRANS_MAGIC_NUM);
+    memcpy(&msg[0], &head, sizeof(head));
+    for (int i = sizeof(head); i < len; i++) msg[i] = (char)(seed + i);
+    return msg;
+  }
+
+  // read at most n bytes of data from off, returns the bytes read
+  int read(const std::string &data, int off, int n) {
+    uv_buf_t uvBuf;
+    transAllocBuffer(&buf, &uvBuf);
+    int r = std::min(n, std::min((int)uvBuf.len, (int)data.size() - off));
+    memcpy(uvBuf.base, data.data() + off, r);
+    buf.len += r;
+    return r;
+  }
+
+  void expectMsg(const std::string &expect) {
+    char *msg = NULL;
+    int   len = transDumpFromBuffer(&buf, &msg);
+    ASSERT_EQ(len, (int)expect.size());
+    EXPECT_EQ(memcmp(msg, expect.data(), len), 0);
+    taosMemoryFree(msg);
+  }
+
+  SConnBuffer buf;
+};
+
+TEST_F(TransBufferEnv, largeMsgThenSmall) {
+  int         cap = buf.cap;
+  std::string large = buildMsg(cap * 3 + 123, 1);
+  std::string small = buildMsg(100, 2);
+
+  // the large message takes several reads of half the buffer each
+  int off = 0, reads = 0;
+  while (off < (int)large.size()) {
+    EXPECT_FALSE(transReadComplete(&buf));
+    off += read(large, off, cap / 2);
+    reads++;
+  }
+  EXPECT_GT(reads, 2);
+  ASSERT_TRUE(transReadComplete(&buf));
+  expectMsg(large);
+
+  // the small message on the same connection goes through the pooled buffer, which has not grown
+  off = read(small, 0, 10);
+  EXPECT_FALSE(transReadComplete(&buf));
+  read(small, off, cap);
+  ASSERT_TRUE(transReadComplete(&buf));
+  expectMsg(small);
+  EXPECT_EQ(buf.cap, cap);
+}
+
+TEST_F(TransBufferEnv, msgStream) {
+  int         cap = buf.cap;
+  int         sizes[] = {100, 3000, cap, cap + 1, 200000, 150, 1 << 20, 170};
+  std::string stream;
+  for (int i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++) stream += buildMsg(sizes[i], i);
+
+  // a read may end anywhere, within a header or across two messages
+  for (int chunk : {1, 7, 100, cap, 65536, 1 << 22}) {
+    int off = 0, nMsg = 0, msgOff = 0;
+    while (off < (int)stream.size()) {
+      off += read(stream, off, chunk);
+      while (transReadComplete(&buf)) {
+        ASSERT_LT(nMsg, (int)(sizeof(sizes) / sizeof(sizes[0])));
+        expectMsg(stream.substr(msgOff, sizes[nMsg]));
+        msgOff += sizes[nMsg++];
+      }
+    }
+    EXPECT_EQ(nMsg, (int)(sizeof(sizes) / sizeof(sizes[0]))) << "chunk:" << chunk;
+    EXPECT_EQ(buf.cap, cap) << "chunk:" << chunk;
+  }
+}
 #endif
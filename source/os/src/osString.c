@@ -261,6 +261,37 @@ int32_t taosUcs4ToMbs(TdUcs4 *ucs4, int32_t ucs4_max_len, char *mbs) {
   return (int32_t)(ucs4_max_len - outLen);
 #endif
 }
+// encode ucs4 as utf-8 without iconv, so the result does not depend on the local charset. Invalid code points are
+// replaced by U+FFFD. The output is never longer than the input.
+int32_t taosUcs4ToUtf8(TdUcs4 *ucs4, int32_t ucs4_max_len, char *utf8) {
+  uint8_t *p = (uint8_t *)utf8;
+  int32_t  num = ucs4_max_len / sizeof(TdUcs4);
+
+  for (int32_t i = 0; i < num; ++i) {
+    uint32_t c = ucs4[i];
+    if (c < 0x80) {
+      *p++ = (uint8_t)c;
+    } else if (c < 0x800) {
+      *p++ = (uint8_t)(0xC0 | (c >> 6));
+      *p++ = (uint8_t)(0x80 | (c & 0x3F));
+    } else if (c < 0x10000 || c > 0x10FFFF) {
+      if (c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF)) {
+        c = 0xFFFD;
+      }
+      *p++ = (uint8_t)(0xE0 | (c >> 12));
+      *p++ = (uint8_t)(0x80 | ((c >> 6) & 0x3F));
+      *p++ = (uint8_t)(0x80 | (c & 0x3F));
+    } else {
+      *p++ = (uint8_t)(0xF0 | (c >> 18));
+      *p++ = (uint8_t)(0x80 | ((c >> 12) & 0x3F));
+      *p++ = (uint8_t)(0x80 | ((c >> 6) & 0x3F));
+      *p++ = (uint8_t)(0x80 | (c & 0x3F));
+    }
+  }
+
+  return (int32_t)(p - (uint8_t *)utf8);
+}
+
 bool taosValidateEncodec(const char *encodec) {
 #ifdef DISALLOW_NCHAR_WITHOUT_ICONV
   printf("Nchar cannot be read and written without iconv, please install iconv library and recompile.\n");
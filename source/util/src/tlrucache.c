@@ -520,6 +520,19 @@ static void taosLRUCacheShardEraseUnrefEntries(SLRUCacheShard *shard) {
   taosArrayDestroy(lastReferenceList);
 }
 
+static void taosLRUCacheShardApply(SLRUCacheShard *shard, _taos_lru_functor_t functor, void *ud) {
+  taosThreadMutexLock(&shard->mutex);
+
+  SLRUEntryTable *table = &shard->table;
+  for (uint32_t i = 0; i < (uint32_t)(1 << table->lengthBits); ++i) {
+    for (SLRUEntry *h = table->list[i]; h; h = h->nextHash) {
+      functor(h->keyData, h->keyLength, h->value, ud);
+    }
+  }
+
+  taosThreadMutexUnlock(&shard->mutex);
+}
+
 static bool taosLRUCacheShardRef(SLRUCacheShard *shard, LRUHandle *handle) {
   SLRUEntry *e = (SLRUEntry *)handle;
   taosThreadMutexLock(&shard->mutex);
@@ -731,6 +744,13 @@ void taosLRUCacheEraseUnrefEntries(SLRUCache *cache) {
   }
 }
 
+void taosLRUCacheApply(SLRUCache *cache, _taos_lru_functor_t functor, void *ud) {
+  int numShards = cache->numShards;
+  for (int i = 0; i < numShards; ++i) {
+    taosLRUCacheShardApply(&cache->shards[i], functor, ud);
+  }
+}
+
 bool taosLRUCacheRef(SLRUCache *cache, LRUHandle *handle) {
   if (handle == NULL) {
     return false;
@@ -11,6 +11,15 @@
 #define HAS_DATA_IN_DISK(_p)           ((_p)->offset >= 0)
 #define NO_IN_MEM_AVAILABLE_PAGES(_b)  (listNEles((_b)->lruList) >= (_b)->inMemPages)
 
+#define MAX_PENDING_WRITE_PAGES 16  // evicted pages of one buffer that may wait for the background writer
+#define MIN_IN_MEM_PAGES        2   // pages of one buffer that are always granted, regardless of the global budget
+#define MAX_PAGE_WRITER_THREADS 16
+
+// In-memory pages of all the paged buffers in this process are charged against one budget, so the concurrent
+// queries on a dnode start to spill instead of growing until the dnode runs out of memory.
+static int64_t dBufMemLimit = -1;  // in bytes, negative value means no limit
+static int64_t dBufMemUsed = 0;
+
 typedef struct SPageDiskInfo {
   int64_t offset;
   int32_t length;
@@ -26,6 +35,8 @@ struct SPageInfo {
   bool       dirty : 1;  // set current buffer page is dirty or not
 };
 
+typedef struct SPageWriter SPageWriter;
+
 struct SDiskbasedBuf {
   int32_t   numOfPages;
   int64_t   totalBufSize;
@@ -46,11 +57,136 @@ struct SDiskbasedBuf {
   bool      comp;              // compressed before flushed to disk
   uint64_t  nextPos;           // next page flush position
 
+  TdThreadMutex pendingLock;
+  TdThreadCond  pendingCond;
+  SSHashObj*    pPending;      // pageId -> SPageWriteReq*, evicted pages not written to disk yet
+  int32_t       numOfPending;  // write requests of this buffer in the writer queue
+  int32_t       writeCode;     // error code of the last failed background write
+  SPageWriter*  pWriter;       // writer of the evicted pages, NULL if they are written synchronously
+
   char*               id;           // for debug purpose
   bool                printStatis;  // Print statistics info when closing this buffer.
   SDiskbasedBufStatis statis;
 };
 
+// Evicted pages are copied (and compressed) into a write request and handed over to a writer thread of the process
+// wide pool, so the query thread reuses the page buffer without waiting for the disk. The write request is kept in the
+// pending hash of its buffer until it is on disk, and a page that is needed again before that is loaded from the
+// request.
+typedef struct SPageWriteReq {
+  SDiskbasedBuf* pBuf;
+  int32_t        pageId;
+  int32_t        size;
+  int64_t        offset;
+  char           data[];
+} SPageWriteReq;
+
+// All the requests of a buffer go to the same writer and are written in FIFO order, so the latest version of a page,
+// or of a file area that is freed and reused, always lands last.
+struct SPageWriter {
+  TdThread      thread;
+  TdThreadMutex lock;
+  TdThreadCond  notEmpty;
+  SList*        queue;  // SPageWriteReq*
+  bool          stop;
+};
+
+typedef struct SPageWriterPool {
+  int32_t     numOfWriters;  // 0 if the pages are written synchronously
+  int32_t     nextWriter;    // writer of the next created buffer
+  SPageWriter writers[MAX_PAGE_WRITER_THREADS];
+} SPageWriterPool;
+
+static int32_t         dBufWriterThreads = 2;
+static SPageWriterPool writerPool = {0};
+static TdThreadOnce    writerPoolInit = PTHREAD_ONCE_INIT;
+
+static void* pageWriterThreadFp(void* param) {
+  SPageWriter* pWriter = param;
+  setThreadName("paged-buf");
+
+  while (1) {
+    taosThreadMutexLock(&pWriter->lock);
+    while (listNEles(pWriter->queue) == 0 && !pWriter->stop) {
+      taosThreadCondWait(&pWriter->notEmpty, &pWriter->lock);
+    }
+    SListNode* pn = tdListPopHead(pWriter->queue);
+    taosThreadMutexUnlock(&pWriter->lock);
+
+    if (pn == NULL) {  // stopped and nothing left to write
+      break;
+    }
+
+    SPageWriteReq* pReq = *(SPageWriteReq**)pn->data;
+    SDiskbasedBuf* pBuf = pReq->pBuf;
+    taosMemoryFree(pn);
+
+    int32_t code = TSDB_CODE_SUCCESS;
+    if (taosPWriteFile(pBuf->pFile, pReq->data, pReq->size, pReq->offset) != pReq->size) {
+      code = TAOS_SYSTEM_ERROR(errno);
+      uError("failed to write page:%d to disk, offset:%" PRId64 ", size:%d, %s", pReq->pageId, pReq->offset,
+             pReq->size, pBuf->id);
+    }
+
+    // pBuf must not be accessed after the lock is released, since it may be destroyed as soon as nothing is pending
+    taosThreadMutexLock(&pBuf->pendingLock);
+    SPageWriteReq** p = tSimpleHashGet(pBuf->pPending, &pReq->pageId, sizeof(int32_t));
+    if (p != NULL && *p == pReq) {  // not superseded by a later flush of the same page
+      tSimpleHashRemove(pBuf->pPending, &pReq->pageId, sizeof(int32_t));
+    }
+
+    if (code != TSDB_CODE_SUCCESS) {
+      pBuf->writeCode = code;
+    }
+
+    pBuf->numOfPending -= 1;
+    taosThreadCondBroadcast(&pBuf->pendingCond);
+    taosThreadMutexUnlock(&pBuf->pendingLock);
+
+    taosMemoryFree(pReq);
+  }
+
+  return NULL;
+}
+
+static void doInitPageWriters() {
+  int32_t num = TMIN(TMAX(dBufWriterThreads, 0), MAX_PAGE_WRITER_THREADS);
+
+  for (int32_t i = 0; i < num; ++i) {
+    SPageWriter* pWriter = &writerPool.writers[i];
+    pWriter->queue = tdListNew(POINTER_BYTES);
+    if (pWriter->queue == NULL) {
+      break;
+    }
+
+    taosThreadMutexInit(&pWriter->lock, NULL);
+    taosThreadCondInit(&pWriter->notEmpty, NULL);
+    if (taosThreadCreate(&pWriter->thread, NULL, pageWriterThreadFp, pWriter) != 0) {
+      uError("failed to create paged buffer writer thread since %s", strerror(errno));
+      taosThreadMutexDestroy(&pWriter->lock);
+      taosThreadCondDestroy(&pWriter->notEmpty);
+      pWriter->queue = tdListFree(pWriter->queue);
+      break;
+    }
+
+    writerPool.numOfWriters += 1;
+  }
+
+  if (writerPool.numOfWriters == 0) {
+    uInfo("no paged buffer writer thread, write pages synchronously");
+  } else if (writerPool.numOfWriters < num) {
+    uWarn("only %d of %d paged buffer writer threads are created", writerPool.numOfWriters, num);
+  }
+}
+
+static void waitForPendingPages(SDiskbasedBuf* pBuf, int32_t maxPending) {
+  taosThreadMutexLock(&pBuf->pendingLock);
+  while (pBuf->numOfPending > maxPending) {
+    taosThreadCondWait(&pBuf->pendingCond, &pBuf->pendingLock);
+  }
+  taosThreadMutexUnlock(&pBuf->pendingLock);
+}
+
 static int32_t createDiskFile(SDiskbasedBuf* pBuf) {
   if (pBuf->path == NULL) {  // prepare the file name when needed it
     char path[PATH_MAX] = {0};
@@ -70,16 +206,13 @@ static int32_t createDiskFile(SDiskbasedBuf* pBuf) {
   return TSDB_CODE_SUCCESS;
 }
 
-static char* doCompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {  // do nothing
+static int32_t doCompressData(const void* data, int32_t srcSize, char* dst, SDiskbasedBuf* pBuf) {
   if (!pBuf->comp) {
-    *dst = srcSize;
-    return data;
+    memcpy(dst, data, srcSize);
+    return srcSize;
   }
 
-  *dst = tsCompressString(data, srcSize, 1, pBuf->assistBuf, srcSize, ONE_STAGE_COMP, NULL, 0);
-
-  memcpy(data, pBuf->assistBuf, *dst);
-  return data;
+  return tsCompressString((void*)data, srcSize, 1, dst, srcSize + 2, ONE_STAGE_COMP, NULL, 0);
 }
 
 static char* doDecompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {  // do nothing
@@ -129,27 +262,96 @@ static uint64_t allocateNewPositionInFile(SDiskbasedBuf* pBuf, size_t size) {
 
 static FORCE_INLINE size_t getAllocPageSize(int32_t pageSize) { return pageSize + POINTER_BYTES + sizeof(SFilePage); }
 
-static int32_t doFlushBufPageImpl(SDiskbasedBuf* pBuf, int64_t offset, const char* pData, int32_t size) {
-  int32_t ret = taosLSeekFile(pBuf->pFile, offset, SEEK_SET);
-  if (ret == -1) {
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    return terrno;
+static bool tryAcquireBufMem(int64_t size) {
+  int64_t limit = atomic_load_64(&dBufMemLimit);
+  int64_t used = atomic_add_fetch_64(&dBufMemUsed, size);
+  if (limit < 0 || used <= limit) {
+    return true;
   }
 
-  ret = (int32_t)taosWriteFile(pBuf->pFile, pData, size);
-  if (ret != size) {
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    return terrno;
+  atomic_sub_fetch_64(&dBufMemUsed, size);
+  return false;
+}
+
+// charged: the page has been granted by tryAcquireBufMem already
+static void* allocBufPage(SDiskbasedBuf* pBuf, bool charged) {
+  size_t size = getAllocPageSize(pBuf->pageSize);
+  if (!charged) {
+    atomic_add_fetch_64(&dBufMemUsed, size);
+  }
+
+  void* p = taosMemoryCalloc(1, size);  // add extract bytes in case of zipped buffer increased.
+  if (p == NULL) {
+    atomic_sub_fetch_64(&dBufMemUsed, size);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
   }
+  return p;
+}
 
+static void freeBufPage(SDiskbasedBuf* pBuf, void** p) {
+  if (*p != NULL) {
+    atomic_sub_fetch_64(&dBufMemUsed, getAllocPageSize(pBuf->pageSize));
+    taosMemoryFreeClear(*p);
+  }
+}
+
+// the ownership of pReq is always taken over
+static int32_t doFlushBufPageImpl(SDiskbasedBuf* pBuf, SPageWriteReq* pReq) {
   // extend the file
-  if (pBuf->fileSize < offset + size) {
-    pBuf->fileSize = offset + size;
+  if (pBuf->fileSize < pReq->offset + pReq->size) {
+    pBuf->fileSize = pReq->offset + pReq->size;
   }
 
-  pBuf->statis.flushBytes += size;
+  pBuf->statis.flushBytes += pReq->size;
   pBuf->statis.flushPages += 1;
 
+  if (pBuf->pWriter == NULL) {
+    int32_t size = pReq->size;
+    int64_t ret = taosPWriteFile(pBuf->pFile, pReq->data, size, pReq->offset);
+    taosMemoryFree(pReq);
+    if (ret != size) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      return terrno;
+    }
+    return TSDB_CODE_SUCCESS;
+  }
+
+  // throttle the query thread if the disk can not keep up with it
+  waitForPendingPages(pBuf, MAX_PENDING_WRITE_PAGES - 1);
+
+  taosThreadMutexLock(&pBuf->pendingLock);
+  int32_t code = pBuf->writeCode;
+  if (code == TSDB_CODE_SUCCESS) {
+    code = tSimpleHashPut(pBuf->pPending, &pReq->pageId, sizeof(int32_t), &pReq, POINTER_BYTES);
+  }
+  if (code == TSDB_CODE_SUCCESS) {
+    pBuf->numOfPending += 1;
+  }
+  taosThreadMutexUnlock(&pBuf->pendingLock);
+
+  if (code != TSDB_CODE_SUCCESS) {
+    taosMemoryFree(pReq);
+    terrno = code;
+    return code;
+  }
+
+  SPageWriter* pWriter = pBuf->pWriter;
+  taosThreadMutexLock(&pWriter->lock);
+  code = tdListAppend(pWriter->queue, &pReq);
+  taosThreadCondSignal(&pWriter->notEmpty);
+  taosThreadMutexUnlock(&pWriter->lock);
+
+  if (code != TSDB_CODE_SUCCESS) {
+    taosThreadMutexLock(&pBuf->pendingLock);
+    tSimpleHashRemove(pBuf->pPending, &pReq->pageId, sizeof(int32_t));
+    pBuf->numOfPending -= 1;
+    taosThreadMutexUnlock(&pBuf->pendingLock);
+
+    taosMemoryFree(pReq);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return terrno;
+  }
+
   return TSDB_CODE_SUCCESS;
 }
 
@@ -163,43 +365,44 @@ static char* doFlushBufPage(SDiskbasedBuf* pBuf, SPageInfo* pg) {
   int32_t size = pBuf->pageSize;
   int64_t offset = pg->offset;
 
-  char* t = NULL;
-  if ((!HAS_DATA_IN_DISK(pg)) || pg->dirty) {
-    void* payload = GET_PAYLOAD_DATA(pg);
-    t = doCompressData(payload, pBuf->pageSize, &size, pBuf);
+  if (pg->dirty) {
+    SPageWriteReq* pReq = taosMemoryMalloc(sizeof(SPageWriteReq) + pBuf->pageSize + 2);  // EXTRA BYTES
+    if (pReq == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return NULL;
+    }
+
+    size = doCompressData(GET_PAYLOAD_DATA(pg), pBuf->pageSize, pReq->data, pBuf);
     if (size < 0) {
       uError("failed to compress data when flushing data to disk, %s", pBuf->id);
+      taosMemoryFree(pReq);
       terrno = TSDB_CODE_INVALID_PARA;
       return NULL;
     }
-  }
 
-  // this page is flushed to disk for the first time
-  if (pg->dirty) {
+    // this page is flushed to disk for the first time
     if (!HAS_DATA_IN_DISK(pg)) {
       offset = allocateNewPositionInFile(pBuf, size);
       pBuf->nextPos += size;
-
-      int32_t code = doFlushBufPageImpl(pBuf, offset, t, size);
-      if (code != TSDB_CODE_SUCCESS) {
-        return NULL;
-      }
-    } else {
+    } else if (pg->length < size) {
       // length becomes greater, current space is not enough, allocate new place, otherwise, do nothing
-      if (pg->length < size) {
-        // 1. add current space to free list
-        SPageDiskInfo dinfo = {.length = pg->length, .offset = offset};
-        taosArrayPush(pBuf->pFree, &dinfo);
-
-        // 2. allocate new position, and update the info
-        offset = allocateNewPositionInFile(pBuf, size);
-        pBuf->nextPos += size;
-      }
+      // 1. add current space to free list
+      SPageDiskInfo dinfo = {.length = pg->length, .offset = offset};
+      taosArrayPush(pBuf->pFree, &dinfo);
 
-      int32_t code = doFlushBufPageImpl(pBuf, offset, t, size);
-      if (code != TSDB_CODE_SUCCESS) {
-        return NULL;
-      }
+      // 2. allocate new position, and update the info
+      offset = allocateNewPositionInFile(pBuf, size);
+      pBuf->nextPos += size;
+    }
+
+    pReq->pBuf = pBuf;
+    pReq->pageId = pg->pageId;
+    pReq->offset = offset;
+    pReq->size = size;
+
+    int32_t code = doFlushBufPageImpl(pBuf, pReq);
+    if (code != TSDB_CODE_SUCCESS) {
+      return NULL;
     }
   } else {  // NOTE: the size may be -1, the this recycle page has not been flushed to disk yet.
     size = pg->length;
@@ -241,21 +444,33 @@ static int32_t loadPageFromDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
     return TSDB_CODE_INVALID_PARA;
   }
 
-  int32_t ret = taosLSeekFile(pBuf->pFile, pg->offset, SEEK_SET);
-  if (ret == -1) {
-    ret = TAOS_SYSTEM_ERROR(errno);
-    return ret;
+  void* pPage = (void*)GET_PAYLOAD_DATA(pg);
+
+  // the page may still be waiting for the background writer, take it from the write request directly
+  bool inQueue = false;
+  taosThreadMutexLock(&pBuf->pendingLock);
+  int32_t ret = pBuf->writeCode;
+  SPageWriteReq** pReq = tSimpleHashGet(pBuf->pPending, &pg->pageId, sizeof(int32_t));
+  if (ret == TSDB_CODE_SUCCESS && pReq != NULL) {
+    memcpy(pPage, (*pReq)->data, pg->length);
+    inQueue = true;
   }
+  taosThreadMutexUnlock(&pBuf->pendingLock);
 
-  void* pPage = (void*)GET_PAYLOAD_DATA(pg);
-  ret = (int32_t)taosReadFile(pBuf->pFile, pPage, pg->length);
-  if (ret != pg->length) {
-    ret = TAOS_SYSTEM_ERROR(errno);
+  if (ret != TSDB_CODE_SUCCESS) {
     return ret;
   }
 
-  pBuf->statis.loadBytes += pg->length;
-  pBuf->statis.loadPages += 1;
+  if (!inQueue) {
+    ret = (int32_t)taosPReadFile(pBuf->pFile, pPage, pg->length, pg->offset);
+    if (ret != pg->length) {
+      ret = TAOS_SYSTEM_ERROR(errno);
+      return ret;
+    }
+
+    pBuf->statis.loadBytes += pg->length;
+    pBuf->statis.loadPages += 1;
+  }
 
   int32_t fullSize = 0;
   doDecompressData(pPage, pg->length, &fullSize, pBuf);
@@ -346,6 +561,16 @@ int32_t createDiskbasedBuf(SDiskbasedBuf** pBuf, int32_t pagesize, int32_t inMem
     goto _error;
   }
 
+  taosThreadMutexInit(&pPBuf->pendingLock, NULL);
+  taosThreadCondInit(&pPBuf->pendingCond, NULL);
+
+  // the buffers are spread over the writers
+  taosThreadOnce(&writerPoolInit, doInitPageWriters);
+  int32_t numOfWriters = atomic_load_32(&writerPool.numOfWriters);
+  if (numOfWriters > 0) {
+    pPBuf->pWriter = &writerPool.writers[(uint32_t)atomic_fetch_add_32(&writerPool.nextWriter, 1) % numOfWriters];
+  }
+
   pPBuf->pageSize = pagesize;
   pPBuf->numOfPages = 0;  // all pages are in buffer in the first place
   pPBuf->totalBufSize = 0;
@@ -379,6 +604,11 @@ int32_t createDiskbasedBuf(SDiskbasedBuf** pBuf, int32_t pagesize, int32_t inMem
     goto _error;
   }
 
+  pPBuf->pPending = tSimpleHashInit(MAX_PENDING_WRITE_PAGES, fn);
+  if (pPBuf->pPending == NULL) {
+    goto _error;
+  }
+
   pPBuf->prefix = (char*)dir;
   pPBuf->emptyDummyIdList = taosArrayInit(1, sizeof(int32_t));
 
@@ -399,13 +629,21 @@ static char* doExtractPage(SDiskbasedBuf* pBuf, bool* newPage) {
       uWarn("no available buf pages, current:%d, max:%d, reason: %s, %s", listNEles(pBuf->lruList), pBuf->inMemPages,
             terrstr(), pBuf->id)
     }
+  } else if (listNEles(pBuf->lruList) < MIN_IN_MEM_PAGES || tryAcquireBufMem(getAllocPageSize(pBuf->pageSize))) {
+    availablePage = allocBufPage(pBuf, listNEles(pBuf->lruList) >= MIN_IN_MEM_PAGES);
+    *newPage = true;
   } else {
-    availablePage =
-        taosMemoryCalloc(1, getAllocPageSize(pBuf->pageSize));  // add extract bytes in case of zipped buffer increased.
+    // the global budget is used up, spill a page of this buffer instead of growing it. If all of the in-memory pages
+    // are referenced, go beyond the budget rather than fail the query.
+    availablePage = evictBufPage(pBuf);
     if (availablePage == NULL) {
-      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      uDebug("query buffer budget exceeded, used:%" PRId64 ", limit:%" PRId64 ", %s", atomic_load_64(&dBufMemUsed),
+             atomic_load_64(&dBufMemLimit), pBuf->id);
+      availablePage = allocBufPage(pBuf, false);
+      *newPage = true;
+    } else {
+      pBuf->statis.budgetSpillPages += 1;
     }
-    *newPage = true;
   }
 
   return availablePage;
@@ -435,7 +673,7 @@ void* getNewBufPage(SDiskbasedBuf* pBuf, int32_t* pageId) {
     pi = registerNewPageInfo(pBuf, *pageId);
     if (pi == NULL) {
       if (newPage) {
-        taosMemoryFree(availablePage);
+        freeBufPage(pBuf, (void**)&availablePage);
       }
       return NULL;
     }
@@ -516,7 +754,7 @@ void* getBufPage(SDiskbasedBuf* pBuf, int32_t id) {
       int32_t code = loadPageFromDisk(pBuf, *pi);
       if (code != 0) {
         if (newPage) {
-          taosMemoryFree((*pi)->pData);
+          freeBufPage(pBuf, &(*pi)->pData);
         }
 
         terrno = code;
@@ -567,6 +805,7 @@ void destroyDiskbasedBuf(SDiskbasedBuf* pBuf) {
   }
 
   dBufPrintStatis(pBuf);
+  waitForPendingPages(pBuf, 0);
 
   bool needRemoveFile = false;
   if (pBuf->pFile != NULL) {
@@ -594,6 +833,10 @@ void destroyDiskbasedBuf(SDiskbasedBuf* pBuf) {
           ps->getPages, ps->releasePages, ps->flushBytes / 1024.0f, ps->flushPages, ps->loadBytes / 1024.0f,
           ps->loadPages, ps->loadBytes / (1024.0 * ps->loadPages));
     }
+
+    if (ps->budgetSpillPages > 0) {
+      uDebug("spilled pages:%d since query buffer budget used up, %s", ps->budgetSpillPages, pBuf->id);
+    }
   }
 
   if (needRemoveFile) {
@@ -608,7 +851,7 @@ void destroyDiskbasedBuf(SDiskbasedBuf* pBuf) {
   size_t n = taosArrayGetSize(pBuf->pIdList);
   for (int32_t i = 0; i < n; ++i) {
     SPageInfo* pi = taosArrayGetP(pBuf->pIdList, i);
-    taosMemoryFreeClear(pi->pData);
+    freeBufPage(pBuf, &pi->pData);
     taosMemoryFreeClear(pi);
   }
 
@@ -621,6 +864,9 @@ void destroyDiskbasedBuf(SDiskbasedBuf* pBuf) {
   taosArrayDestroy(pBuf->pFree);
 
   tSimpleHashCleanup(pBuf->all);
+  tSimpleHashCleanup(pBuf->pPending);
+  taosThreadMutexDestroy(&pBuf->pendingLock);
+  taosThreadCondDestroy(&pBuf->pendingCond);
 
   taosMemoryFreeClear(pBuf->id);
   taosMemoryFreeClear(pBuf->assistBuf);
@@ -661,7 +907,7 @@ void dBufSetBufPageRecycled(SDiskbasedBuf* pBuf, void* pPage) {
 
   // add this pageinfo into the free page info list
   SListNode* pNode = tdListPopNode(pBuf->lruList, ppi->pn);
-  taosMemoryFreeClear(ppi->pData);
+  freeBufPage(pBuf, &ppi->pData);
   taosMemoryFreeClear(pNode);
   ppi->pn = NULL;
 
@@ -670,6 +916,36 @@ void dBufSetBufPageRecycled(SDiskbasedBuf* pBuf, void* pPage) {
 
 void dBufSetPrintInfo(SDiskbasedBuf* pBuf) { pBuf->printStatis = true; }
 
+void dBufSetMemLimit(int64_t limit) { atomic_store_64(&dBufMemLimit, limit); }
+
+void dBufSetWriterThreads(int32_t num) { dBufWriterThreads = num; }
+
+void dBufStopWriters() {
+  TdThreadOnce tmp = PTHREAD_ONCE_INIT;
+  if (memcmp(&writerPoolInit, &tmp, sizeof(TdThreadOnce)) == 0) {
+    return;
+  }
+
+  // the buffers created from now on write their pages synchronously
+  int32_t num = atomic_exchange_32(&writerPool.numOfWriters, 0);
+  for (int32_t i = 0; i < num; ++i) {
+    SPageWriter* pWriter = &writerPool.writers[i];
+    taosThreadMutexLock(&pWriter->lock);
+    pWriter->stop = true;
+    taosThreadCondSignal(&pWriter->notEmpty);
+    taosThreadMutexUnlock(&pWriter->lock);
+
+    taosThreadJoin(pWriter->thread, NULL);
+    taosThreadMutexDestroy(&pWriter->lock);
+    taosThreadCondDestroy(&pWriter->notEmpty);
+    pWriter->queue = tdListFree(pWriter->queue);
+  }
+
+  uDebug("%d paged buffer writer threads are stopped", num);
+}
+
+int64_t dBufGetMemUsed() { return atomic_load_64(&dBufMemUsed); }
+
 SDiskbasedBufStatis getDBufStatis(const SDiskbasedBuf* pBuf) { return pBuf->statis; }
 
 void dBufPrintStatis(const SDiskbasedBuf* pBuf) {
@@ -699,10 +975,13 @@ void dBufPrintStatis(const SDiskbasedBuf* pBuf) {
 }
 
 void clearDiskbasedBuf(SDiskbasedBuf* pBuf) {
+  waitForPendingPages(pBuf, 0);
+  pBuf->writeCode = TSDB_CODE_SUCCESS;
+
   size_t n = taosArrayGetSize(pBuf->pIdList);
   for (int32_t i = 0; i < n; ++i) {
     SPageInfo* pi = taosArrayGetP(pBuf->pIdList, i);
-    taosMemoryFreeClear(pi->pData);
+    freeBufPage(pBuf, &pi->pData);
     taosMemoryFreeClear(pi);
   }
 
@@ -157,6 +157,75 @@ void recyclePageTest() {
 
   destroyDiskbasedBuf(pBuf);
 }
+
+// evicted pages are written behind and possibly still in the writer queue when they are loaded again
+void writeBehindTest(bool comp) {
+  SDiskbasedBuf* pBuf = NULL;
+  int32_t        ret = createDiskbasedBuf(&pBuf, 1024, 4 * 1024, "1", TD_TMP_DIR_PATH);
+  ASSERT_EQ(ret, 0);
+  setBufPageCompressOnDisk(pBuf, comp);
+
+  const int32_t numOfPages = 64;
+  for (int32_t i = 0; i < numOfPages; ++i) {
+    int32_t    pageId = 0;
+    SFilePage* pBufPage = static_cast<SFilePage*>(getNewBufPage(pBuf, &pageId));
+    ASSERT_TRUE(pBufPage != NULL);
+    ASSERT_EQ(pageId, i);
+
+    *(int32_t*)(pBufPage->data) = i * 10;
+    setBufPageDirty(pBufPage, true);
+    releaseBufPage(pBuf, pBufPage);
+  }
+
+  for (int32_t i = 0; i < numOfPages; ++i) {
+    SFilePage* pBufPage = static_cast<SFilePage*>(getBufPage(pBuf, i));
+    ASSERT_TRUE(pBufPage != NULL);
+    ASSERT_EQ(*(int32_t*)(pBufPage->data), i * 10);
+    releaseBufPage(pBuf, pBufPage);
+  }
+
+  ASSERT_FALSE(isAllDataInMemBuf(pBuf));
+  destroyDiskbasedBuf(pBuf);
+}
+
+// buffers spill to disk once the global budget is used up, even if their own in-memory quota is not reached
+void memBudgetTest() {
+  int64_t used = dBufGetMemUsed();
+  dBufSetMemLimit(used + 8 * 1024);
+
+  SDiskbasedBuf* pBuf1 = NULL;
+  SDiskbasedBuf* pBuf2 = NULL;
+  ASSERT_EQ(createDiskbasedBuf(&pBuf1, 1024, 64 * 1024, "1", TD_TMP_DIR_PATH), 0);
+  ASSERT_EQ(createDiskbasedBuf(&pBuf2, 1024, 64 * 1024, "2", TD_TMP_DIR_PATH), 0);
+
+  const int32_t numOfPages = 32;
+  for (int32_t i = 0; i < numOfPages; ++i) {
+    SDiskbasedBuf* pBuf = (i % 2 == 0) ? pBuf1 : pBuf2;
+    int32_t        pageId = 0;
+    SFilePage*     pBufPage = static_cast<SFilePage*>(getNewBufPage(pBuf, &pageId));
+    ASSERT_TRUE(pBufPage != NULL);
+
+    *(int32_t*)(pBufPage->data) = i;
+    setBufPageDirty(pBufPage, true);
+    releaseBufPage(pBuf, pBufPage);
+  }
+
+  ASSERT_LE(dBufGetMemUsed(), used + 8 * 1024 + 4 * 1024);
+  ASSERT_GT(getDBufStatis(pBuf1).budgetSpillPages, 0);
+
+  for (int32_t i = 0; i < numOfPages; ++i) {
+    SDiskbasedBuf* pBuf = (i % 2 == 0) ? pBuf1 : pBuf2;
+    SFilePage*     pBufPage = static_cast<SFilePage*>(getBufPage(pBuf, i / 2));
+    ASSERT_TRUE(pBufPage != NULL);
+    ASSERT_EQ(*(int32_t*)(pBufPage->data), i);
+    releaseBufPage(pBuf, pBufPage);
+  }
+
+  destroyDiskbasedBuf(pBuf1);
+  destroyDiskbasedBuf(pBuf2);
+  ASSERT_EQ(dBufGetMemUsed(), used);
+  dBufSetMemLimit(-1);
+}
 }  // namespace
 
 TEST(testCase, resultBufferTest) {
@@ -164,6 +233,13 @@ TEST(testCase, resultBufferTest) {
   simpleTest();
   writeDownTest();
   recyclePageTest();
+  writeBehindTest(false);
+  writeBehindTest(true);
+  memBudgetTest();
+
+  // the writers are joined, and the pages are written synchronously afterwards
+  dBufStopWriters();
+  writeBehindTest(false);
 }
 
 #pragma GCC diagnostic pop
\ No newline at end of file